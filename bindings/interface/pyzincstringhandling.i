@@ -27,6 +27,8 @@ free($1);
 
 %newobject *::getSolutionReport();
 
+%newobject *::writeMemoryUsageReport();
+
 /* the following line handle binary data */
 %apply (char *STRING, size_t LENGTH) { (const void *buffer, unsigned int buffer_length) }
 
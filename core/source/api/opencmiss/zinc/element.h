@@ -262,6 +262,29 @@ ZINC_API int cmzn_element_get_scale_factors(cmzn_element_id element,
 ZINC_API int cmzn_element_set_scale_factors(cmzn_element_id element,
 	cmzn_elementfieldtemplate_id eft, int valuesCount, const double *valuesIn);
 
+/**
+ * Get the neighbour element sharing the given face of this element, and the
+ * face of the neighbour it is on. Faces must have been defined for the mesh.
+ * Where more than two elements share the face, the first other element it is
+ * a face of is returned. An element which wraps around so a face joins
+ * another face of itself returns itself, with the other face type.
+ * Face types CMZN_ELEMENT_FACE_TYPE_XI1_0 onwards give the faces of the
+ * element shape in order. Lookup is constant time if the element neighbour
+ * table is enabled for the mesh, otherwise the face's parents are searched.
+ * @see cmzn_mesh_set_element_neighbour_table_enabled
+ *
+ * @param element  The element to query.
+ * @param face_type  The face of the element to get the neighbour across.
+ * @param neighbour_face_type_out  Optional address of variable which is set to
+ * the face type of the neighbour element on the face, or
+ * CMZN_ELEMENT_FACE_TYPE_INVALID if there is no neighbour. Can be NULL.
+ * @return  Handle to neighbour element, or NULL/invalid handle if none or
+ * failed.
+ */
+ZINC_API cmzn_element_id cmzn_element_get_neighbour(cmzn_element_id element,
+	enum cmzn_element_face_type face_type,
+	enum cmzn_element_face_type *neighbour_face_type_out);
+
 /**
  * Gets the shape type of the element. Note that legacy meshes may return an
  * unknown shape type for certain custom element shapes e.g. polygon shapes.
@@ -158,6 +158,18 @@ public:
 
 	inline Mesh getMesh() const;
 
+	/** @param neighbourFaceTypeOut  Optional address to receive face type of
+	 * neighbour the face is on. */
+	Element getNeighbour(FaceType faceType, FaceType *neighbourFaceTypeOut = 0)
+	{
+		cmzn_element_face_type neighbourFaceType = CMZN_ELEMENT_FACE_TYPE_INVALID;
+		cmzn_element_id neighbourId = cmzn_element_get_neighbour(this->id,
+			static_cast<cmzn_element_face_type>(faceType), &neighbourFaceType);
+		if (neighbourFaceTypeOut)
+			*neighbourFaceTypeOut = static_cast<FaceType>(neighbourFaceType);
+		return Element(neighbourId);
+	}
+
 	Node getNode(const Elementfieldtemplate &eft, int localNodeIndex)
 	{
 		return Node(cmzn_element_get_node(this->id, eft.getId(), localNodeIndex));
@@ -99,6 +99,62 @@ ZINC_API bool cmzn_field_is_managed(cmzn_field_id field);
  */
 ZINC_API int cmzn_field_set_managed(cmzn_field_id field, bool value);
 
+/**
+ * Get whether field values are evaluated with a compiled program.
+ * @see cmzn_field_set_compiled_evaluation
+ *
+ * @param field  The field to query.
+ * @return  true if compiled evaluation is enabled for field, otherwise false.
+ */
+ZINC_API bool cmzn_field_is_compiled_evaluation(cmzn_field_id field);
+
+/**
+ * Set whether values of this real field are evaluated with a compiled
+ * program. If set, the first evaluation with each field cache compiles the
+ * arithmetic expression tree below this field (add, multiply, divide, power,
+ * sqrt, exp, log, abs, trigonometric, dot product, magnitude, sum components,
+ * component, concatenate and constant fields) into a flat list of
+ * instructions evaluated without calling each field in the expression in
+ * turn. Other source fields are evaluated normally. The program is discarded
+ * and recompiled whenever the field or any field it depends on changes.
+ * Compiled evaluation is only used for values, not derivatives, and is
+ * recommended for large expressions evaluated at many locations, e.g.
+ * objective functions. Not set by default.
+ *
+ * @param field  The real field to modify.
+ * @param value  The new value for the compiled evaluation flag.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_field_set_compiled_evaluation(cmzn_field_id field, bool value);
+
+/**
+ * Get the maximum number of recent locations at which values of this field
+ * are memoised in each field cache.
+ * @see cmzn_field_set_location_memo_capacity
+ *
+ * @param field  The field to query.
+ * @return  The location memo capacity, or 0 if none or invalid field.
+ */
+ZINC_API int cmzn_field_get_location_memo_capacity(cmzn_field_id field);
+
+/**
+ * Set the maximum number of recent locations at which values of this field
+ * are memoised in each field cache. Normally a field cache only holds values
+ * at the current location; with memoisation, values evaluated at up to this
+ * number of element xi, node or time locations are kept and reused when the
+ * cache returns to any of them, avoiding recalculation of expensive fields
+ * when alternating between a few locations. Memoised values are discarded
+ * whenever the field or any field it depends on changes, and are not used
+ * for field coordinate locations or while field changes are cached.
+ * Defaults to a small number for expensive field types including
+ * find_mesh_location, eigenvalues and mesh_integral, otherwise 0.
+ *
+ * @param field  The field to modify.
+ * @param capacity  The number of locations to memoise, >= 0. 0 to disable.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_field_set_location_memo_capacity(cmzn_field_id field, int capacity);
+
 /**
  * Assign mesh_location field values at location specified in cache. Only
  * supported by stored_mesh_location field type.
@@ -178,6 +234,44 @@ ZINC_API cmzn_element_id cmzn_field_evaluate_mesh_location(cmzn_field_id field,
 ZINC_API int cmzn_field_evaluate_real(cmzn_field_id field, cmzn_fieldcache_id cache,
 	int number_of_values, double *values);
 
+/**
+ * Evaluate real field values at a batch of element locations in one call,
+ * optionally with first derivatives with respect to element chart. All
+ * locations are evaluated at the current time in cache, and the location
+ * in cache is unchanged on return. This is much more efficient than
+ * setting each location in cache and evaluating it separately since
+ * supporting fields process all locations in a single pass.
+ *
+ * @param field  The field to evaluate. Must be real valued.
+ * @param cache  Store of time to evaluate at and intermediate field values.
+ * @param number_of_locations  The number of element locations to evaluate
+ * at; must be positive.
+ * @param elements  Array of number_of_locations elements to evaluate in,
+ * all of the same dimension.
+ * @param number_of_chart_coordinates  The number of chart coordinates per
+ * location, which must equal the dimension of the elements.
+ * @param chart_coordinates  Array of number_of_locations*
+ * number_of_chart_coordinates element chart coordinates, with all
+ * coordinates for the first location followed by those for the next.
+ * @param number_of_values  Size of values array. Checked that it equals or
+ * exceeds number_of_locations times the number of components of field.
+ * @param values  Array of real values to evaluate into, with all components
+ * for the first location followed by those for the next.
+ * @param number_of_derivatives  Size of derivatives array, or 0 to not
+ * evaluate derivatives. If non-zero, checked that it equals or exceeds
+ * number_of_values*number_of_chart_coordinates.
+ * @param derivatives  Array to evaluate derivatives into, or NULL if not
+ * evaluating derivatives. For each location and component the derivatives
+ * with respect to each chart coordinate are consecutive.
+ * @return  Status CMZN_OK on success, any other value on failure including
+ * if field is not defined at any of the locations.
+ */
+ZINC_API int cmzn_field_evaluate_real_batch(cmzn_field_id field,
+	cmzn_fieldcache_id cache, int number_of_locations,
+	const cmzn_element_id *elements, int number_of_chart_coordinates,
+	const double *chart_coordinates, int number_of_values, double *values,
+	int number_of_derivatives, double *derivatives);
+
 /**
  * Evaluate field as string at location specified in cache. Numerical valued
  * fields are written to a string with comma separated components.
@@ -197,9 +291,14 @@ ZINC_API char *cmzn_field_evaluate_string(cmzn_field_id field,
  * 1. Can only evaluate at an element location.
  * 2. Differential operator must be obtained from mesh owning element. It is not
  * yet possible to evaluate derivatives with respect to parent element chart.
+ * 3. Second order derivatives are evaluated exactly by forward mode automatic
+ * differentiation, which is only supported for finite element, xi, constant
+ * and arithmetic, trigonometric, vector and composite operator fields
+ * combining them; evaluation fails for other fields.
  * NOTE:
  * It is currently more efficient to evaluate derivatives before field values
- * since values are cached simultaneously.
+ * since values are cached simultaneously. All second order derivatives at a
+ * location are evaluated and cached together.
  *
  * @param field  The field to evaluate derivatives for. Must be real valued.
  * @param differential_operator  The differential operator identifying which
@@ -39,6 +39,7 @@ class FieldStoredMeshLocation;
 class FieldStoredString;
 class Fieldmodule;
 class Fieldsmoothing;
+class Nodeset;
 
 class Field
 {
@@ -159,6 +160,26 @@ public:
 		return cmzn_field_set_managed(id, value);
 	}
 
+	bool isCompiledEvaluation()
+	{
+		return cmzn_field_is_compiled_evaluation(id);
+	}
+
+	int setCompiledEvaluation(bool value)
+	{
+		return cmzn_field_set_compiled_evaluation(id, value);
+	}
+
+	int getLocationMemoCapacity()
+	{
+		return cmzn_field_get_location_memo_capacity(id);
+	}
+
+	int setLocationMemoCapacity(int capacity)
+	{
+		return cmzn_field_set_location_memo_capacity(id, capacity);
+	}
+
 	char *getComponentName(int componentNumber)
 	{
 		return cmzn_field_get_component_name(id, componentNumber);
@@ -238,6 +259,9 @@ public:
 
 	inline int assignReal(const Fieldcache& cache, int valuesCount, const double *valuesIn);
 
+	inline int assignRealNodeset(const Fieldcache& cache, const Nodeset& nodeset,
+		int valuesCount, const double *valuesIn);
+
 	inline int assignString(const Fieldcache& cache, const char *stringValue);
 
 	inline Element evaluateMeshLocation(const Fieldcache& cache, int coordinatesCount,
@@ -245,6 +269,14 @@ public:
 
 	inline int evaluateReal(const Fieldcache& cache, int valuesCount, double *valuesOut);
 
+	inline int evaluateRealBatch(const Fieldcache& cache, int locationsCount,
+		const Element *elements, int coordinatesCount, const double *coordinatesIn,
+		int valuesCount, double *valuesOut, int derivativesCount = 0,
+		double *derivativesOut = 0);
+
+	inline int evaluateRealNodeset(const Fieldcache& cache, const Nodeset& nodeset,
+		int valuesCount, double *valuesOut);
+
 	inline char *evaluateString(const Fieldcache& cache);
 
 	inline int evaluateDerivative(const Differentialoperator& differentialOperator,
@@ -12,6 +12,7 @@
 #define CMZN_FIELDASSIGNMENT_H__
 
 #include "types/fieldassignmentid.h"
+#include "types/fieldcacheid.h"
 #include "types/fieldid.h"
 #include "types/nodesetid.h"
 
@@ -132,6 +133,53 @@ ZINC_API cmzn_field_id cmzn_fieldassignment_get_source_field(
 ZINC_API cmzn_field_id cmzn_fieldassignment_get_target_field(
 	cmzn_fieldassignment_id fieldassignment);
 
+/**
+ * Evaluate real field at all nodes in nodeset into a flat array in a single
+ * call, without setting each node in a field cache. Nodes are visited in
+ * order of increasing identifier. Finite element fields with real parameters
+ * are read directly from node storage; other fields are evaluated at each
+ * node in turn.
+ *
+ * @param field  The real field to evaluate.
+ * @param cache  The field cache supplying the time to evaluate at. Its
+ * location is unchanged on return.
+ * @param nodeset  The nodeset or nodeset group to evaluate over.
+ * @param number_of_values  Size of values array. Must be at least the size of
+ * the nodeset times the number of field components.
+ * @param values  Array to receive values of all components at each node in
+ * turn. Values for nodes where the field is not defined are not modified.
+ * @return  Result OK if evaluated at all nodes, WARNING_PART_DONE if only
+ * evaluated at some nodes, ERROR_NOT_FOUND if not evaluated at any nodes,
+ * otherwise ERROR_ARGUMENT for invalid arguments or other error.
+ */
+ZINC_API int cmzn_field_evaluate_real_nodeset(cmzn_field_id field,
+	cmzn_fieldcache_id cache, cmzn_nodeset_id nodeset, int number_of_values,
+	double *values);
+
+/**
+ * Assign real field at all nodes in nodeset from a flat array in a single
+ * call, without setting each node in a field cache. Nodes are visited in
+ * order of increasing identifier. For finite element fields, all versions of
+ * the VALUE parameter are set, writing directly to node storage. Other fields
+ * are assigned at each node in turn, which is only supported by some types.
+ * Change notification is deferred until all values are assigned.
+ *
+ * @param field  The real field to assign.
+ * @param cache  The field cache supplying the time to assign at. Its
+ * location is unchanged on return.
+ * @param nodeset  The nodeset or nodeset group to assign over.
+ * @param number_of_values  Size of values array. Must be at least the size of
+ * the nodeset times the number of field components.
+ * @param values  Array of values of all components for each node in turn.
+ * Values for nodes where the field is not defined are ignored.
+ * @return  Result OK if assigned at all nodes, WARNING_PART_DONE if only
+ * assigned at some nodes, ERROR_NOT_FOUND if not assigned at any nodes,
+ * otherwise ERROR_ARGUMENT for invalid arguments or other error.
+ */
+ZINC_API int cmzn_field_assign_real_nodeset(cmzn_field_id field,
+	cmzn_fieldcache_id cache, cmzn_nodeset_id nodeset, int number_of_values,
+	const double *values);
+
 #ifdef __cplusplus
 }
 #endif
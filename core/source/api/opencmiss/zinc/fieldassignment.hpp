@@ -12,6 +12,7 @@
 
 #include "opencmiss/zinc/fieldassignment.h"
 #include "opencmiss/zinc/field.hpp"
+#include "opencmiss/zinc/fieldcache.hpp"
 #include "opencmiss/zinc/nodeset.hpp"
 
 namespace OpenCMISS
@@ -112,6 +113,20 @@ inline Fieldassignment Field::createFieldassignment(const Field& sourceField)
 	return Fieldassignment(cmzn_field_create_fieldassignment(this->getId(), sourceField.getId()));
 }
 
+inline int Field::assignRealNodeset(const Fieldcache& cache, const Nodeset& nodeset,
+	int valuesCount, const double *valuesIn)
+{
+	return cmzn_field_assign_real_nodeset(this->id, cache.getId(), nodeset.getId(),
+		valuesCount, valuesIn);
+}
+
+inline int Field::evaluateRealNodeset(const Fieldcache& cache, const Nodeset& nodeset,
+	int valuesCount, double *valuesOut)
+{
+	return cmzn_field_evaluate_real_nodeset(this->id, cache.getId(), nodeset.getId(),
+		valuesCount, valuesOut);
+}
+
 }  // namespace Zinc
 }
 
@@ -2,6 +2,14 @@
  * @file fieldcache.h
  *
  * The public interface to the zinc field evaluation and assignment cache.
+ *
+ * Thread safety: fields in a region may be evaluated concurrently from
+ * multiple threads provided each thread uses its own field cache, which must
+ * not be shared or passed between threads while in use. Each thread may
+ * create and destroy its own field caches and handles to existing fields,
+ * elements, nodes and iterators while others evaluate. Assigning field values,
+ * or any other change to the model such as creating or modifying fields,
+ * elements or nodes, must not happen while any other thread is evaluating.
  */
 /* OpenCMISS-Zinc Library
 *
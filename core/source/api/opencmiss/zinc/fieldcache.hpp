@@ -139,6 +139,24 @@ inline int Field::evaluateReal(const Fieldcache& cache, int valuesCount, double
 	return cmzn_field_evaluate_real(id, cache.getId(), valuesCount, valuesOut);
 }
 
+inline int Field::evaluateRealBatch(const Fieldcache& cache, int locationsCount,
+	const Element *elements, int coordinatesCount, const double *coordinatesIn,
+	int valuesCount, double *valuesOut, int derivativesCount, double *derivativesOut)
+{
+	cmzn_element_id *elementIds = 0;
+	if ((locationsCount > 0) && (elements))
+	{
+		elementIds = new cmzn_element_id[locationsCount];
+		for (int i = 0; i < locationsCount; ++i)
+			elementIds[i] = elements[i].getId();
+	}
+	int result = cmzn_field_evaluate_real_batch(id, cache.getId(), locationsCount,
+		elementIds, coordinatesCount, coordinatesIn, valuesCount, valuesOut,
+		derivativesCount, derivativesOut);
+	delete[] elementIds;
+	return result;
+}
+
 inline char *Field::evaluateString(const Fieldcache& cache)
 {
 	return cmzn_field_evaluate_string(id, cache.getId());
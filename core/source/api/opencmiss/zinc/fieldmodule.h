@@ -86,6 +86,9 @@ ZINC_API cmzn_field_id cmzn_fieldmodule_find_field_by_name(
 /**
  * Creates a field cache for storing a known location and field values and
  * derivatives at that location. Required to evaluate and assign field values.
+ * A field cache must only be used by one thread at a time, but fields may be
+ * evaluated concurrently by several threads each using its own field cache.
+ * @see cmzn_fieldcache
  *
  * @param fieldmodule  The field module to create a field cache for.
  * @return  Handle to new field cache, or NULL/invalid handle on failure.
@@ -130,6 +133,130 @@ ZINC_API cmzn_fieldmodulenotifier_id cmzn_fieldmodule_create_fieldmodulenotifier
  */
 ZINC_API int cmzn_fieldmodule_define_all_faces(cmzn_fieldmodule_id fieldmodule);
 
+/**
+ * Get the maximum number of entries in the cache of element field values
+ * shared by all field caches of the field module's region. Element field
+ * values are the interpolation parameters and basis of a finite element field
+ * on an element, which are expensive to calculate; the least recently used
+ * entry is discarded when the cache is full. Cached entries are discarded
+ * when the field, or the element or its nodes are changed.
+ *
+ * @param fieldmodule  The field module to query.
+ * @return  Maximum number of cached element field values, or 0 if invalid
+ * argument.
+ */
+ZINC_API int cmzn_fieldmodule_get_element_field_values_cache_capacity(
+	cmzn_fieldmodule_id fieldmodule);
+
+/**
+ * Set the maximum number of entries in the cache of element field values
+ * shared by all field caches of the field module's region. Least recently
+ * used entries in excess of the new capacity are discarded immediately.
+ * @see cmzn_fieldmodule_get_element_field_values_cache_capacity
+ *
+ * @param fieldmodule  The field module to modify.
+ * @param capacity  The maximum number of cached element field values > 0.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_fieldmodule_set_element_field_values_cache_capacity(
+	cmzn_fieldmodule_id fieldmodule, int capacity);
+
+/**
+ * Discard all cached element field values for the field module's region, and
+ * reset hit and miss counts.
+ * @see cmzn_fieldmodule_get_element_field_values_cache_capacity
+ *
+ * @param fieldmodule  The field module to modify.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_fieldmodule_clear_element_field_values_cache(
+	cmzn_fieldmodule_id fieldmodule);
+
+/**
+ * Get statistics for the cache of element field values shared by all field
+ * caches of the field module's region. Hits and misses count lookups which
+ * did or did not find cached values, since the cache was created or last
+ * cleared.
+ * @see cmzn_fieldmodule_get_element_field_values_cache_capacity
+ *
+ * @param fieldmodule  The field module to query.
+ * @param size_out  Address to return current number of cached entries in.
+ * @param hits_out  Address to return number of lookups finding values in.
+ * @param misses_out  Address to return number of lookups not finding values in.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_fieldmodule_get_element_field_values_cache_statistics(
+	cmzn_fieldmodule_id fieldmodule, int *size_out, int *hits_out, int *misses_out);
+
+/**
+ * Enable or disable profiling of field evaluation for all field caches of the
+ * field module's region. While enabled, each field records the number of
+ * times it is evaluated, how many of those evaluations were satisfied by
+ * values already in the field cache, the wall time spent evaluating it
+ * including (inclusive) and excluding (exclusive) time evaluating its source
+ * fields, and the number of find mesh location searches on it. The element
+ * field values cache hits and misses are also recorded.
+ * Profiling is off by default; it adds negligible overhead when disabled.
+ * Disabling discards all recorded profile data. Profiling may be enabled,
+ * disabled, reset and reported while other threads evaluate fields in the
+ * region with their own field caches.
+ * @see cmzn_fieldmodule_write_profile_report
+ *
+ * @param fieldmodule  The field module to modify.
+ * @param enabled  True to enable profiling, false to disable.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_fieldmodule_set_profiling_enabled(cmzn_fieldmodule_id fieldmodule,
+	bool enabled);
+
+/**
+ * Query whether profiling of field evaluation is enabled for the field module.
+ * @see cmzn_fieldmodule_set_profiling_enabled
+ *
+ * @param fieldmodule  The field module to query.
+ * @return  True if profiling is enabled, otherwise false.
+ */
+ZINC_API bool cmzn_fieldmodule_is_profiling_enabled(cmzn_fieldmodule_id fieldmodule);
+
+/**
+ * Discard profile data recorded so far, while keeping profiling enabled.
+ * @see cmzn_fieldmodule_set_profiling_enabled
+ *
+ * @param fieldmodule  The field module to modify.
+ * @return  Result OK on success, ERROR_NOT_FOUND if profiling is not enabled,
+ * otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_fieldmodule_reset_profile(cmzn_fieldmodule_id fieldmodule);
+
+/**
+ * Write a report of field evaluation profile data recorded since profiling
+ * was enabled or last reset, as a JSON object. Its "Fields" array has an
+ * object for each field evaluated, in order of decreasing exclusive time,
+ * with members: Name, Evaluations, CacheHits, CacheHitRate, InclusiveTime,
+ * ExclusiveTime (times in seconds) and FindMeshLocationSearches. Its
+ * "ElementFieldValuesCache" object has members Hits, Misses and HitRate.
+ * If other threads are evaluating fields in the region, evaluations they have
+ * not finished are not reported.
+ * @see cmzn_fieldmodule_set_profiling_enabled
+ *
+ * @param fieldmodule  The field module to query.
+ * @return  On success, allocated string containing JSON report. Up to caller
+ * to free using cmzn_deallocate(). Returns NULL if profiling is not enabled
+ * or invalid argument.
+ */
+ZINC_API char *cmzn_fieldmodule_write_profile_report(cmzn_fieldmodule_id fieldmodule);
+
+/**
+ * Write the JSON report of field evaluation profile data as an information
+ * message to the logger of the context.
+ * @see cmzn_fieldmodule_write_profile_report
+ *
+ * @param fieldmodule  The field module to query.
+ * @return  Result OK on success, ERROR_NOT_FOUND if profiling is not enabled,
+ * otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_fieldmodule_log_profile_report(cmzn_fieldmodule_id fieldmodule);
+
 /**
  * Gets the region this field module can create fields for.
  *
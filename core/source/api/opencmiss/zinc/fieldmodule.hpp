@@ -183,6 +183,52 @@ public:
 		return cmzn_fieldmodule_define_all_faces(id);
 	}
 
+	int getElementFieldValuesCacheCapacity()
+	{
+		return cmzn_fieldmodule_get_element_field_values_cache_capacity(id);
+	}
+
+	int setElementFieldValuesCacheCapacity(int capacity)
+	{
+		return cmzn_fieldmodule_set_element_field_values_cache_capacity(id, capacity);
+	}
+
+	int clearElementFieldValuesCache()
+	{
+		return cmzn_fieldmodule_clear_element_field_values_cache(id);
+	}
+
+	int getElementFieldValuesCacheStatistics(int *sizeOut, int *hitsOut, int *missesOut)
+	{
+		return cmzn_fieldmodule_get_element_field_values_cache_statistics(id,
+			sizeOut, hitsOut, missesOut);
+	}
+
+	int setProfilingEnabled(bool enabled)
+	{
+		return cmzn_fieldmodule_set_profiling_enabled(id, enabled);
+	}
+
+	bool isProfilingEnabled()
+	{
+		return cmzn_fieldmodule_is_profiling_enabled(id);
+	}
+
+	int resetProfile()
+	{
+		return cmzn_fieldmodule_reset_profile(id);
+	}
+
+	char *writeProfileReport()
+	{
+		return cmzn_fieldmodule_write_profile_report(id);
+	}
+
+	int logProfileReport()
+	{
+		return cmzn_fieldmodule_log_profile_report(id);
+	}
+
 	Field findFieldByName(const char *fieldName)
 	{
 		return Field(cmzn_fieldmodule_find_field_by_name(id, fieldName));
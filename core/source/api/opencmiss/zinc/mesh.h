@@ -175,6 +175,39 @@ ZINC_API cmzn_elementiterator_id cmzn_mesh_create_elementiterator(
 ZINC_API int cmzn_mesh_define_element(cmzn_mesh_id mesh, int identifier,
 	cmzn_elementtemplate_id element_template);
 
+/**
+ * Create many elements in this mesh with shape and fields described by the
+ * element template, optionally setting their nodes for an element field
+ * template, in a single call. Much faster than defining elements one at a
+ * time as the template is checked once, storage is reserved up front and
+ * change notification is sent once for all new elements.
+ * @see cmzn_mesh_define_element
+ *
+ * @param mesh  Handle to the mesh to create the new elements in. If a mesh
+ * group, new elements are also added to the group.
+ * @param element_template  Template describing element shape and fields to
+ * define. Must be valid, with a valid shape.
+ * @param elements_count  Number of elements to create, > 0.
+ * @param identifiers  Array of elements_count unique non-negative identifiers
+ * for the new elements, none already used by existing elements in the mesh.
+ * Pass NULL to automatically generate identifiers starting from 1.
+ * @param eft  Element field template used by the element template to set
+ * local nodes for, or NULL/invalid handle to not set nodes.
+ * @param node_identifiers_count  Size of node_identifiers array, which must
+ * equal elements_count times the number of local nodes in eft. Ignored if no
+ * eft.
+ * @param node_identifiers  Array of identifiers of the local nodes of each
+ * element in turn, varying fastest by local node. Negative identifiers leave
+ * local nodes unset. Ignored if no eft.
+ * @return  Result OK on success, ERROR_ARGUMENT if any argument is invalid in
+ * which case no elements are created, otherwise any other value on failure
+ * in which case elements created before the failure remain.
+ */
+ZINC_API int cmzn_mesh_define_elements(cmzn_mesh_id mesh,
+	cmzn_elementtemplate_id element_template, int elements_count,
+	const int *identifiers, cmzn_elementfieldtemplate_id eft,
+	int node_identifiers_count, const int *node_identifiers);
+
 /**
  * Destroy all elements in mesh, also removing them from any related groups.
  * All handles to the destroyed element become invalid.
@@ -227,9 +260,12 @@ ZINC_API cmzn_element_id cmzn_mesh_find_element_by_identifier(cmzn_mesh_id mesh,
  * dimension of the mesh.
  *
  * @param mesh  Handle to the mesh to get differential operator from.
- * @param order  The order of the derivative. Currently must be 1.
+ * @param order  The order of the derivative. Currently must be 1 or 2.
  * @param term  Which of the (dimensions)^order differential operators is
- * required, starting at 1. For order 1, corresponds to a chart axis.
+ * required, starting at 1. For order 1, corresponds to a chart axis. For
+ * order 2, term (i - 1)*dimensions + j gives the second derivative with
+ * respect to chart axes i and j, e.g. for 2-D: 1 = d2/dxi1dxi1,
+ * 2 = d2/dxi1dxi2, 3 = d2/dxi2dxi1, 4 = d2/dxi2dxi2.
  * @return  Handle to differential operator, or NULL/invalid handle on failure.
  */
 ZINC_API cmzn_differentialoperator_id cmzn_mesh_get_chart_differentialoperator(
@@ -278,6 +314,15 @@ ZINC_API char *cmzn_mesh_get_name(cmzn_mesh_id mesh);
  */
 ZINC_API int cmzn_mesh_get_size(cmzn_mesh_id mesh);
 
+/**
+ * Query whether the master mesh keeps a table of element neighbours.
+ * @see cmzn_mesh_set_element_neighbour_table_enabled
+ *
+ * @param mesh  The mesh to query.
+ * @return  Boolean true if element neighbour table is enabled, otherwise false.
+ */
+ZINC_API bool cmzn_mesh_is_element_neighbour_table_enabled(cmzn_mesh_id mesh);
+
 /**
  * Check if two mesh handles refer to the same object.
  *
@@ -287,6 +332,45 @@ ZINC_API int cmzn_mesh_get_size(cmzn_mesh_id mesh);
  */
 ZINC_API bool cmzn_mesh_match(cmzn_mesh_id mesh1, cmzn_mesh_id mesh2);
 
+/**
+ * Set whether the master mesh keeps a table of the neighbour element across
+ * each face of every element, so finding neighbours, e.g. with
+ * cmzn_element_get_neighbour or when tracking streamlines between elements,
+ * is a constant time lookup instead of a search of the face's parents. The
+ * table is built when first needed, and afterwards only recalculated for
+ * elements whose faces or neighbours have changed. It costs memory per
+ * element face so is disabled by default. Applies to all mesh groups of the
+ * master mesh.
+ *
+ * @param mesh  The mesh to modify.
+ * @param enabled  True to enable the element neighbour table, false to disable
+ * it and free its memory.
+ * @return  Result OK on success, otherwise any other error code.
+ */
+ZINC_API int cmzn_mesh_set_element_neighbour_table_enabled(cmzn_mesh_id mesh,
+	bool enabled);
+
+/**
+ * Reorder elements in memory so elements sharing nodes are stored close
+ * together, reducing cache misses when evaluating fields over elements, and
+ * compact storage left unused by destroyed elements. Elements are sorted by
+ * the lowest index of their nodes after any node reordering; elements without
+ * nodes follow in their existing order. Element groups, faces, parents and
+ * all element data are updated, and all elements are notified as changed.
+ * Element handles remain valid, but element iterators are invalidated.
+ * Iteration order, which is by identifier, only changes if identifiers are
+ * renumbered.
+ * Best called after cmzn_nodeset_reorder_nodes once a mesh is fully defined.
+ *
+ * @param mesh  Handle to the mesh to reorder. If a mesh group, its master
+ * mesh is reordered.
+ * @param keep_identifiers  If true, elements keep their identifiers. If
+ * false, elements are renumbered from 1 in the new order.
+ * @return  Result OK on success, ERROR_IN_USE if faces are being defined,
+ * otherwise any other error code.
+ */
+ZINC_API int cmzn_mesh_reorder_elements(cmzn_mesh_id mesh, bool keep_identifiers);
+
 /**
  * If the mesh is a mesh group i.e. subset of elements from a master mesh,
  * get the mesh group specific interface for add/remove functions.
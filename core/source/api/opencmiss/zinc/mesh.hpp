@@ -104,6 +104,14 @@ public:
 		return cmzn_mesh_define_element(id, identifier, elementTemplate.getId());
 	}
 
+	int defineElements(const Elementtemplate& elementTemplate, int elementsCount,
+		const int *identifiers, const Elementfieldtemplate& eft,
+		int nodeIdentifiersCount, const int *nodeIdentifiers)
+	{
+		return cmzn_mesh_define_elements(id, elementTemplate.getId(), elementsCount,
+			identifiers, eft.getId(), nodeIdentifiersCount, nodeIdentifiers);
+	}
+
 	int destroyAllElements()
 	{
 		return cmzn_mesh_destroy_all_elements(id);
@@ -153,6 +161,21 @@ public:
 		return cmzn_mesh_get_size(id);
 	}
 
+	bool isElementNeighbourTableEnabled()
+	{
+		return cmzn_mesh_is_element_neighbour_table_enabled(id);
+	}
+
+	int setElementNeighbourTableEnabled(bool enabled)
+	{
+		return cmzn_mesh_set_element_neighbour_table_enabled(id, enabled);
+	}
+
+	int reorderElements(bool keepIdentifiers)
+	{
+		return cmzn_mesh_reorder_elements(id, keepIdentifiers);
+	}
+
 };
 
 inline bool operator==(const Mesh& a, const Mesh& b)
@@ -110,6 +110,40 @@ ZINC_API cmzn_nodetemplate_id cmzn_nodeset_create_nodetemplate(
 ZINC_API cmzn_node_id cmzn_nodeset_create_node(cmzn_nodeset_id nodeset,
 	int identifier, cmzn_nodetemplate_id node_template);
 
+/**
+ * Create many nodes in this nodeset with fields defined as in the node
+ * template, optionally setting parameters of real-valued fields, in a single
+ * call. Much faster than creating nodes one at a time as the template and
+ * fields are checked once, storage is reserved up front and change
+ * notification is sent once for all new nodes.
+ * @see cmzn_nodeset_create_node
+ *
+ * @param nodeset  Handle to the nodeset to create the new nodes in. If a
+ * nodeset group, new nodes are also added to the group.
+ * @param node_template  Template for defining node fields.
+ * @param nodes_count  Number of nodes to create, > 0.
+ * @param identifiers  Array of nodes_count unique non-negative identifiers
+ * for the new nodes, none already used by existing nodes in the nodeset.
+ * Pass NULL to automatically generate identifiers starting from 1.
+ * @param fields_count  Number of fields to set parameters for, >= 0.
+ * @param fields  Array of fields_count real-valued finite element fields
+ * defined without time variation by the node template.
+ * @param values_count  Size of values array, which must equal nodes_count
+ * times the total number of parameters of fields per node. Ignored if no
+ * fields.
+ * @param values  Parameters for each node in turn, containing all parameters
+ * for each field in turn, cycling slowest by component, then value label,
+ * with versions of each value label consecutive. For 3-component nodal
+ * coordinates with only VALUE parameters this is x, y, z for each node.
+ * @return  Result OK on success, ERROR_ARGUMENT if any argument is invalid in
+ * which case no nodes are created, otherwise any other value on failure
+ * in which case nodes created before the failure remain.
+ */
+ZINC_API int cmzn_nodeset_define_nodes(cmzn_nodeset_id nodeset,
+	cmzn_nodetemplate_id node_template, int nodes_count, const int *identifiers,
+	int fields_count, const cmzn_field_id *fields, int values_count,
+	const double *values);
+
 /**
  * Create a node iterator object for iterating through the nodes in the nodeset
  * which are ordered from lowest to highest identifier. The iterator initially
@@ -212,6 +246,27 @@ ZINC_API char *cmzn_nodeset_get_name(cmzn_nodeset_id nodeset);
  */
 ZINC_API int cmzn_nodeset_get_size(cmzn_nodeset_id nodeset);
 
+/**
+ * Reorder nodes in memory so nodes sharing elements are stored close together,
+ * reducing cache misses when evaluating fields over elements, and compact
+ * storage left unused by destroyed nodes. Uses the reverse Cuthill-McKee
+ * ordering of nodes connected through elements of all meshes; nodes not used
+ * by elements follow in their existing order. Node groups, element nodes and
+ * all node data are updated, and all nodes are notified as changed. Node handles remain valid, but node iterators
+ * are invalidated. Iteration order, which is by identifier, only changes if
+ * identifiers are renumbered.
+ * Best called once a mesh is fully defined, e.g. after merging several
+ * sources.
+ *
+ * @param nodeset  Handle to the nodeset to reorder. If a nodeset group, its
+ * master nodeset is reordered.
+ * @param keep_identifiers  If true, nodes keep their identifiers. If false,
+ * nodes are renumbered from 1 in the new order.
+ * @return  Result OK on success, ERROR_IN_USE if faces are being defined,
+ * otherwise any other error code.
+ */
+ZINC_API int cmzn_nodeset_reorder_nodes(cmzn_nodeset_id nodeset, bool keep_identifiers);
+
 /**
  * Check if two nodeset handles refer to the same object.
  *
@@ -86,6 +86,23 @@ public:
 		return Node(cmzn_nodeset_create_node(id, identifier, nodeTemplate.getId()));
 	}
 
+	int defineNodes(const Nodetemplate& nodeTemplate, int nodesCount,
+		const int *identifiers, int fieldsCount, const Field *fields,
+		int valuesCount, const double *values)
+	{
+		cmzn_field_id *fieldIds = 0;
+		if ((fieldsCount > 0) && (fields))
+		{
+			fieldIds = new cmzn_field_id[fieldsCount];
+			for (int i = 0; i < fieldsCount; i++)
+				fieldIds[i] = fields[i].getId();
+		}
+		int result = cmzn_nodeset_define_nodes(id, nodeTemplate.getId(), nodesCount,
+			identifiers, fieldsCount, fieldIds, valuesCount, values);
+		delete[] fieldIds;
+		return result;
+	}
+
 	Nodeiterator createNodeiterator()
 	{
 		return Nodeiterator(cmzn_nodeset_create_nodeiterator(id));
@@ -128,6 +145,11 @@ public:
 		return cmzn_nodeset_get_size(id);
 	}
 
+	int reorderNodes(bool keepIdentifiers)
+	{
+		return cmzn_nodeset_reorder_nodes(id, keepIdentifiers);
+	}
+
 };
 
 inline bool operator==(const Nodeset& a, const Nodeset& b)
@@ -336,6 +336,22 @@ ZINC_API int cmzn_region_write(cmzn_region_id region,
  */
 ZINC_API int cmzn_region_write_file(cmzn_region_id region, const char *file_name);
 
+/**
+ * Create a new region in the same context as the region, holding an
+ * independent copy of the region's finite element fields, groups, nodes,
+ * datapoints, elements and subregions. Modifying the fork does not change the
+ * original region and vice versa. The fork has no parent or name.
+ * The copy is made by writing the region to EX format in memory and reading it
+ * into the fork, so all storage is copied and other computed fields are not
+ * copied. Time-varying nodal parameters are copied at the given time only.
+ *
+ * @param region  The region to fork.
+ * @param time  Time at which to copy time-varying nodal parameters.
+ * @return  Handle to new region, or NULL/invalid handle on failure.
+ */
+ZINC_API cmzn_region_id cmzn_region_create_fork(cmzn_region_id region,
+	double time);
+
 /**
  * Return handle to the scene for this region, which contains
  * graphics for visualising fields in the region.
@@ -345,6 +361,44 @@ ZINC_API int cmzn_region_write_file(cmzn_region_id region, const char *file_name
  */
 ZINC_API cmzn_scene_id cmzn_region_get_scene(cmzn_region_id region);
 
+/**
+ * Write a report of memory allocated for storage in the region and all its
+ * subregions, as a JSON object for capacity planning. Each region object has
+ * members:
+ * Path: full path of the region.
+ * Nodesets: array with Name, Size, LabelsBytes, NodesBytes, ValuesBytes and
+ * TotalBytes of each nodeset.
+ * Meshes: array with Name, Size, LabelsBytes, ElementsBytes,
+ * ElementFieldTemplatesBytes, ScaleFactorsBytes and TotalBytes of each mesh.
+ * Fields: array with Name and TotalBytes of each field holding storage, plus
+ * as applicable NodesetValuesBytes and MeshValuesBytes objects giving bytes
+ * per nodeset and mesh name, GroupBytes and TextureBytes. Field nodeset
+ * values are part of the nodeset ValuesBytes.
+ * Graphics: array with Name, Type and VertexArrayBytes of each graphics in
+ * the region's scene.
+ * RegionBytes: total for this region only.
+ * Regions: array of objects for each child region.
+ * TotalBytes: total for this region and all its subregions.
+ * Bytes are those allocated for data structures, excluding allocator overheads
+ * and small fixed-size objects. Time is proportional to the numbers of nodes
+ * and elements in the region tree.
+ *
+ * @param region  The root region of the tree to report on.
+ * @return  On success, allocated string containing JSON report. Up to caller
+ * to free using cmzn_deallocate(). Returns NULL on invalid argument.
+ */
+ZINC_API char *cmzn_region_write_memory_usage_report(cmzn_region_id region);
+
+/**
+ * Write the JSON report of memory allocated for storage in the region tree as
+ * an information message to the logger of the context.
+ * @see cmzn_region_write_memory_usage_report
+ *
+ * @param region  The root region of the tree to report on.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_region_log_memory_usage_report(cmzn_region_id region);
+
 #ifdef __cplusplus
 }
 #endif
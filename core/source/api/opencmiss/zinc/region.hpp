@@ -174,6 +174,21 @@ public:
 		return cmzn_region_write_file(id, fileName);
 	}
 
+	Region createFork(double time)
+	{
+		return Region(cmzn_region_create_fork(id, time));
+	}
+
+	char *writeMemoryUsageReport()
+	{
+		return cmzn_region_write_memory_usage_report(id);
+	}
+
+	int logMemoryUsageReport()
+	{
+		return cmzn_region_log_memory_usage_report(id);
+	}
+
 	inline Scene getScene();
 
 	inline StreaminformationRegion createStreaminformationRegion();
@@ -11,6 +11,7 @@
 
 SET( FINITE_ELEMENT_CORE_SRCS
 	source/finite_element/element_field_template.cpp
+	source/finite_element/element_field_values_cache.cpp
 	source/finite_element/export_finite_element.cpp
 	source/finite_element/finite_element.cpp
 	source/finite_element/finite_element_basis.cpp
@@ -20,9 +21,11 @@ SET( FINITE_ELEMENT_CORE_SRCS
 	source/finite_element/finite_element_region.cpp
 	source/finite_element/finite_element_time.cpp
 	source/finite_element/import_finite_element.cpp
-	source/finite_element/node_field_template.cpp )
+	source/finite_element/node_field_template.cpp
+	source/finite_element/xi_point_set.cpp )
 SET( FINITE_ELEMENT_CORE_HDRS
 	source/finite_element/element_field_template.hpp
+	source/finite_element/element_field_values_cache.hpp
 	source/finite_element/export_finite_element.h
 	source/finite_element/finite_element_discretization.h
 	source/finite_element/finite_element_mesh.hpp
@@ -34,7 +37,8 @@ SET( FINITE_ELEMENT_CORE_HDRS
 	source/finite_element/finite_element_basis.h
 	source/finite_element/finite_element_time.h
 	source/finite_element/import_finite_element.h
-	source/finite_element/node_field_template.hpp )
+	source/finite_element/node_field_template.hpp
+	source/finite_element/xi_point_set.hpp )
 
 SET( FINITE_ELEMENT_GRAPHICS_SRCS
 	source/finite_element/finite_element_to_graphics_object.cpp
@@ -72,9 +72,11 @@ SET( NODE_SRCS source/node/node_operations.cpp )
 SET( NODE_HDRS source/node/node_operations.h )
 
 SET( REGION_SRCS source/region/cmiss_region.cpp
+	source/region/cmiss_region_memory_usage.cpp
 	source/stream/region_stream.cpp
 	source/region/cmiss_region_write_info.cpp )
 SET( REGION_HDRS source/region/cmiss_region.h
+	source/region/cmiss_region_memory_usage.hpp
 	source/region/cmiss_region_private.h
 	source/stream/region_stream.hpp
 	source/region/cmiss_region_write_info.h )
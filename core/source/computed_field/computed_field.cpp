@@ -125,6 +125,8 @@ like the number of components.
 #include "computed_field/computed_field_set.h"
 #include "computed_field/differential_operator.hpp"
 #include "computed_field/field_cache.hpp"
+#include "computed_field/field_evaluation_program.hpp"
+#include "computed_field/field_taylor_values.hpp"
 #include "computed_field/field_module.hpp"
 #include "finite_element/finite_element.h"
 #include "finite_element/finite_element_region.h"
@@ -141,6 +143,7 @@ like the number of components.
 #include "region/cmiss_region_private.h"
 #include "general/message.h"
 #include "general/enumerator_conversion.hpp"
+#include <new>
 #include <typeinfo>
 
 /*
@@ -292,12 +295,14 @@ COMPUTED_FIELD_INVALID with no components.
 			field->source_values = (FE_value *)NULL;
 			field->number_of_source_values = 0;
 
-			field->access_count = 0;
+			// construct atomic in memory from ALLOCATE
+			new (&field->access_count) std::atomic<int>(0);
 
 			field->manager = (struct MANAGER(Computed_field) *)NULL;
 			field->manager_change_status = MANAGER_CHANGE_NONE(Computed_field);
 
 			field->attribute_flags = 0;
+			field->location_memo_capacity = 0;
 		}
 		else
 		{
@@ -369,14 +374,15 @@ PROTOTYPE_DEACCESS_OBJECT_FUNCTION(Computed_field)
 	ENTER(DEACCESS(Computed_field));
 	if (object_address && (object = *object_address))
 	{
-		(object->access_count)--;
-		if (object->access_count <= 0)
+		// decrement and test once as access count may be changed concurrently
+		const int access_count = --(object->access_count);
+		if (access_count <= 0)
 		{
 			return_code = DESTROY(Computed_field)(object_address);
 		}
 		else if ((0 == (object->attribute_flags & COMPUTED_FIELD_ATTRIBUTE_IS_MANAGED_BIT)) &&
-			(object->manager) && ((1 == object->access_count) ||
-				((2 == object->access_count) &&
+			(object->manager) && ((1 == access_count) ||
+				((2 == access_count) &&
 					(MANAGER_CHANGE_NONE(Computed_field) != object->manager_change_status))) &&
 			object->core->not_in_use())
 		{
@@ -1011,6 +1017,7 @@ Computed_field *Computed_field_create_generic(
 				field->core = field_core;
 				if (return_code)
 				{
+					field->location_memo_capacity = field_core->getDefaultLocationMemoCapacity();
 					// only some field types implement the following, e.g. set default
 					// coordinate system of new field to that of a source field:
 					field_core->inherit_source_field_attributes();
@@ -1099,6 +1106,139 @@ void cmzn_field::clearCaches()
 	}
 }
 
+int cmzn_field::evaluateCompiled(cmzn_fieldcache& cache, FieldValueCache& inValueCache)
+{
+	// program only evaluates values, and like value caching is not used while
+	// changes are cached as it may be out of date
+	if ((0 == cache.getRequestedDerivatives()) && (0 == this->manager->cache))
+	{
+		RealFieldValueCache& valueCache = RealFieldValueCache::cast(inValueCache);
+		if (!valueCache.program)
+			valueCache.program = FieldEvaluationProgram::create(this);
+		if (valueCache.program->isValid())
+		{
+			valueCache.derivatives_valid = 0;
+			return valueCache.program->evaluate(cache, valueCache.values);
+		}
+	}
+	return this->core->evaluate(cache, inValueCache);
+}
+
+const FieldTaylorValues *cmzn_field::evaluateTaylor(cmzn_fieldcache& cache)
+{
+	Field_element_xi_location *elementXiLocation =
+		dynamic_cast<Field_element_xi_location *>(cache.getLocation());
+	if ((!elementXiLocation) || (CMZN_FIELD_VALUE_TYPE_REAL != this->core->get_value_type()))
+		return 0;
+	RealFieldValueCache& valueCache = RealFieldValueCache::cast(*this->getValueCache(cache));
+	const int dimension = elementXiLocation->get_dimension();
+	if (!valueCache.taylorValues)
+		valueCache.taylorValues = new FieldTaylorValues(this->number_of_components, dimension);
+	else if ((valueCache.taylorEvaluationCounter >= cache.getLocationCounter()) &&
+			(valueCache.taylorValues->getVariableCount() == dimension))
+		return valueCache.taylorValues;
+	else
+		valueCache.taylorValues->setVariableCount(dimension);
+	if (!this->core->evaluateTaylor(cache, *valueCache.taylorValues))
+	{
+		valueCache.taylorEvaluationCounter = -1;
+		return 0;
+	}
+	// like values, not reused between manager begin/end change
+	if (0 == this->manager->cache)
+		valueCache.taylorEvaluationCounter = cache.getLocationCounter();
+	return valueCache.taylorValues;
+}
+
+RealFieldValueCache *cmzn_field::evaluateComponents(cmzn_fieldcache& cache,
+	FieldComponentMask componentMask, bool& derivativesValid)
+{
+	if ((this->number_of_components > FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS) ||
+		(!this->core->hasComponentEvaluation()))
+	{
+		RealFieldValueCache *valueCache = RealFieldValueCache::cast(this->evaluate(cache));
+		derivativesValid = valueCache && valueCache->hasDerivatives();
+		return valueCache;
+	}
+	RealFieldValueCache *valueCache = RealFieldValueCache::cast(this->getValueCache(cache));
+	const int locationCounter = cache.getLocationCounter();
+	const bool derivativesRequested = (0 != cache.getRequestedDerivatives());
+	// use all values if already evaluated
+	if ((valueCache->evaluationCounter >= locationCounter) &&
+		((!derivativesRequested) || valueCache->hasDerivatives()))
+	{
+		derivativesValid = valueCache->hasDerivatives();
+		return valueCache;
+	}
+	if ((valueCache->componentsEvaluationCounter < locationCounter) ||
+		(derivativesRequested && (!valueCache->validComponentsDerivatives)))
+	{
+		valueCache->validComponents = 0;
+		valueCache->validComponentsDerivatives = derivativesRequested;
+	}
+	const FieldComponentMask evaluateMask = componentMask & (~valueCache->validComponents);
+	if (evaluateMask)
+	{
+		// evaluating some components overwrites values so all are no longer valid
+		valueCache->evaluationCounter = -1;
+		bool evaluatedDerivativesValid = false;
+		if (!this->core->evaluateComponents(cache, *valueCache, evaluateMask, evaluatedDerivativesValid))
+		{
+			valueCache->componentsEvaluationCounter = -1;
+			return 0;
+		}
+		if (!evaluatedDerivativesValid)
+			valueCache->validComponentsDerivatives = false;
+		// like values, not reused between manager begin/end change
+		if (0 == this->manager->cache)
+		{
+			valueCache->componentsEvaluationCounter = locationCounter;
+			valueCache->validComponents |= evaluateMask;
+		}
+		else
+			valueCache->componentsEvaluationCounter = -1;
+	}
+	derivativesValid = valueCache->validComponentsDerivatives;
+	return valueCache;
+}
+
+int cmzn_field::evaluateMemoised(cmzn_fieldcache& cache, FieldValueCache& valueCache)
+{
+	FieldLocationKey key;
+	// values may be out of date while changes are cached; values assigned in
+	// cache only are not true values at location
+	if ((0 != this->manager->cache) || cache.assignInCacheOnly() ||
+		(!key.setFromLocation(*cache.getLocation())))
+	{
+		return (this->attribute_flags & COMPUTED_FIELD_ATTRIBUTE_COMPILED_EVALUATION_BIT) ?
+			this->evaluateCompiled(cache, valueCache) : this->core->evaluate(cache, valueCache);
+	}
+	FieldValueMemo *memo = valueCache.getOrCreateLocationMemo(this->location_memo_capacity);
+	if (memo->restore(key, 0 != cache.getRequestedDerivatives(), valueCache))
+		return 1;
+	const int return_code = (this->attribute_flags & COMPUTED_FIELD_ATTRIBUTE_COMPILED_EVALUATION_BIT) ?
+		this->evaluateCompiled(cache, valueCache) : this->core->evaluate(cache, valueCache);
+	if (return_code)
+		memo->store(key, valueCache);
+	return return_code;
+}
+
+FieldValueCache *cmzn_field::evaluateProfiled(cmzn_fieldcache& cache, FieldProfile& profile)
+{
+	FieldValueCache *valueCache = getValueCache(cache);
+	if ((valueCache->evaluationCounter < cache.getLocationCounter()) ||
+		(cache.getRequestedDerivatives() && (!valueCache->hasDerivatives())))
+	{
+		const FieldProfile::Timer timer = profile.startTimer();
+		if (!this->evaluateValueCache(cache, *valueCache))
+			valueCache = 0;
+		profile.stopTimer(timer, this->cache_index);
+	}
+	else
+		profile.recordCacheHit(this->cache_index);
+	return valueCache;
+}
+
 int Computed_field_is_defined_in_element(struct Computed_field *field,
 	struct FE_element *element)
 {
@@ -1150,9 +1290,80 @@ char *Computed_field_core::getComponentName(int componentNumber) const
 	return duplicate_string(name);
 }
 
-FieldValueCache *Computed_field_core::createValueCache(cmzn_fieldcache& /*parentCache*/)
+FieldValueCache *Computed_field_core::createValueCache(cmzn_fieldcache& parentCache)
+{
+	return new RealFieldValueCache(field->number_of_components, parentCache);
+}
+
+int Computed_field_core::evaluateTaylor(cmzn_fieldcache& cache, FieldTaylorValues& taylorValues)
+{
+	if (0 != field->manager->cache)
+	{
+		// cached program may be out of date while changes are cached
+		FieldEvaluationProgram *program = FieldEvaluationProgram::create(field);
+		const int return_code = (program->isValid()) ? program->evaluateTaylor(cache, taylorValues) : 0;
+		delete program;
+		return return_code;
+	}
+	RealFieldValueCache& valueCache = RealFieldValueCache::cast(*field->getValueCache(cache));
+	if (!valueCache.program)
+		valueCache.program = FieldEvaluationProgram::create(field);
+	if (valueCache.program->isValid())
+		return valueCache.program->evaluateTaylor(cache, taylorValues);
+	return 0;
+}
+
+int Computed_field_core::evaluateComponents(cmzn_fieldcache& cache, RealFieldValueCache& valueCache,
+	FieldComponentMask /*componentMask*/, bool& derivativesValid)
 {
-	return new RealFieldValueCache(field->number_of_components);
+	const int return_code = this->evaluate(cache, valueCache);
+	derivativesValid = valueCache.hasDerivatives();
+	return return_code;
+}
+
+int Computed_field_core::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	valueCache.setupBatch(cache);
+	const int batchSize = cache.getBatchSize();
+	const int dimension = cache.getBatchDimension();
+	const int derivativesCount = cache.getBatchRequestedDerivatives();
+	const cmzn_element_id *elements = cache.getBatchElements();
+	const FE_value *xi = cache.getBatchXi();
+	const int componentCount = valueCache.componentCount;
+	const int derivativesSize = componentCount*derivativesCount;
+	FE_value *values = valueCache.batchValues.data();
+	FE_value *derivatives = (derivativesCount) ? valueCache.batchDerivatives.data() : 0;
+	const int requestedDerivatives = cache.getRequestedDerivatives();
+	cache.setRequestedDerivatives(derivativesCount);
+	int return_code = 1;
+	for (int p = 0; p < batchSize; ++p)
+	{
+		cache.setMeshLocation(elements[p], xi + p*dimension);
+		if (!this->field->evaluate(cache))
+		{
+			return_code = 0;
+			break;
+		}
+		for (int c = 0; c < componentCount; ++c)
+			values[c] = valueCache.values[c];
+		values += componentCount;
+		if (derivatives)
+		{
+			if (valueCache.derivatives_valid)
+			{
+				for (int i = 0; i < derivativesSize; ++i)
+					derivatives[i] = valueCache.derivatives[i];
+				derivatives += derivativesSize;
+			}
+			else
+			{
+				valueCache.batchDerivativesValid = 0;
+				derivatives = 0;
+			}
+		}
+	}
+	cache.setRequestedDerivatives(requestedDerivatives);
+	return return_code;
 }
 
 /** @return  true if all source fields are defined at cache location */
@@ -1371,6 +1582,61 @@ int cmzn_field_evaluate_real(cmzn_field_id field, cmzn_fieldcache_id cache,
 	return CMZN_ERROR_ARGUMENT;
 }
 
+int cmzn_field_evaluate_real_batch(cmzn_field_id field,
+	cmzn_fieldcache_id cache, int number_of_locations,
+	const cmzn_element_id *elements, int number_of_chart_coordinates,
+	const double *chart_coordinates, int number_of_values, double *values,
+	int number_of_derivatives, double *derivatives)
+{
+	if (!(cmzn_fieldcache_check(field, cache) && (0 < number_of_locations) && elements &&
+		(0 < number_of_chart_coordinates) && (number_of_chart_coordinates <= MAXIMUM_ELEMENT_XI_DIMENSIONS) &&
+		chart_coordinates && (number_of_values >= number_of_locations*field->number_of_components) && values &&
+		((0 == number_of_derivatives) || (derivatives &&
+			(number_of_derivatives >= number_of_locations*field->number_of_components*number_of_chart_coordinates))) &&
+		field->core->has_numerical_components()))
+	{
+		display_message(ERROR_MESSAGE, "cmzn_field_evaluate_real_batch.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	for (int p = 0; p < number_of_locations; ++p)
+	{
+		if (cmzn_element_get_dimension(elements[p]) != number_of_chart_coordinates)
+		{
+			display_message(ERROR_MESSAGE, "cmzn_field_evaluate_real_batch.  "
+				"Missing element or element dimension does not match number of chart coordinates");
+			return CMZN_ERROR_ARGUMENT;
+		}
+	}
+	// generic batch evaluation changes location in cache, so restore it afterwards
+	const int locationCounter = cache->getLocationCounter();
+	Field_location *savedLocation = cache->cloneLocation();
+	cache->setBatchMeshLocations(number_of_locations, elements, number_of_chart_coordinates,
+		chart_coordinates, (0 < number_of_derivatives) ? number_of_chart_coordinates : 0);
+	int return_code = CMZN_ERROR_GENERAL;
+	RealFieldValueCache *valueCache = field->evaluateBatch(*cache);
+	if (valueCache && ((0 == number_of_derivatives) || valueCache->batchDerivativesValid))
+	{
+		const int valuesCount = number_of_locations*field->number_of_components;
+		const FE_value *batchValues = valueCache->batchValues.data();
+		for (int i = 0; i < valuesCount; ++i)
+			values[i] = batchValues[i];
+		if (number_of_derivatives)
+		{
+			const int derivativesCount = valuesCount*number_of_chart_coordinates;
+			const FE_value *batchDerivatives = valueCache->batchDerivatives.data();
+			for (int i = 0; i < derivativesCount; ++i)
+				derivatives[i] = batchDerivatives[i];
+		}
+		return_code = CMZN_OK;
+	}
+	cache->clearBatchMeshLocations();
+	if (cache->getLocationCounter() != locationCounter)
+		cache->setLocation(savedLocation);
+	else
+		delete savedLocation;
+	return return_code;
+}
+
 // Internal API
 // IMPORTANT: Not yet approved for external API!
 int cmzn_field_evaluate_real_with_derivatives(cmzn_field_id field,
@@ -1433,6 +1699,18 @@ int cmzn_field_evaluate_derivative(cmzn_field_id field,
 		if (element_xi_location)
 		{
 			int element_dimension = element_xi_location->get_dimension();
+			if ((element_dimension == differential_operator->getDimension()) &&
+				(2 == differential_operator->getOrder()))
+			{
+				const FieldTaylorValues *taylorValues = field->evaluateTaylor(*cache);
+				if (!taylorValues)
+					return CMZN_ERROR_GENERAL;
+				int i, j;
+				differential_operator->getSecondOrderXiIndexes(i, j);
+				for (int c = 0; c < field->number_of_components; ++c)
+					values[c] = taylorValues->getSecondDerivative(c, i, j);
+				return CMZN_OK;
+			}
 			if (element_dimension == differential_operator->getDimension())
 			{
 				FieldValueCache *valueCache = field->evaluateWithDerivatives(*cache, element_dimension);
@@ -2331,7 +2609,7 @@ Writes the properties of the <field> to the command window.
 			display_message(INFORMATION_MESSAGE,"\n");
 		}
 		display_message(INFORMATION_MESSAGE,"  (access count = %d)\n",
-			field->access_count);
+			field->access_count.load());
 	}
 	else
 	{
@@ -2783,6 +3061,55 @@ int cmzn_field_set_managed(cmzn_field_id field, bool value)
 	return CMZN_ERROR_ARGUMENT;
 }
 
+bool cmzn_field_is_compiled_evaluation(cmzn_field_id field)
+{
+	if (field)
+		return (0 != (field->attribute_flags & COMPUTED_FIELD_ATTRIBUTE_COMPILED_EVALUATION_BIT));
+	return false;
+}
+
+int cmzn_field_set_compiled_evaluation(cmzn_field_id field, bool value)
+{
+	if ((field) && (CMZN_FIELD_VALUE_TYPE_REAL == field->core->get_value_type()))
+	{
+		if (value != cmzn_field_is_compiled_evaluation(field))
+		{
+			if (value)
+				field->attribute_flags |= COMPUTED_FIELD_ATTRIBUTE_COMPILED_EVALUATION_BIT;
+			else
+				field->attribute_flags &= ~COMPUTED_FIELD_ATTRIBUTE_COMPILED_EVALUATION_BIT;
+			// discard any programs and values evaluated the other way
+			if (field->manager)
+				cmzn_region_clear_field_value_caches(field->manager->owner, field);
+		}
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
+int cmzn_field_get_location_memo_capacity(cmzn_field_id field)
+{
+	if (field)
+		return field->location_memo_capacity;
+	return 0;
+}
+
+int cmzn_field_set_location_memo_capacity(cmzn_field_id field, int capacity)
+{
+	if ((field) && (0 <= capacity))
+	{
+		if (capacity != field->location_memo_capacity)
+		{
+			field->location_memo_capacity = capacity;
+			// discard values memoised with the old capacity
+			if (field->manager)
+				cmzn_region_clear_field_value_caches(field->manager->owner, field);
+		}
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 char *cmzn_field_get_component_name(cmzn_field_id field, int component_number)
 {
 	if (field && (0 < component_number) &&
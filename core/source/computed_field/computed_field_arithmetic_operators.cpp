@@ -16,6 +16,7 @@ Implements a number of basic component wise operators on computed fields.
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/field_cache.hpp"
 #include "computed_field/computed_field_set.h"
+#include "computed_field/field_evaluation_program.hpp"
 #include "general/debug.h"
 #include "general/mystring.h"
 #include "general/message.h"
@@ -67,6 +68,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -121,6 +126,35 @@ int Computed_field_power::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVa
 	return 0;
 }
 
+/** Batch operator: u^v */
+struct BatchPowerOperator
+{
+	FE_value value(int, FE_value u, FE_value v) const
+	{
+		return (FE_value)pow((double)u, (double)v);
+	}
+
+	void derivatives(int, FE_value u, FE_value v, FE_value f, FE_value& dfdu, FE_value& dfdv) const
+	{
+		/* d(u^v)/dx = v * u^(v-1) * du/dx + u^v * ln(u) * dv/dx */
+		dfdu = v*(FE_value)pow((double)u, (double)(v - 1));
+		dfdv = f*(FE_value)log((double)u);
+	}
+};
+
+int Computed_field_power::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_binary(cache, valueCache,
+		getSourceField(0), getSourceField(1), BatchPowerOperator());
+}
+
+bool Computed_field_power::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addBinaryInstructions(FieldEvaluationProgram::OPCODE_POWER, getSourceField(0), getSourceField(1),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 
 int Computed_field_power::list()
 /*******************************************************************************
@@ -308,6 +342,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -353,6 +391,34 @@ int Computed_field_multiply_components::evaluate(cmzn_fieldcache& cache, FieldVa
 	return 0;
 }
 
+/** Batch operator: u*v */
+struct BatchMultiplyOperator
+{
+	FE_value value(int, FE_value u, FE_value v) const
+	{
+		return u*v;
+	}
+
+	void derivatives(int, FE_value u, FE_value v, FE_value, FE_value& dfdu, FE_value& dfdv) const
+	{
+		dfdu = v;
+		dfdv = u;
+	}
+};
+
+int Computed_field_multiply_components::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_binary(cache, valueCache,
+		getSourceField(0), getSourceField(1), BatchMultiplyOperator());
+}
+
+bool Computed_field_multiply_components::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addBinaryInstructions(FieldEvaluationProgram::OPCODE_MULTIPLY, getSourceField(0), getSourceField(1),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_multiply_components::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -539,6 +605,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -587,6 +657,34 @@ int Computed_field_divide_components::evaluate(cmzn_fieldcache& cache, FieldValu
 	return 0;
 }
 
+/** Batch operator: u/v */
+struct BatchDivideOperator
+{
+	FE_value value(int, FE_value u, FE_value v) const
+	{
+		return u / v;
+	}
+
+	void derivatives(int, FE_value u, FE_value v, FE_value, FE_value& dfdu, FE_value& dfdv) const
+	{
+		dfdu = 1.0 / v;
+		dfdv = -u / (v*v);
+	}
+};
+
+int Computed_field_divide_components::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_binary(cache, valueCache,
+		getSourceField(0), getSourceField(1), BatchDivideOperator());
+}
+
+bool Computed_field_divide_components::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addBinaryInstructions(FieldEvaluationProgram::OPCODE_DIVIDE, getSourceField(0), getSourceField(1),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_divide_components::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -777,6 +875,10 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	virtual bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -819,6 +921,45 @@ int Computed_field_add::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+/** Batch operator: a*u + b*v */
+struct BatchAddOperator
+{
+	const FE_value a, b;
+
+	BatchAddOperator(FE_value aIn, FE_value bIn) :
+		a(aIn),
+		b(bIn)
+	{
+	}
+
+	FE_value value(int, FE_value u, FE_value v) const
+	{
+		return a*u + b*v;
+	}
+
+	void derivatives(int, FE_value, FE_value, FE_value, FE_value& dfdu, FE_value& dfdv) const
+	{
+		dfdu = a;
+		dfdv = b;
+	}
+};
+
+int Computed_field_add::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_binary(cache, valueCache,
+		getSourceField(0), getSourceField(1), BatchAddOperator(field->source_values[0], field->source_values[1]));
+}
+
+bool Computed_field_add::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	const int *source1 = program.getFieldRegisters(getSourceField(0));
+	const int *source2 = program.getFieldRegisters(getSourceField(1));
+	for (int i = 0; i < field->number_of_components; ++i)
+		componentRegisters[i] = program.addInstruction(FieldEvaluationProgram::OPCODE_ADD,
+			source1[i], source2[i], field->source_values[0], field->source_values[1]);
+	return true;
+}
+
 int Computed_field_add::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -1043,6 +1184,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -1092,6 +1237,42 @@ int Computed_field_scale::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVa
 	return 0;
 }
 
+/** Batch operator: scale[c]*u */
+struct BatchScaleOperator
+{
+	const FE_value *scaleFactors;
+
+	BatchScaleOperator(const FE_value *scaleFactorsIn) :
+		scaleFactors(scaleFactorsIn)
+	{
+	}
+
+	FE_value value(int c, FE_value u) const
+	{
+		return scaleFactors[c]*u;
+	}
+
+	FE_value derivative(int c, FE_value, FE_value) const
+	{
+		return scaleFactors[c];
+	}
+};
+
+int Computed_field_scale::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchScaleOperator(field->source_values));
+}
+
+bool Computed_field_scale::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	const int *source = program.getFieldRegisters(getSourceField(0));
+	for (int i = 0; i < field->number_of_components; ++i)
+		componentRegisters[i] = program.addInstruction(FieldEvaluationProgram::OPCODE_SCALE,
+			source[i], -1, field->source_values[i]);
+	return true;
+}
+
 enum FieldAssignmentResult Computed_field_scale::assign(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
 {
 	RealFieldValueCache *sourceCache = RealFieldValueCache::cast(getSourceField(0)->getValueCache(cache));
@@ -1887,6 +2068,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -1936,6 +2121,42 @@ int Computed_field_offset::evaluate(cmzn_fieldcache& cache, FieldValueCache& inV
 	return 0;
 }
 
+/** Batch operator: offset[c] + u */
+struct BatchOffsetOperator
+{
+	const FE_value *offsets;
+
+	BatchOffsetOperator(const FE_value *offsetsIn) :
+		offsets(offsetsIn)
+	{
+	}
+
+	FE_value value(int c, FE_value u) const
+	{
+		return offsets[c] + u;
+	}
+
+	FE_value derivative(int, FE_value, FE_value) const
+	{
+		return 1.0;
+	}
+};
+
+int Computed_field_offset::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchOffsetOperator(field->source_values));
+}
+
+bool Computed_field_offset::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	const int *source = program.getFieldRegisters(getSourceField(0));
+	for (int i = 0; i < field->number_of_components; ++i)
+		componentRegisters[i] = program.addInstruction(FieldEvaluationProgram::OPCODE_OFFSET,
+			source[i], -1, field->source_values[i]);
+	return true;
+}
+
 enum FieldAssignmentResult Computed_field_offset::assign(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
 {
 	RealFieldValueCache *sourceCache = RealFieldValueCache::cast(getSourceField(0)->getValueCache(cache));
@@ -2415,6 +2636,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -2457,6 +2682,33 @@ int Computed_field_log::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+/** Batch operator: log(u) */
+struct BatchLogOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)log((double)u);
+	}
+
+	FE_value derivative(int, FE_value u, FE_value) const
+	{
+		return 1.0 / u;
+	}
+};
+
+int Computed_field_log::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchLogOperator());
+}
+
+bool Computed_field_log::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_LOG, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_log::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -2615,6 +2867,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -2658,6 +2914,33 @@ int Computed_field_sqrt::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVal
 	return 0;
 }
 
+/** Batch operator: sqrt(u) */
+struct BatchSqrtOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)sqrt((double)u);
+	}
+
+	FE_value derivative(int, FE_value, FE_value f) const
+	{
+		return 1.0 / (2*f);
+	}
+};
+
+int Computed_field_sqrt::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchSqrtOperator());
+}
+
+bool Computed_field_sqrt::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_SQRT, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_sqrt::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -2816,6 +3099,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -2859,6 +3146,33 @@ int Computed_field_exp::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+/** Batch operator: exp(u) */
+struct BatchExpOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)exp((double)u);
+	}
+
+	FE_value derivative(int, FE_value, FE_value f) const
+	{
+		return f;
+	}
+};
+
+int Computed_field_exp::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchExpOperator());
+}
+
+bool Computed_field_exp::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_EXP, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_exp::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -3017,6 +3331,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -3079,6 +3397,33 @@ int Computed_field_abs::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+/** Batch operator: abs(u); derivative is 0 at u = 0 */
+struct BatchAbsOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)fabs((double)u);
+	}
+
+	FE_value derivative(int, FE_value u, FE_value) const
+	{
+		return (u > 0.0) ? 1.0 : ((u < 0.0) ? -1.0 : 0.0);
+	}
+};
+
+int Computed_field_abs::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchAbsOperator());
+}
+
+bool Computed_field_abs::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_ABS, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_abs::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -17,6 +17,7 @@ and real values in any order into a single vector field.
 #include "computed_field/computed_field_composite.h"
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/computed_field_set.h"
+#include "computed_field/field_evaluation_program.hpp"
 #include "computed_field/field_module.hpp"
 #include "general/debug.h"
 #include "general/mystring.h"
@@ -130,6 +131,18 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual bool hasComponentEvaluation() const
+	{
+		return true;
+	}
+
+	virtual int evaluateComponents(cmzn_fieldcache& cache, RealFieldValueCache& valueCache,
+		FieldComponentMask componentMask, bool& derivativesValid);
+
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -208,57 +221,174 @@ Compare the type specific data
 
 int Computed_field_composite::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache)
 {
-	// try to avoid allocating cache array
+	RealFieldValueCache& valueCache = RealFieldValueCache::cast(inValueCache);
+	bool derivativesValid = false;
+	const int return_code = this->evaluateComponents(cache, valueCache,
+		FieldComponentMask_all(field->number_of_components), derivativesValid);
+	valueCache.derivatives_valid = derivativesValid ? 1 : 0;
+	return return_code;
+}
+
+/** Evaluates source fields for only the components in mask, and only the
+ * source components needed for them */
+int Computed_field_composite::evaluateComponents(cmzn_fieldcache& cache, RealFieldValueCache& valueCache,
+	FieldComponentMask componentMask, bool& derivativesValid)
+{
+	const int componentCount = field->number_of_components;
+	// component masks are only used for up to FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS
+	const bool allComponents = (componentCount > FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS);
+	// try to avoid allocating cache arrays
 	const int CacheStackSize = 10;
 	RealFieldValueCache *fixedValueCache[CacheStackSize];
+	FieldComponentMask fixedSourceMask[CacheStackSize];
 	RealFieldValueCache **sourceValueCache = (field->number_of_source_fields <= CacheStackSize) ?
 		fixedValueCache : new RealFieldValueCache*[field->number_of_source_fields];
+	FieldComponentMask *sourceMask = (field->number_of_source_fields <= CacheStackSize) ?
+		fixedSourceMask : new FieldComponentMask[field->number_of_source_fields];
+	for (int i = 0; i < field->number_of_source_fields; ++i)
+	{
+		sourceValueCache[i] = 0;
+		sourceMask[i] = 0;
+	}
+	for (int i = 0; i < componentCount; ++i)
+	{
+		if ((0 <= source_field_numbers[i]) && (allComponents || FieldComponentMask_has(componentMask, i)))
+		{
+			// sources with too many components for masks are evaluated in full
+			sourceMask[source_field_numbers[i]] |=
+				(source_value_numbers[i] < FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS) ?
+				(static_cast<FieldComponentMask>(1) << source_value_numbers[i]) :
+				FieldComponentMask_all(FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS);
+		}
+	}
 	int return_code = 1;
 	int number_of_derivatives = cache.getRequestedDerivatives();
 	for (int i = 0; i < field->number_of_source_fields; ++i)
 	{
-		sourceValueCache[i] = RealFieldValueCache::cast(getSourceField(i)->evaluate(cache));
+		if (sourceMask[i])
+		{
+			bool sourceDerivativesValid = false;
+			sourceValueCache[i] = getSourceField(i)->evaluateComponents(cache, sourceMask[i], sourceDerivativesValid);
+			if (!sourceValueCache[i])
+			{
+				return_code = 0;
+				break;
+			}
+			if (!sourceDerivativesValid)
+				number_of_derivatives = 0;
+		}
+	}
+	if (return_code)
+	{
+		derivativesValid = (0 < number_of_derivatives);
+		for (int i = 0; i < componentCount; ++i)
+		{
+			if (!(allComponents || FieldComponentMask_has(componentMask, i)))
+				continue;
+			FE_value *destination = valueCache.derivatives + i*number_of_derivatives;
+			if (0 <= source_field_numbers[i])
+			{
+				const RealFieldValueCache *sourceCache = sourceValueCache[source_field_numbers[i]];
+				valueCache.values[i] = sourceCache->values[source_value_numbers[i]];
+				if (derivativesValid)
+				{
+					/* source field component */
+					const FE_value *source = sourceCache->derivatives +
+						source_value_numbers[i]*number_of_derivatives;
+					for (int j = 0; j < number_of_derivatives; ++j)
+						destination[j] = source[j];
+				}
+			}
+			else
+			{
+				valueCache.values[i] = field->source_values[source_value_numbers[i]];
+				if (derivativesValid)
+				{
+					for (int j = 0; j < number_of_derivatives; ++j)
+						destination[j] = 0.0;
+				}
+			}
+		}
+	}
+	if (sourceValueCache != fixedValueCache)
+	{
+		delete[] sourceValueCache;
+		delete[] sourceMask;
+	}
+	return (return_code);
+}
+
+int Computed_field_composite::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	const int CacheStackSize = 10;
+	const RealFieldValueCache *fixedValueCache[CacheStackSize];
+	const RealFieldValueCache **sourceValueCache = (field->number_of_source_fields <= CacheStackSize) ?
+		fixedValueCache : new const RealFieldValueCache*[field->number_of_source_fields];
+	int return_code = 1;
+	int number_of_derivatives = cache.getBatchRequestedDerivatives();
+	for (int i = 0; i < field->number_of_source_fields; ++i)
+	{
+		sourceValueCache[i] = getSourceField(i)->evaluateBatch(cache);
 		if (!sourceValueCache[i])
 		{
 			return_code = 0;
 			break;
 		}
-		if (number_of_derivatives && !sourceValueCache[i]->derivatives_valid)
+		if (number_of_derivatives && !sourceValueCache[i]->batchDerivativesValid)
 			number_of_derivatives = 0;
 	}
 	if (return_code)
 	{
-		RealFieldValueCache& valueCache = RealFieldValueCache::cast(inValueCache);
-		valueCache.derivatives_valid = (0 < number_of_derivatives);
-		FE_value *destination = number_of_derivatives ? valueCache.derivatives : 0;
-		for (int i=0;i<field->number_of_components;i++)
+		valueCache.setupBatch(cache);
+		valueCache.batchDerivativesValid = (0 < number_of_derivatives);
+		const int batchSize = cache.getBatchSize();
+		const int componentCount = field->number_of_components;
+		for (int i = 0; i < componentCount; ++i)
 		{
+			FE_value *destination = valueCache.batchValues.data() + i;
+			FE_value *destinationDerivatives = number_of_derivatives ?
+				valueCache.batchDerivatives.data() + i*number_of_derivatives : 0;
+			const int destinationDerivativesStep = componentCount*number_of_derivatives;
 			if (0 <= source_field_numbers[i])
 			{
-				valueCache.values[i] = sourceValueCache[source_field_numbers[i]]->
-					values[source_value_numbers[i]];
-				if (valueCache.derivatives_valid)
+				const RealFieldValueCache *sourceCache = sourceValueCache[source_field_numbers[i]];
+				const int sourceComponentCount = sourceCache->componentCount;
+				const FE_value *source = sourceCache->batchValues.data() + source_value_numbers[i];
+				for (int p = 0; p < batchSize; ++p)
 				{
-					/* source field component */
-					FE_value *source = sourceValueCache[source_field_numbers[i]]->derivatives +
+					*destination = *source;
+					destination += componentCount;
+					source += sourceComponentCount;
+				}
+				if (destinationDerivatives)
+				{
+					const int sourceDerivativesStep = sourceComponentCount*number_of_derivatives;
+					const FE_value *sourceDerivatives = sourceCache->batchDerivatives.data() +
 						source_value_numbers[i]*number_of_derivatives;
-					for (int j=0;j<number_of_derivatives;j++)
+					for (int p = 0; p < batchSize; ++p)
 					{
-						*destination = *source;
-						destination++;
-						source++;
+						for (int j = 0; j < number_of_derivatives; ++j)
+							destinationDerivatives[j] = sourceDerivatives[j];
+						destinationDerivatives += destinationDerivativesStep;
+						sourceDerivatives += sourceDerivativesStep;
 					}
 				}
 			}
 			else
 			{
-				valueCache.values[i] = field->source_values[source_value_numbers[i]];
-				if (valueCache.derivatives_valid)
+				const FE_value value = field->source_values[source_value_numbers[i]];
+				for (int p = 0; p < batchSize; ++p)
 				{
-					for (int j=0;j<number_of_derivatives;j++)
+					*destination = value;
+					destination += componentCount;
+				}
+				if (destinationDerivatives)
+				{
+					for (int p = 0; p < batchSize; ++p)
 					{
-						*destination = 0.0;
-						destination++;
+						for (int j = 0; j < number_of_derivatives; ++j)
+							destinationDerivatives[j] = 0.0;
+						destinationDerivatives += destinationDerivativesStep;
 					}
 				}
 			}
@@ -269,6 +399,19 @@ int Computed_field_composite::evaluate(cmzn_fieldcache& cache, FieldValueCache&
 	return (return_code);
 }
 
+bool Computed_field_composite::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	for (int i = 0; i < field->number_of_components; ++i)
+	{
+		if (0 <= source_field_numbers[i])
+			componentRegisters[i] = program.getFieldRegisters(
+				getSourceField(source_field_numbers[i]))[source_value_numbers[i]];
+		else
+			componentRegisters[i] = program.addConstant(field->source_values[source_value_numbers[i]]);
+	}
+	return true;
+}
+
 enum FieldAssignmentResult Computed_field_composite::assign(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
 {
 	/* go through each source field, getting current values, changing values
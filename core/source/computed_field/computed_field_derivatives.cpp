@@ -1115,8 +1115,9 @@ public:
 	FE_value perturbationSize;
 	std::vector<FE_value> cacheValues;
 
-	GradientRealFieldValueCache(int sourceComponentCount, int coordinateComponentCount) :
-		RealFieldValueCache(sourceComponentCount*coordinateComponentCount),
+	GradientRealFieldValueCache(int sourceComponentCount, int coordinateComponentCount,
+			cmzn_fieldcache& parentCache) :
+		RealFieldValueCache(sourceComponentCount*coordinateComponentCount, parentCache),
 		needEvaluatePerturbationSize(true),
 		perturbationSize(1.0E-5),
 		cacheValues(sourceComponentCount*2 + coordinateComponentCount*3)  // large enough for evaluate and getNodePerturbationSize
@@ -1259,11 +1260,11 @@ private:
 		}
 	}
 
-	virtual FieldValueCache *createValueCache(cmzn_fieldcache& /*parentCache*/)
+	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
 		return new GradientRealFieldValueCache(
 			getSourceField(0)->number_of_components,
-			getSourceField(1)->number_of_components);
+			getSourceField(1)->number_of_components, parentCache);
 	}
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
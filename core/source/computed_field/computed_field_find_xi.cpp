@@ -302,6 +302,9 @@ int Computed_field_perform_find_element_xi(struct Computed_field *field,
 		(number_of_values >= element_dimension))
 	{
 		return_code = 1;
+		FieldProfile *profile = field_cache->getProfile();
+		if (profile)
+			profile->recordFindMeshLocationSearch(cmzn_field_get_cache_index_private(field));
 		Computed_field_find_element_xi_base_cache *cache = 0;
 		if (valueCache->find_element_xi_cache && valueCache->find_element_xi_cache->cache_data)
 		{
@@ -11,6 +11,7 @@ Implements a number of basic component wise operations on computed fields.
 * This Source Code Form is subject to the terms of the Mozilla Public
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#include <algorithm>
 #include <math.h>
 #include "opencmiss/zinc/fieldmodule.h"
 #include "opencmiss/zinc/fieldfiniteelement.h"
@@ -20,6 +21,8 @@ Implements a number of basic component wise operations on computed fields.
 #include "computed_field/computed_field_find_xi.h"
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/computed_field_set.h"
+#include "computed_field/field_taylor_values.hpp"
+#include "finite_element/element_field_values_cache.hpp"
 #include "finite_element/finite_element.h"
 #include "finite_element/finite_element_discretization.h"
 #include "finite_element/finite_element_mesh.hpp"
@@ -62,104 +65,141 @@ DESCRIPTION :
 
 namespace {
 
+// maximum number of element field values kept by a single field value cache
+// for values not shared with other field caches
+const int localElementFieldValuesCacheCapacity = 1000;
+
 /***************************************************************************//**
  * Establishes the FE_element_field values necessary for evaluating field in
- * element at time, inherited from optional top_level_element. Uses existing
- * values in cache if nothing changed.
+ * element at time, inherited from optional top_level_element. Uses current
+ * values if still valid, otherwise gets them from the element field values
+ * cache shared by all field caches of the region, calculating and adding them
+ * to it if not found. Indexed fields are not shared as their evaluation
+ * temporarily modifies the values, and differentiated values are not shared
+ * as they are not keyed by differential order; these are instead kept in the
+ * caller's local cache, if supplied. Values are always recalculated if the
+ * field has changes cached between begin/end change.
+ * @param fe_element_field_values  Current element field values for caller,
+ * accessed. Replaced with accessed values for element on success, or 0.
+ * @param localCacheAddress  Optional address of caller's local cache for
+ * values not shared, created on demand. Caller must delete it, and clear it
+ * whenever its value cache is cleared.
  * @param calculate_derivatives  Controls whether basis functions for
  * derivatives are also evaluated.
  * @param differential_order  Optional order to differentiate monomials by.
  * @param differential_xi_indices  Which xi indices to differentiate.
  */
 int calculate_FE_element_field_values_for_element(
-	LIST(FE_element_field_values) *field_values_cache,
 	FE_element_field_values* &fe_element_field_values,
+	FE_element_field_values_cache **localCacheAddress,
 	FE_field *fe_field, int calculate_derivatives, struct FE_element *element,
 	FE_value time, struct FE_element *top_level_element, int differential_order = 0,
 	int *differential_xi_indices = 0)
 {
-	int return_code = 1;
-	if (field_values_cache && fe_field && element)
-	{
-		// can't trust cached element field values if between manager begin/end change
-		// and this field has been modified.
-		const bool fieldChanged = FE_field_has_cached_changes(fe_field);
-		/* ensure we have FE_element_field_values for element, with
-			 derivatives_calculated if requested */
-		if (fieldChanged || (!fe_element_field_values) ||
-			(!FE_element_field_values_are_for_element_and_time(
-				fe_element_field_values, element, time, top_level_element)) ||
-			(calculate_derivatives &&
-				(!FE_element_field_values_have_derivatives_calculated(fe_element_field_values))))
+	if (!(fe_field && element))
+		return 0;
+	// can't trust cached element field values if between manager begin/end change
+	// and this field has been modified.
+	const bool fieldChanged = FE_field_has_cached_changes(fe_field);
+	if ((!fieldChanged) && (fe_element_field_values) &&
+		FE_element_field_values_are_for_element_and_time(
+			fe_element_field_values, element, time, top_level_element) &&
+		((!calculate_derivatives) ||
+			FE_element_field_values_have_derivatives_calculated(fe_element_field_values)))
+	{
+		return 1;
+	}
+	DEACCESS(FE_element_field_values)(&fe_element_field_values);
+	FE_element_field_values_cache *elementFieldValuesCache = 0;
+	if (!fieldChanged)
+	{
+		if ((0 == differential_order) && (INDEXED_FE_FIELD != get_FE_field_FE_field_type(fe_field)))
 		{
-			bool needUpdate = false;
-			bool addToList = false;
-			if (!(fe_element_field_values = FIND_BY_IDENTIFIER_IN_LIST(
-				FE_element_field_values, element)(element, field_values_cache)))
-			{
-				needUpdate = true;
-				fe_element_field_values = CREATE(FE_element_field_values)();
-				if (fe_element_field_values)
-				{
-					addToList = true;
-				}
-				else
-				{
-					return_code = 0;
-				}
-			}
-			else
-			{
-				if (fieldChanged ||
-					(!FE_element_field_values_are_for_element_and_time(
-						fe_element_field_values,element,time,top_level_element)) ||
-					(calculate_derivatives&&
-						(!FE_element_field_values_have_derivatives_calculated(fe_element_field_values))))
-				{
-					needUpdate = true;
-					clear_FE_element_field_values(fe_element_field_values);
-				}
-			}
-			if (return_code && needUpdate)
-			{
-				/* note that FE_element_field_values accesses the element */
-				if (calculate_FE_element_field_values(element,fe_field,
-						time,calculate_derivatives,fe_element_field_values,
-						top_level_element))
-				{
-
-					for (int i = 0 ; i < differential_order ; i++)
-					{
-						FE_element_field_values_differentiate(fe_element_field_values,
-							differential_xi_indices[i]);
-					}
-
-					if (addToList)
-					{
-						/* Set a cache size limit */
-						if (1000 < NUMBER_IN_LIST(FE_element_field_values)(field_values_cache))
-						{
-							REMOVE_ALL_OBJECTS_FROM_LIST(FE_element_field_values)
-								(field_values_cache);
-						}
-						return_code = ADD_OBJECT_TO_LIST(FE_element_field_values)(
-							fe_element_field_values, field_values_cache);
-					}
-				}
-				else
-				{
-					/* clear element to indicate that values are clear */
-					clear_FE_element_field_values(fe_element_field_values);
-					return_code=0;
-				}
-			}
+			elementFieldValuesCache = FE_region_get_element_field_values_cache(FE_field_get_FE_region(fe_field));
+		}
+		else if (localCacheAddress)
+		{
+			if (!(*localCacheAddress))
+				*localCacheAddress = new FE_element_field_values_cache(localElementFieldValuesCacheCapacity);
+			elementFieldValuesCache = *localCacheAddress;
+		}
+		if (elementFieldValuesCache)
+		{
+			fe_element_field_values = elementFieldValuesCache->find(element, fe_field, time,
+				top_level_element, (0 != calculate_derivatives));
+			if (fe_element_field_values)
+				return 1;
 		}
 	}
-	else
+	fe_element_field_values = ACCESS(FE_element_field_values)(CREATE(FE_element_field_values)());
+	if (!fe_element_field_values)
+		return 0;
+	/* note that FE_element_field_values accesses the element */
+	if (!calculate_FE_element_field_values(element, fe_field, time,
+		calculate_derivatives, fe_element_field_values, top_level_element))
 	{
-		return_code = 0;
+		DEACCESS(FE_element_field_values)(&fe_element_field_values);
+		return 0;
 	}
-	return (return_code);
+	for (int i = 0; i < differential_order; i++)
+	{
+		FE_element_field_values_differentiate(fe_element_field_values,
+			differential_xi_indices[i]);
+	}
+	if (elementFieldValuesCache)
+		elementFieldValuesCache->add(element, fe_field, time, top_level_element, fe_element_field_values);
+	return 1;
+}
+
+/**
+ * Determines whether xi of points form a tensor product grid with xi1 varying
+ * fastest, as produced by tessellation and Gauss point loops.
+ * @param numbersOfPoints  On success, number of grid points in each direction.
+ * @param gridXi  On success, xi of grid points in each direction: all points
+ * for xi1, followed by those for xi2 etc.
+ * @return  True if xi form a grid with values exactly matching in each
+ * direction, otherwise false.
+ */
+bool getXiGrid(int dimension, int pointsCount, const FE_value *xi,
+	int *numbersOfPoints, std::vector<FE_value>& gridXi)
+{
+	gridXi.clear();
+	int stride = 1;
+	for (int d = 0; d < dimension; ++d)
+	{
+		// count points along direction d until a slower varying xi changes
+		int count = 1;
+		if (d == (dimension - 1))
+		{
+			count = pointsCount/stride;
+		}
+		else
+		{
+			while ((count*stride < pointsCount) &&
+				std::equal(xi + d + 1, xi + dimension, xi + count*stride*dimension + d + 1))
+				++count;
+		}
+		numbersOfPoints[d] = count;
+		for (int i = 0; i < count; ++i)
+			gridXi.push_back(xi[i*stride*dimension + d]);
+		stride *= count;
+	}
+	if (stride != pointsCount)
+		return false;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		const FE_value *pointXi = xi + p*dimension;
+		const FE_value *directionXi = gridXi.data();
+		int index = p;
+		for (int d = 0; d < dimension; ++d)
+		{
+			if (pointXi[d] != directionXi[index % numbersOfPoints[d]])
+				return false;
+			index /= numbersOfPoints[d];
+			directionXi += numbersOfPoints[d];
+		}
+	}
+	return true;
 }
 
 class MultiTypeRealFieldValueCache : public RealFieldValueCache
@@ -171,8 +211,8 @@ public:
 	std::vector<int> int_values;
 	std::vector<short> short_values;
 
-	MultiTypeRealFieldValueCache(int componentCount) :
-		RealFieldValueCache(componentCount),
+	MultiTypeRealFieldValueCache(int componentCount, cmzn_fieldcache& parentCache) :
+		RealFieldValueCache(componentCount, parentCache),
 		double_values(componentCount),
 		float_values(componentCount),
 		int_values(componentCount),
@@ -200,27 +240,30 @@ public:
 class FiniteElementRealFieldValueCache : public MultiTypeRealFieldValueCache
 {
 public:
-	FE_element_field_values* fe_element_field_values; // cache for a single element at one time
-	/* Keep a cache of FE_element_field_values as calculation is expensive */
-	LIST(FE_element_field_values) *field_values_cache;
-
-	FiniteElementRealFieldValueCache(int componentCount) :
-		MultiTypeRealFieldValueCache(componentCount),
+	// accessed values for current element and time, usually shared with other
+	// field caches through the region's element field values cache
+	FE_element_field_values* fe_element_field_values;
+	// values not shared with other field caches; created on demand
+	FE_element_field_values_cache *localElementFieldValuesCache;
+
+	FiniteElementRealFieldValueCache(int componentCount, cmzn_fieldcache& parentCache) :
+		MultiTypeRealFieldValueCache(componentCount, parentCache),
 		fe_element_field_values(0),
-		field_values_cache(CREATE(LIST(FE_element_field_values))())
+		localElementFieldValuesCache(0)
 	{
 	}
 
 	virtual ~FiniteElementRealFieldValueCache()
 	{
-		DESTROY(LIST(FE_element_field_values))(&field_values_cache);
+		DEACCESS(FE_element_field_values)(&fe_element_field_values);
+		delete this->localElementFieldValuesCache;
 	}
 
 	virtual void clear()
 	{
-		REMOVE_ALL_OBJECTS_FROM_LIST(FE_element_field_values)(field_values_cache);
-		// Following was a pointer to an object just destroyed, so must clear
-		fe_element_field_values = (FE_element_field_values *)NULL;
+		DEACCESS(FE_element_field_values)(&fe_element_field_values);
+		if (this->localElementFieldValuesCache)
+			this->localElementFieldValuesCache->clear();
 		RealFieldValueCache::clear();
 	}
 
@@ -240,28 +283,29 @@ public:
 class FiniteElementStringFieldValueCache : public StringFieldValueCache
 {
 public:
-	FE_element_field_values* fe_element_field_values; // cache for a single element at one time
-
-	/* Keep a cache of FE_element_field_values as calculation is expensive */
-	LIST(FE_element_field_values) *field_values_cache;
+	// accessed values for current element and time
+	FE_element_field_values* fe_element_field_values;
+	// values not shared with other field caches; created on demand
+	FE_element_field_values_cache *localElementFieldValuesCache;
 
 	FiniteElementStringFieldValueCache() :
 		StringFieldValueCache(),
 		fe_element_field_values(0),
-		field_values_cache(CREATE(LIST(FE_element_field_values))())
+		localElementFieldValuesCache(0)
 	{
 	}
 
 	virtual ~FiniteElementStringFieldValueCache()
 	{
-		DESTROY(LIST(FE_element_field_values))(&field_values_cache);
+		DEACCESS(FE_element_field_values)(&fe_element_field_values);
+		delete this->localElementFieldValuesCache;
 	}
 
 	virtual void clear()
 	{
-		REMOVE_ALL_OBJECTS_FROM_LIST(FE_element_field_values)(field_values_cache);
-		// Following was a pointer to an object just destroyed, so must clear
-		fe_element_field_values = (FE_element_field_values *)NULL;
+		DEACCESS(FE_element_field_values)(&fe_element_field_values);
+		if (this->localElementFieldValuesCache)
+			this->localElementFieldValuesCache->clear();
 		StringFieldValueCache::clear();
 	}
 
@@ -331,7 +375,7 @@ private:
 
 	int compare(Computed_field_core* other_field);
 
-	virtual FieldValueCache *createValueCache(cmzn_fieldcache& /*parentCache*/)
+	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
 		enum Value_type value_type = get_FE_field_value_type(fe_field);
 		switch (value_type)
@@ -344,15 +388,34 @@ private:
 			default:
 				break;
 		}
-		// Note it will be more efficient in some cases to allow finite element field value caches
-		// in related cmzn_fieldcache objects to have a common FE_element_field_values list,
-		// however they must not be shared with time lookup fields as only a single time is cached
-		// and performance will be poor. Leaving implementation to a later date.
-		return new FiniteElementRealFieldValueCache(field->number_of_components);
+		// element field values are shared between field caches via the region's
+		// element field values cache, which also caches time-varying fields by time
+		return new FiniteElementRealFieldValueCache(field->number_of_components, parentCache);
 	}
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual bool hasComponentEvaluation() const
+	{
+		switch (get_FE_field_value_type(this->fe_field))
+		{
+		case ELEMENT_XI_VALUE:
+		case STRING_VALUE:
+		case URL_VALUE:
+			return false;
+		default:
+			break;
+		}
+		return true;
+	}
+
+	virtual int evaluateComponents(cmzn_fieldcache& cache, RealFieldValueCache& valueCache,
+		FieldComponentMask componentMask, bool& derivativesValid);
+
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	int evaluateTaylor(cmzn_fieldcache& cache, FieldTaylorValues& taylorValues);
+
 	int list();
 
 	char* get_command_string();
@@ -689,6 +752,7 @@ The FE_field must also not be in use.
 
 int Computed_field_finite_element::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache)
 {
+	FE_time_sequence_interpolation_cache::Scope timeScope(cache.getTimeSequenceInterpolationCache());
 	int return_code = 0;
 	enum Value_type value_type = get_FE_field_value_type(fe_field);
 	switch (value_type)
@@ -740,7 +804,7 @@ int Computed_field_finite_element::evaluate(cmzn_fieldcache& cache, FieldValueCa
 				const FE_value* xi = element_xi_location->get_xi();
 
 				return_code = calculate_FE_element_field_values_for_element(
-					feStringValueCache.field_values_cache, feStringValueCache.fe_element_field_values,
+					feStringValueCache.fe_element_field_values, &(feStringValueCache.localElementFieldValuesCache),
 					fe_field, /*number_of_derivatives*/0, element, time, top_level_element);
 				if (return_code)
 				{
@@ -763,7 +827,7 @@ int Computed_field_finite_element::evaluate(cmzn_fieldcache& cache, FieldValueCa
 				int number_of_derivatives = cache.getRequestedDerivatives();
 
 				return_code = calculate_FE_element_field_values_for_element(
-					feValueCache.field_values_cache, feValueCache.fe_element_field_values,
+					feValueCache.fe_element_field_values, &(feValueCache.localElementFieldValuesCache),
 					fe_field, (0 < number_of_derivatives), element, time, top_level_element);
 				if (return_code)
 				{
@@ -777,14 +841,16 @@ int Computed_field_finite_element::evaluate(cmzn_fieldcache& cache, FieldValueCa
 							{
 								return_code=calculate_FE_element_field(-1,
 									feValueCache.fe_element_field_values,xi,feValueCache.values,
-									feValueCache.derivatives);
+									feValueCache.derivatives, element_xi_location->get_xi_point_set(),
+									element_xi_location->get_xi_point_index());
 								feValueCache.derivatives_valid = 1;
 							}
 							else
 							{
 								return_code=calculate_FE_element_field(-1,
 									feValueCache.fe_element_field_values,xi,feValueCache.values,
-									(FE_value *)NULL);
+									(FE_value *)NULL, element_xi_location->get_xi_point_set(),
+									element_xi_location->get_xi_point_index());
 								feValueCache.derivatives_valid = 0;
 							}
 						} break;
@@ -903,10 +969,178 @@ int Computed_field_finite_element::evaluate(cmzn_fieldcache& cache, FieldValueCa
 	return return_code;
 }
 
+/** Calculates only the masked components of real values at element and node
+ * locations; other value types are evaluated in full */
+int Computed_field_finite_element::evaluateComponents(cmzn_fieldcache& cache,
+	RealFieldValueCache& valueCache, FieldComponentMask componentMask, bool& derivativesValid)
+{
+	FE_time_sequence_interpolation_cache::Scope timeScope(cache.getTimeSequenceInterpolationCache());
+	const enum Value_type value_type = get_FE_field_value_type(fe_field);
+	const int componentCount = field->number_of_components;
+	Field_element_xi_location *element_xi_location;
+	Field_node_location *node_location;
+	if (((FE_VALUE_VALUE == value_type) || (SHORT_VALUE == value_type)) &&
+		(0 != (element_xi_location = dynamic_cast<Field_element_xi_location*>(cache.getLocation()))))
+	{
+		FiniteElementRealFieldValueCache& feValueCache = FiniteElementRealFieldValueCache::cast(valueCache);
+		const FE_value* xi = element_xi_location->get_xi();
+		const int number_of_derivatives = cache.getRequestedDerivatives();
+		if (!calculate_FE_element_field_values_for_element(feValueCache.fe_element_field_values,
+			&(feValueCache.localElementFieldValuesCache), fe_field, (0 < number_of_derivatives),
+			element_xi_location->get_element(), element_xi_location->get_time(),
+			element_xi_location->get_top_level_element()))
+			return 0;
+		for (int c = 0; c < componentCount; ++c)
+		{
+			if (FieldComponentMask_has(componentMask, c))
+			{
+				// single component values and derivatives are put at the start of arrays
+				if (!calculate_FE_element_field(c, feValueCache.fe_element_field_values, xi,
+					feValueCache.values + c, (number_of_derivatives) ?
+						feValueCache.derivatives + c*number_of_derivatives : (FE_value *)NULL,
+					element_xi_location->get_xi_point_set(), element_xi_location->get_xi_point_index()))
+					return 0;
+			}
+		}
+		derivativesValid = (0 < number_of_derivatives);
+		return 1;
+	}
+	if ((FE_VALUE_VALUE == value_type) &&
+		(0 != (node_location = dynamic_cast<Field_node_location*>(cache.getLocation()))))
+	{
+		for (int c = 0; c < componentCount; ++c)
+		{
+			if (FieldComponentMask_has(componentMask, c) &&
+				(CMZN_OK != get_FE_nodal_FE_value_value(node_location->get_node(), fe_field, c,
+					CMZN_NODE_VALUE_LABEL_VALUE, /*version_number*/0, node_location->get_time(),
+					valueCache.values + c)))
+				return 0;
+		}
+		/* No derivatives at node */
+		derivativesValid = false;
+		return 1;
+	}
+	const int return_code = this->evaluate(cache, valueCache);
+	derivativesValid = valueCache.hasDerivatives();
+	return return_code;
+}
+
+int Computed_field_finite_element::evaluateTaylor(cmzn_fieldcache& cache,
+	FieldTaylorValues& taylorValues)
+{
+	FE_time_sequence_interpolation_cache::Scope timeScope(cache.getTimeSequenceInterpolationCache());
+	Field_element_xi_location *element_xi_location =
+		dynamic_cast<Field_element_xi_location*>(cache.getLocation());
+	if ((!element_xi_location) || (FE_VALUE_VALUE != get_FE_field_value_type(fe_field)) ||
+			(GENERAL_FE_FIELD != get_FE_field_FE_field_type(fe_field)))
+		return 0;
+	cmzn_element *element = element_xi_location->get_element();
+	cmzn_element *top_level_element = element_xi_location->get_top_level_element();
+	const FE_value time = element_xi_location->get_time();
+	const FE_value *xi = element_xi_location->get_xi();
+	const int n = taylorValues.getVariableCount();
+	const int componentCount = field->number_of_components;
+	std::vector<FE_value> values(componentCount), derivatives(componentCount*n);
+	// values and first derivatives from element field values in value cache
+	FiniteElementRealFieldValueCache& feValueCache =
+		FiniteElementRealFieldValueCache::cast(*field->getValueCache(cache));
+	if (!(calculate_FE_element_field_values_for_element(feValueCache.fe_element_field_values,
+			&(feValueCache.localElementFieldValuesCache), fe_field, /*calculate_derivatives*/1,
+			element, time, top_level_element) &&
+		calculate_FE_element_field(-1, feValueCache.fe_element_field_values, xi,
+			values.data(), derivatives.data())))
+		return 0;
+	for (int c = 0; c < componentCount; ++c)
+	{
+		FE_value *component = taylorValues.getComponent(c);
+		component[0] = values[c];
+		for (int i = 0; i < n; ++i)
+			component[1 + i] = derivatives[c*n + i];
+	}
+	// second derivatives are first derivatives of element field values
+	// differentiated with respect to each xi in turn
+	for (int i = 0; i < n; ++i)
+	{
+		FE_element_field_values *differentiated_values = 0;
+		int xi_index = i;
+		int return_code = calculate_FE_element_field_values_for_element(differentiated_values, /*localCacheAddress*/0,
+			fe_field, /*calculate_derivatives*/1, element, time, top_level_element,
+			/*differential_order*/1, &xi_index);
+		if (return_code)
+			return_code = calculate_FE_element_field(-1, differentiated_values, xi,
+				values.data(), derivatives.data());
+		DEACCESS(FE_element_field_values)(&differentiated_values);
+		if (!return_code)
+			return 0;
+		for (int c = 0; c < componentCount; ++c)
+		{
+			FE_value *hessianRow = taylorValues.getComponent(c) + 1 + n + i*n;
+			for (int j = 0; j < n; ++j)
+				hessianRow[j] = derivatives[c*n + j];
+		}
+	}
+	return 1;
+}
+
+int Computed_field_finite_element::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	FE_time_sequence_interpolation_cache::Scope timeScope(cache.getTimeSequenceInterpolationCache());
+	enum Value_type value_type = get_FE_field_value_type(fe_field);
+	if ((value_type != FE_VALUE_VALUE) && (value_type != SHORT_VALUE))
+		return Computed_field_core::evaluateBatch(cache, valueCache);
+	FiniteElementRealFieldValueCache& feValueCache = FiniteElementRealFieldValueCache::cast(valueCache);
+	feValueCache.setupBatch(cache);
+	const int batchSize = cache.getBatchSize();
+	const int dimension = cache.getBatchDimension();
+	const int number_of_derivatives = cache.getBatchRequestedDerivatives();
+	const cmzn_element_id *elements = cache.getBatchElements();
+	const FE_value *xi = cache.getBatchXi();
+	const FE_value time = cache.getTime();
+	const int componentCount = field->number_of_components;
+	FE_value *values = feValueCache.batchValues.data();
+	FE_value *derivatives = (number_of_derivatives) ? feValueCache.batchDerivatives.data() : 0;
+	// location in cache is not changed; element field values are only recalculated
+	// when element changes so consecutive locations in the same element are cheap
+	int numbersOfPoints[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+	std::vector<FE_value> gridXi;
+	int p = 0;
+	while (p < batchSize)
+	{
+		int runEnd = p + 1;
+		while ((runEnd < batchSize) && (elements[runEnd] == elements[p]))
+			++runEnd;
+		if (!calculate_FE_element_field_values_for_element(
+				feValueCache.fe_element_field_values, &(feValueCache.localElementFieldValuesCache),
+				fe_field, (0 < number_of_derivatives), elements[p], time, /*top_level_element*/0))
+			return 0;
+		// evaluate grids of points in element by sum factorisation
+		if ((1 < (runEnd - p)) &&
+			FE_element_field_values_is_monomial(feValueCache.fe_element_field_values) &&
+			getXiGrid(dimension, runEnd - p, xi + p*dimension, numbersOfPoints, gridXi))
+		{
+			if (!calculate_FE_element_field_grid(feValueCache.fe_element_field_values,
+					numbersOfPoints, gridXi.data(), values + p*componentCount,
+					(derivatives) ? derivatives + p*componentCount*number_of_derivatives : 0))
+				return 0;
+			p = runEnd;
+			continue;
+		}
+		for (; p < runEnd; ++p)
+		{
+			if (!calculate_FE_element_field(/*all components*/-1, feValueCache.fe_element_field_values,
+					xi + p*dimension, values + p*componentCount,
+					(derivatives) ? derivatives + p*componentCount*number_of_derivatives : 0))
+				return 0;
+		}
+	}
+	return 1;
+}
+
 int Computed_field_finite_element::getNodeParameters(cmzn_fieldcache& cache, int componentNumber, 
 	cmzn_node_value_label valueLabel, int versionNumber,
 	int valuesCount, double *valuesOut)
 {
+	FE_time_sequence_interpolation_cache::Scope timeScope(cache.getTimeSequenceInterpolationCache());
 	Field_node_location *node_location = dynamic_cast<Field_node_location*>(cache.getLocation());
 	if ((componentNumber >= this->field->number_of_components)
 		|| (versionNumber < 0)
@@ -2040,9 +2274,9 @@ private:
 
 	int compare(Computed_field_core* other_field);
 
-	virtual FieldValueCache *createValueCache(cmzn_fieldcache& /*parentCache*/)
+	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
-		return new MultiTypeRealFieldValueCache(field->number_of_components);
+		return new MultiTypeRealFieldValueCache(field->number_of_components, parentCache);
 	}
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
@@ -2154,6 +2388,7 @@ DESCRIPTION :
 int Computed_field_node_value::evaluate(cmzn_fieldcache& cache,
 	FieldValueCache& inValueCache)
 {
+	FE_time_sequence_interpolation_cache::Scope timeScope(cache.getTimeSequenceInterpolationCache());
 	int return_code = 1;
 	MultiTypeRealFieldValueCache& valueCache = MultiTypeRealFieldValueCache::cast(inValueCache);
 	Field_node_location *node_location = dynamic_cast<Field_node_location*>(cache.getLocation());
@@ -2560,7 +2795,7 @@ private:
 
 	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
-		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components);
+		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components, parentCache);
 		// need extra cache for evaluating at parent element locations
 		valueCache->createExtraCache(parentCache, Computed_field_get_region(field));
 		return valueCache;
@@ -2615,9 +2850,9 @@ int Computed_field_edge_discontinuity::evaluate(cmzn_fieldcache& cache, FieldVal
 		parentsCount = 0;
 	FE_value parentXi[2];
 	const int numberOfComponents = field->number_of_components;
-	// Future: put in type-specific value cache to save allocations here
-	RealFieldValueCache parent1SourceValueCache(numberOfComponents);
-	RealFieldValueCache parent2SourceValueCache(numberOfComponents);
+	// temporary value caches recycle storage in the arena of cache
+	RealFieldValueCache parent1SourceValueCache(numberOfComponents, cache);
+	RealFieldValueCache parent2SourceValueCache(numberOfComponents, cache);
 	RealFieldValueCache *parentSourceValueCaches[2] =
 		{ &parent1SourceValueCache, &parent2SourceValueCache };
 	const FE_value *elementToParentsXi[2];
@@ -2925,7 +3160,7 @@ private:
 
 	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
-		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components);
+		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components, parentCache);
 		valueCache->createExtraCache(parentCache, Computed_field_get_region(field));
 		return valueCache;
 	}
@@ -3208,6 +3443,11 @@ private:
 		return valueCache;
 	}
 
+	virtual int getDefaultLocationMemoCapacity() const
+	{
+		return 4;
+	}
+
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
 	int list();
@@ -3541,6 +3781,8 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateTaylor(cmzn_fieldcache& cache, FieldTaylorValues& taylorValues);
+
 	int list();
 
 	char* get_command_string();
@@ -3553,6 +3795,25 @@ bool Computed_field_xi_coordinates::is_defined_at_location(cmzn_fieldcache& cach
 	return (0 != dynamic_cast<Field_element_xi_location*>(cache.getLocation()));
 }
 
+int Computed_field_xi_coordinates::evaluateTaylor(cmzn_fieldcache& cache,
+	FieldTaylorValues& taylorValues)
+{
+	Field_element_xi_location *element_xi_location =
+		dynamic_cast<Field_element_xi_location*>(cache.getLocation());
+	if (!element_xi_location)
+		return 0;
+	const FE_value* xi = element_xi_location->get_xi();
+	const int n = taylorValues.getVariableCount();
+	for (int c = 0; c < field->number_of_components; ++c)
+	{
+		FE_value *component = taylorValues.getComponent(c);
+		FieldTaylorValues::setConstant(n, component, (c < n) ? xi[c] : 0.0);
+		if (c < n)
+			component[1 + c] = 1.0;
+	}
+	return 1;
+}
+
 int Computed_field_xi_coordinates::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache)
 {
 	Field_element_xi_location *element_xi_location = dynamic_cast<Field_element_xi_location*>(cache.getLocation());
@@ -3743,9 +4004,9 @@ private:
 
 	int compare(Computed_field_core* other_field);
 
-	virtual FieldValueCache *createValueCache(cmzn_fieldcache& /*parentCache*/)
+	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
-		return new FiniteElementRealFieldValueCache(field->number_of_components);
+		return new FiniteElementRealFieldValueCache(field->number_of_components, parentCache);
 	}
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& valueCache);
@@ -3914,7 +4175,7 @@ int Computed_field_basis_derivative::evaluate(cmzn_fieldcache& cache, FieldValue
 		int number_of_derivatives = cache.getRequestedDerivatives();
 
 		if (calculate_FE_element_field_values_for_element(
-			feValueCache.field_values_cache, feValueCache.fe_element_field_values,
+			feValueCache.fe_element_field_values, &(feValueCache.localElementFieldValuesCache),
 			fe_field, /*derivatives_required*/1, element, time, top_level_element, order, xi_indices))
 		{
 			int return_code = 1;
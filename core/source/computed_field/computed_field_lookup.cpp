@@ -80,7 +80,7 @@ private:
 
 	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
-		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components);
+		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components, parentCache);
 		valueCache->createExtraCache(parentCache, Computed_field_get_region(field));
 		// set node once as doesn't change
 		valueCache->getExtraCache()->setNode(lookup_node);
@@ -369,7 +369,7 @@ private:
 
 	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
-		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components);
+		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components, parentCache);
 		valueCache->createExtraCache(parentCache, Computed_field_get_region(field));
 		// set node once as doesn't change
 		valueCache->getExtraCache()->setNode(nodal_lookup_node);
@@ -462,6 +462,7 @@ int Computed_field_quaternion_SLERP::evaluate(cmzn_fieldcache& cache, FieldValue
 	{
 		FE_value xi, lower_time, upper_time;
 		int time_index_one, time_index_two;
+		FE_time_sequence_interpolation_cache::Scope timeScope(cache.getTimeSequenceInterpolationCache());
 		FE_time_sequence_get_interpolation_for_time(
 			time_sequence, time, &time_index_one,
 			&time_index_two, &xi);
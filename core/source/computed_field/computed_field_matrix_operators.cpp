@@ -8,6 +8,7 @@
 * This Source Code Form is subject to the terms of the Mozilla Public
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#include <algorithm>
 #include <cmath>
 #include "opencmiss/zinc/fieldmatrixoperators.h"
 #include "computed_field/computed_field.h"
@@ -216,8 +217,8 @@ public:
 	/* cache for matrix, eigenvectors. eigenvalues go in values member of base class */
 	double *a, *v;
 
-	EigenvalueFieldValueCache(int componentCount) :
-		RealFieldValueCache(componentCount),
+	EigenvalueFieldValueCache(int componentCount, cmzn_fieldcache& parentCache) :
+		RealFieldValueCache(componentCount, parentCache),
 		a(new double[componentCount*componentCount]),
 		v(new double[componentCount*componentCount])
 	{
@@ -238,6 +239,21 @@ public:
 	{
 		return FIELD_VALUE_CACHE_CAST<EigenvalueFieldValueCache&>(valueCache);
 	}
+
+	/** Also memoise eigenvectors as read by eigenvectors field */
+	virtual bool saveToMemo(FieldValueMemoEntry& entry) const
+	{
+		RealFieldValueCache::saveToMemo(entry);
+		entry.values.insert(entry.values.end(), v, v + componentCount*componentCount);
+		return true;
+	}
+
+	virtual bool loadFromMemo(const FieldValueMemoEntry& entry)
+	{
+		RealFieldValueCache::loadFromMemo(entry);
+		std::copy(entry.values.end() - componentCount*componentCount, entry.values.end(), v);
+		return true;
+	}
 };
 
 const char computed_field_eigenvalues_type_string[] = "eigenvalues";
@@ -278,9 +294,14 @@ private:
 		}
 	}
 
-	virtual FieldValueCache *createValueCache(cmzn_fieldcache& /*parentCache*/)
+	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
+	{
+		return new EigenvalueFieldValueCache(field->number_of_components, parentCache);
+	}
+
+	virtual int getDefaultLocationMemoCapacity() const
 	{
-		return new EigenvalueFieldValueCache(field->number_of_components);
+		return 4;
 	}
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
@@ -699,8 +720,8 @@ public:
 	double *a, *b;
 	int *indx;
 
-	MatrixInvertFieldValueCache(int componentCount, int n) :
-		RealFieldValueCache(componentCount),
+	MatrixInvertFieldValueCache(int componentCount, int n, cmzn_fieldcache& parentCache) :
+		RealFieldValueCache(componentCount, parentCache),
 		n(n),
 		a(new double[n*n]),
 		b(new double[n]),
@@ -764,9 +785,9 @@ private:
 		}
 	}
 
-	virtual FieldValueCache *createValueCache(cmzn_fieldcache& /*parentCache*/)
+	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
-		return new MatrixInvertFieldValueCache(field->number_of_components, Computed_field_get_square_matrix_size(getSourceField(0)));
+		return new MatrixInvertFieldValueCache(field->number_of_components, Computed_field_get_square_matrix_size(getSourceField(0)), parentCache);
 	}
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
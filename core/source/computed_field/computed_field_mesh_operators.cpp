@@ -72,11 +72,16 @@ public:
 
 	virtual FieldValueCache *createValueCache(cmzn_fieldcache& parentCache)
 	{
-		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components);
+		RealFieldValueCache *valueCache = new RealFieldValueCache(field->number_of_components, parentCache);
 		valueCache->createExtraCache(parentCache, Computed_field_get_region(field));
 		return valueCache;
 	}
 
+	virtual int getDefaultLocationMemoCapacity() const
+	{
+		return 4;
+	}
+
 	virtual bool is_defined_at_location(cmzn_fieldcache& cache);
 
 	void appendNumbersOfPointsString(char **theString, int *error) const;
@@ -203,6 +208,8 @@ protected:
 	cmzn_field *coordinateField;
 	const int coordinatesCount;
 	cmzn_element *element;
+	FE_xi_point_set *xiPointSet;
+	int xiPointIndex;
 
 public:
 	IntegralTermBase(Computed_field_mesh_integral& meshIntegralIn, cmzn_fieldcache& parentCache, RealFieldValueCache& valueCache) :
@@ -213,7 +220,9 @@ public:
 		integrandField(meshIntegral.getSourceField(0)),
 		coordinateField(meshIntegral.getSourceField(1)),
 		coordinatesCount(coordinateField->number_of_components),
-		element(0)
+		element(0),
+		xiPointSet(0),
+		xiPointIndex(-1)
 	{
 		cache.setTime(parentCache.getTime());
 	}
@@ -221,12 +230,24 @@ public:
 	void setElement(cmzn_element *elementIn)
 	{
 		element = elementIn;
+		xiPointSet = 0;
+	}
+
+	/** Set point set and index of xi passed to next process call, so
+	 * fields are interpolated with its basis function tables. */
+	void setXiPoint(FE_xi_point_set *xiPointSetIn, int xiPointIndexIn)
+	{
+		xiPointSet = xiPointSetIn;
+		xiPointIndex = xiPointIndexIn;
 	}
 
 	/** @return pointer to integrand values */
 	inline FE_value *baseProcess(FE_value *xi, FE_value &dLAV)
 	{
-		this->cache.setMeshLocation(this->element, xi);
+		if (this->xiPointSet)
+			this->cache.setMeshLocationXiPoint(this->element, this->xiPointSet, this->xiPointIndex);
+		else
+			this->cache.setMeshLocation(this->element, xi);
 		RealFieldValueCache *integrandValueCache = RealFieldValueCache::cast(integrandField->evaluate(cache));
 		RealFieldValueCache *coordinateValueCache = coordinateField->evaluateWithDerivatives(cache, dimension);
 		if (integrandValueCache && coordinateValueCache)
@@ -28,6 +28,7 @@ Types used only internally to computed fields.
 #include "general/debug.h"
 #include "general/manager_private.h"
 #include "region/cmiss_region.h"
+#include <atomic>
 
 /**
  * Argument to field modifier functions supplying region, default name,
@@ -260,6 +261,67 @@ public:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& valueCache) = 0;
 
+	/** Evaluate real values, plus derivatives if requested, at all batch mesh
+	 * locations in cache into the batch arrays of valueCache. Override for
+	 * field types able to evaluate all locations in a single pass. The default
+	 * implementation evaluates each location in turn, changing the location
+	 * in cache; callers must restore it.
+	 * @return  1 on success, 0 on failure including not defined at any location. */
+	virtual int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	/** Override for field types able to append instructions to program
+	 * computing their values from registers holding source field values,
+	 * obtained from program.getFieldRegisters(). Must not modify program if
+	 * returning false. Default implementation returns false so field is
+	 * evaluated normally and loaded into program as a leaf field.
+	 * @see FieldEvaluationProgram
+	 * @param componentRegisters  Array to receive register index for each
+	 * component of field.
+	 * @return  True if compiled, false if not supported. */
+	virtual bool compile(FieldEvaluationProgram& /*program*/, int * /*componentRegisters*/)
+	{
+		return false;
+	}
+
+	/** Evaluate real values with exact first and second derivatives with
+	 * respect to xi at the element location in cache, by forward mode
+	 * automatic differentiation. The default implementation executes the
+	 * field's compiled program in Taylor arithmetic, so supports all field
+	 * types able to compile themselves provided their leaf source fields
+	 * support Taylor evaluation. Override for leaf field types.
+	 * @see FieldTaylorValues
+	 * @param taylorValues  Taylor values to fill, with variable count set to
+	 * the element dimension.
+	 * @return  1 on success, 0 on failure or if not supported. */
+	virtual int evaluateTaylor(cmzn_fieldcache& cache, FieldTaylorValues& taylorValues);
+
+	/** Override & return true for real field types implementing
+	 * evaluateComponents to evaluate only some of their components. */
+	virtual bool hasComponentEvaluation() const
+	{
+		return false;
+	}
+
+	/** Evaluate values, plus derivatives if requested and possible, of only
+	 * the components in componentMask into the value cache. Other components
+	 * are unchanged. Only called if hasComponentEvaluation() returns true, and
+	 * only for fields with up to FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS
+	 * components. Default implementation evaluates all components.
+	 * @param derivativesValid  Set to true if derivatives of components are
+	 * evaluated, otherwise false.
+	 * @return  1 on success, 0 on failure. */
+	virtual int evaluateComponents(cmzn_fieldcache& cache, RealFieldValueCache& valueCache,
+		FieldComponentMask componentMask, bool& derivativesValid);
+
+	/** Override for expensive field types to return the number of recent
+	 * locations their values are memoised at by default in each field cache.
+	 * Default implementation returns 0 for no memoisation.
+	 * @see cmzn_field_set_location_memo_capacity */
+	virtual int getDefaultLocationMemoCapacity() const
+	{
+		return 0;
+	}
+
 	/** Override & return true for field types supporting the sum_square_terms API */
 	virtual bool supports_sum_square_terms() const
 	{
@@ -445,9 +507,12 @@ protected:
 /** Flag attributes for generic fields */
 enum Computed_field_attribute_flags
 {
-	COMPUTED_FIELD_ATTRIBUTE_IS_MANAGED_BIT = 1
+	COMPUTED_FIELD_ATTRIBUTE_IS_MANAGED_BIT = 1,
 	/*!< If NOT set, destroy field when only access is from region.
 	 * @see cmzn_field_set_mnanaged */
+	COMPUTED_FIELD_ATTRIBUTE_COMPILED_EVALUATION_BIT = 2
+	/*!< If set, evaluate values with a compiled program where possible.
+	 * @see cmzn_field_set_compiled_evaluation */
 };
 
 struct Computed_field
@@ -481,7 +546,8 @@ DESCRIPTION :
 	int number_of_source_values;
 	FE_value *source_values;
 
-	int access_count;
+	// atomic so fields can be accessed from concurrent evaluation threads
+	std::atomic<int> access_count;
 
 	/* after clearing in create, following to be modified only by manager */
 	/* Keep a reference to the objects manager */
@@ -491,6 +557,10 @@ DESCRIPTION :
 	/** bit flag attributes. @see Computed_field_attribute_flags. */
 	int attribute_flags;
 
+	/** maximum number of recent locations values are memoised at in each
+	 * field cache, 0 to not memoise */
+	int location_memo_capacity;
+
 	inline Computed_field *access()
 	{
 		++access_count;
@@ -538,6 +608,48 @@ DESCRIPTION :
 
 	inline FieldValueCache *evaluate(cmzn_fieldcache& cache);
 
+	/** Evaluate values with compiled program held in valueCache, compiling it
+	 * on first use. Falls back to core evaluate if derivatives are requested,
+	 * changes are being cached, or field cannot be compiled.
+	 * @return  1 on success, 0 on failure. */
+	int evaluateCompiled(cmzn_fieldcache& cache, FieldValueCache& valueCache);
+
+	/** Evaluate values, restoring them from the location memo in valueCache if
+	 * previously evaluated at the current location, otherwise memoising them.
+	 * Memo is bypassed while changes are cached, when assigning in cache only,
+	 * and for locations without identity such as field coordinates.
+	 * @return  1 on success, 0 on failure. */
+	int evaluateMemoised(cmzn_fieldcache& cache, FieldValueCache& valueCache);
+
+	/** Evaluate values into valueCache by the fastest applicable means, marking
+	 * them as evaluated at the current location.
+	 * @return  1 on success, 0 on failure. */
+	inline int evaluateValueCache(cmzn_fieldcache& cache, FieldValueCache& valueCache);
+
+	/** Variant of evaluate recording counts and times in profile. */
+	FieldValueCache *evaluateProfiled(cmzn_fieldcache& cache, FieldProfile& profile);
+
+	/**
+	 * Evaluate real field values, plus derivatives if requested, of at least
+	 * the components in componentMask. Field types supporting it evaluate only
+	 * those components, which are remembered as valid at the current location;
+	 * other fields are evaluated in full.
+	 * @param derivativesValid  Set to true if derivatives of the requested
+	 * components are valid in the returned value cache, otherwise false.
+	 * @return  Value cache holding values of requested components, or 0 if
+	 * failed.
+	 */
+	RealFieldValueCache *evaluateComponents(cmzn_fieldcache& cache,
+		FieldComponentMask componentMask, bool& derivativesValid);
+
+	/** Evaluate values with first and second derivatives with respect to xi
+	 * at element location in cache, reusing Taylor values already evaluated at
+	 * the location.
+	 * @see Computed_field_core::evaluateTaylor
+	 * @return  Taylor values valid until field is next evaluated, or 0 if
+	 * failed or not supported by field or its sources. */
+	const FieldTaylorValues *evaluateTaylor(cmzn_fieldcache& cache);
+
 	/** @param numberOfDerivatives  positive number of xi dimension of element location */
 	inline RealFieldValueCache *evaluateWithDerivatives(cmzn_fieldcache& cache, int numberOfDerivatives)
 	{
@@ -550,6 +662,11 @@ DESCRIPTION :
 		return 0;
 	}
 
+	/** Evaluate real field at all batch mesh locations in cache.
+	 * @return  Value cache with valid batch values, or 0 on failure. Batch
+	 * derivatives are only valid if batchDerivativesValid is set. */
+	inline RealFieldValueCache *evaluateBatch(cmzn_fieldcache& cache);
+
 	inline FieldValueCache *evaluateNoDerivatives(cmzn_fieldcache& cache)
 	{
 		int requestedDerivatives = cache.getRequestedDerivatives();
@@ -670,18 +787,47 @@ typedef cmzn_set<Computed_field *,Computed_field_compare_name> cmzn_set_cmzn_fie
 
 FULL_DECLARE_MANAGER_TYPE_WITH_OWNER(Computed_field, struct cmzn_region, struct cmzn_field_change_detail *);
 
+inline int Computed_field::evaluateValueCache(cmzn_fieldcache& cache, FieldValueCache& valueCache)
+{
+	if ((0 < this->location_memo_capacity) ? this->evaluateMemoised(cache, valueCache) :
+		((this->attribute_flags & COMPUTED_FIELD_ATTRIBUTE_COMPILED_EVALUATION_BIT) ?
+			this->evaluateCompiled(cache, valueCache) : core->evaluate(cache, valueCache)))
+	{
+		// this disables field value caching between manager begin/end change
+		if (0 == this->manager->cache)
+			valueCache.evaluationCounter = cache.getLocationCounter();
+		return 1;
+	}
+	return 0;
+}
+
 inline FieldValueCache *Computed_field::evaluate(cmzn_fieldcache& cache)
 {
+	FieldProfile *profile = cache.getProfile();
+	if (profile)
+		return this->evaluateProfiled(cache, *profile);
 	FieldValueCache *valueCache = getValueCache(cache);
 	// GRC: move derivatives to a separate value cache in future
 	if ((valueCache->evaluationCounter < cache.getLocationCounter()) ||
 		(cache.getRequestedDerivatives() && (!valueCache->hasDerivatives())))
 	{
-		if (core->evaluate(cache, *valueCache))
+		if (!this->evaluateValueCache(cache, *valueCache))
+			valueCache = 0;
+	}
+	return valueCache;
+}
+
+inline RealFieldValueCache *Computed_field::evaluateBatch(cmzn_fieldcache& cache)
+{
+	RealFieldValueCache *valueCache = RealFieldValueCache::cast(getValueCache(cache));
+	if ((valueCache->batchEvaluationCounter != cache.getBatchCounter()) ||
+		(cache.getBatchRequestedDerivatives() && (!valueCache->batchDerivativesValid)))
+	{
+		if (core->evaluateBatch(cache, *valueCache))
 		{
 			// this disables field value caching between manager begin/end change
 			if (0 == this->manager->cache)
-				valueCache->evaluationCounter = cache.getLocationCounter();
+				valueCache->batchEvaluationCounter = cache.getBatchCounter();
 		}
 		else
 			valueCache = 0;
@@ -689,6 +835,106 @@ inline FieldValueCache *Computed_field::evaluate(cmzn_fieldcache& cache)
 	return valueCache;
 }
 
+/**
+ * Batch evaluation for fields whose components are each a function of the
+ * same component of a single source field with the same number of components.
+ * UnaryOperator must implement:
+ * FE_value value(int component, FE_value u) const;
+ * FE_value derivative(int component, FE_value u, FE_value f) const; // df/du
+ * @return  1 on success, 0 on failure.
+ */
+template <class UnaryOperator> int Computed_field_evaluate_batch_unary(
+	cmzn_fieldcache& cache, RealFieldValueCache& valueCache,
+	cmzn_field *sourceField, const UnaryOperator& op)
+{
+	const RealFieldValueCache *sourceCache = sourceField->evaluateBatch(cache);
+	if (!sourceCache)
+		return 0;
+	valueCache.setupBatch(cache);
+	const int batchSize = cache.getBatchSize();
+	const int componentCount = valueCache.componentCount;
+	const FE_value *u = sourceCache->batchValues.data();
+	FE_value *f = valueCache.batchValues.data();
+	for (int p = 0; p < batchSize; ++p)
+		for (int c = 0; c < componentCount; ++c, ++u, ++f)
+			*f = op.value(c, *u);
+	if (valueCache.batchDerivativesValid)
+	{
+		if (sourceCache->batchDerivativesValid)
+		{
+			const int derivativesCount = cache.getBatchRequestedDerivatives();
+			u = sourceCache->batchValues.data();
+			f = valueCache.batchValues.data();
+			const FE_value *du = sourceCache->batchDerivatives.data();
+			FE_value *df = valueCache.batchDerivatives.data();
+			for (int p = 0; p < batchSize; ++p)
+				for (int c = 0; c < componentCount; ++c, ++u, ++f)
+				{
+					const FE_value dfdu = op.derivative(c, *u, *f);
+					for (int d = 0; d < derivativesCount; ++d, ++du, ++df)
+						*df = dfdu*(*du);
+				}
+		}
+		else
+			valueCache.batchDerivativesValid = 0;
+	}
+	return 1;
+}
+
+/**
+ * Batch evaluation for fields whose components are each a function of the
+ * same component of two source fields, all with the same number of components.
+ * BinaryOperator must implement:
+ * FE_value value(int component, FE_value u, FE_value v) const;
+ * void derivatives(int component, FE_value u, FE_value v, FE_value f,
+ *   FE_value& dfdu, FE_value& dfdv) const;
+ * @return  1 on success, 0 on failure.
+ */
+template <class BinaryOperator> int Computed_field_evaluate_batch_binary(
+	cmzn_fieldcache& cache, RealFieldValueCache& valueCache,
+	cmzn_field *sourceField1, cmzn_field *sourceField2, const BinaryOperator& op)
+{
+	const RealFieldValueCache *sourceCache1 = sourceField1->evaluateBatch(cache);
+	if (!sourceCache1)
+		return 0;
+	const RealFieldValueCache *sourceCache2 = sourceField2->evaluateBatch(cache);
+	if (!sourceCache2)
+		return 0;
+	valueCache.setupBatch(cache);
+	const int batchSize = cache.getBatchSize();
+	const int componentCount = valueCache.componentCount;
+	const FE_value *u = sourceCache1->batchValues.data();
+	const FE_value *v = sourceCache2->batchValues.data();
+	FE_value *f = valueCache.batchValues.data();
+	for (int p = 0; p < batchSize; ++p)
+		for (int c = 0; c < componentCount; ++c, ++u, ++v, ++f)
+			*f = op.value(c, *u, *v);
+	if (valueCache.batchDerivativesValid)
+	{
+		if (sourceCache1->batchDerivativesValid && sourceCache2->batchDerivativesValid)
+		{
+			const int derivativesCount = cache.getBatchRequestedDerivatives();
+			u = sourceCache1->batchValues.data();
+			v = sourceCache2->batchValues.data();
+			f = valueCache.batchValues.data();
+			const FE_value *du = sourceCache1->batchDerivatives.data();
+			const FE_value *dv = sourceCache2->batchDerivatives.data();
+			FE_value *df = valueCache.batchDerivatives.data();
+			FE_value dfdu, dfdv;
+			for (int p = 0; p < batchSize; ++p)
+				for (int c = 0; c < componentCount; ++c, ++u, ++v, ++f)
+				{
+					op.derivatives(c, *u, *v, *f, dfdu, dfdv);
+					for (int d = 0; d < derivativesCount; ++d, ++du, ++dv, ++df)
+						*df = dfdu*(*du) + dfdv*(*dv);
+				}
+		}
+		else
+			valueCache.batchDerivativesValid = 0;
+	}
+	return 1;
+}
+
 struct cmzn_fielditerator : public cmzn_set_cmzn_field::ext_iterator
 {
 private:
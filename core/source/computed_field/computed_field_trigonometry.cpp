@@ -15,6 +15,7 @@ Implements a number of basic component wise operations on computed fields.
 #include "computed_field/computed_field.h"
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/computed_field_set.h"
+#include "computed_field/field_evaluation_program.hpp"
 #include "general/debug.h"
 #include "general/mystring.h"
 #include "general/message.h"
@@ -60,6 +61,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -101,6 +106,33 @@ int Computed_field_sin::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+/** Batch operator: sin(u) */
+struct BatchSinOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)sin((double)u);
+	}
+
+	FE_value derivative(int, FE_value u, FE_value) const
+	{
+		return (FE_value)cos((double)u);
+	}
+};
+
+int Computed_field_sin::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchSinOperator());
+}
+
+bool Computed_field_sin::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_SIN, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_sin::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -248,6 +280,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -290,6 +326,33 @@ int Computed_field_cos::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+/** Batch operator: cos(u) */
+struct BatchCosOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)cos((double)u);
+	}
+
+	FE_value derivative(int, FE_value u, FE_value) const
+	{
+		return -(FE_value)sin((double)u);
+	}
+};
+
+int Computed_field_cos::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchCosOperator());
+}
+
+bool Computed_field_cos::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_COS, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_cos::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -437,6 +500,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -480,6 +547,33 @@ int Computed_field_tan::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+/** Batch operator: tan(u) */
+struct BatchTanOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)tan((double)u);
+	}
+
+	FE_value derivative(int, FE_value u, FE_value) const
+	{
+		return (FE_value)(1.0 / (cos((double)u)*cos((double)u)));
+	}
+};
+
+int Computed_field_tan::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchTanOperator());
+}
+
+bool Computed_field_tan::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_TAN, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_tan::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -627,6 +721,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -676,6 +774,33 @@ int Computed_field_asin::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVal
 	return 0;
 }
 
+/** Batch operator: asin(u); derivative is 0 at u = 1 */
+struct BatchAsinOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)asin((double)u);
+	}
+
+	FE_value derivative(int, FE_value u, FE_value) const
+	{
+		return (u != 1.0) ? (FE_value)(1.0 / sqrt(1.0 - (double)u*(double)u)) : 0.0;
+	}
+};
+
+int Computed_field_asin::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchAsinOperator());
+}
+
+bool Computed_field_asin::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_ASIN, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_asin::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -823,6 +948,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -872,6 +1001,33 @@ int Computed_field_acos::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVal
 	return 0;
 }
 
+/** Batch operator: acos(u); derivative is 0 at u = 1 */
+struct BatchAcosOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)acos((double)u);
+	}
+
+	FE_value derivative(int, FE_value u, FE_value) const
+	{
+		return (u != 1.0) ? (FE_value)(-1.0 / sqrt(1.0 - (double)u*(double)u)) : 0.0;
+	}
+};
+
+int Computed_field_acos::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchAcosOperator());
+}
+
+bool Computed_field_acos::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_ACOS, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_acos::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -1019,6 +1175,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -1061,6 +1221,33 @@ int Computed_field_atan::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVal
 	return 0;
 }
 
+/** Batch operator: atan(u) */
+struct BatchAtanOperator
+{
+	FE_value value(int, FE_value u) const
+	{
+		return (FE_value)atan((double)u);
+	}
+
+	FE_value derivative(int, FE_value u, FE_value) const
+	{
+		return (FE_value)(1.0 / (1.0 + (double)u*(double)u));
+	}
+};
+
+int Computed_field_atan::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_unary(cache, valueCache,
+		getSourceField(0), BatchAtanOperator());
+}
+
+bool Computed_field_atan::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addUnaryInstructions(FieldEvaluationProgram::OPCODE_ATAN, getSourceField(0),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_atan::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -1208,6 +1395,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -1255,6 +1446,35 @@ int Computed_field_atan2::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVa
 	return 0;
 }
 
+/** Batch operator: atan2(u, v) */
+struct BatchAtan2Operator
+{
+	FE_value value(int, FE_value u, FE_value v) const
+	{
+		return (FE_value)atan2((double)u, (double)v);
+	}
+
+	void derivatives(int, FE_value u, FE_value v, FE_value, FE_value& dfdu, FE_value& dfdv) const
+	{
+		const FE_value denominator = u*u + v*v;
+		dfdu = v / denominator;
+		dfdv = -u / denominator;
+	}
+};
+
+int Computed_field_atan2::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	return Computed_field_evaluate_batch_binary(cache, valueCache,
+		getSourceField(0), getSourceField(1), BatchAtan2Operator());
+}
+
+bool Computed_field_atan2::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	program.addBinaryInstructions(FieldEvaluationProgram::OPCODE_ATAN2, getSourceField(0), getSourceField(1),
+		field->number_of_components, componentRegisters);
+	return true;
+}
+
 int Computed_field_atan2::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
@@ -14,6 +14,7 @@
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/computed_field_vector_operators.hpp"
 #include "computed_field/computed_field_set.h"
+#include "computed_field/field_evaluation_program.hpp"
 #include "general/debug.h"
 #include "general/matrix_vector.h"
 #include "general/mystring.h"
@@ -285,7 +286,9 @@ int Computed_field_cross_product::evaluate(cmzn_fieldcache& cache, FieldValueCac
 	{
 		case 1:
 		{
-			valueCache.values = 0;
+			// not reachable as creation requires at least one source field;
+			// values array belongs to the field cache so set value, don't clear pointer
+			valueCache.values[0] = 0.0;
 		} break;
 		case 2:
 		{
@@ -631,6 +634,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -688,6 +695,72 @@ int Computed_field_dot_product::evaluate(cmzn_fieldcache& cache, FieldValueCache
 	return 0;
 }
 
+int Computed_field_dot_product::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	const RealFieldValueCache *source1Cache = getSourceField(0)->evaluateBatch(cache);
+	if (!source1Cache)
+		return 0;
+	const RealFieldValueCache *source2Cache = getSourceField(1)->evaluateBatch(cache);
+	if (!source2Cache)
+		return 0;
+	valueCache.setupBatch(cache);
+	const int batchSize = cache.getBatchSize();
+	const int vector_number_of_components = getSourceField(0)->number_of_components;
+	const FE_value *u = source1Cache->batchValues.data();
+	const FE_value *v = source2Cache->batchValues.data();
+	for (int p = 0; p < batchSize; ++p)
+	{
+		FE_value sum = 0.0;
+		for (int i = 0; i < vector_number_of_components; ++i)
+			sum += u[i]*v[i];
+		valueCache.batchValues[p] = sum;
+		u += vector_number_of_components;
+		v += vector_number_of_components;
+	}
+	if (valueCache.batchDerivativesValid)
+	{
+		if (source1Cache->batchDerivativesValid && source2Cache->batchDerivativesValid)
+		{
+			const int number_of_xi = cache.getBatchRequestedDerivatives();
+			u = source1Cache->batchValues.data();
+			v = source2Cache->batchValues.data();
+			const FE_value *du = source1Cache->batchDerivatives.data();
+			const FE_value *dv = source2Cache->batchDerivatives.data();
+			FE_value *derivatives = valueCache.batchDerivatives.data();
+			for (int p = 0; p < batchSize; ++p)
+			{
+				for (int j = 0; j < number_of_xi; ++j)
+					derivatives[j] = 0.0;
+				for (int i = 0; i < vector_number_of_components; ++i)
+				{
+					for (int j = 0; j < number_of_xi; ++j)
+						derivatives[j] += u[i]*dv[j] + v[i]*du[j];
+					du += number_of_xi;
+					dv += number_of_xi;
+				}
+				u += vector_number_of_components;
+				v += vector_number_of_components;
+				derivatives += number_of_xi;
+			}
+		}
+		else
+			valueCache.batchDerivativesValid = 0;
+	}
+	return 1;
+}
+
+bool Computed_field_dot_product::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	const int *source1 = program.getFieldRegisters(getSourceField(0));
+	const int *source2 = program.getFieldRegisters(getSourceField(1));
+	const int vector_number_of_components = getSourceField(0)->number_of_components;
+	const int sum = program.addInstruction(FieldEvaluationProgram::OPCODE_MULTIPLY, source1[0], source2[0]);
+	for (int i = 1; i < vector_number_of_components; ++i)
+		program.addAccumulateInstruction(FieldEvaluationProgram::OPCODE_MULTIPLY_ADD, sum, source1[i], source2[i]);
+	componentRegisters[0] = sum;
+	return true;
+}
+
 int Computed_field_dot_product::list(
 	)
 /*******************************************************************************
@@ -860,6 +933,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -907,6 +984,62 @@ int Computed_field_magnitude::evaluate(cmzn_fieldcache& cache, FieldValueCache&
 	return 0;
 }
 
+int Computed_field_magnitude::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	const RealFieldValueCache *sourceCache = getSourceField(0)->evaluateBatch(cache);
+	if (!sourceCache)
+		return 0;
+	valueCache.setupBatch(cache);
+	const int batchSize = cache.getBatchSize();
+	const int source_number_of_components = getSourceField(0)->number_of_components;
+	const FE_value *source_values = sourceCache->batchValues.data();
+	for (int p = 0; p < batchSize; ++p)
+	{
+		FE_value sum = 0.0;
+		for (int i = 0; i < source_number_of_components; ++i)
+			sum += source_values[i]*source_values[i];
+		valueCache.batchValues[p] = sqrt(sum);
+		source_values += source_number_of_components;
+	}
+	if (valueCache.batchDerivativesValid)
+	{
+		if (sourceCache->batchDerivativesValid)
+		{
+			const int number_of_xi = cache.getBatchRequestedDerivatives();
+			source_values = sourceCache->batchValues.data();
+			const FE_value *source_derivatives = sourceCache->batchDerivatives.data();
+			FE_value *derivatives = valueCache.batchDerivatives.data();
+			for (int p = 0; p < batchSize; ++p)
+			{
+				for (int j = 0; j < number_of_xi; ++j)
+				{
+					FE_value sum = 0.0;
+					for (int i = 0; i < source_number_of_components; ++i)
+						sum += source_values[i]*source_derivatives[i*number_of_xi + j];
+					derivatives[j] = sum / valueCache.batchValues[p];
+				}
+				source_values += source_number_of_components;
+				source_derivatives += source_number_of_components*number_of_xi;
+				derivatives += number_of_xi;
+			}
+		}
+		else
+			valueCache.batchDerivativesValid = 0;
+	}
+	return 1;
+}
+
+bool Computed_field_magnitude::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	const int *source = program.getFieldRegisters(getSourceField(0));
+	const int source_number_of_components = getSourceField(0)->number_of_components;
+	const int sum = program.addInstruction(FieldEvaluationProgram::OPCODE_MULTIPLY, source[0], source[0]);
+	for (int i = 1; i < source_number_of_components; ++i)
+		program.addAccumulateInstruction(FieldEvaluationProgram::OPCODE_MULTIPLY_ADD, sum, source[i], source[i]);
+	componentRegisters[0] = program.addInstruction(FieldEvaluationProgram::OPCODE_SQRT, sum);
+	return true;
+}
+
 enum FieldAssignmentResult Computed_field_magnitude::assign(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
 {
 	RealFieldValueCache *sourceCache = RealFieldValueCache::cast(getSourceField(0)->evaluate(cache));
@@ -1082,6 +1215,10 @@ private:
 
 	int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	int evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache);
+
+	bool compile(FieldEvaluationProgram& program, int *componentRegisters);
+
 	int list();
 
 	char* get_command_string();
@@ -1127,6 +1264,60 @@ int Computed_field_sum_components::evaluate(cmzn_fieldcache& cache, FieldValueCa
 	return 0;
 }
 
+int Computed_field_sum_components::evaluateBatch(cmzn_fieldcache& cache, RealFieldValueCache& valueCache)
+{
+	const RealFieldValueCache *sourceCache = getSourceField(0)->evaluateBatch(cache);
+	if (!sourceCache)
+		return 0;
+	valueCache.setupBatch(cache);
+	const int batchSize = cache.getBatchSize();
+	const int source_number_of_components = getSourceField(0)->number_of_components;
+	const FE_value *source_values = sourceCache->batchValues.data();
+	for (int p = 0; p < batchSize; ++p)
+	{
+		FE_value sum = 0.0;
+		for (int i = 0; i < source_number_of_components; ++i)
+			sum += source_values[i];
+		valueCache.batchValues[p] = sum;
+		source_values += source_number_of_components;
+	}
+	if (valueCache.batchDerivativesValid)
+	{
+		if (sourceCache->batchDerivativesValid)
+		{
+			const int number_of_xi = cache.getBatchRequestedDerivatives();
+			const FE_value *source_derivatives = sourceCache->batchDerivatives.data();
+			FE_value *derivatives = valueCache.batchDerivatives.data();
+			for (int p = 0; p < batchSize; ++p)
+			{
+				for (int j = 0; j < number_of_xi; ++j)
+					derivatives[j] = 0.0;
+				for (int i = 0; i < source_number_of_components; ++i)
+				{
+					for (int j = 0; j < number_of_xi; ++j)
+						derivatives[j] += source_derivatives[j];
+					source_derivatives += number_of_xi;
+				}
+				derivatives += number_of_xi;
+			}
+		}
+		else
+			valueCache.batchDerivativesValid = 0;
+	}
+	return 1;
+}
+
+bool Computed_field_sum_components::compile(FieldEvaluationProgram& program, int *componentRegisters)
+{
+	const int *source = program.getFieldRegisters(getSourceField(0));
+	const int source_number_of_components = getSourceField(0)->number_of_components;
+	int sum = source[0];
+	for (int i = 1; i < source_number_of_components; ++i)
+		sum = program.addInstruction(FieldEvaluationProgram::OPCODE_ADD, sum, source[i], 1.0, 1.0);
+	componentRegisters[0] = sum;
+	return true;
+}
+
 int Computed_field_sum_components::list()
 /*******************************************************************************
 LAST MODIFIED : 24 August 2006
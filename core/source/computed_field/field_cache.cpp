@@ -9,6 +9,7 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <cstdio>
 #include "opencmiss/zinc/field.h"
 #include "computed_field/computed_field_find_xi.h"
@@ -18,16 +19,101 @@
 #include "region/cmiss_region.h"
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/field_cache.hpp"
+#include "computed_field/field_evaluation_program.hpp"
+#include "computed_field/field_taylor_values.hpp"
+
+void FieldValueMemo::moveToFront(int index)
+{
+	if (index > 0)
+		std::rotate(this->entries.begin(), this->entries.begin() + index,
+			this->entries.begin() + index + 1);
+}
+
+void FieldValueMemo::setCapacity(int capacityIn)
+{
+	this->capacity = (capacityIn > 0) ? capacityIn : 0;
+	while (static_cast<int>(this->entries.size()) > this->capacity)
+	{
+		this->releaseEntry(this->entries.back());
+		this->entries.pop_back();
+	}
+}
+
+void FieldValueMemo::clear()
+{
+	for (std::vector<FieldValueMemoEntry>::iterator iter = this->entries.begin();
+			iter != this->entries.end(); ++iter)
+		this->releaseEntry(*iter);
+	this->entries.clear();
+}
+
+bool FieldValueMemo::restore(const FieldLocationKey& key, bool derivativesRequired,
+	FieldValueCache& valueCache)
+{
+	const int size = static_cast<int>(this->entries.size());
+	for (int i = 0; i < size; ++i)
+	{
+		FieldValueMemoEntry& entry = this->entries[i];
+		if (entry.key == key)
+		{
+			if ((derivativesRequired && !entry.derivativesValid) ||
+					(!valueCache.loadFromMemo(entry)))
+				return false;
+			this->moveToFront(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+void FieldValueMemo::store(const FieldLocationKey& key, const FieldValueCache& valueCache)
+{
+	if (this->capacity <= 0)
+		return;
+	int index = -1;
+	const int size = static_cast<int>(this->entries.size());
+	for (int i = 0; i < size; ++i)
+		if (this->entries[i].key == key)
+		{
+			index = i;
+			break;
+		}
+	if (index < 0)
+	{
+		if (size < this->capacity)
+		{
+			this->entries.push_back(FieldValueMemoEntry());
+			index = size;
+		}
+		else
+			index = size - 1; // replace least recently used
+	}
+	FieldValueMemoEntry& entry = this->entries[index];
+	this->releaseEntry(entry);
+	if (valueCache.saveToMemo(entry))
+	{
+		entry.key = key;
+		entry.key.accessObjects();
+		this->moveToFront(index);
+	}
+	else
+	{
+		this->entries.erase(this->entries.begin() + index);
+	}
+}
 
 FieldValueCache::~FieldValueCache()
 {
 	if (extraCache)
 		cmzn_fieldcache::deaccess(extraCache);
+	delete this->locationMemo;
 }
 
 void FieldValueCache::clear()
 {
 	resetEvaluationCounter();
+	if (this->locationMemo)
+		this->locationMemo->clear();
 }
 
 RealFieldValueCache::~RealFieldValueCache()
@@ -37,8 +123,11 @@ RealFieldValueCache::~RealFieldValueCache()
 		DESTROY(Computed_field_find_element_xi_cache)(&find_element_xi_cache);
 		find_element_xi_cache = 0;
 	}
-	delete[] values;
-	delete[] derivatives;
+	delete program;
+	delete this->taylorValues;
+	if (!((this->arena.release(this->values, this->componentCount)) &&
+		(this->arena.release(this->derivatives, this->componentCount*MAXIMUM_ELEMENT_XI_DIMENSIONS))))
+		display_message(ERROR_MESSAGE, "~RealFieldValueCache.  Arena has no arrays in use");
 }
 
 void RealFieldValueCache::clear()
@@ -48,6 +137,11 @@ void RealFieldValueCache::clear()
 		DESTROY(Computed_field_find_element_xi_cache)(&find_element_xi_cache);
 		find_element_xi_cache = 0;
 	}
+	if (program)
+	{
+		delete program;
+		program = 0;
+	}
 	FieldValueCache::clear();
 }
 
@@ -78,6 +172,29 @@ void StringFieldValueCache::setString(const char *string_in)
 	stringValue = duplicate_string(string_in);
 }
 
+bool RealFieldValueCache::saveToMemo(FieldValueMemoEntry& entry) const
+{
+	const int derivativeCount = (this->derivatives_valid) ?
+		this->componentCount*MAXIMUM_ELEMENT_XI_DIMENSIONS : 0;
+	entry.values.resize(this->componentCount + derivativeCount);
+	std::copy(this->values, this->values + this->componentCount, entry.values.begin());
+	if (derivativeCount)
+		std::copy(this->derivatives, this->derivatives + derivativeCount,
+			entry.values.begin() + this->componentCount);
+	entry.derivativesValid = this->derivatives_valid;
+	return true;
+}
+
+bool RealFieldValueCache::loadFromMemo(const FieldValueMemoEntry& entry)
+{
+	std::copy(entry.values.begin(), entry.values.begin() + this->componentCount, this->values);
+	if (entry.derivativesValid)
+		std::copy(entry.values.begin() + this->componentCount,
+			entry.values.begin() + this->componentCount*(1 + MAXIMUM_ELEMENT_XI_DIMENSIONS), this->derivatives);
+	this->derivatives_valid = entry.derivativesValid;
+	return true;
+}
+
 char *StringFieldValueCache::getAsString()
 {
 	return duplicate_string(stringValue);
@@ -89,6 +206,23 @@ void MeshLocationFieldValueCache::clear()
 	FieldValueCache::clear();
 }
 
+bool MeshLocationFieldValueCache::saveToMemo(FieldValueMemoEntry& entry) const
+{
+	entry.element = (this->element) ? this->element->access() : 0;
+	entry.values.assign(this->xi, this->xi + MAXIMUM_ELEMENT_XI_DIMENSIONS);
+	entry.derivativesValid = 0;
+	return true;
+}
+
+bool MeshLocationFieldValueCache::loadFromMemo(const FieldValueMemoEntry& entry)
+{
+	if (entry.element)
+		this->setMeshLocation(entry.element, entry.values.data());
+	else
+		cmzn_element_destroy(&this->element);
+	return true;
+}
+
 char *MeshLocationFieldValueCache::getAsString()
 {
 	if (!element)
@@ -115,6 +249,7 @@ cmzn_fieldcache::~cmzn_fieldcache()
 		*iter = 0;
 	}
 	cmzn_region_remove_field_cache(region, this);
+	delete this->ownedProfile;
 	delete location;
 	cmzn_region_destroy(&region);
 }
@@ -20,9 +20,16 @@
 #include "general/debug.h"
 #include "region/cmiss_region.h"
 #include "computed_field/field_location.hpp"
+#include "computed_field/field_profiler.hpp"
+#include "computed_field/field_value_cache_arena.hpp"
+#include "finite_element/finite_element_time.h"
+#include "finite_element/xi_point_set.hpp"
+#include <atomic>
 #include <vector>
 
 struct Computed_field_find_element_xi_cache;
+class FieldEvaluationProgram;
+class FieldTaylorValues;
 
 // dynamic_cast may make cache value type crashes more predictable.
 // Enable for spurious errors, but switching off for performance reasons, release and debug.
@@ -36,21 +43,123 @@ struct Computed_field_find_element_xi_cache;
 #  define FIELD_VALUE_CACHE_CAST static_cast
 #endif // defined (TEST_FIELD_VALUE_CACHE_CAST)
 
+class FieldValueCache;
+
+/** Bit mask of field components, with bit i set for component i starting at
+ * 0. Component-selective evaluation is only used for fields with up to
+ * FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS components. */
+typedef unsigned long long FieldComponentMask;
+
+const int FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS = 64;
+
+/** @return  Mask with all components of a field with componentCount set */
+inline FieldComponentMask FieldComponentMask_all(int componentCount)
+{
+	return (componentCount >= FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS) ?
+		~static_cast<FieldComponentMask>(0) :
+		((static_cast<FieldComponentMask>(1) << componentCount) - 1);
+}
+
+inline bool FieldComponentMask_has(FieldComponentMask mask, int componentIndex)
+{
+	return 0 != (mask & (static_cast<FieldComponentMask>(1) << componentIndex));
+}
+
+/** Values of a field memoised at one location */
+struct FieldValueMemoEntry
+{
+	FieldLocationKey key; // objects accessed
+	std::vector<FE_value> values; // values then derivatives if valid
+	int derivativesValid;
+	cmzn_element *element; // for mesh location values: accessed
+
+	FieldValueMemoEntry() :
+		derivativesValid(0),
+		element(0)
+	{
+	}
+};
+
+/**
+ * Small associative memo of field values at the most recently evaluated
+ * locations, so values of expensive fields are not recalculated when
+ * alternating between a few locations. Searched linearly in order of most
+ * recent use, so capacity should be small. Owned by a field value cache and
+ * cleared with it whenever the field or anything it depends on changes.
+ */
+class FieldValueMemo
+{
+	std::vector<FieldValueMemoEntry> entries; // most recently used first
+	int capacity;
+
+	void releaseEntry(FieldValueMemoEntry& entry)
+	{
+		entry.key.deaccessObjects();
+		if (entry.element)
+			cmzn_element::deaccess(entry.element);
+		entry.derivativesValid = 0;
+	}
+
+	void moveToFront(int index);
+
+public:
+
+	FieldValueMemo(int capacityIn) :
+		capacity(capacityIn)
+	{
+	}
+
+	~FieldValueMemo()
+	{
+		this->clear();
+	}
+
+	int getCapacity() const
+	{
+		return this->capacity;
+	}
+
+	/** Set maximum number of locations, discarding least recently used */
+	void setCapacity(int capacityIn);
+
+	void clear();
+
+	/** If values are memoised at location key, copy them to valueCache.
+	 * @param derivativesRequired  If true, only succeeds if memoised values
+	 * include derivatives.
+	 * @return  True if values restored, otherwise false. */
+	bool restore(const FieldLocationKey& key, bool derivativesRequired,
+		FieldValueCache& valueCache);
+
+	/** Memoise values in valueCache at location key, replacing the least
+	 * recently used entry if full. */
+	void store(const FieldLocationKey& key, const FieldValueCache& valueCache);
+
+};
+
 class FieldValueCache
 {
 private:
 	cmzn_fieldcache *extraCache; // optional extra cache for working evaluations at different locations
+	FieldValueMemo *locationMemo; // optional values at recent locations
 
 	void operator=(const FieldValueCache&); // private to prohibit
 
 public:
 	int evaluationCounter; // set to cmzn_fieldcache::locationCounter when field evaluated
 	int derivatives_valid; // only relevant to real caches, but having here saves a virtual function call
+	int batchEvaluationCounter; // set to cmzn_fieldcache::batchCounter when field evaluated at batch locations
+	int taylorEvaluationCounter; // set to cmzn_fieldcache::locationCounter when Taylor values evaluated
+	int componentsEvaluationCounter; // set to cmzn_fieldcache::locationCounter when some components evaluated
 
 	FieldValueCache() :
 		extraCache(0),
+		locationMemo(0),
 		evaluationCounter(-1),
-		derivatives_valid(0)
+		derivatives_valid(0),
+		batchEvaluationCounter(-1),
+		taylorEvaluationCounter(-1),
+		componentsEvaluationCounter(-1)
 	{
 	}
 
@@ -59,6 +168,9 @@ public:
 	inline void resetEvaluationCounter()
 	{
 		evaluationCounter = -1;
+		batchEvaluationCounter = -1;
+		taylorEvaluationCounter = -1;
+		componentsEvaluationCounter = -1;
 	}
 
 	/** override to clear type-specific buffer information & call this */
@@ -73,6 +185,31 @@ public:
 
 	cmzn_fieldcache *getOrCreateExtraCache(cmzn_fieldcache& parentCache);
 
+	/** Get location memo, creating it or changing its capacity as needed */
+	FieldValueMemo *getOrCreateLocationMemo(int capacity)
+	{
+		if (!this->locationMemo)
+			this->locationMemo = new FieldValueMemo(capacity);
+		else if (this->locationMemo->getCapacity() != capacity)
+			this->locationMemo->setCapacity(capacity);
+		return this->locationMemo;
+	}
+
+	/** Override to copy current values to memo entry for value cache types
+	 * supporting location memoisation.
+	 * @return  True if values saved, false if not supported. */
+	virtual bool saveToMemo(FieldValueMemoEntry& /*entry*/) const
+	{
+		return false;
+	}
+
+	/** Override to restore values from memo entry saved by saveToMemo.
+	 * @return  True if values restored, false if not supported. */
+	virtual bool loadFromMemo(const FieldValueMemoEntry& /*entry*/)
+	{
+		return false;
+	}
+
 	/** all derived classed must implement function to return values as string
 	 * @return  allocated string.
 	 */
@@ -95,8 +232,23 @@ private:
 	Field_location *location;
 	int requestedDerivatives;
 	ValueCacheVector valueCaches;
+	FieldValueCacheArena valueCacheArena; // storage for real values of value caches
+	// profile to record in, set by region while profiling field evaluation.
+	// Atomic as set from other threads
+	std::atomic<FieldProfile *> profile;
+	// owned; kept until cache destroyed so evaluation in progress may finish
+	// recording in it after profiling is disabled
+	FieldProfile *ownedProfile;
+	FE_time_sequence_interpolation_cache timeSequenceInterpolationCache; // recent time bracket lookups
 	bool assignInCache;
 	int access_count;
+	// batch of element locations evaluated together by evaluateBatch; valid until next batch set
+	int batchCounter; // incremented whenever batch locations are set
+	int batchSize;
+	int batchDimension;
+	const cmzn_element_id *batchElements;
+	const FE_value *batchXi; // batchSize*batchDimension chart coordinates
+	int batchRequestedDerivatives;
 
 	/** call whenever location changes to increment location counter */
 	void locationChanged()
@@ -119,8 +271,17 @@ public:
 		location(new Field_time_location()),
 		requestedDerivatives(0),
 		valueCaches(cmzn_region_get_field_cache_size(this->region), (FieldValueCache*)0),
+		valueCacheArena(static_cast<int>(valueCaches.size())),
+		profile(0),
+		ownedProfile(0),
 		assignInCache(false),
-		access_count(1)
+		access_count(1),
+		batchCounter(0),
+		batchSize(0),
+		batchDimension(0),
+		batchElements(0),
+		batchXi(0),
+		batchRequestedDerivatives(0)
 	{
 		cmzn_region_add_field_cache(this->region, this);
 	}
@@ -230,6 +391,28 @@ public:
 		return CMZN_ERROR_ARGUMENT;
 	}
 
+	/** Set location to a point of an xi point set in element, so finite
+	 * element fields are interpolated with its basis function tables. Point set
+	 * must persist while the location is set. */
+	int setMeshLocationXiPoint(cmzn_element_id element, FE_xi_point_set *xiPointSet,
+		int pointIndex)
+	{
+		if (element && xiPointSet && (0 <= pointIndex) &&
+			(pointIndex < xiPointSet->getNumberOfPoints()) &&
+			(xiPointSet->getDimension() == element->getDimension()))
+		{
+			FE_value time = location->get_time();
+			delete location;
+			Field_element_xi_location *elementXiLocation = new Field_element_xi_location(
+				element, xiPointSet->getPointXi(pointIndex), time);
+			elementXiLocation->set_xi_point(xiPointSet, pointIndex);
+			location = elementXiLocation;
+			locationChanged();
+			return CMZN_OK;
+		}
+		return CMZN_ERROR_ARGUMENT;
+	}
+
 	int setNode(cmzn_node_id node)
 	{
 		FE_value time = location->get_time();
@@ -239,11 +422,109 @@ public:
 		return CMZN_OK;
 	}
 
+	/** Set batch of element locations to evaluate at together with
+	 * Computed_field::evaluateBatch. Arrays are not copied and must persist
+	 * until batch evaluation is complete. Does not change current location.
+	 * @param requestedDerivativesIn  Number of xi derivatives to evaluate: 0 or
+	 * dimensionIn */
+	void setBatchMeshLocations(int batchSizeIn, const cmzn_element_id *elementsIn,
+		int dimensionIn, const FE_value *xiIn, int requestedDerivativesIn)
+	{
+		this->batchSize = batchSizeIn;
+		this->batchElements = elementsIn;
+		this->batchDimension = dimensionIn;
+		this->batchXi = xiIn;
+		this->batchRequestedDerivatives = requestedDerivativesIn;
+		++this->batchCounter;
+		// same overflow logic as locationChanged
+		if (this->batchCounter < 0)
+		{
+			this->batchCounter = 0;
+			this->resetValueCacheEvaluationCounters();
+		}
+	}
+
+	/** Call after batch evaluation to release batch arrays. Batch counter is
+	 * not changed as setBatchMeshLocations always invalidates batch values. */
+	void clearBatchMeshLocations()
+	{
+		this->batchSize = 0;
+		this->batchElements = 0;
+		this->batchDimension = 0;
+		this->batchXi = 0;
+		this->batchRequestedDerivatives = 0;
+	}
+
+	inline int getBatchCounter() const
+	{
+		return this->batchCounter;
+	}
+
+	inline int getBatchSize() const
+	{
+		return this->batchSize;
+	}
+
+	inline int getBatchDimension() const
+	{
+		return this->batchDimension;
+	}
+
+	inline const cmzn_element_id *getBatchElements() const
+	{
+		return this->batchElements;
+	}
+
+	inline const FE_value *getBatchXi() const
+	{
+		return this->batchXi;
+	}
+
+	inline int getBatchRequestedDerivatives() const
+	{
+		return this->batchRequestedDerivatives;
+	}
+
 	int setFieldReal(cmzn_field_id field, int numberOfValues, const double *values);
 
 	int setFieldRealWithDerivatives(cmzn_field_id field, int numberOfValues, const double *values,
 		int numberOfDerivatives, const double *derivatives);
 
+	FieldValueCacheArena& getValueCacheArena()
+	{
+		return this->valueCacheArena;
+	}
+
+	/** @return  Profile to record field evaluation in, or 0 if not profiling */
+	inline FieldProfile *getProfile() const
+	{
+		return this->profile.load(std::memory_order_acquire);
+	}
+
+	/** Start or stop recording field evaluation in a profile. Called by
+	 * region only, with its field caches mutex locked. Starting clears any
+	 * profile kept from earlier profiling. */
+	void setProfiling(bool enabled)
+	{
+		if (enabled)
+		{
+			if (this->ownedProfile)
+				this->ownedProfile->clear();
+			else
+				this->ownedProfile = new FieldProfile();
+			this->profile.store(this->ownedProfile, std::memory_order_release);
+		}
+		else
+			this->profile.store(0, std::memory_order_release);
+	}
+
+	/** @return  Cache of time sequence interpolations to make current while
+	  * evaluating time-varying finite element fields with this cache */
+	FE_time_sequence_interpolation_cache& getTimeSequenceInterpolationCache()
+	{
+		return this->timeSequenceInterpolationCache;
+	}
+
 	FieldValueCache* getValueCache(int cacheIndex)
 	{
 		return valueCaches[cacheIndex];
@@ -312,13 +593,32 @@ public:
 	int componentCount;
 	FE_value *values, *derivatives;
 	Computed_field_find_element_xi_cache *find_element_xi_cache;
+	// values and derivatives at batch locations, all components for each location in turn
+	std::vector<FE_value> batchValues, batchDerivatives;
+	int batchDerivativesValid;
+	FieldEvaluationProgram *program; // for compiled evaluation; discarded on clear
+	FieldTaylorValues *taylorValues; // for second derivatives; created on demand
+	// components with values evaluated at componentsEvaluationCounter when not all are evaluated
+	FieldComponentMask validComponents;
+	bool validComponentsDerivatives; // whether derivatives are evaluated for validComponents
+private:
+	FieldValueCacheArena& arena; // of parent cache, holding values and derivatives
+public:
 
-	RealFieldValueCache(int componentCount) :
+	/** @param parentCache  Field cache the value cache is for. Values and
+	 * derivatives are allocated from its arena. */
+	RealFieldValueCache(int componentCount, cmzn_fieldcache& parentCache) :
 		FieldValueCache(),
 		componentCount(componentCount),
-		values(new FE_value[componentCount]),
-		derivatives(new FE_value[componentCount*MAXIMUM_ELEMENT_XI_DIMENSIONS]),
-		find_element_xi_cache(0)
+		values(parentCache.getValueCacheArena().allocate(componentCount)),
+		derivatives(parentCache.getValueCacheArena().allocate(componentCount*MAXIMUM_ELEMENT_XI_DIMENSIONS)),
+		find_element_xi_cache(0),
+		batchDerivativesValid(0),
+		program(0),
+		taylorValues(0),
+		validComponents(0),
+		validComponentsDerivatives(false),
+		arena(parentCache.getValueCacheArena())
 	{
 	}
 
@@ -376,6 +676,22 @@ public:
 
 	virtual char *getAsString();
 
+	virtual bool saveToMemo(FieldValueMemoEntry& entry) const;
+
+	virtual bool loadFromMemo(const FieldValueMemoEntry& entry);
+
+	/** Size batch values and derivatives for current batch in cache, and
+	 * mark batch derivatives as valid if any are requested. */
+	void setupBatch(const cmzn_fieldcache& cache)
+	{
+		const int batchSize = cache.getBatchSize();
+		this->batchValues.resize(batchSize*this->componentCount);
+		const int derivativesCount = cache.getBatchRequestedDerivatives();
+		if (derivativesCount)
+			this->batchDerivatives.resize(batchSize*this->componentCount*derivativesCount);
+		this->batchDerivativesValid = (0 < derivativesCount) ? 1 : 0;
+	}
+
 	void setValues(const FE_value *values_in)
 	{
 		for (int i = 0; i < componentCount; ++i)
@@ -461,6 +777,10 @@ public:
 
 	virtual char *getAsString();
 
+	virtual bool saveToMemo(FieldValueMemoEntry& entry) const;
+
+	virtual bool loadFromMemo(const FieldValueMemoEntry& entry);
+
 };
 
 #endif /* !defined (FIELD_CACHE_HPP) */
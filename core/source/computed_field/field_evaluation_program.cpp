@@ -0,0 +1,328 @@
+/**
+ * FILE : field_evaluation_program.cpp
+ *
+ * Flat register-based program for evaluating arithmetic field expressions.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <cmath>
+#include "computed_field/computed_field_private.hpp"
+#include "computed_field/field_cache.hpp"
+#include "computed_field/field_evaluation_program.hpp"
+#include "computed_field/field_taylor_values.hpp"
+
+FieldEvaluationProgram::FieldEvaluationProgram(cmzn_field *fieldIn) :
+	field(fieldIn),
+	valid(false)
+{
+}
+
+FieldEvaluationProgram *FieldEvaluationProgram::create(cmzn_field *fieldIn)
+{
+	FieldEvaluationProgram *program = new FieldEvaluationProgram(fieldIn);
+	std::vector<int> componentRegisters(fieldIn->number_of_components);
+	// top-level field must compile itself otherwise there is nothing to gain
+	if (fieldIn->core->compile(*program, componentRegisters.data()))
+	{
+		program->resultRegisters.swap(componentRegisters);
+		program->setLeafComponentMasks();
+		program->valid = true;
+	}
+	else
+	{
+		program->instructions.clear();
+		program->leafFields.clear();
+		program->registers.clear();
+	}
+	program->fieldRegisters.clear();
+	return program;
+}
+
+void FieldEvaluationProgram::setLeafComponentMasks()
+{
+	std::vector<bool> registerUsed(this->registers.size(), false);
+	for (std::vector<Instruction>::const_iterator iter = this->instructions.begin();
+		iter != this->instructions.end(); ++iter)
+	{
+		if (iter->opcode != OPCODE_LOAD_FIELD)
+		{
+			if (0 <= iter->source1)
+				registerUsed[iter->source1] = true;
+			if (0 <= iter->source2)
+				registerUsed[iter->source2] = true;
+		}
+	}
+	for (std::vector<int>::const_iterator iter = this->resultRegisters.begin();
+		iter != this->resultRegisters.end(); ++iter)
+		registerUsed[*iter] = true;
+	this->leafComponentMasks.assign(this->leafFields.size(), 0);
+	for (std::vector<Instruction>::const_iterator iter = this->instructions.begin();
+		iter != this->instructions.end(); ++iter)
+	{
+		if (iter->opcode == OPCODE_LOAD_FIELD)
+		{
+			const int componentCount = this->leafFields[iter->source1]->number_of_components;
+			FieldComponentMask mask = 0;
+			if (componentCount > FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS)
+				mask = FieldComponentMask_all(componentCount);
+			else
+			{
+				for (int c = 0; c < componentCount; ++c)
+					if (registerUsed[iter->result + c])
+						mask |= static_cast<FieldComponentMask>(1) << c;
+			}
+			this->leafComponentMasks[iter->source1] = mask;
+		}
+	}
+}
+
+const int *FieldEvaluationProgram::getFieldRegisters(cmzn_field *sourceField)
+{
+	std::map<cmzn_field *, std::vector<int> >::iterator iter = this->fieldRegisters.find(sourceField);
+	if (iter != this->fieldRegisters.end())
+		return iter->second.data();
+	const int componentCount = sourceField->number_of_components;
+	std::vector<int> componentRegisters(componentCount);
+	if (!sourceField->core->compile(*this, componentRegisters.data()))
+	{
+		// leaf field: evaluate normally and load values into consecutive registers
+		const int first = this->addRegisters(componentCount);
+		Instruction instruction = { OPCODE_LOAD_FIELD, first,
+			static_cast<int>(this->leafFields.size()), -1, 0.0, 0.0 };
+		this->instructions.push_back(instruction);
+		this->leafFields.push_back(sourceField);
+		for (int c = 0; c < componentCount; ++c)
+			componentRegisters[c] = first + c;
+	}
+	std::vector<int>& storedRegisters = this->fieldRegisters[sourceField];
+	storedRegisters.swap(componentRegisters);
+	return storedRegisters.data();
+}
+
+int FieldEvaluationProgram::addInstruction(Opcode opcode, int source1, int source2,
+	FE_value constant1, FE_value constant2)
+{
+	const int result = this->addRegisters(1);
+	Instruction instruction = { opcode, result, source1, source2, constant1, constant2 };
+	this->instructions.push_back(instruction);
+	return result;
+}
+
+void FieldEvaluationProgram::addAccumulateInstruction(Opcode opcode, int result,
+	int source1, int source2)
+{
+	Instruction instruction = { opcode, result, source1, source2, 0.0, 0.0 };
+	this->instructions.push_back(instruction);
+}
+
+int FieldEvaluationProgram::evaluate(cmzn_fieldcache& cache, FE_value *valuesOut)
+{
+	FE_value *r = this->registers.data();
+	const Instruction *instruction = this->instructions.data();
+	const Instruction *instructionsEnd = instruction + this->instructions.size();
+	for (; instruction < instructionsEnd; ++instruction)
+	{
+		switch (instruction->opcode)
+		{
+		case OPCODE_LOAD_FIELD:
+		{
+			cmzn_field *leafField = this->leafFields[instruction->source1];
+			// only evaluate components used by program; others are not copied
+			const FieldComponentMask mask = this->leafComponentMasks[instruction->source1];
+			bool derivativesValid;
+			const RealFieldValueCache *leafCache = leafField->evaluateComponents(cache, mask, derivativesValid);
+			if (!leafCache)
+				return 0;
+			FE_value *result = r + instruction->result;
+			const int componentCount = leafField->number_of_components;
+			for (int c = 0; c < componentCount; ++c)
+				if ((componentCount > FIELD_COMPONENT_MASK_MAXIMUM_COMPONENTS) || FieldComponentMask_has(mask, c))
+					result[c] = leafCache->values[c];
+		} break;
+		case OPCODE_ADD:
+			r[instruction->result] = instruction->constant1*r[instruction->source1] +
+				instruction->constant2*r[instruction->source2];
+			break;
+		case OPCODE_MULTIPLY:
+			r[instruction->result] = r[instruction->source1]*r[instruction->source2];
+			break;
+		case OPCODE_MULTIPLY_ADD:
+			r[instruction->result] += r[instruction->source1]*r[instruction->source2];
+			break;
+		case OPCODE_DIVIDE:
+			r[instruction->result] = r[instruction->source1]/r[instruction->source2];
+			break;
+		case OPCODE_SCALE:
+			r[instruction->result] = instruction->constant1*r[instruction->source1];
+			break;
+		case OPCODE_OFFSET:
+			r[instruction->result] = instruction->constant1 + r[instruction->source1];
+			break;
+		case OPCODE_POWER:
+			r[instruction->result] = (FE_value)pow((double)r[instruction->source1], (double)r[instruction->source2]);
+			break;
+		case OPCODE_SQRT:
+			r[instruction->result] = (FE_value)sqrt((double)r[instruction->source1]);
+			break;
+		case OPCODE_EXP:
+			r[instruction->result] = (FE_value)exp((double)r[instruction->source1]);
+			break;
+		case OPCODE_LOG:
+			r[instruction->result] = (FE_value)log((double)r[instruction->source1]);
+			break;
+		case OPCODE_ABS:
+			r[instruction->result] = (FE_value)fabs((double)r[instruction->source1]);
+			break;
+		case OPCODE_SIN:
+			r[instruction->result] = (FE_value)sin((double)r[instruction->source1]);
+			break;
+		case OPCODE_COS:
+			r[instruction->result] = (FE_value)cos((double)r[instruction->source1]);
+			break;
+		case OPCODE_TAN:
+			r[instruction->result] = (FE_value)tan((double)r[instruction->source1]);
+			break;
+		case OPCODE_ASIN:
+			r[instruction->result] = (FE_value)asin((double)r[instruction->source1]);
+			break;
+		case OPCODE_ACOS:
+			r[instruction->result] = (FE_value)acos((double)r[instruction->source1]);
+			break;
+		case OPCODE_ATAN:
+			r[instruction->result] = (FE_value)atan((double)r[instruction->source1]);
+			break;
+		case OPCODE_ATAN2:
+			r[instruction->result] = (FE_value)atan2((double)r[instruction->source1], (double)r[instruction->source2]);
+			break;
+		}
+	}
+	const int componentCount = this->field->number_of_components;
+	for (int c = 0; c < componentCount; ++c)
+		valuesOut[c] = r[this->resultRegisters[c]];
+	return 1;
+}
+
+int FieldEvaluationProgram::evaluateTaylor(cmzn_fieldcache& cache, FieldTaylorValues& taylorValuesOut)
+{
+	const int n = taylorValuesOut.getVariableCount();
+	const int stride = FieldTaylorValues::getStride(n);
+	const int registerCount = static_cast<int>(this->registers.size());
+	this->taylorRegisters.resize(registerCount*stride);
+	this->taylorWorkspace.resize(2*stride);
+	FE_value *t = this->taylorRegisters.data();
+	FE_value *workspace = this->taylorWorkspace.data();
+	// registers not written by instructions hold constants
+	for (int i = 0; i < registerCount; ++i)
+		FieldTaylorValues::setConstant(n, t + i*stride, this->registers[i]);
+	const Instruction *instruction = this->instructions.data();
+	const Instruction *instructionsEnd = instruction + this->instructions.size();
+	for (; instruction < instructionsEnd; ++instruction)
+	{
+		FE_value *result = t + instruction->result*stride;
+		const FE_value *a = t + instruction->source1*stride;
+		const FE_value *b = (0 <= instruction->source2) ? t + instruction->source2*stride : 0;
+		const FE_value x = a[0];
+		switch (instruction->opcode)
+		{
+		case OPCODE_LOAD_FIELD:
+		{
+			cmzn_field *leafField = this->leafFields[instruction->source1];
+			const FieldTaylorValues *leafTaylorValues = leafField->evaluateTaylor(cache);
+			if ((!leafTaylorValues) || (leafTaylorValues->getVariableCount() != n))
+				return 0;
+			const int componentCount = leafField->number_of_components;
+			for (int c = 0; c < componentCount; ++c)
+			{
+				const FE_value *source = leafTaylorValues->getComponent(c);
+				for (int k = 0; k < stride; ++k)
+					result[c*stride + k] = source[k];
+			}
+		} break;
+		case OPCODE_ADD:
+			FieldTaylorValues::linear(n, result, instruction->constant1, a, instruction->constant2, b);
+			break;
+		case OPCODE_MULTIPLY:
+			FieldTaylorValues::multiply(n, result, a, b);
+			break;
+		case OPCODE_MULTIPLY_ADD:
+			FieldTaylorValues::multiply(n, result, a, b, /*accumulate*/true);
+			break;
+		case OPCODE_DIVIDE:
+			FieldTaylorValues::divide(n, result, a, b, workspace);
+			break;
+		case OPCODE_SCALE:
+			FieldTaylorValues::linear(n, result, instruction->constant1, a, 0.0, a);
+			break;
+		case OPCODE_OFFSET:
+			FieldTaylorValues::linear(n, result, 1.0, a, 0.0, a);
+			result[0] += instruction->constant1;
+			break;
+		case OPCODE_POWER:
+			FieldTaylorValues::power(n, result, a, b, workspace);
+			break;
+		case OPCODE_SQRT:
+		{
+			const FE_value s = (FE_value)sqrt((double)x);
+			FieldTaylorValues::chain(n, result, a, s, 0.5/s, -0.25/(s*x));
+		} break;
+		case OPCODE_EXP:
+		{
+			const FE_value e = (FE_value)exp((double)x);
+			FieldTaylorValues::chain(n, result, a, e, e, e);
+		} break;
+		case OPCODE_LOG:
+			FieldTaylorValues::chain(n, result, a, (FE_value)log((double)x), 1.0/x, -1.0/(x*x));
+			break;
+		case OPCODE_ABS:
+			FieldTaylorValues::chain(n, result, a, (FE_value)fabs((double)x), (x < 0.0) ? -1.0 : 1.0, 0.0);
+			break;
+		case OPCODE_SIN:
+		{
+			const FE_value sinx = (FE_value)sin((double)x);
+			FieldTaylorValues::chain(n, result, a, sinx, (FE_value)cos((double)x), -sinx);
+		} break;
+		case OPCODE_COS:
+		{
+			const FE_value cosx = (FE_value)cos((double)x);
+			FieldTaylorValues::chain(n, result, a, cosx, -(FE_value)sin((double)x), -cosx);
+		} break;
+		case OPCODE_TAN:
+		{
+			const FE_value tanx = (FE_value)tan((double)x);
+			const FE_value sec2 = 1.0 + tanx*tanx;
+			FieldTaylorValues::chain(n, result, a, tanx, sec2, 2.0*tanx*sec2);
+		} break;
+		case OPCODE_ASIN:
+		{
+			const FE_value d = 1.0/(FE_value)sqrt((double)(1.0 - x*x));
+			FieldTaylorValues::chain(n, result, a, (FE_value)asin((double)x), d, x*d*d*d);
+		} break;
+		case OPCODE_ACOS:
+		{
+			const FE_value d = 1.0/(FE_value)sqrt((double)(1.0 - x*x));
+			FieldTaylorValues::chain(n, result, a, (FE_value)acos((double)x), -d, -x*d*d*d);
+		} break;
+		case OPCODE_ATAN:
+		{
+			const FE_value d = 1.0/(1.0 + x*x);
+			FieldTaylorValues::chain(n, result, a, (FE_value)atan((double)x), d, -2.0*x*d*d);
+		} break;
+		case OPCODE_ATAN2:
+			FieldTaylorValues::atan2(n, result, a, b);
+			break;
+		}
+	}
+	const int componentCount = this->field->number_of_components;
+	for (int c = 0; c < componentCount; ++c)
+	{
+		const FE_value *source = t + this->resultRegisters[c]*stride;
+		FE_value *target = taylorValuesOut.getComponent(c);
+		for (int k = 0; k < stride; ++k)
+			target[k] = source[k];
+	}
+	return 1;
+}
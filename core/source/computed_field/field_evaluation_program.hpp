@@ -0,0 +1,209 @@
+/**
+ * FILE : field_evaluation_program.hpp
+ *
+ * Flat register-based program for evaluating arithmetic field expressions
+ * without recursive virtual evaluation of each field in the expression.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (FIELD_EVALUATION_PROGRAM_HPP)
+#define FIELD_EVALUATION_PROGRAM_HPP
+
+#include "opencmiss/zinc/types/fieldid.h"
+#include "opencmiss/zinc/types/fieldcacheid.h"
+#include "computed_field/field_cache.hpp"
+#include "general/value.h"
+#include <map>
+#include <vector>
+
+/**
+ * Program evaluating values of a field by executing a flat list of scalar
+ * instructions on a register file. It is compiled from the expression graph
+ * of the field: field types able to compile themselves append instructions
+ * computing each of their components from registers holding components of
+ * their source fields; all other source fields are leaves evaluated normally
+ * and loaded into registers. Common sub-expressions are compiled once.
+ * Only values are evaluated; derivatives must be evaluated normally.
+ * Programs are owned by a field value cache and are discarded whenever the
+ * field or any field it depends on changes.
+ */
+class FieldTaylorValues;
+
+class FieldEvaluationProgram
+{
+public:
+
+	enum Opcode
+	{
+		OPCODE_LOAD_FIELD,  // evaluate leaf field source1, copy components to registers from result
+		OPCODE_ADD,         // result = constant1*source1 + constant2*source2
+		OPCODE_MULTIPLY,    // result = source1*source2
+		OPCODE_MULTIPLY_ADD,// result = source1*source2 + result
+		OPCODE_DIVIDE,      // result = source1/source2
+		OPCODE_SCALE,       // result = constant1*source1
+		OPCODE_OFFSET,      // result = source1 + constant1
+		OPCODE_POWER,       // result = source1^source2
+		OPCODE_SQRT,
+		OPCODE_EXP,
+		OPCODE_LOG,
+		OPCODE_ABS,
+		OPCODE_SIN,
+		OPCODE_COS,
+		OPCODE_TAN,
+		OPCODE_ASIN,
+		OPCODE_ACOS,
+		OPCODE_ATAN,
+		OPCODE_ATAN2        // result = atan2(source1, source2)
+	};
+
+private:
+
+	struct Instruction
+	{
+		Opcode opcode;
+		int result;
+		int source1;
+		int source2;
+		FE_value constant1;
+		FE_value constant2;
+	};
+
+	cmzn_field *field; // not accessed: program is owned by value cache of field
+	bool valid;
+	std::vector<Instruction> instructions;
+	std::vector<cmzn_field *> leafFields; // not accessed: field depends on them
+	std::vector<FieldComponentMask> leafComponentMasks; // components of each leaf field used
+	std::vector<FE_value> registers; // constants are held in registers never written to
+	std::vector<int> resultRegisters; // register holding each component of field
+	// during compilation only: registers holding components of each field compiled
+	std::map<cmzn_field *, std::vector<int> > fieldRegisters;
+	// for Taylor evaluation only: Taylor numbers for each register, and workspace
+	std::vector<FE_value> taylorRegisters;
+	std::vector<FE_value> taylorWorkspace;
+
+	FieldEvaluationProgram(cmzn_field *fieldIn);
+
+	/** Set masks of leaf field components read by instructions or giving
+	 * results, so unused components need not be evaluated */
+	void setLeafComponentMasks();
+
+	int addRegisters(int count)
+	{
+		const int first = static_cast<int>(this->registers.size());
+		this->registers.resize(first + count, 0.0);
+		return first;
+	}
+
+public:
+
+	/**
+	 * Compile program for evaluating field. Check isValid() before use.
+	 * @return  New program, invalid if field does not support compilation.
+	 */
+	static FieldEvaluationProgram *create(cmzn_field *fieldIn);
+
+	/** @return  True if program can evaluate field, false if field must be
+	 * evaluated normally */
+	bool isValid() const
+	{
+		return this->valid;
+	}
+
+	int getInstructionCount() const
+	{
+		return static_cast<int>(this->instructions.size());
+	}
+
+	int getLeafFieldCount() const
+	{
+		return static_cast<int>(this->leafFields.size());
+	}
+
+	/**
+	 * For use by fields compiling themselves: get registers holding components
+	 * of source field, compiling it or loading it as a leaf field on first call.
+	 * @return  Pointer to register indexes for each component of source field,
+	 * valid until compilation ends.
+	 */
+	const int *getFieldRegisters(cmzn_field *sourceField);
+
+	/**
+	 * For use by fields compiling themselves: append instruction writing to a
+	 * new register.
+	 * @return  Index of result register.
+	 */
+	int addInstruction(Opcode opcode, int source1, int source2 = -1,
+		FE_value constant1 = 0.0, FE_value constant2 = 0.0);
+
+	/**
+	 * For use by fields compiling themselves: append instruction accumulating
+	 * into an existing result register written by an earlier instruction.
+	 */
+	void addAccumulateInstruction(Opcode opcode, int result, int source1, int source2);
+
+	/**
+	 * For use by fields compiling themselves: append instruction for each of
+	 * componentCount components of source field.
+	 * @param componentRegisters  Array to receive result register for each
+	 * component.
+	 */
+	void addUnaryInstructions(Opcode opcode, cmzn_field *sourceField,
+		int componentCount, int *componentRegisters)
+	{
+		const int *source = this->getFieldRegisters(sourceField);
+		for (int c = 0; c < componentCount; ++c)
+			componentRegisters[c] = this->addInstruction(opcode, source[c]);
+	}
+
+	/**
+	 * For use by fields compiling themselves: append instruction for each of
+	 * componentCount components of two source fields.
+	 * @param componentRegisters  Array to receive result register for each
+	 * component.
+	 */
+	void addBinaryInstructions(Opcode opcode, cmzn_field *sourceField1,
+		cmzn_field *sourceField2, int componentCount, int *componentRegisters)
+	{
+		const int *source1 = this->getFieldRegisters(sourceField1);
+		const int *source2 = this->getFieldRegisters(sourceField2);
+		for (int c = 0; c < componentCount; ++c)
+			componentRegisters[c] = this->addInstruction(opcode, source1[c], source2[c]);
+	}
+
+	/**
+	 * For use by fields compiling themselves.
+	 * @return  Index of new register permanently holding value.
+	 */
+	int addConstant(FE_value value)
+	{
+		const int index = this->addRegisters(1);
+		this->registers[index] = value;
+		return index;
+	}
+
+	/**
+	 * Evaluate values of field at location in cache. Leaf fields are evaluated
+	 * normally so their values are cached as usual.
+	 * @param valuesOut  Array to receive values of all components of field.
+	 * @return  1 on success, 0 if any leaf field could not be evaluated.
+	 */
+	int evaluate(cmzn_fieldcache& cache, FE_value *valuesOut);
+
+	/**
+	 * Evaluate values and first and second derivatives of field with respect
+	 * to element xi at the element location in cache, executing instructions
+	 * in Taylor arithmetic. Leaf fields are evaluated with their own Taylor
+	 * evaluation, so fail if they do not support it.
+	 * @param taylorValuesOut  Taylor values to receive all components of field,
+	 * with variable count set to the element dimension.
+	 * @return  1 on success, 0 on failure.
+	 */
+	int evaluateTaylor(cmzn_fieldcache& cache, FieldTaylorValues& taylorValuesOut);
+
+};
+
+#endif /* !defined (FIELD_EVALUATION_PROGRAM_HPP) */
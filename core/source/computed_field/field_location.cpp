@@ -22,6 +22,8 @@ int Field_element_xi_location::set_element_xi(struct FE_element *element_in,
 {
 	if ((!element_in) || (!xi_in))
 		return 0;
+	xi_point_set = 0;
+	xi_point_index = -1;
 	if (element_in != element)
 	{
 		int new_dimension = element_in->getDimension();
@@ -21,6 +21,7 @@
 #include "general/value.h"
 
 struct cmzn_field;
+class FE_xi_point_set;
 
 class Field_location
 {
@@ -76,6 +77,8 @@ private:
 	int dimension;
 	FE_value xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
 	struct FE_element *top_level_element;
+	FE_xi_point_set *xi_point_set; // optional set xi is a point of; not accessed
+	int xi_point_index;
 
 public:
 	Field_element_xi_location(struct FE_element *element_in,
@@ -84,7 +87,9 @@ public:
 		Field_location(time_in, number_of_derivatives_in),
 		element(element_in ? ACCESS(FE_element)(element_in) : 0),
 		dimension(element_in ? element_in->getDimension() : 0),
-		top_level_element(top_level_element_in ? ACCESS(FE_element)(top_level_element_in) : 0)
+		top_level_element(top_level_element_in ? ACCESS(FE_element)(top_level_element_in) : 0),
+		xi_point_set(0),
+		xi_point_index(-1)
 	{
 		if (xi_in)
 		{
@@ -107,7 +112,9 @@ public:
 		Field_location(time_in, number_of_derivatives_in),
 		element(0),
 		dimension(0),
-		top_level_element(0)
+		top_level_element(0),
+		xi_point_set(0),
+		xi_point_index(-1)
 	{
 	}
 
@@ -143,6 +150,26 @@ public:
 		return top_level_element;
 	}
 
+	/** @return  Point set xi is a point of, or 0 if none */
+	FE_xi_point_set *get_xi_point_set() const
+	{
+		return xi_point_set;
+	}
+
+	int get_xi_point_index() const
+	{
+		return xi_point_index;
+	}
+
+	/** Record that xi is point xi_point_index_in of xi_point_set_in so
+	 * interpolation can use its basis function tables. Point set must persist
+	 * while it is set; it is cleared by set_element_xi and not cloned. */
+	void set_xi_point(FE_xi_point_set *xi_point_set_in, int xi_point_index_in)
+	{
+		xi_point_set = xi_point_set_in;
+		xi_point_index = xi_point_index_in;
+	}
+
 	int set_element_xi(struct FE_element *element_in,
 		int number_of_xi_in, const FE_value *xi_in,
 		struct FE_element *top_level_element_in = NULL);
@@ -253,4 +280,117 @@ public:
 
 };
 
+/**
+ * Identity of a node, element xi or time-only location, used as a key for
+ * memoising field values at recently evaluated locations. Element and xi
+ * match only if exactly equal. Objects are not accessed unless
+ * accessObjects() is called.
+ */
+class FieldLocationKey
+{
+public:
+	enum Type
+	{
+		TYPE_INVALID,
+		TYPE_TIME,
+		TYPE_NODE,
+		TYPE_ELEMENT_XI
+	};
+
+private:
+	Type type;
+	FE_value time;
+	FE_node *node;
+	cmzn_element *element;
+	cmzn_element *topLevelElement;
+	int dimension;
+	FE_value xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+
+public:
+	FieldLocationKey() :
+		type(TYPE_INVALID),
+		time(0.0),
+		node(0),
+		element(0),
+		topLevelElement(0),
+		dimension(0)
+	{
+	}
+
+	Type getType() const
+	{
+		return this->type;
+	}
+
+	/** Set key to identify location. Objects are not accessed.
+	 * @return  True if location can be identified, false if not, e.g. a
+	 * field coordinate location. */
+	bool setFromLocation(Field_location& location)
+	{
+		this->time = location.get_time();
+		this->node = 0;
+		this->element = 0;
+		this->topLevelElement = 0;
+		this->dimension = 0;
+		Field_element_xi_location *elementXiLocation;
+		Field_node_location *nodeLocation;
+		if (0 != (elementXiLocation = dynamic_cast<Field_element_xi_location*>(&location)))
+		{
+			this->type = TYPE_ELEMENT_XI;
+			this->element = elementXiLocation->get_element();
+			this->topLevelElement = elementXiLocation->get_top_level_element();
+			this->dimension = elementXiLocation->get_dimension();
+			const FE_value *locationXi = elementXiLocation->get_xi();
+			for (int i = 0; i < this->dimension; ++i)
+				this->xi[i] = locationXi[i];
+		}
+		else if (0 != (nodeLocation = dynamic_cast<Field_node_location*>(&location)))
+		{
+			this->type = TYPE_NODE;
+			this->node = nodeLocation->get_node();
+		}
+		else if (0 != dynamic_cast<Field_time_location*>(&location))
+			this->type = TYPE_TIME;
+		else
+			this->type = TYPE_INVALID;
+		return (TYPE_INVALID != this->type);
+	}
+
+	bool operator==(const FieldLocationKey& other) const
+	{
+		if ((this->type != other.type) || (this->time != other.time) ||
+			(this->node != other.node) || (this->element != other.element) ||
+			(this->topLevelElement != other.topLevelElement))
+			return false;
+		for (int i = 0; i < this->dimension; ++i)
+			if (this->xi[i] != other.xi[i])
+				return false;
+		return true;
+	}
+
+	/** Access objects so they cannot be destroyed and reused while key is held */
+	void accessObjects()
+	{
+		if (this->node)
+			ACCESS(FE_node)(this->node);
+		if (this->element)
+			this->element->access();
+		if (this->topLevelElement)
+			this->topLevelElement->access();
+	}
+
+	/** Deaccess objects after accessObjects and clear key */
+	void deaccessObjects()
+	{
+		if (this->node)
+			DEACCESS(FE_node)(&this->node);
+		if (this->element)
+			cmzn_element::deaccess(this->element);
+		if (this->topLevelElement)
+			cmzn_element::deaccess(this->topLevelElement);
+		this->type = TYPE_INVALID;
+		this->dimension = 0;
+	}
+};
+
 #endif /* !defined (__FIELD_LOCATION_HPP__) */
@@ -0,0 +1,98 @@
+/**
+ * FILE : field_profiler.cpp
+ *
+ * Opt-in profiling of field evaluation: per-field evaluation counts, value
+ * cache hits and timing.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include "computed_field/computed_field_private.hpp"
+#include "computed_field/field_profiler.hpp"
+#include "region/cmiss_region.h"
+#include "jsoncpp/json.h"
+
+namespace {
+
+struct FieldProfileReportEntry
+{
+	const char *name;
+	FieldProfileRecord record;
+};
+
+bool FieldProfileReportEntry_exclusive_time_greater(const FieldProfileReportEntry& a,
+	const FieldProfileReportEntry& b)
+{
+	return a.record.exclusiveTime > b.record.exclusiveTime;
+}
+
+double getHitRate(double hits, double misses)
+{
+	return (0.0 < (hits + misses)) ? hits/(hits + misses) : 0.0;
+}
+
+}
+
+void FieldProfile::add(const FieldProfile& source)
+{
+	std::lock(this->mutex, source.mutex);
+	std::lock_guard<std::mutex> lock(this->mutex, std::adopt_lock);
+	std::lock_guard<std::mutex> sourceLock(source.mutex, std::adopt_lock);
+	const int size = static_cast<int>(source.records.size());
+	if (size > static_cast<int>(this->records.size()))
+		this->records.resize(size);
+	for (int i = 0; i < size; ++i)
+		this->records[i].add(source.records[i]);
+}
+
+std::string FieldProfiler::writeReport(cmzn_region_id region, const FieldProfile& profile,
+	int elementFieldValuesHits, int elementFieldValuesMisses) const
+{
+	std::vector<FieldProfileReportEntry> entries;
+	const cmzn_set_cmzn_field& fields =
+		Computed_field_manager_get_fields(cmzn_region_get_Computed_field_manager(region));
+	for (cmzn_set_cmzn_field::const_iterator iter = fields.begin(); iter != fields.end(); ++iter)
+	{
+		const FieldProfileRecord *record = profile.findRecord(cmzn_field_get_cache_index_private(*iter));
+		if (record && ((0 < record->evaluations) || (0 < record->findMeshLocationSearches)))
+		{
+			FieldProfileReportEntry entry;
+			entry.name = (*iter)->name;
+			entry.record = *record;
+			entries.push_back(entry);
+		}
+	}
+	std::stable_sort(entries.begin(), entries.end(), FieldProfileReportEntry_exclusive_time_greater);
+	Json::Value root;
+	Json::Value fieldsJson(Json::arrayValue);
+	for (std::vector<FieldProfileReportEntry>::iterator iter = entries.begin(); iter != entries.end(); ++iter)
+	{
+		const FieldProfileRecord& record = iter->record;
+		Json::Value fieldJson;
+		fieldJson["Name"] = iter->name;
+		fieldJson["Evaluations"] = static_cast<Json::Int64>(record.evaluations);
+		fieldJson["CacheHits"] = static_cast<Json::Int64>(record.cacheHits);
+		fieldJson["CacheHitRate"] = getHitRate(static_cast<double>(record.cacheHits),
+			static_cast<double>(record.evaluations - record.cacheHits));
+		fieldJson["InclusiveTime"] = record.inclusiveTime;
+		fieldJson["ExclusiveTime"] = record.exclusiveTime;
+		fieldJson["FindMeshLocationSearches"] = static_cast<Json::Int64>(record.findMeshLocationSearches);
+		fieldsJson.append(fieldJson);
+	}
+	root["Fields"] = fieldsJson;
+	// element field values cache statistics are reset when it is cleared
+	const int hits = (elementFieldValuesHits >= this->elementFieldValuesHitsStart) ?
+		elementFieldValuesHits - this->elementFieldValuesHitsStart : elementFieldValuesHits;
+	const int misses = (elementFieldValuesMisses >= this->elementFieldValuesMissesStart) ?
+		elementFieldValuesMisses - this->elementFieldValuesMissesStart : elementFieldValuesMisses;
+	Json::Value elementFieldValuesJson;
+	elementFieldValuesJson["Hits"] = hits;
+	elementFieldValuesJson["Misses"] = misses;
+	elementFieldValuesJson["HitRate"] = getHitRate(static_cast<double>(hits), static_cast<double>(misses));
+	root["ElementFieldValuesCache"] = elementFieldValuesJson;
+	return Json::StyledWriter().write(root);
+}
@@ -0,0 +1,209 @@
+/**
+ * FILE : field_profiler.hpp
+ *
+ * Opt-in profiling of field evaluation: per-field evaluation counts, value
+ * cache hits and timing.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (FIELD_PROFILER_HPP)
+#define FIELD_PROFILER_HPP
+
+#include "opencmiss/zinc/types/regionid.h"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** Profile counts and times for one field. Times are in seconds. */
+struct FieldProfileRecord
+{
+	long long evaluations; // requests to evaluate field at a location
+	long long cacheHits; // requests satisfied by values already in value cache
+	long long findMeshLocationSearches; // searches for mesh location of field values
+	double inclusiveTime; // time evaluating field including its source fields
+	double exclusiveTime; // time evaluating field excluding its source fields
+
+	FieldProfileRecord() :
+		evaluations(0),
+		cacheHits(0),
+		findMeshLocationSearches(0),
+		inclusiveTime(0.0),
+		exclusiveTime(0.0)
+	{
+	}
+
+	void add(const FieldProfileRecord& source)
+	{
+		this->evaluations += source.evaluations;
+		this->cacheHits += source.cacheHits;
+		this->findMeshLocationSearches += source.findMeshLocationSearches;
+		this->inclusiveTime += source.inclusiveTime;
+		this->exclusiveTime += source.exclusiveTime;
+	}
+};
+
+/**
+ * Profile records for all fields of a region, indexed by field cache index.
+ * Each field cache records into its own profile while profiling is enabled.
+ * Records are guarded by a mutex as the region reads, clears and adds them
+ * while other threads may be evaluating with the field cache. Timing state
+ * is only used by the thread evaluating with the field cache.
+ */
+class FieldProfile
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	/** State saved on starting timing of a field evaluation */
+	struct Timer
+	{
+		Clock::time_point start;
+		double savedChildTime;
+	};
+
+private:
+	std::vector<FieldProfileRecord> records;
+	mutable std::mutex mutex; // guards records
+	double childTime; // inclusive time of source fields of field currently being timed
+
+	FieldProfile(const FieldProfile&); // not implemented
+	FieldProfile& operator=(const FieldProfile&); // not implemented
+
+	/** Caller must hold mutex.
+	 * @return  Record for field with cache index. Reference is invalidated by
+	 * getting records for higher cache indexes. */
+	FieldProfileRecord& getRecord(int cacheIndex)
+	{
+		if (cacheIndex >= static_cast<int>(this->records.size()))
+			this->records.resize(cacheIndex + 1);
+		return this->records[cacheIndex];
+	}
+
+public:
+
+	FieldProfile() :
+		childTime(0.0)
+	{
+	}
+
+	/** Only for profiles not shared with other threads, e.g. a report total.
+	 * @return  Record for cache index, or 0 if none. */
+	const FieldProfileRecord *findRecord(int cacheIndex) const
+	{
+		if ((0 <= cacheIndex) && (cacheIndex < static_cast<int>(this->records.size())))
+			return &(this->records[cacheIndex]);
+		return 0;
+	}
+
+	/** Record evaluation of field with cache index satisfied from value cache */
+	void recordCacheHit(int cacheIndex)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		FieldProfileRecord& record = this->getRecord(cacheIndex);
+		++record.evaluations;
+		++record.cacheHits;
+	}
+
+	/** Record search for mesh location by field with cache index */
+	void recordFindMeshLocationSearch(int cacheIndex)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		++(this->getRecord(cacheIndex).findMeshLocationSearches);
+	}
+
+	/** Start timing evaluation of a field; times of source fields evaluated
+	 * until stopTimer are subtracted from its exclusive time. */
+	Timer startTimer()
+	{
+		Timer timer;
+		timer.savedChildTime = this->childTime;
+		this->childTime = 0.0;
+		timer.start = Clock::now();
+		return timer;
+	}
+
+	/** Stop timing evaluation of field with cache index started with timer,
+	 * and record its evaluation */
+	void stopTimer(const Timer& timer, int cacheIndex)
+	{
+		const double time = std::chrono::duration<double>(Clock::now() - timer.start).count();
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			FieldProfileRecord& record = this->getRecord(cacheIndex);
+			++record.evaluations;
+			record.inclusiveTime += time;
+			record.exclusiveTime += time - this->childTime;
+		}
+		this->childTime = timer.savedChildTime + time;
+	}
+
+	/** Clear record for cache index, e.g. when it is given to a new field */
+	void clearRecord(int cacheIndex)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (cacheIndex < static_cast<int>(this->records.size()))
+			this->records[cacheIndex] = FieldProfileRecord();
+	}
+
+	/** Clear all records. Timing state is left for any evaluation in progress. */
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->records.clear();
+	}
+
+	/** Add records of source profile to this */
+	void add(const FieldProfile& source);
+
+};
+
+/**
+ * Profiler owned by a region while profiling of its field evaluation is
+ * enabled. Accumulates the profiles of field caches destroyed while profiling.
+ * Element field values cache statistics are reported relative to their values
+ * when profiling was enabled or reset.
+ */
+class FieldProfiler
+{
+	FieldProfile accumulatedProfile;
+	int elementFieldValuesHitsStart;
+	int elementFieldValuesMissesStart;
+
+public:
+
+	FieldProfiler() :
+		elementFieldValuesHitsStart(0),
+		elementFieldValuesMissesStart(0)
+	{
+	}
+
+	FieldProfile& getAccumulatedProfile()
+	{
+		return this->accumulatedProfile;
+	}
+
+	void setElementFieldValuesStart(int hits, int misses)
+	{
+		this->elementFieldValuesHitsStart = hits;
+		this->elementFieldValuesMissesStart = misses;
+	}
+
+	/**
+	 * Write report of profile as JSON, with fields ordered by decreasing
+	 * exclusive time. Fields not evaluated since profiling began are omitted.
+	 * @param region  Region owning fields profiled.
+	 * @param profile  Total profile of all field caches in region.
+	 * @param elementFieldValuesHits, elementFieldValuesMisses  Current
+	 * statistics of element field values cache for region.
+	 */
+	std::string writeReport(cmzn_region_id region, const FieldProfile& profile,
+		int elementFieldValuesHits, int elementFieldValuesMisses) const;
+
+};
+
+#endif /* !defined (FIELD_PROFILER_HPP) */
@@ -0,0 +1,69 @@
+/**
+ * FILE : field_taylor_values.cpp
+ *
+ * Truncated second order Taylor expansions of field components for forward
+ * mode automatic differentiation.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <cmath>
+#include "computed_field/field_taylor_values.hpp"
+
+void FieldTaylorValues::divide(int n, FE_value *result, const FE_value *a, const FE_value *b,
+	FE_value *workspace)
+{
+	const FE_value x = b[0];
+	FE_value *reciprocal = workspace;
+	chain(n, reciprocal, b, 1.0/x, -1.0/(x*x), 2.0/(x*x*x));
+	multiply(n, result, a, reciprocal);
+}
+
+void FieldTaylorValues::power(int n, FE_value *result, const FE_value *a, const FE_value *b,
+	FE_value *workspace)
+{
+	const FE_value x = a[0];
+	if (isConstant(n, b))
+	{
+		// also handles negative a with integer exponent
+		const FE_value p = b[0];
+		chain(n, result, a, (FE_value)pow((double)x, (double)p),
+			p*(FE_value)pow((double)x, (double)(p - 1.0)),
+			p*(p - 1.0)*(FE_value)pow((double)x, (double)(p - 2.0)));
+	}
+	else
+	{
+		// a^b = exp(b*log(a))
+		FE_value *logA = workspace;
+		FE_value *exponent = workspace + getStride(n);
+		chain(n, logA, a, (FE_value)log((double)x), 1.0/x, -1.0/(x*x));
+		multiply(n, exponent, logA, b);
+		const FE_value e = (FE_value)exp((double)exponent[0]);
+		chain(n, result, exponent, e, e, e);
+	}
+}
+
+void FieldTaylorValues::atan2(int n, FE_value *result, const FE_value *a, const FE_value *b)
+{
+	const FE_value y = a[0], x = b[0];
+	const FE_value *gy = a + 1, *gx = b + 1;
+	const FE_value *hy = gy + n, *hx = gx + n;
+	FE_value *gr = result + 1, *hr = gr + n;
+	const FE_value r2 = x*x + y*y;
+	// first derivatives u/r2 with u = x*dy - y*dx; second derivatives by quotient rule
+	for (int i = 0; i < n; ++i)
+	{
+		const FE_value u_i = x*gy[i] - y*gx[i];
+		for (int j = 0; j < n; ++j)
+		{
+			const FE_value du_ij = gx[j]*gy[i] + x*hy[i*n + j] - gy[j]*gx[i] - y*hx[i*n + j];
+			const FE_value dr2_j = 2.0*(x*gx[j] + y*gy[j]);
+			hr[i*n + j] = du_ij/r2 - u_i*dr2_j/(r2*r2);
+		}
+		gr[i] = u_i/r2;
+	}
+	result[0] = (FE_value)::atan2((double)y, (double)x);
+}
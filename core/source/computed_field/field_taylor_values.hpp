@@ -0,0 +1,184 @@
+/**
+ * FILE : field_taylor_values.hpp
+ *
+ * Truncated second order Taylor expansions of field components for forward
+ * mode automatic differentiation.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (FIELD_TAYLOR_VALUES_HPP)
+#define FIELD_TAYLOR_VALUES_HPP
+
+#include "general/value.h"
+#include <vector>
+
+/**
+ * Values, first derivatives and second derivatives of all components of a
+ * field with respect to a number of variables, currently the element chart
+ * (xi) coordinates of the location. Each component is a Taylor number stored
+ * as consecutive coefficients: value, then first derivative with respect to
+ * each variable, then the full symmetric matrix of second derivatives with
+ * variable j varying fastest. Static functions implement Taylor arithmetic on
+ * such coefficient arrays, giving exact derivatives by the chain rule when
+ * evaluating expressions in turn.
+ */
+class FieldTaylorValues
+{
+	int componentCount;
+	int variableCount;
+	int stride; // number of coefficients per component
+	std::vector<FE_value> coefficients;
+
+public:
+
+	FieldTaylorValues(int componentCountIn, int variableCountIn) :
+		componentCount(componentCountIn),
+		variableCount(0),
+		stride(1)
+	{
+		this->setVariableCount(variableCountIn);
+	}
+
+	static int getStride(int variableCount)
+	{
+		return 1 + variableCount + variableCount*variableCount;
+	}
+
+	int getComponentCount() const
+	{
+		return this->componentCount;
+	}
+
+	int getVariableCount() const
+	{
+		return this->variableCount;
+	}
+
+	void setVariableCount(int variableCountIn)
+	{
+		this->variableCount = variableCountIn;
+		this->stride = getStride(variableCountIn);
+		this->coefficients.resize(this->componentCount*this->stride);
+	}
+
+	int getStride() const
+	{
+		return this->stride;
+	}
+
+	FE_value *getComponent(int componentIndex)
+	{
+		return this->coefficients.data() + componentIndex*this->stride;
+	}
+
+	const FE_value *getComponent(int componentIndex) const
+	{
+		return this->coefficients.data() + componentIndex*this->stride;
+	}
+
+	FE_value getValue(int componentIndex) const
+	{
+		return this->getComponent(componentIndex)[0];
+	}
+
+	/** @param i  Variable index starting at 0. */
+	FE_value getFirstDerivative(int componentIndex, int i) const
+	{
+		return this->getComponent(componentIndex)[1 + i];
+	}
+
+	/** @param i, j  Variable indexes starting at 0. */
+	FE_value getSecondDerivative(int componentIndex, int i, int j) const
+	{
+		return this->getComponent(componentIndex)[1 + this->variableCount + i*this->variableCount + j];
+	}
+
+	/** Set all components from values with zero derivatives */
+	void setConstants(const FE_value *values)
+	{
+		for (int c = 0; c < this->componentCount; ++c)
+			setConstant(this->variableCount, this->getComponent(c), values[c]);
+	}
+
+	/** Set result to constant value with zero derivatives. */
+	static void setConstant(int n, FE_value *result, FE_value value)
+	{
+		result[0] = value;
+		const int stride = getStride(n);
+		for (int k = 1; k < stride; ++k)
+			result[k] = 0.0;
+	}
+
+	/** result = ca*a + cb*b. Result may be a or b. */
+	static void linear(int n, FE_value *result, FE_value ca, const FE_value *a,
+		FE_value cb, const FE_value *b)
+	{
+		const int stride = getStride(n);
+		for (int k = 0; k < stride; ++k)
+			result[k] = ca*a[k] + cb*b[k];
+	}
+
+	/** result = a*b, or result += a*b if accumulate. Result must not be a or b. */
+	static void multiply(int n, FE_value *result, const FE_value *a, const FE_value *b,
+		bool accumulate = false)
+	{
+		const FE_value *ga = a + 1, *gb = b + 1;
+		const FE_value *ha = ga + n, *hb = gb + n;
+		FE_value *gr = result + 1, *hr = gr + n;
+		if (!accumulate)
+			setConstant(n, result, 0.0);
+		result[0] += a[0]*b[0];
+		for (int i = 0; i < n; ++i)
+		{
+			gr[i] += a[0]*gb[i] + b[0]*ga[i];
+			for (int j = 0; j < n; ++j)
+				hr[i*n + j] += a[0]*hb[i*n + j] + b[0]*ha[i*n + j] + ga[i]*gb[j] + gb[i]*ga[j];
+		}
+	}
+
+	/** result = f(a) given f and its first and second derivatives evaluated at
+	 * the value of a. Result may be a. */
+	static void chain(int n, FE_value *result, const FE_value *a,
+		FE_value f0, FE_value f1, FE_value f2)
+	{
+		const FE_value *ga = a + 1, *ha = ga + n;
+		FE_value *gr = result + 1, *hr = gr + n;
+		// update second derivatives before overwriting first derivatives of a
+		for (int i = 0; i < n; ++i)
+			for (int j = 0; j < n; ++j)
+				hr[i*n + j] = f1*ha[i*n + j] + f2*ga[i]*ga[j];
+		for (int i = 0; i < n; ++i)
+			gr[i] = f1*ga[i];
+		result[0] = f0;
+	}
+
+	/** @return  True if a has zero first and second derivatives. */
+	static bool isConstant(int n, const FE_value *a)
+	{
+		const int stride = getStride(n);
+		for (int k = 1; k < stride; ++k)
+			if (0.0 != a[k])
+				return false;
+		return true;
+	}
+
+	/** result = a/b. Result must not be a or b.
+	 * @param workspace  Array of at least getStride(n) values. */
+	static void divide(int n, FE_value *result, const FE_value *a, const FE_value *b,
+		FE_value *workspace);
+
+	/** result = a^b. Result must not be a or b.
+	 * @param workspace  Array of at least 2*getStride(n) values. */
+	static void power(int n, FE_value *result, const FE_value *a, const FE_value *b,
+		FE_value *workspace);
+
+	/** result = atan2(a, b). Result must not be a or b. */
+	static void atan2(int n, FE_value *result, const FE_value *a, const FE_value *b);
+
+};
+
+#endif /* !defined (FIELD_TAYLOR_VALUES_HPP) */
@@ -0,0 +1,156 @@
+/**
+ * FILE : field_value_cache_arena.hpp
+ *
+ * Bump allocator for the real value arrays of all field value caches of one
+ * field cache.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (FIELD_VALUE_CACHE_ARENA_HPP)
+#define FIELD_VALUE_CACHE_ARENA_HPP
+
+#include "general/value.h"
+#include <map>
+#include <vector>
+
+/**
+ * Arena supplying FE_value arrays for values and derivatives of the field
+ * value caches of a field cache, replacing many small heap allocations with
+ * a few large blocks. Arrays are carved sequentially from the current block;
+ * the first block is sized on first use from the number of fields in the
+ * region, and later blocks double in size. Arrays released by value caches
+ * discarded when fields change are recycled for later arrays of the same
+ * size, and the arena is rewound once no arrays are in use.
+ * Owned by a field cache and not thread safe, like the field cache.
+ * Header only so it can be unit tested without the library.
+ */
+class FieldValueCacheArena
+{
+	static const int minimumBlockSize = 256;
+	// typical number of values per field: values + derivatives of a 3-component field
+	static const int valuesPerFieldEstimate = 3*(1 + MAXIMUM_ELEMENT_XI_DIMENSIONS);
+
+	std::vector<FE_value *> blocks;
+	int blockSize; // size of last block
+	int blockUsed; // number of values used in last block
+	int nextBlockSize;
+	int capacity; // total size of all blocks
+	int liveArrayCount;
+	std::map<int, std::vector<FE_value *> > freeArrays; // released arrays by size
+
+	FieldValueCacheArena(const FieldValueCacheArena&); // not implemented
+	FieldValueCacheArena& operator=(const FieldValueCacheArena&); // not implemented
+
+	void freeBlocks()
+	{
+		for (std::vector<FE_value *>::iterator iter = this->blocks.begin(); iter != this->blocks.end(); ++iter)
+			delete[] *iter;
+		this->blocks.clear();
+		this->blockSize = 0;
+		this->blockUsed = 0;
+		this->capacity = 0;
+		this->freeArrays.clear();
+	}
+
+public:
+
+	/** @param fieldCountHint  Number of fields in region, used to size the
+	 * first block */
+	FieldValueCacheArena(int fieldCountHint) :
+		blockSize(0),
+		blockUsed(0),
+		nextBlockSize((fieldCountHint*valuesPerFieldEstimate > minimumBlockSize) ?
+			fieldCountHint*valuesPerFieldEstimate : minimumBlockSize),
+		capacity(0),
+		liveArrayCount(0)
+	{
+	}
+
+	~FieldValueCacheArena()
+	{
+		this->freeBlocks();
+	}
+
+	/** @return  Pointer to uninitialised array of size values, valid until
+	 * released or arena is destroyed. */
+	FE_value *allocate(int size)
+	{
+		if (size < 1)
+			size = 1;
+		std::map<int, std::vector<FE_value *> >::iterator freeIter = this->freeArrays.find(size);
+		if ((freeIter != this->freeArrays.end()) && (!freeIter->second.empty()))
+		{
+			FE_value *array = freeIter->second.back();
+			freeIter->second.pop_back();
+			++(this->liveArrayCount);
+			return array;
+		}
+		if (this->blockUsed + size > this->blockSize)
+		{
+			this->blockSize = (size > this->nextBlockSize) ? size : this->nextBlockSize;
+			this->blocks.push_back(new FE_value[this->blockSize]);
+			this->capacity += this->blockSize;
+			this->blockUsed = 0;
+			this->nextBlockSize = 2*this->blockSize;
+		}
+		FE_value *array = this->blocks.back() + this->blockUsed;
+		this->blockUsed += size;
+		++(this->liveArrayCount);
+		return array;
+	}
+
+	/** Release array obtained from allocate with the same size.
+	 * @return  False if no arrays are in use, otherwise true. */
+	bool release(FE_value *array, int size)
+	{
+		if (!array)
+			return true;
+		if (this->liveArrayCount <= 0)
+			return false;
+		--(this->liveArrayCount);
+		if (0 == this->liveArrayCount)
+		{
+			// rewind: keep a single block large enough for all arrays used so far
+			if (1 < this->blocks.size())
+			{
+				const int totalSize = this->capacity;
+				this->freeBlocks();
+				this->nextBlockSize = totalSize;
+			}
+			else
+			{
+				this->blockUsed = 0;
+				this->freeArrays.clear();
+			}
+			return true;
+		}
+		if (size < 1)
+			size = 1;
+		this->freeArrays[size].push_back(array);
+		return true;
+	}
+
+	/** @return  Total number of values in all blocks */
+	int getCapacity() const
+	{
+		return this->capacity;
+	}
+
+	/** @return  Number of blocks allocated */
+	int getBlockCount() const
+	{
+		return static_cast<int>(this->blocks.size());
+	}
+
+	int getLiveArrayCount() const
+	{
+		return this->liveArrayCount;
+	}
+
+};
+
+#endif /* !defined (FIELD_VALUE_CACHE_ARENA_HPP) */
@@ -10,12 +10,18 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
 #include "opencmiss/zinc/fieldmodule.h"
 #include "opencmiss/zinc/node.h"
 #include "opencmiss/zinc/nodeset.h"
 #include "computed_field/fieldassignmentprivate.hpp"
 #include "computed_field/computed_field.h"
+#include "computed_field/computed_field_finite_element.h"
+#include "computed_field/computed_field_subobject_group.hpp"
 #include "computed_field/computed_field_update.h"
+#include "computed_field/field_cache.hpp"
+#include "finite_element/finite_element_nodeset.hpp"
+#include "finite_element/finite_element_private.h"
 #include "mesh/cmiss_node_private.hpp"
 #include "general/debug.h"
 
@@ -205,3 +211,145 @@ cmzn_field_id cmzn_fieldassignment_get_target_field(
 	display_message(ERROR_MESSAGE, "Fieldassignment getTargetField:  Invalid field assignment object");
 	return 0;
 }
+
+namespace {
+
+/**
+ * Check arguments for bulk nodeset evaluate/assign and create iterator over
+ * nodeset or nodeset group labels in identifier order.
+ * @return  Iterator, or 0 if invalid arguments. Caller must deaccess.
+ */
+DsLabelIterator *cmzn_nodeset_create_label_iterator_for_real_values(
+	cmzn_field_id field, cmzn_fieldcache_id cache, cmzn_nodeset_id nodeset,
+	int number_of_values, const double *values)
+{
+	if (!((field) && (cache) && (nodeset) && (values)
+		&& (Computed_field_get_region(field) == cache->getRegion())
+		&& (cmzn_nodeset_get_region_internal(nodeset) == cache->getRegion())
+		&& (cmzn_field_get_value_type(field) == CMZN_FIELD_VALUE_TYPE_REAL)
+		&& (number_of_values >= cmzn_nodeset_get_size(nodeset)*cmzn_field_get_number_of_components(field))))
+	{
+		return 0;
+	}
+	cmzn_field_node_group *nodeGroup = cmzn_nodeset_get_node_group_field_internal(nodeset);
+	if (nodeGroup)
+		return Computed_field_node_group_core_cast(nodeGroup)->getLabelsGroup().createLabelIterator();
+	return cmzn_nodeset_get_FE_nodeset_internal(nodeset)->getLabels().createLabelIterator();
+}
+
+/** @return  General real finite element field if field is one, otherwise 0. */
+FE_field *cmzn_field_get_general_real_FE_field(cmzn_field_id field)
+{
+	FE_field *feField = 0;
+	if (Computed_field_get_type_finite_element(field, &feField) && (feField)
+		&& (FE_VALUE_VALUE == get_FE_field_value_type(feField))
+		&& (GENERAL_FE_FIELD == get_FE_field_FE_field_type(feField)))
+	{
+		return feField;
+	}
+	return 0;
+}
+
+inline int nodeset_result_from_counts(int nodesCount, int definedCount)
+{
+	if (definedCount == nodesCount)
+		return CMZN_RESULT_OK;
+	if (definedCount > 0)
+		return CMZN_RESULT_WARNING_PART_DONE;
+	return CMZN_RESULT_ERROR_NOT_FOUND;
+}
+
+}
+
+int cmzn_field_evaluate_real_nodeset(cmzn_field_id field,
+	cmzn_fieldcache_id cache, cmzn_nodeset_id nodeset, int number_of_values,
+	double *values)
+{
+	DsLabelIterator *iter = cmzn_nodeset_create_label_iterator_for_real_values(
+		field, cache, nodeset, number_of_values, values);
+	if (!iter)
+	{
+		display_message(ERROR_MESSAGE, "Field evaluateRealNodeset.  Invalid argument(s)");
+		return CMZN_RESULT_ERROR_ARGUMENT;
+	}
+	FE_nodeset *fe_nodeset = cmzn_nodeset_get_FE_nodeset_internal(nodeset);
+	int nodesCount = 0;
+	int definedCount = 0;
+	int result = CMZN_RESULT_OK;
+	FE_field *feField = cmzn_field_get_general_real_FE_field(field);
+	if (feField)
+	{
+		FE_time_sequence_interpolation_cache::Scope timeScope(cache->getTimeSequenceInterpolationCache());
+		result = FE_nodeset_get_FE_field_FE_value_values(fe_nodeset, iter, feField,
+			cache->getTime(), number_of_values, values, &nodesCount, &definedCount);
+	}
+	else
+	{
+		// generic fallback: evaluate at each node in turn, restoring location afterwards
+		const int componentsCount = cmzn_field_get_number_of_components(field);
+		Field_location *savedLocation = cache->cloneLocation();
+		double *valuesOut = values;
+		DsLabelIndex nodeIndex;
+		while ((nodeIndex = iter->nextIndex()) != DS_LABEL_INDEX_INVALID)
+		{
+			cache->setNode(fe_nodeset->getNode(nodeIndex));
+			if (CMZN_RESULT_OK == cmzn_field_evaluate_real(field, cache, componentsCount, valuesOut))
+				++definedCount;
+			++nodesCount;
+			valuesOut += componentsCount;
+		}
+		cache->setLocation(savedLocation);
+	}
+	cmzn::Deaccess(iter);
+	if (CMZN_RESULT_OK != result)
+		return result;
+	return nodeset_result_from_counts(nodesCount, definedCount);
+}
+
+int cmzn_field_assign_real_nodeset(cmzn_field_id field,
+	cmzn_fieldcache_id cache, cmzn_nodeset_id nodeset, int number_of_values,
+	const double *values)
+{
+	DsLabelIterator *iter = cmzn_nodeset_create_label_iterator_for_real_values(
+		field, cache, nodeset, number_of_values, values);
+	if (!iter)
+	{
+		display_message(ERROR_MESSAGE, "Field assignRealNodeset.  Invalid argument(s)");
+		return CMZN_RESULT_ERROR_ARGUMENT;
+	}
+	FE_nodeset *fe_nodeset = cmzn_nodeset_get_FE_nodeset_internal(nodeset);
+	int nodesCount = 0;
+	int definedCount = 0;
+	int result = CMZN_RESULT_OK;
+	FE_field *feField = cmzn_field_get_general_real_FE_field(field);
+	if (feField)
+	{
+		result = FE_nodeset_set_FE_field_FE_value_values(fe_nodeset, iter, feField,
+			cache->getTime(), number_of_values, values, &nodesCount, &definedCount);
+	}
+	else
+	{
+		// generic fallback: assign at each node in turn, restoring location afterwards
+		const int componentsCount = cmzn_field_get_number_of_components(field);
+		cmzn_fieldmodule *fieldmodule = cmzn_field_get_fieldmodule(field);
+		cmzn_fieldmodule_begin_change(fieldmodule);
+		Field_location *savedLocation = cache->cloneLocation();
+		const double *valuesIn = values;
+		DsLabelIndex nodeIndex;
+		while ((nodeIndex = iter->nextIndex()) != DS_LABEL_INDEX_INVALID)
+		{
+			cache->setNode(fe_nodeset->getNode(nodeIndex));
+			if (CMZN_RESULT_OK == cmzn_field_assign_real(field, cache, componentsCount, valuesIn))
+				++definedCount;
+			++nodesCount;
+			valuesIn += componentsCount;
+		}
+		cache->setLocation(savedLocation);
+		cmzn_fieldmodule_end_change(fieldmodule);
+		cmzn_fieldmodule_destroy(&fieldmodule);
+	}
+	cmzn::Deaccess(iter);
+	if (CMZN_RESULT_OK != result)
+		return result;
+	return nodeset_result_from_counts(nodesCount, definedCount);
+}
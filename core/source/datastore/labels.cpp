@@ -12,7 +12,9 @@
 
 #include "opencmiss/zinc/status.h"
 #include "datastore/labels.hpp"
+#include "datastore/labelsgroup.hpp"
 #include "general/message.h"
+#include <algorithm>
 
 DsLabels::DsLabels() :
 	cmzn::RefCounted(),
@@ -30,6 +32,11 @@ DsLabels::~DsLabels()
 {
 	// can't free externally held objects, hence just invalidate for safety
 	this->invalidateLabelIterators();
+	for (std::vector<DsLabelsGroup *>::iterator iter = this->labelsGroups.begin();
+		iter != this->labelsGroups.end(); ++iter)
+	{
+		(*iter)->labels = 0;
+	}
 }
 
 /** restore to initial empty, contiguous state. Keeps current name, if any */
@@ -281,6 +288,7 @@ DsLabelIndex DsLabels::getFirstIndex() const
 
 DsLabelIterator *DsLabels::createLabelIterator(bool_array<DsLabelIndex> *condition) const
 {
+	std::lock_guard<std::mutex> lock(this->activeIteratorsMutex);
 	DsLabelIterator *iterator = new DsLabelIterator();
 	if (iterator)
 	{
@@ -301,12 +309,16 @@ void DsLabels::removeLabelIterator(DsLabelIterator *iterator) const
 {
 	if (iterator)
 	{
+		std::lock_guard<std::mutex> lock(this->activeIteratorsMutex);
 		if (iterator->previous)
 			iterator->previous->next = iterator->next;
 		else
 			this->activeIterators = iterator->next;
 		if (iterator->next)
 			iterator->next->previous = iterator->previous;
+		// identifier map iterator is also in a list in labels
+		delete iterator->iter;
+		iterator->iter = 0;
 		// Following not necessary since only called from ~DsLabelIterator:
 		//iterator->invalidate();
 	}
@@ -314,6 +326,7 @@ void DsLabels::removeLabelIterator(DsLabelIterator *iterator) const
 
 void DsLabels::invalidateLabelIterators()
 {
+	std::lock_guard<std::mutex> lock(this->activeIteratorsMutex);
 	DsLabelIterator *iterator = this->activeIterators;
 	DsLabelIterator *nextIterator;
 	while (iterator)
@@ -327,6 +340,7 @@ void DsLabels::invalidateLabelIterators()
 
 void DsLabels::invalidateLabelIteratorsWithCondition(bool_array<DsLabelIndex> *condition)
 {
+	std::lock_guard<std::mutex> lock(this->activeIteratorsMutex);
 	DsLabelIterator *iterator = this->activeIterators;
 	while (iterator)
 	{
@@ -373,6 +387,80 @@ int DsLabels::getIdentifierRanges(DsLabelIdentifierRanges& ranges) const
 	return CMZN_OK;
 }
 
+void DsLabels::addLabelsGroup(DsLabelsGroup *labelsGroup)
+{
+	std::lock_guard<std::mutex> lock(this->labelsGroupsMutex);
+	this->labelsGroups.push_back(labelsGroup);
+}
+
+void DsLabels::removeLabelsGroup(DsLabelsGroup *labelsGroup)
+{
+	std::lock_guard<std::mutex> lock(this->labelsGroupsMutex);
+	std::vector<DsLabelsGroup *>::iterator iter =
+		std::find(this->labelsGroups.begin(), this->labelsGroups.end(), labelsGroup);
+	if (iter != this->labelsGroups.end())
+		this->labelsGroups.erase(iter);
+}
+
+int DsLabels::permuteIndexes(const DsLabelIndex *newIndexes, bool keepIdentifiers)
+{
+	if (!newIndexes)
+		return CMZN_ERROR_ARGUMENT;
+	this->invalidateLabelIterators();
+	const DsLabelIndex oldIndexSize = this->indexSize;
+	int return_code = CMZN_OK;
+	if (keepIdentifiers)
+	{
+		DsLabelIdentifierArray newIdentifiers;
+		for (DsLabelIndex index = 0; index < oldIndexSize; ++index)
+		{
+			const DsLabelIdentifier identifier = this->getIdentifier(index);
+			if ((identifier >= 0) && (newIndexes[index] >= 0))
+			{
+				if (!newIdentifiers.setValue(newIndexes[index], identifier))
+				{
+					return_code = CMZN_ERROR_MEMORY;
+					break;
+				}
+			}
+		}
+		if (CMZN_OK == return_code)
+		{
+			this->identifierToIndexMap.clear();
+			this->identifiers.swap(newIdentifiers);
+			this->indexSize = this->labelsCount;
+			this->contiguous = false;
+			for (DsLabelIndex index = 0; index < this->indexSize; ++index)
+			{
+				if (!this->identifierToIndexMap.insert(*this, index))
+				{
+					display_message(ERROR_MESSAGE, "DsLabels::permuteIndexes.  Failed to insert index into map");
+					return_code = CMZN_ERROR_MEMORY;
+					break;
+				}
+			}
+		}
+	}
+	else
+	{
+		this->identifierToIndexMap.clear();
+		this->identifiers.clear();
+		this->contiguous = true;
+		this->indexSize = this->labelsCount;
+		this->firstIdentifier = 1;
+		this->lastIdentifier = this->labelsCount;
+		this->firstFreeIdentifier = this->labelsCount + 1;
+	}
+	std::lock_guard<std::mutex> lock(this->labelsGroupsMutex);
+	for (std::vector<DsLabelsGroup *>::iterator iter = this->labelsGroups.begin();
+		iter != this->labelsGroups.end(); ++iter)
+	{
+		if (!(*iter)->permuteIndexes(oldIndexSize, newIndexes))
+			return_code = CMZN_ERROR_MEMORY;
+	}
+	return return_code;
+}
+
 DsLabelIterator::DsLabelIterator() :
 	cmzn::RefCounted(),
 	labels(0),
@@ -420,6 +508,11 @@ void DsLabelIterator::setIndex(DsLabelIndex newIndex)
 		display_message(ERROR_MESSAGE, "DsLabelIterator::setIndex  Iterator has been invalidated");
 }
 
+size_t DsLabels::getAllocatedBytes() const
+{
+	return this->identifiers.getAllocatedBytes() + this->identifierToIndexMap.getAllocatedBytes();
+}
+
 void DsLabels::list_storage_details() const
 {
 	if (this->contiguous)
@@ -13,6 +13,7 @@
 #if !defined (CMZN_DATASTORE_LABELS_HPP)
 #define CMZN_DATASTORE_LABELS_HPP
 
+#include <mutex>
 #include <string>
 #include <vector>
 #include "general/block_array.hpp"
@@ -56,6 +57,8 @@ typedef cmzn_btree_index<DsLabels, DsLabelIndex, DsLabelIdentifier, DS_LABEL_IND
 
 class DsLabelIterator;
 
+class DsLabelsGroup;
+
 /**
  * A set of entries with unique identifiers, used to label nodes, elements,
  * field components etc. for indexing into a datastore map.
@@ -75,6 +78,12 @@ class DsLabels : public cmzn::RefCounted
 	// linked-lists of active iterators, to invalidate when labels set changes
 	// including eventually when defragmenting memory
 	mutable DsLabelIterator *activeIterators;
+	// guards activeIterators and active iterators in identifierToIndexMap as
+	// iterators are created and destroyed by concurrent evaluation threads
+	mutable std::mutex activeIteratorsMutex;
+	// groups of these labels, remapped when indexes are permuted
+	std::vector<DsLabelsGroup *> labelsGroups;
+	std::mutex labelsGroupsMutex;
 
 public:
 
@@ -193,6 +202,28 @@ public:
 
 	int getIdentifierRanges(DsLabelIdentifierRanges& ranges) const;
 
+	void addLabelsGroup(DsLabelsGroup *labelsGroup); // only used by DsLabelsGroup constructor
+
+	void removeLabelsGroup(DsLabelsGroup *labelsGroup); // only used by ~DsLabelsGroup
+
+	/**
+	 * Move labels to new indexes, compacting out unused indexes. Also remaps
+	 * all groups of these labels, including change logs. Invalidates all
+	 * iterators. Caller must permute all other data indexed by these labels.
+	 * @param newIndexes  Array of getIndexSize() new indexes for each old
+	 * index, giving each valid label a unique new index from 0 to
+	 * getSize() - 1, and DS_LABEL_INDEX_INVALID for unused indexes.
+	 * @param keepIdentifiers  If true, labels keep their identifiers. If false,
+	 * identifiers are renumbered from 1 in new index order.
+	 * @return  CMZN_OK on success, any other error code on failure.
+	 */
+	int permuteIndexes(const DsLabelIndex *newIndexes, bool keepIdentifiers);
+
+	/** @return  Bytes allocated for identifiers array and identifier-to-index
+	  * btree, which are only used if not contiguous. Excludes allocator
+	  * overheads. */
+	size_t getAllocatedBytes() const;
+
 	void list_storage_details() const;
 };
 
@@ -46,6 +46,17 @@ void DsLabelsChangeLog::setIndexChange(DsLabelIndex index, int change)
 	}
 }
 
+void DsLabelsChangeLog::setIndexRangeChange(DsLabelIndex minIndex, DsLabelIndex maxIndex, int change)
+{
+	this->changeSummary |= change;
+	if (!this->allChange)
+	{
+		const int result = DsLabelsGroup::addIndexRange(minIndex, maxIndex);
+		if ((result != CMZN_OK) || ((this->maxChanges >= 0) && (this->getSize() > this->maxChanges)))
+			this->setAllChange(this->changeSummary);
+	}
+}
+
 void DsLabelsChangeLog::setAllChange(int change)
 {
 	this->allChange = true;
@@ -99,6 +99,14 @@ public:
 	 */
 	void setIndexChange(DsLabelIndex index, int change);
 
+	/**
+	 * Set all indexes in range as having the change. Faster than setting
+	 * each index in turn, e.g. for labels added together.
+	 * @param minIndex, maxIndex  Valid range of indexes for this labels object.
+	 * @param change  A value / logical OR of values from enum DsLabelChangeType
+	 */
+	void setIndexRangeChange(DsLabelIndex minIndex, DsLabelIndex maxIndex, int change);
+
 	/**
 	 * @return  True if index is flagged as having a change, or all change flag set.
 	 * @param index  A valid index for this labels object.
@@ -18,12 +18,17 @@ DsLabelsGroup::DsLabelsGroup(DsLabels *labelsIn) :
 	labelsCount(0),
 	indexLimit(0)
 {
+	if (this->labels)
+		this->labels->addLabelsGroup(this);
 };
 
 DsLabelsGroup::~DsLabelsGroup()
 {
 	if (this->labels)
+	{
 		this->labels->invalidateLabelIteratorsWithCondition(&(this->values));
+		this->labels->removeLabelsGroup(this);
+	}
 }
 
 DsLabelsGroup *DsLabelsGroup::create(DsLabels *labelsIn)
@@ -81,6 +86,55 @@ int DsLabelsGroup::setIndex(DsLabelIndex index, bool inGroup)
 	return CMZN_ERROR_MEMORY;
 }
 
+int DsLabelsGroup::addIndexRange(DsLabelIndex minIndex, DsLabelIndex maxIndex)
+{
+	if ((minIndex < 0) || (maxIndex < minIndex))
+	{
+		display_message(ERROR_MESSAGE, "DsLabelsGroup::addIndexRange.  Invalid argument");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	DsLabelIndex newCount = 0;
+	if (!values.setRangeTrue(minIndex, maxIndex, newCount))
+	{
+		display_message(ERROR_MESSAGE, "DsLabelsGroup::addIndexRange.  Failed to set bools");
+		return CMZN_ERROR_MEMORY;
+	}
+	labelsCount += newCount;
+	if (maxIndex >= indexLimit)
+		indexLimit = maxIndex + 1;
+	return CMZN_OK;
+}
+
+bool DsLabelsGroup::permuteIndexes(DsLabelIndex oldIndexSize, const DsLabelIndex *newIndexes)
+{
+	bool_array<DsLabelIndex> newValues;
+	int newLabelsCount = 0;
+	DsLabelIndex newIndexLimit = 0;
+	bool success = true;
+	// labels index size is already updated so iterate to old size
+	DsLabelIndex index = 0;
+	for (; this->values.advanceIndexWhileFalse(index, oldIndexSize); ++index)
+	{
+		const DsLabelIndex newIndex = newIndexes[index];
+		if (newIndex >= 0)
+		{
+			bool oldValue;
+			if (!newValues.setBool(newIndex, true, oldValue))
+			{
+				success = false;
+				break;
+			}
+			++newLabelsCount;
+			if (newIndex >= newIndexLimit)
+				newIndexLimit = newIndex + 1;
+		}
+	}
+	this->values.swap(newValues);
+	this->labelsCount = newLabelsCount;
+	this->indexLimit = newIndexLimit;
+	return success;
+}
+
 /**
  * Get first label index in group or DS_LABEL_INDEX_INVALID if none.
  * Currently returns index with the lowest identifier in set.
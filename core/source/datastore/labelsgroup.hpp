@@ -20,6 +20,8 @@
  */
 class DsLabelsGroup : public cmzn::RefCounted
 {
+	friend class DsLabels;
+
 protected:
 	DsLabels *labels;
 	// Note: ensure all members are transferred by swap() method
@@ -51,6 +53,13 @@ public:
 		return labelsCount;
 	}
 
+	/** @return  Bytes allocated for the group membership bits. Excludes
+	  * allocator overheads. */
+	size_t getAllocatedBytes() const
+	{
+		return this->values.getAllocatedBytes();
+	}
+
 	DsLabelIndex getIndexLimit()
 	{
 		if (indexLimit > 0)
@@ -93,6 +102,13 @@ public:
 	 */
 	int setIndex(DsLabelIndex index, bool inGroup);
 
+	/**
+	 * Ensure all indexes from minIndex to maxIndex inclusive are in the group.
+	 * Be careful that indexes are for this labels.
+	 * @return  CMZN_OK on success, any other error code on failure.
+	 */
+	int addIndexRange(DsLabelIndex minIndex, DsLabelIndex maxIndex);
+
 	DsLabelIndex getFirstIndex(DsLabelIterator &iterator);
 
 	/**
@@ -117,6 +133,13 @@ public:
 		this->labels->invalidateLabelIteratorsWithCondition(&(this->values));
 	}
 
+private:
+
+	/** Move indexes in group to new indexes. Only called by owning labels.
+	 * @see DsLabels::permuteIndexes
+	 * @return  True on success, false if failed. */
+	bool permuteIndexes(DsLabelIndex oldIndexSize, const DsLabelIndex *newIndexes);
+
 };
 
 #endif /* !defined (CMZN_DATASTORE_LABELSGROUP_HPP) */
@@ -15,6 +15,8 @@
 
 #include "datastore/labels.hpp"
 #include "general/block_array.hpp"
+#include <cstdio>
+#include <string>
 
 // IndexType is normally DsLabelIndex, but must be raised to 64-bit integer
 // once arraySize*number-of-labels exceeds 2^31.
@@ -40,9 +42,10 @@ public:
 	DsMapArray(DsLabels *labelsIn, DsLabelIndex arraySizeIn, ValueType unallocatedValueIn = 0, ValueType initValueIn = 0) :
 		labels(Access(labelsIn)),
 		// array blocks must be multiple of arraySize
-		// use exact size if large enough to prevent wastage when sparse
+		// pack arrays into blocks of at least the default size so there is not
+		// one heap block per index; use exact size only for larger arrays
 		arraySize(static_cast<IndexType>(arraySizeIn)),
-		arraysPerBlock(arraySizeIn*sizeof(ValueType) >= 128 ? 1 :
+		arraysPerBlock(arraySizeIn*sizeof(ValueType) >= CMZN_BLOCK_ARRAY_DEFAULT_BLOCK_SIZE_BYTES ? 1 :
 			(CMZN_BLOCK_ARRAY_DEFAULT_BLOCK_SIZE_BYTES / (arraySizeIn*sizeof(ValueType)))),
 		values(arraysPerBlock*arraySizeIn, initValueIn),
 		unallocatedValue(unallocatedValueIn),
@@ -100,7 +103,7 @@ public:
 	/**
 	 * @return  Address of array for the given labels index, or 0 if unallocated.
 	 */
-	ValueType *getArray(DsLabelIndex index) const
+	ValueType *getArray(DsLabelIndex index)
 	{
 		const IndexType arrayIndex = index*this->arraySize;
 		ValueType *array = this->values.getAddress(arrayIndex);
@@ -109,6 +112,19 @@ public:
 		return 0;
 	}
 
+	/**
+	 * @return  Address of array for reading only for the given labels index,
+	 * or 0 if unallocated.
+	 */
+	const ValueType *getArray(DsLabelIndex index) const
+	{
+		const IndexType arrayIndex = index*this->arraySize;
+		const ValueType *array = this->values.getAddress(arrayIndex);
+		if (array && (*array != this->unallocatedValue))
+			return array;
+		return 0;
+	}
+
 	/**
 	 * @return address of existing or new array for the given labels index, or 0 if failed.
 	 */
@@ -125,6 +141,75 @@ public:
 		return array;
 	}
 
+	IndexType getArraySize() const
+	{
+		return this->arraySize;
+	}
+
+	/** @return  Number of indexes with arrays allocated, scanning all blocks. */
+	DsLabelIndex getAllocatedArrayCount() const
+	{
+		DsLabelIndex allocatedArrayCount = 0;
+		const DsLabelIndex indexLimit = this->values.getBlockCount()*this->arraysPerBlock;
+		for (DsLabelIndex index = 0; index < indexLimit; ++index)
+		{
+			if (this->getArray(index))
+				++allocatedArrayCount;
+		}
+		return allocatedArrayCount;
+	}
+
+	/**
+	 * Move arrays to new indexes, e.g. when labels are reordered. Storage is
+	 * only allocated for new indexes receiving an array.
+	 * @param oldIndexCount  Size of newIndexes array. Arrays at or beyond
+	 * this index are cleared.
+	 * @param newIndexes  New index for array at each old index, or negative
+	 * to clear it. Must not map two old indexes to the same new index.
+	 * @return  True on success, false on failure in which case arrays moved
+	 * so far are lost.
+	 */
+	bool permute(DsLabelIndex oldIndexCount, const DsLabelIndex *newIndexes)
+	{
+		block_array<IndexType, ValueType> permuted(this->values.getBlockLength(), this->initValue);
+		bool success = true;
+		const DsLabelIndex indexLimit = this->values.getBlockCount()*this->arraysPerBlock;
+		const DsMapArray& constThis = *this; // reads must not copy shared blocks
+		for (DsLabelIndex index = 0; (index < indexLimit) && (index < oldIndexCount); ++index)
+		{
+			const ValueType *array = constThis.getArray(index);
+			if ((!array) || (newIndexes[index] < 0))
+				continue;
+			const IndexType newArrayIndex = newIndexes[index]*this->arraySize;
+			ValueType *newArray = permuted.getOrCreateAddressArrayInit(newArrayIndex, this->unallocatedValue, this->arraySize);
+			if (!newArray)
+			{
+				success = false;
+				break;
+			}
+			memcpy(newArray, array, this->arraySize*sizeof(ValueType));
+		}
+		this->values.swap(permuted);
+		return success;
+	}
+
+	/** @return  Bytes allocated for array storage. */
+	size_t getAllocatedBytes() const
+	{
+		return this->values.getAllocatedBytes();
+	}
+
+	/** @return  Summary of storage for listing: number of arrays allocated,
+	  * array size and bytes allocated. */
+	std::string getStorageDetails() const
+	{
+		char details[100];
+		snprintf(details, sizeof(details), "%d arrays of %d, %lu bytes",
+			static_cast<int>(this->getAllocatedArrayCount()), static_cast<int>(this->arraySize),
+			static_cast<unsigned long>(this->getAllocatedBytes()));
+		return std::string(details);
+	}
+
 	/* get the highest index data is held for, minimum from allocated blocks or labels size */
 	DsLabelIndex getIndexLimit() const
 	{
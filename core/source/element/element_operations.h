@@ -20,6 +20,7 @@ therefore cannot reside in finite element modules.
 #include "opencmiss/zinc/types/nodesetid.h"
 #include "computed_field/computed_field.h"
 #include "finite_element/finite_element.h"
+#include "finite_element/xi_point_set.hpp"
 #include "finite_element/finite_element_region.h"
 #include "general/multi_range.h"
 #include "selection/element_point_ranges_selection.h"
@@ -36,6 +37,7 @@ protected:
 	int numPoints;
 	FE_value *points;
 	FE_value *weights;
+	FE_xi_point_set *xiPointSet; // tabulates basis functions at points, if any
 
 public:
 	typedef bool (*InvokeFunction)(void *, FE_value *xi, FE_value weight);
@@ -47,7 +49,8 @@ public:
 		dimension(get_FE_element_shape_dimension(shapeIn)),
 		numPoints(numPointsIn),
 		points(pointsIn),
-		weights(weightsIn)
+		weights(weightsIn),
+		xiPointSet(pointsIn ? new FE_xi_point_set(this->dimension, numPointsIn, pointsIn) : 0)
 	{
 		for (int i = 0; i < this->dimension; ++i)
 			this->numbersOfPoints[i] = numbersOfPointsIn[i];
@@ -56,6 +59,7 @@ public:
 	virtual ~IntegrationShapePoints()
 	{
 		DEACCESS(FE_element_shape)(&this->shape);
+		delete this->xiPointSet;
 		delete[] this->points;
 		delete[] this->weights;
 	}
@@ -72,14 +76,20 @@ public:
 		*weight = this->weights[index];
 	}
 
+	/** Calls term for each point with its xi and weight. Where points are
+	 * stored, term.setXiPoint is called first with the point set and index so
+	 * the term can evaluate fields with basis functions tabulated at the points. */
 	template<class IntegralTerm>
 		void forEachPoint(IntegralTerm& term)
 	{
 		if (this->points)
 		{
 			for (int i = 0; i < this->numPoints; ++i)
+			{
+				term.setXiPoint(this->xiPointSet, i);
 				if (!term(points + i*dimension, weights[i]))
 					return;
+			}
 		}
 		else
 			this->forEachPointVirtual(IntegralTerm::invoke, (void*)&term);
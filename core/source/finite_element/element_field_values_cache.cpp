@@ -0,0 +1,214 @@
+/**
+ * FILE : element_field_values_cache.cpp
+ *
+ * Size-bounded least-recently-used cache of FE_element_field_values shared by
+ * all field caches of a region.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "opencmiss/zinc/status.h"
+#include "datastore/labelschangelog.hpp"
+#include "finite_element/element_field_values_cache.hpp"
+#include "finite_element/finite_element.h"
+#include "finite_element/finite_element_mesh.hpp"
+#include "finite_element/finite_element_region.h"
+#include "general/message.h"
+
+FE_element_field_values_cache::FE_element_field_values_cache(int capacityIn) :
+	size(0),
+	capacity((capacityIn > 0) ? capacityIn : defaultCapacity)
+{
+}
+
+FE_element_field_values_cache::~FE_element_field_values_cache()
+{
+	this->clear();
+}
+
+void FE_element_field_values_cache::removeEntry(Shard& shard, EntryList::iterator iter)
+{
+	shard.entryMap.erase(iter->key);
+	DEACCESS(FE_element_field_values)(&(iter->values));
+	shard.entries.erase(iter);
+	--(this->size);
+}
+
+void FE_element_field_values_cache::trimToCapacity()
+{
+	while (this->size > this->capacity)
+	{
+		// find shard with least recently used last entry, locking one at a time
+		Shard *oldestShard = 0;
+		Clock::rep oldestLastUsed = 0;
+		for (int i = 0; i < shardCount; ++i)
+		{
+			Shard& shard = this->shards[i];
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			if ((!shard.entries.empty()) &&
+				((!oldestShard) || (shard.entries.back().lastUsed < oldestLastUsed)))
+			{
+				oldestShard = &shard;
+				oldestLastUsed = shard.entries.back().lastUsed;
+			}
+		}
+		if (!oldestShard)
+			break;
+		std::lock_guard<std::mutex> lock(oldestShard->mutex);
+		// another thread may have used or removed it in the meantime
+		if ((!oldestShard->entries.empty()) && (oldestShard->entries.back().lastUsed == oldestLastUsed))
+			this->removeEntry(*oldestShard, --(oldestShard->entries.end()));
+	}
+}
+
+FE_element_field_values *FE_element_field_values_cache::find(cmzn_element *element,
+	FE_field *field, FE_value time, cmzn_element *topLevelElement, bool derivatives)
+{
+	Shard& shard = this->getShard(element, field);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	// try time independent values first as most fields do not vary with time
+	EntryMap::iterator mapIter = shard.entryMap.find(
+		Key(element, field, topLevelElement, /*timeDependent*/false, time));
+	if (mapIter == shard.entryMap.end())
+		mapIter = shard.entryMap.find(Key(element, field, topLevelElement, /*timeDependent*/true, time));
+	if ((mapIter != shard.entryMap.end()) && ((!derivatives) ||
+		FE_element_field_values_have_derivatives_calculated(mapIter->second->values)))
+	{
+		EntryList::iterator iter = mapIter->second;
+		if (iter != shard.entries.begin())
+			shard.entries.splice(shard.entries.begin(), shard.entries, iter);
+		iter->lastUsed = Clock::now().time_since_epoch().count();
+		++(shard.hits);
+		return ACCESS(FE_element_field_values)(iter->values);
+	}
+	++(shard.misses);
+	return 0;
+}
+
+void FE_element_field_values_cache::add(cmzn_element *element, FE_field *field,
+	FE_value time, cmzn_element *topLevelElement, FE_element_field_values *values)
+{
+	if (!((element) && (field) && (values)))
+	{
+		display_message(ERROR_MESSAGE, "FE_element_field_values_cache::add.  Invalid argument(s)");
+		return;
+	}
+	const Key key(element, field, topLevelElement,
+		FE_element_field_values_is_time_dependent(values), time);
+	Shard& shard = this->getShard(element, field);
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		EntryMap::iterator mapIter = shard.entryMap.find(key);
+		if (mapIter != shard.entryMap.end())
+			this->removeEntry(shard, mapIter->second);
+		shard.entries.push_front(Entry(key, ACCESS(FE_element_field_values)(values)));
+		shard.entryMap[key] = shard.entries.begin();
+		++(this->size);
+	}
+	this->trimToCapacity();
+}
+
+void FE_element_field_values_cache::clear()
+{
+	for (int i = 0; i < shardCount; ++i)
+	{
+		Shard& shard = this->shards[i];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		for (EntryList::iterator iter = shard.entries.begin(); iter != shard.entries.end(); ++iter)
+			DEACCESS(FE_element_field_values)(&(iter->values));
+		this->size -= static_cast<int>(shard.entries.size());
+		shard.entries.clear();
+		shard.entryMap.clear();
+		shard.hits = 0;
+		shard.misses = 0;
+	}
+}
+
+void FE_element_field_values_cache::removeField(FE_field *field)
+{
+	for (int i = 0; i < shardCount; ++i)
+	{
+		Shard& shard = this->shards[i];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		EntryList::iterator iter = shard.entries.begin();
+		while (iter != shard.entries.end())
+		{
+			if (iter->key.field == field)
+				this->removeEntry(shard, iter++);
+			else
+				++iter;
+		}
+	}
+}
+
+void FE_element_field_values_cache::invalidate(FE_region_changes *changes)
+{
+	if (!changes)
+		return;
+	struct CHANGE_LOG(FE_field) *fieldChanges = changes->getFieldChanges();
+	for (int i = 0; i < shardCount; ++i)
+	{
+		Shard& shard = this->shards[i];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		EntryList::iterator iter = shard.entries.begin();
+		while (iter != shard.entries.end())
+		{
+			bool remove = true;
+			int change = CHANGE_LOG_OBJECT_UNCHANGED(FE_field);
+			CHANGE_LOG_QUERY(FE_field)(fieldChanges, iter->key.field, &change);
+			if (0 == (change & ~CHANGE_LOG_OBJECT_IDENTIFIER_CHANGED(FE_field)))
+			{
+				remove = false;
+			}
+			else if ((change == CHANGE_LOG_RELATED_OBJECT_CHANGED(FE_field)) &&
+				(GENERAL_FE_FIELD == get_FE_field_FE_field_type(iter->key.field)))
+			{
+				// only parameters changed: keep if element, its nodes and parents unchanged
+				cmzn_element *element = iter->key.element;
+				const DsLabelIndex elementIndex = element->getIndex();
+				if (DS_LABEL_INDEX_INVALID != elementIndex)
+				{
+					const int dimension = element->getDimension();
+					changes->propagateToDimension(dimension);
+					DsLabelsChangeLog *elementChangeLog = changes->getElementChangeLog(dimension);
+					remove = (!elementChangeLog) || elementChangeLog->isIndexChange(elementIndex);
+				}
+			}
+			if (remove)
+				this->removeEntry(shard, iter++);
+			else
+				++iter;
+		}
+	}
+}
+
+int FE_element_field_values_cache::setCapacity(int capacityIn)
+{
+	if (capacityIn <= 0)
+		return CMZN_ERROR_ARGUMENT;
+	this->capacity = capacityIn;
+	this->trimToCapacity();
+	return CMZN_OK;
+}
+
+int FE_element_field_values_cache::getSize() const
+{
+	return this->size;
+}
+
+void FE_element_field_values_cache::getStatistics(int& sizeOut, int& hitsOut, int& missesOut)
+{
+	sizeOut = this->size;
+	hitsOut = 0;
+	missesOut = 0;
+	for (int i = 0; i < shardCount; ++i)
+	{
+		Shard& shard = this->shards[i];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		hitsOut += shard.hits;
+		missesOut += shard.misses;
+	}
+}
@@ -0,0 +1,194 @@
+/**
+ * FILE : element_field_values_cache.hpp
+ *
+ * Size-bounded least-recently-used cache of FE_element_field_values shared by
+ * all field caches of a region.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (CMZN_ELEMENT_FIELD_VALUES_CACHE_HPP)
+#define CMZN_ELEMENT_FIELD_VALUES_CACHE_HPP
+
+#include "general/value.h"
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+#include <mutex>
+
+struct cmzn_element;
+struct FE_element_field_values;
+struct FE_field;
+class FE_region_changes;
+
+/**
+ * Cache of element field values, the interpolation data calculated for a
+ * finite element field on an element, which are expensive to calculate.
+ * Entries are keyed by element, field, optional top-level element the field is
+ * inherited from, and time for time-varying fields only. Entries with
+ * derivatives calculated also serve requests for values only.
+ * Entries are split between shards by element and field, each with its own
+ * mutex, least recently used order and statistics, so concurrent threads
+ * switching elements rarely wait for each other. Once capacity is exceeded
+ * the least recently used entry over all shards is discarded.
+ * Cached element field values must not be modified once added as they may be
+ * in use by several field caches in concurrent threads.
+ * Owned by FE_region; entries are invalidated from region changes.
+ */
+class FE_element_field_values_cache
+{
+public:
+
+	static const int defaultCapacity = 10000;
+
+private:
+
+	struct Key
+	{
+		cmzn_element *element;
+		FE_field *field;
+		cmzn_element *topLevelElement;
+		bool timeDependent;
+		FE_value time; // only used if timeDependent
+
+		Key(cmzn_element *elementIn, FE_field *fieldIn, cmzn_element *topLevelElementIn,
+				bool timeDependentIn, FE_value timeIn) :
+			element(elementIn),
+			field(fieldIn),
+			topLevelElement(topLevelElementIn),
+			timeDependent(timeDependentIn),
+			time(timeDependentIn ? timeIn : 0.0)
+		{
+		}
+
+		bool operator<(const Key& other) const
+		{
+			if (this->element != other.element)
+				return this->element < other.element;
+			if (this->field != other.field)
+				return this->field < other.field;
+			if (this->topLevelElement != other.topLevelElement)
+				return this->topLevelElement < other.topLevelElement;
+			if (this->timeDependent != other.timeDependent)
+				return this->timeDependent < other.timeDependent;
+			return this->time < other.time;
+		}
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	struct Entry
+	{
+		Key key;
+		FE_element_field_values *values; // accessed
+		Clock::rep lastUsed; // time last found or added, to compare entries of different shards
+
+		Entry(const Key& keyIn, FE_element_field_values *valuesIn) :
+			key(keyIn),
+			values(valuesIn),
+			lastUsed(Clock::now().time_since_epoch().count())
+		{
+		}
+	};
+
+	typedef std::list<Entry> EntryList;
+	typedef std::map<Key, EntryList::iterator> EntryMap;
+
+	struct Shard
+	{
+		EntryList entries; // most recently used first
+		EntryMap entryMap;
+		int hits;
+		int misses;
+		std::mutex mutex;
+
+		Shard() :
+			hits(0),
+			misses(0)
+		{
+		}
+	};
+
+	static const int shardCount = 16;
+
+	Shard shards[shardCount];
+	std::atomic<int> size; // total entries in all shards
+	std::atomic<int> capacity;
+
+	FE_element_field_values_cache(const FE_element_field_values_cache&); // not implemented
+	FE_element_field_values_cache& operator=(const FE_element_field_values_cache&); // not implemented
+
+	Shard& getShard(cmzn_element *element, FE_field *field)
+	{
+		const size_t hash = (reinterpret_cast<size_t>(element)/sizeof(void *))*31 +
+			reinterpret_cast<size_t>(field)/sizeof(void *);
+		return this->shards[hash % shardCount];
+	}
+
+	/** Caller must hold shard mutex */
+	void removeEntry(Shard& shard, EntryList::iterator iter);
+
+	/** Remove least recently used entries over all shards until within
+	  * capacity. Caller must not hold any shard mutex. */
+	void trimToCapacity();
+
+public:
+
+	FE_element_field_values_cache(int capacityIn = defaultCapacity);
+
+	~FE_element_field_values_cache();
+
+	/**
+	 * Find element field values valid for evaluating field in element at time.
+	 * Records a hit or miss.
+	 * @param topLevelElement  Optional element field is inherited from.
+	 * @param derivatives  Set if values must have derivatives calculated.
+	 * @return  Accessed element field values or 0 if none cached.
+	 */
+	FE_element_field_values *find(cmzn_element *element, FE_field *field,
+		FE_value time, cmzn_element *topLevelElement, bool derivatives);
+
+	/**
+	 * Add element field values calculated for element and field, replacing any
+	 * existing entry for the same key. Values must not be modified afterwards.
+	 * @param topLevelElement  Top-level element passed when calculating values.
+	 */
+	void add(cmzn_element *element, FE_field *field, FE_value time,
+		cmzn_element *topLevelElement, FE_element_field_values *values);
+
+	/** Remove all entries and reset statistics */
+	void clear();
+
+	/** Remove all entries for field, e.g. so it is no longer accessed */
+	void removeField(FE_field *field);
+
+	/**
+	 * Remove entries for changed fields. Entries for fields whose only change
+	 * is to related node or element parameters are removed only if their
+	 * element, its nodes or the element it inherits the field from changed.
+	 */
+	void invalidate(FE_region_changes *changes);
+
+	int getCapacity() const
+	{
+		return this->capacity;
+	}
+
+	/** @param capacityIn  Maximum number of entries > 0. Excess least recently
+	  * used entries are removed.
+	  * @return  Result OK on success, ERROR_ARGUMENT if invalid capacity */
+	int setCapacity(int capacityIn);
+
+	/** @return  Number of entries currently cached */
+	int getSize() const;
+
+	/** Get number of entries and counts of lookups finding and not finding an
+	  * entry since creation or last clear */
+	void getStatistics(int& sizeOut, int& hitsOut, int& missesOut);
+
+};
+
+#endif /* !defined (CMZN_ELEMENT_FIELD_VALUES_CACHE_HPP) */
@@ -12,9 +12,14 @@
 /*???DB.  Testing */
 #define DOUBLE_FOR_DOT_PRODUCT
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdlib>
 #include <cstdio>
+#include <map>
+#include <memory>
+#include <new>
 #include <vector>
 
 #include "opencmiss/zinc/element.h"
@@ -28,6 +33,7 @@
 #include "finite_element/finite_element_nodeset.hpp"
 #include "finite_element/finite_element_private.h"
 #include "finite_element/finite_element_region_private.h"
+#include "finite_element/xi_point_set.hpp"
 #include "general/change_log_private.h"
 #include "general/compare.h"
 #include "general/debug.h"
@@ -134,8 +140,9 @@ the point and the Xi coordinates of the point within the element.
 	/* the number of computed fields wrapping this FE_field */
 	int number_of_wrappers;
 	/* the number of structures that point to this field.  The field cannot be
-		destroyed while this is greater than 0 */
-	int access_count;
+		destroyed while this is greater than 0. Atomic as accessed by concurrent
+		evaluation of element field values */
+	std::atomic<int> access_count;
 
 	inline FE_field *access()
 	{
@@ -226,6 +233,22 @@ struct FE_node_field_info
 
 FULL_DECLARE_LIST_TYPE(FE_node_field_info);
 
+/**
+ * Plan for gathering the element parameters of a field component using an
+ * element field template, cached with the mesh element field template data
+ * for a node field info and the generation of its nodeset's node field infos.
+ * Valid for any element whose local nodes all have that node field info,
+ * so that the node value index of each term and the offset of the component
+ * values in the node values storage can be looked up once.
+ */
+struct FE_element_field_gather_plan
+{
+	int valuesOffset; // offset of field component values in node values_storage
+	FE_time_sequence *timeSequence; // not accessed; owned by node field
+	std::vector<int> localNodeIndexes; // unique local nodes used by terms
+	std::vector<int> termValueIndexes; // index of each term's value in component values
+};
+
 struct FE_node
 /*******************************************************************************
 LAST MODIFIED : 11 February 2003
@@ -237,8 +260,9 @@ DESCRIPTION :
 	DsLabelIndex index;
 
 	/* the number of structures that point to this node.  The node cannot be
-	   destroyed while this is greater than 0 */
-	int access_count;
+	   destroyed while this is greater than 0. Atomic as accessed by concurrent
+	   evaluation at nodes and of element field values */
+	std::atomic<int> access_count;
 
 	/* the fields defined at the node */
 	struct FE_node_field_info *fields;
@@ -339,19 +363,18 @@ calculated from the element field as required and are then destroyed.
 		 top_level_elements. For faces and lines these values are adjusted to get
 		 the correct index for the top_level_element */
 	int *component_base_grid_offset,**component_grid_offset_in_xi;
-	/* following allocated with 2^number_of_xi for grid-based fields for use in
-		 calculate_FE_element_field */
-	int *element_value_offsets;
 	/* the values for each component */
 	FE_value **component_values;
 	/* the standard basis function for each component */
 	Standard_basis_function **component_standard_basis_functions;
 	/* the arguments for the standard basis function for each component */
 	int **component_standard_basis_function_arguments;
-	/* working space for evaluating basis */
-	FE_value *basis_function_values;
+	/* size of working space needed for evaluating basis. Working space is
+		 thread local so these values may be shared by concurrent evaluations */
+	int basis_function_values_size;
 
-	int access_count;
+	/* atomic as shared element field values may be accessed from many threads */
+	std::atomic<int> access_count;
 }; /* struct FE_element_field_values */
 
 FULL_DECLARE_INDEXED_LIST_TYPE(FE_element_field_values);
@@ -600,45 +623,6 @@ cmzn_element *FE_field::getOrInheritOnElement(cmzn_element *element,
 }
 
 
-/**
- * @see struct FE_element_type_node_sequence.
- */
-struct FE_element_type_node_sequence_identifier
-{
-	/* node_numbers must be ordered from lowest to highest to work! */
-	int *node_numbers,number_of_nodes;
-};
-
-struct FE_element_type_node_sequence
-/*******************************************************************************
-LAST MODIFIED : 30 April 1999
-
-DESCRIPTION :
-Structure for storing an element with its identifier being its cm_type and the
-number and list - in ascending order - of the nodes referred to by the default
-coordinate field of the element. Indexed lists, indexed using function
-compare_FE_element_type_node_sequence_identifier ensure that recalling a line or
-face with the same nodes is extremely rapid. FE_mesh
-uses them to find faces and lines for elements without them, if they exist.
-
-???RC Can only match faces correctly for coordinate fields with standard node
-to element maps and no versions. A grid-based coordinate field would fail
-utterly since it has no nodes. A possible future solution for all cases is to
-match the geometry exactly either by using the FE_element_field_values
-(coefficients of the monomial basis functions), although there is a problem with
-xi-directions not matching up, or actual centre positions of the face being a
-trivial rejection, narrowing down to a single face or list of faces to compare
-against.
-==============================================================================*/
-{
-	struct FE_element_type_node_sequence_identifier identifier;
-	struct FE_element *element;
-	int dimension; // can be different from element dimension if created with face number
-	int access_count;
-}; /* struct FE_element_line_face_node_sequence */
-
-FULL_DECLARE_INDEXED_LIST_TYPE(FE_element_type_node_sequence);
-
 struct FE_node_field_iterator_and_data
 {
 	FE_node_field_iterator_function *iterator;
@@ -3351,6 +3335,8 @@ int DESTROY(FE_node_field_info)(
 	{
 		if (0 == node_field_info->access_count)
 		{
+			if (node_field_info->fe_nodeset)
+				node_field_info->fe_nodeset->nodeFieldInfoChange();
 			DESTROY(LIST(FE_node_field))(&(node_field_info->node_field_list));
 			DEALLOCATE(*node_field_info_address);
 			return_code = 1;
@@ -3657,6 +3643,8 @@ is known to be the only object using this field info.
 		if (ADD_OBJECT_TO_LIST(FE_node_field)(new_node_field,
 				fe_node_field_info->node_field_list))
 		{
+			if (fe_node_field_info->fe_nodeset)
+				fe_node_field_info->fe_nodeset->nodeFieldInfoChange();
 			fe_node_field_info->number_of_values = new_number_of_values;
 			FE_node_field_add_values_storage_size(
 				new_node_field, (void *)&fe_node_field_info->values_storage_size);
@@ -3778,266 +3766,42 @@ in <fe_field_change_log>.
 	return (return_code);
 } /* FE_node_field_info_log_FE_field_changes */
 
-/**
- * Compare functions for listing struct FE_element_type_node_sequence in order:
- * - number_of_nodes changing slowest;
- * - node numbers in numerical order (nodes must be in ascending order).
- * Returns values like strcmp:
- * -1 = identifier 1 < identifier 2
- * 0 = identifier 1 = identifier 2
- * 1 = identifier 1 > identifier 2
- */
-static int compare_FE_element_type_node_sequence_identifier(
-	FE_element_type_node_sequence_identifier &identifier1,
-	FE_element_type_node_sequence_identifier &identifier2)
+int calculate_FE_element_sorted_node_identifiers(struct FE_element *element,
+	int face_number, std::vector<int>& nodeIdentifiers)
 {
-	/* 1. compare number_of_nodes */
-	int number_of_nodes = identifier1.number_of_nodes;
-	if (number_of_nodes < identifier2.number_of_nodes)
-	{
-		return -1;
-	}
-	else if (number_of_nodes > identifier2.number_of_nodes)
-	{
-		return 1;
-	}
-	else
-	{
-		/* 2. compare node_numbers - assumed in ascending order */
-		for (int i = 0; i < number_of_nodes; ++i)
-		{
-			if (identifier1.node_numbers[i] < identifier2.node_numbers[i])
-			{
-				return -1;
-			}
-			else if (identifier1.node_numbers[i] > identifier2.node_numbers[i])
-			{
-				return 1;
-			}
-		}
-	}
-	return 0;
-}
-
-struct FE_element_type_node_sequence *CREATE(FE_element_type_node_sequence)(
-	int &result, struct FE_element *element, int face_number)
-{
-	result = CMZN_OK;
-	int i,node_number,*node_numbers,number_of_nodes,placed,j,k;
-	struct FE_element_type_node_sequence *element_type_node_sequence;
-	struct FE_node **nodes_in_element;
-
-	if (element)
-	{
-		/* get list of nodes used by default coordinate field in element/face */
-		result = calculate_FE_element_field_nodes(element, face_number,
-			(struct FE_field *)NULL, &number_of_nodes, &nodes_in_element,
-			/*top_level_element*/(struct FE_element *)NULL);
-		if ((CMZN_OK == result) && (0 < number_of_nodes))
-		{
-			if (ALLOCATE(element_type_node_sequence, struct FE_element_type_node_sequence, 1) &&
-				ALLOCATE(node_numbers, int, number_of_nodes))
-			{
-				element_type_node_sequence->identifier.number_of_nodes = number_of_nodes;
-				element_type_node_sequence->identifier.node_numbers = node_numbers;
-				element_type_node_sequence->element=ACCESS(FE_element)(element);
-				element_type_node_sequence->dimension = element->getDimension();
-				if (face_number >= 0)
-					--(element_type_node_sequence->dimension);
-				element_type_node_sequence->access_count=0;
-				/* put the nodes in the identifier in ascending order */
-				for (i=0;element_type_node_sequence&&(i<number_of_nodes);i++)
-				{
-					node_number=(nodes_in_element[i])->getIdentifier();
-					node_numbers[i]=node_number;
-					/* SAB Reenabled the matching of differently ordered faces as
-						detecting the continuity correctly is more important than the
-						problems with lines matching to different nodes when
-						inheriting from different parents.
-						OLDCOMMENT
-						We do not want to sort these node numbers as the order of the nodes
-						determines which ordering the faces are in and if these do not match
-						we will get the lines matched to different pairs of the nodes. */
-					placed=0;
-					for (j=0;(!placed)&&(j<i);j++)
-					{
-						if (node_number<node_numbers[j])
-						{
-							/* make space for the new number */
-							for (k=i;j<k;k--)
-							{
-								node_numbers[k]=node_numbers[k-1];
-							}
-							node_numbers[j]=node_number;
-							placed=1;
-						}
-					}
-					if (!placed)
-					{
-						node_numbers[i]=node_number;
-					}
-				}
-#if defined (DEBUG_CODE)
-				/*???debug*/
-				printf("FE_element_type_node_sequence  %d-D element %d has nodes: ",
-					element->getDimension(), element->getIdentifier());
-				for (i=0;i<number_of_nodes;i++)
-				{
-					printf(" %d",node_numbers[i]);
-				}
-				printf("\n");
-#endif /* defined (DEBUG_CODE) */
-			}
-			else
-			{
-				display_message(ERROR_MESSAGE,
-					"CREATE(FE_element_type_node_sequence).  Not enough memory");
-				DEALLOCATE(element_type_node_sequence);
-			}
-			for (i=0;i<number_of_nodes;i++)
-			{
-				DEACCESS(FE_node)(nodes_in_element+i);
-			}
-			DEALLOCATE(nodes_in_element);
-		}
-		else
-		{
-			if (CMZN_ERROR_NOT_FOUND != result)
-			{
-				display_message(ERROR_MESSAGE, "CREATE(FE_element_type_node_sequence).  Failed to get nodes in element");
-			}
-			element_type_node_sequence=(struct FE_element_type_node_sequence *)NULL;
-		}
-	}
-	else
+	nodeIdentifiers.clear();
+	if (!element)
 	{
 		display_message(ERROR_MESSAGE,
-			"CREATE(FE_element_type_node_sequence).  Invalid argument(s)");
-		element_type_node_sequence=(struct FE_element_type_node_sequence *)NULL;
-		result = CMZN_ERROR_ARGUMENT;
+			"calculate_FE_element_sorted_node_identifiers.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
 	}
-	return (element_type_node_sequence);
-}
-
-int DESTROY(FE_element_type_node_sequence)(
-	struct FE_element_type_node_sequence **element_type_node_sequence_address)
-/*******************************************************************************
-LAST MODIFIED : 13 February 2003
-
-DESCRIPTION :
-Cleans up memory used by the FE_element_type_node_sequence.
-==============================================================================*/
-{
-	int return_code;
-	struct FE_element_type_node_sequence *element_type_node_sequence;
-
-	ENTER(DESTROY(FE_element_type_node_sequence));
-	if (element_type_node_sequence_address&&
-		(element_type_node_sequence= *element_type_node_sequence_address))
+	int number_of_nodes = 0;
+	struct FE_node **nodes_in_element = 0;
+	const int result = calculate_FE_element_field_nodes(element, face_number,
+		(struct FE_field *)NULL, &number_of_nodes, &nodes_in_element,
+		/*top_level_element*/(struct FE_element *)NULL);
+	if (CMZN_OK != result)
 	{
-		if (0==element_type_node_sequence->access_count)
+		if (CMZN_ERROR_NOT_FOUND != result)
 		{
-			/* must deaccess element */
-			DEACCESS(FE_element)(&(element_type_node_sequence->element));
-			DEALLOCATE(element_type_node_sequence->identifier.node_numbers);
-			DEALLOCATE(*element_type_node_sequence_address);
-			return_code=1;
-		}
-		else
-		{
-			display_message(ERROR_MESSAGE,
-				"DESTROY(FE_element_type_node_sequence).  Non-zero access count of %d",
-				element_type_node_sequence->access_count);
-			*element_type_node_sequence_address=
-				(struct FE_element_type_node_sequence *)NULL;
-			return_code=0;
+			display_message(ERROR_MESSAGE, "calculate_FE_element_sorted_node_identifiers.  "
+				"Failed to get nodes in element");
 		}
+		return result;
 	}
-	else
-	{
-		display_message(ERROR_MESSAGE,
-			"DESTROY(FE_element_type_node_sequence).  Invalid argument(s)");
-		return_code=0;
-	}
-	LEAVE;
-
-	return (return_code);
-} /* DESTROY(FE_element_type_node_sequence) */
-
-DECLARE_OBJECT_FUNCTIONS(FE_element_type_node_sequence)
-
-DECLARE_INDEXED_LIST_MODULE_FUNCTIONS(FE_element_type_node_sequence, \
-	identifier, FE_element_type_node_sequence_identifier&, \
-	compare_FE_element_type_node_sequence_identifier)
-
-DECLARE_INDEXED_LIST_FUNCTIONS(FE_element_type_node_sequence)
-
-DECLARE_FIND_BY_IDENTIFIER_IN_INDEXED_LIST_FUNCTION( \
-	FE_element_type_node_sequence,identifier, \
-	FE_element_type_node_sequence_identifier&, \
-	compare_FE_element_type_node_sequence_identifier)
-
-int FE_element_type_node_sequence_is_collapsed(
-	struct FE_element_type_node_sequence *element_type_node_sequence)
-/*******************************************************************************
-LAST MODIFIED : 13 February 2003
-
-DESCRIPTION :
-Returns true if the <element_type_node_sequence> represents an element that
-has collapsed, ie, is a face with <= 2 unique nodes, or a line with 1 unique
-node.
-???RC Note that repeated nodes in the face/line are not put in the node_numbers
-array twice, facilitating the simple logic in this function. If they were, then
-this function would have to be modified extensively.
-==============================================================================*/
-{
-	int return_code;
-
-	ENTER(FE_element_type_node_sequence_is_collapsed);
-	if (element_type_node_sequence)
-	{
-		return_code=((2 == element_type_node_sequence->dimension)&&
-			(2 >= element_type_node_sequence->identifier.number_of_nodes))||
-			((1 == element_type_node_sequence->dimension)&&
-				(1 == element_type_node_sequence->identifier.number_of_nodes));
-	}
-	else
+	/* SAB Matching differently ordered faces as detecting the continuity
+		correctly is more important than the problems with lines matching to
+		different nodes when inheriting from different parents. */
+	nodeIdentifiers.reserve(number_of_nodes);
+	for (int i = 0; i < number_of_nodes; ++i)
 	{
-		display_message(ERROR_MESSAGE,
-			"FE_element_type_node_sequence_is_collapsed.  Invalid argument(s)");
-		return_code=0;
+		nodeIdentifiers.push_back(nodes_in_element[i]->getIdentifier());
+		DEACCESS(FE_node)(nodes_in_element + i);
 	}
-	LEAVE;
-
-	return (return_code);
-} /* FE_element_type_node_sequence_is_collapsed */
-
-struct FE_element *FE_element_type_node_sequence_get_FE_element(
-	struct FE_element_type_node_sequence *element_type_node_sequence)
-{
-	if (element_type_node_sequence)
-		return element_type_node_sequence->element;
-	return 0;
-}
-
-void FE_element_type_node_sequence_set_FE_element(
-	struct FE_element_type_node_sequence *element_type_node_sequence,
-	struct FE_element *element)
-{
-	if (element_type_node_sequence)
-		REACCESS(FE_element)(&element_type_node_sequence->element, element);
-}
-
-FE_element_type_node_sequence *FE_element_type_node_sequence_list_find_match(
-	struct LIST(FE_element_type_node_sequence) *element_type_node_sequence_list,
-	FE_element_type_node_sequence *element_type_node_sequence)
-{
-	if (element_type_node_sequence_list && element_type_node_sequence)
-	{
-		return FIND_BY_IDENTIFIER_IN_LIST(FE_element_type_node_sequence, identifier)(
-			element_type_node_sequence->identifier, element_type_node_sequence_list);
-	}
-	return 0;
+	DEALLOCATE(nodes_in_element);
+	std::sort(nodeIdentifiers.begin(), nodeIdentifiers.end());
+	return CMZN_OK;
 }
 
 DECLARE_CHANGE_LOG_MODULE_FUNCTIONS(FE_field)
@@ -4598,12 +4362,56 @@ A NULL <type> means an unspecified shape of <dimension>.
 	return (shape);
 } /* find_FE_element_shape_in_list */
 
+/**
+ * Apply legacy modify theta and blending of element field template basis to
+ * element parameters gathered from nodes.
+ *
+ * @param eft  Element field template describing parameter mapping and basis.
+ * @param basisFunctionCount  Number of parameters gathered.
+ * @param elementValues  Array of gathered parameters; reallocated if basis uses
+ * a blending function. Caller is required to deallocate.
+ * @return  Number of values calculated or 0 if error.
+ */
+static int FE_element_field_template_finish_element_values(
+	const FE_element_field_template *eft, int basisFunctionCount, FE_value*& elementValues)
+{
+	FE_basis *basis = eft->getBasis();
+	if (eft->getLegacyModifyThetaMode() != FE_BASIS_MODIFY_THETA_MODE_INVALID)
+	{
+		if (!FE_basis_modify_theta_in_xi1(basis, eft->getLegacyModifyThetaMode(), elementValues))
+		{
+			display_message(ERROR_MESSAGE, "FE_element_field_template_finish_element_values.  "
+				"Error modifying element values");
+			return 0;
+		}
+	}
+	const int blendedElementValuesCount = FE_basis_get_number_of_blended_functions(basis);
+	if (blendedElementValuesCount > 0)
+	{
+		FE_value *blendedElementValues = FE_basis_get_blended_element_values(basis, elementValues);
+		if (!blendedElementValues)
+		{
+			display_message(ERROR_MESSAGE, "FE_element_field_template_finish_element_values.  "
+				"Could not allocate memory for blended values");
+			return 0;
+		}
+		DEALLOCATE(elementValues);
+		elementValues = blendedElementValues;
+		return blendedElementValuesCount;
+	}
+	return basisFunctionCount;
+}
+
 /**
  * The standard function for mapping global parameters to get the local element
  * parameters weighting the basis in the element field template.
  * Uses relative offsets into nodal values array in standard and general node to
  * element maps. Absolute offset for start of field component is obtained from
  * the node_field_component for the field at the node.
+ * Node value indexes for each term are looked up once per node field info and
+ * cached as a gather plan with the mesh element field template data, so where
+ * all nodes of the element have the same node field info only the values and
+ * scale factors are read. Otherwise values are looked up term by term.
  * Does not check arguments as called internally.
  *
  * @param field  The field to get values for.
@@ -4636,7 +4444,6 @@ int global_to_element_map_values(FE_field *field, int componentNumber,
 	}
 	FE_mesh *mesh = element->getMesh();
 	FE_mesh_element_field_template_data *meshEFTData = mesh->getElementfieldtemplateData(eft->getIndexInMesh());
-	FE_basis *basis = eft->getBasis();
 
 	const DsLabelIndex elementIndex = element->getIndex();
 	const DsLabelIndex *nodeIndexes = meshEFTData->getElementNodeIndexes(elementIndex);
@@ -4662,6 +4469,111 @@ int global_to_element_map_values(FE_field *field, int componentNumber,
 	}
 
 	const int basisFunctionCount = eft->getNumberOfFunctions();
+	// Gather with the cached plan if all local nodes used have the same node
+	// field info as the node of the first term, which is the usual case
+	std::shared_ptr<const FE_element_field_gather_plan> plan;
+	FE_node *firstNode = (0 < eft->totalTermCount) ? nodeset->getNode(nodeIndexes[eft->localNodeIndexes[0]]) : 0;
+	const FE_node_field_info *planNodeFieldInfo = (firstNode) ? firstNode->fields : 0;
+	if (planNodeFieldInfo)
+	{
+		const unsigned int generation = nodeset->getNodeFieldInfoGeneration();
+		plan = meshEFTData->getGatherPlan(field, componentNumber, planNodeFieldInfo, generation);
+		if (!plan)
+		{
+			const FE_node_field *node_field = FIND_BY_IDENTIFIER_IN_LIST(FE_node_field, field)(field, planNodeFieldInfo->node_field_list);
+			if (node_field)
+			{
+				const FE_node_field_template *planNft = node_field->getComponent(componentNumber);
+				std::shared_ptr<FE_element_field_gather_plan> newPlan(new FE_element_field_gather_plan());
+				newPlan->valuesOffset = planNft->valuesOffset;
+				newPlan->timeSequence = node_field->time_sequence;
+				newPlan->termValueIndexes.resize(eft->totalTermCount);
+				std::vector<bool> localNodeUsed(eft->numberOfLocalNodes, false);
+				int tt = 0;
+				for (; tt < eft->totalTermCount; ++tt)
+				{
+					const int valueIndex = planNft->getValueIndex(eft->nodeValueLabels[tt], eft->nodeVersions[tt]);
+					if (valueIndex < 0)
+						break; // reported by general lookups below
+					newPlan->termValueIndexes[tt] = valueIndex;
+					const int localNodeIndex = eft->localNodeIndexes[tt];
+					if (!localNodeUsed[localNodeIndex])
+					{
+						localNodeUsed[localNodeIndex] = true;
+						newPlan->localNodeIndexes.push_back(localNodeIndex);
+					}
+				}
+				if (tt == eft->totalTermCount)
+				{
+					meshEFTData->setGatherPlan(field, componentNumber, planNodeFieldInfo, generation, newPlan);
+					plan = newPlan;
+				}
+			}
+		}
+	}
+	if (plan)
+	{
+		// per-thread array of start of field component values at each local node
+		thread_local std::vector<Value_storage *> localNodeValues;
+		if (static_cast<int>(localNodeValues.size()) < eft->numberOfLocalNodes)
+			localNodeValues.resize(eft->numberOfLocalNodes);
+		const int planNodeCount = static_cast<int>(plan->localNodeIndexes.size());
+		int n = 0;
+		for (; n < planNodeCount; ++n)
+		{
+			const int localNodeIndex = plan->localNodeIndexes[n];
+			FE_node *planNode = nodeset->getNode(nodeIndexes[localNodeIndex]);
+			if ((!planNode) || (planNode->fields != planNodeFieldInfo))
+				break;
+			localNodeValues[localNodeIndex] = planNode->values_storage + plan->valuesOffset;
+		}
+		if (n == planNodeCount)
+		{
+			const int *termLocalNodeIndexes = eft->localNodeIndexes;
+			const int *termValueIndexes = plan->termValueIndexes.data();
+			Value_storage **nodeValues = localNodeValues.data();
+			int time_index_one = 0, time_index_two = 0;
+			FE_value time_xi = 0.0;
+			if (plan->timeSequence)
+			{
+				FE_time_sequence_get_interpolation_for_time(plan->timeSequence,
+					time, &time_index_one, &time_index_two, &time_xi);
+			}
+			// at a time in the sequence only read parameters for that time
+			const bool timeInterpolate = (time_xi != 0.0) && (time_index_one != time_index_two);
+			int tt = 0;
+			int tts = 0;
+			for (int f = 0; f < basisFunctionCount; ++f)
+			{
+				FE_value termSum = 0.0;
+				const int termLimit = tt + eft->termCounts[f];
+				for (; tt < termLimit; ++tt)
+				{
+					FE_value termValue;
+					if (plan->timeSequence)
+					{
+						const FE_value *timeValues = *(reinterpret_cast<FE_value **>(nodeValues[termLocalNodeIndexes[tt]]) + termValueIndexes[tt]);
+						termValue = (timeInterpolate) ?
+							(1.0 - time_xi)*timeValues[time_index_one] + time_xi*timeValues[time_index_two] :
+							timeValues[time_index_one];
+					}
+					else
+					{
+						termValue = reinterpret_cast<FE_value *>(nodeValues[termLocalNodeIndexes[tt]])[termValueIndexes[tt]];
+					}
+					if (scaleFactors)
+					{
+						const int termScaleFactorLimit = tts + eft->termScaleFactorCounts[tt];
+						for (; tts < termScaleFactorLimit; ++tts)
+							termValue *= scaleFactors[eft->localScaleFactorIndexes[tts]];
+					}
+					termSum += termValue;
+				}
+				elementValues[f] = termSum;
+			}
+			return FE_element_field_template_finish_element_values(eft, basisFunctionCount, elementValues);
+		}
+	}
 	int lastLocalNodeIndex = -1;
 	FE_node *node = 0;
 	// Cache last node_field_info since expensive to find and probably same as last node
@@ -4751,29 +4663,7 @@ int global_to_element_map_values(FE_field *field, int componentNumber,
 		}
 		elementValues[f] = termSum;
 	}
-	if (eft->getLegacyModifyThetaMode() != FE_BASIS_MODIFY_THETA_MODE_INVALID)
-	{
-		if (!FE_basis_modify_theta_in_xi1(eft->basis, eft->getLegacyModifyThetaMode(), elementValues))
-		{
-			display_message(ERROR_MESSAGE, "global_to_element_map_values.  Error modifying element values");
-			return 0;
-		}
-	}
-	const int blendedElementValuesCount = FE_basis_get_number_of_blended_functions(basis);
-	if (blendedElementValuesCount > 0)
-	{
-		FE_value *blendedElementValues = FE_basis_get_blended_element_values(basis, elementValues);
-		if (!blendedElementValues)
-		{
-			display_message(ERROR_MESSAGE,
-				"global_to_element_map_values.  Could not allocate memory for blended values");
-			return 0;
-		}
-		DEALLOCATE(elementValues);
-		elementValues = blendedElementValues;
-		return blendedElementValuesCount;
-	}
-	return basisFunctionCount;
+	return FE_element_field_template_finish_element_values(eft, basisFunctionCount, elementValues);
 }
 
 /**
@@ -5400,7 +5290,8 @@ FE_region.
 			for (int d = 0; d < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++d)
 				field->meshFieldData[d] = 0;
 			field->number_of_wrappers = 0;
-			field->access_count = 0;
+			// construct atomic in memory from ALLOCATE
+			new (&field->access_count) std::atomic<int>(0);
 			if (!return_code)
 			{
 				display_message(ERROR_MESSAGE,
@@ -5474,7 +5365,7 @@ Frees the memory for the field and sets <*field_address> to NULL.
 		else
 		{
 			display_message(ERROR_MESSAGE,
-				"DESTROY(FE_field).  Non-zero access_count (%d)",field->access_count);
+				"DESTROY(FE_field).  Non-zero access_count (%d)",field->access_count.load());
 			return_code=0;
 		}
 	}
@@ -5506,7 +5397,7 @@ Outputs the information contained in <field>.
 		/* write the identifier */
 		display_message(INFORMATION_MESSAGE, "field : %s\n", field->name);
 		display_message(INFORMATION_MESSAGE,
-			"  access count = %d\n", field->access_count);
+			"  access count = %d\n", field->access_count.load());
 		display_message(INFORMATION_MESSAGE,"  type = %s",
 			ENUMERATOR_STRING(CM_field_type)(field->cm_field_type));
 		display_message(INFORMATION_MESSAGE,"  coordinate system = %s",
@@ -8152,7 +8043,8 @@ struct FE_node *CREATE(FE_node)()
 	{
 		// not a global node until nodeset gives a non-negative index:
 		node->index = DS_LABEL_INDEX_INVALID;
-		node->access_count = 1;
+		// construct atomic in memory from ALLOCATE
+		new (&node->access_count) std::atomic<int>(1);
 		node->fields = (struct FE_node_field_info *)NULL;
 		node->values_storage = (Value_storage *)NULL;
 	}
@@ -8198,7 +8090,7 @@ int DESTROY(FE_node)(struct FE_node **node_address)
 		{
 			display_message(ERROR_MESSAGE,
 				"DESTROY(FE_node).  Node has non-zero access count %d",
-				node->access_count);
+				node->access_count.load());
 			*node_address = (struct FE_node *)NULL;
 			return_code = 0;
 		}
@@ -8259,6 +8151,98 @@ cmzn_node *create_FE_node_from_template(DsLabelIndex index, cmzn_node *template_
 	return node;
 }
 
+int FE_node_get_FE_value_parameter_offsets(cmzn_node *node, FE_field *field,
+	std::vector<int>& offsets)
+{
+	if (!((node) && (node->fields) && (field)))
+	{
+		display_message(ERROR_MESSAGE, "FE_node_get_FE_value_parameter_offsets.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	const FE_node_field *node_field = FIND_BY_IDENTIFIER_IN_LIST(FE_node_field, field)(
+		field, node->fields->node_field_list);
+	if (!node_field)
+	{
+		display_message(ERROR_MESSAGE, "FE_node_get_FE_value_parameter_offsets.  "
+			"Field %s is not defined at node", field->name);
+		return CMZN_ERROR_NOT_FOUND;
+	}
+	if ((field->value_type != FE_VALUE_VALUE) || (node_field->time_sequence))
+	{
+		display_message(ERROR_MESSAGE, "FE_node_get_FE_value_parameter_offsets.  "
+			"Field %s is not real-valued or is time-varying", field->name);
+		return CMZN_ERROR_ARGUMENT;
+	}
+	for (int c = 0; c < field->number_of_components; ++c)
+	{
+		const FE_node_field_template &nft = *(node_field->getComponent(c));
+		const int totalValuesCount = nft.getTotalValuesCount();
+		int offset = nft.getValuesOffset();
+		for (int j = 0; j < totalValuesCount; ++j)
+		{
+			offsets.push_back(offset);
+			offset += static_cast<int>(sizeof(FE_value));
+		}
+	}
+	return CMZN_OK;
+}
+
+void FE_node_set_FE_value_parameters_at_offsets(cmzn_node *node, int valuesCount,
+	const int *offsets, const FE_value *valuesIn)
+{
+	Value_storage *values_storage = node->values_storage;
+	for (int i = 0; i < valuesCount; ++i)
+		*((FE_value *)(values_storage + offsets[i])) = valuesIn[i];
+}
+
+void FE_node_get_allocated_bytes(cmzn_node *node, size_t& nodeBytes, size_t& valuesBytes)
+{
+	nodeBytes = sizeof(FE_node);
+	valuesBytes = ((node) && (node->fields) && (node->values_storage)) ?
+		static_cast<size_t>(node->fields->values_storage_size) : 0;
+}
+
+struct FE_node_field_add_values_allocated_bytes_data
+{
+	size_t nodesCount;
+	std::map<FE_field *, size_t>& fieldValuesBytes;
+};
+
+static int FE_node_field_add_values_allocated_bytes(struct FE_node_field *node_field,
+	void *add_data_void)
+{
+	FE_node_field_add_values_allocated_bytes_data *add_data =
+		static_cast<FE_node_field_add_values_allocated_bytes_data *>(add_data_void);
+	FE_field *field = node_field->field;
+	if (GENERAL_FE_FIELD != field->fe_field_type)
+		return 1;
+	const int totalValuesCount = node_field->getTotalValuesCount();
+	int values_storage_size = totalValuesCount*get_Value_storage_size(field->value_type, node_field->time_sequence);
+	ADJUST_VALUE_STORAGE_SIZE(values_storage_size);
+	size_t bytes = static_cast<size_t>(values_storage_size);
+	if (node_field->time_sequence)
+	{
+		// each value is a pointer to an array of values at times
+		bytes += static_cast<size_t>(totalValuesCount)*
+			FE_time_sequence_get_number_of_times(node_field->time_sequence)*
+			get_Value_storage_size(field->value_type, /*time_sequence*/0);
+	}
+	add_data->fieldValuesBytes[field] += bytes*add_data->nodesCount;
+	return 1;
+}
+
+void FE_node_field_info_add_field_values_allocated_bytes(
+	struct FE_node_field_info *node_field_info, size_t nodesCount,
+	std::map<FE_field *, size_t>& fieldValuesBytes)
+{
+	if ((node_field_info) && (0 < nodesCount))
+	{
+		FE_node_field_add_values_allocated_bytes_data add_data = { nodesCount, fieldValuesBytes };
+		FOR_EACH_OBJECT_IN_LIST(FE_node_field)(FE_node_field_add_values_allocated_bytes,
+			static_cast<void *>(&add_data), node_field_info->node_field_list);
+	}
+}
+
 void FE_node_invalidate(cmzn_node *node)
 {
 	if (node)
@@ -8347,6 +8331,8 @@ int FE_nodeset_get_FE_node_field_info_adding_new_times(
 		{
 			if (FE_node_field_info_used_only_once(existing_node_field_info))
 			{
+				// node fields are modified in place
+				fe_nodeset->nodeFieldInfoChange();
 				if (node_field->access_count > 1)
 				{
 					/* Need to copy this node_field */
@@ -9564,6 +9550,228 @@ INSTANTIATE_FE_NODAL_VALUE_FUNCTIONS( float , FLT_VALUE )
 INSTANTIATE_FE_NODAL_VALUE_FUNCTIONS( int , INT_VALUE )
 INSTANTIATE_FE_NODAL_VALUE_FUNCTIONS( short , SHORT_VALUE )
 
+namespace {
+
+/**
+ * Caches the location of VALUE parameters of all components of a general
+ * FE_VALUE field in node values storage. Only recomputed when the node field
+ * info changes, which is rare over a nodeset, so bulk get/set of values can
+ * go straight to node values storage.
+ */
+class FE_node_field_value_locator
+{
+	FE_field *field;
+	const FE_value time;
+	const FE_node_field_info *fieldInfo; // field info offsets are for
+	bool defined; // true if field is defined with VALUE parameters for all components
+	FE_time_sequence *timeSequence;
+	int valueTypeSize;
+	std::vector<int> valueOffsets; // offsets of each VALUE version for all components in turn
+	std::vector<int> componentStarts; // index of first offset for each component, plus end
+	int timeIndexOne, timeIndexTwo; // for getting interpolated values
+	FE_value timeXi;
+	bool timeIndexValid;
+	int timeIndex; // for setting values at exact time
+
+	void updateTimeSequence(FE_time_sequence *newTimeSequence)
+	{
+		this->timeSequence = newTimeSequence;
+		if (newTimeSequence)
+		{
+			this->timeXi = 0.0;
+			FE_time_sequence_get_interpolation_for_time(newTimeSequence, this->time,
+				&this->timeIndexOne, &this->timeIndexTwo, &this->timeXi);
+			this->timeIndexValid = (0 != FE_time_sequence_get_index_for_time(newTimeSequence,
+				this->time, &this->timeIndex));
+		}
+	}
+
+public:
+
+	FE_node_field_value_locator(FE_field *fieldIn, FE_value timeIn) :
+		field(fieldIn),
+		time(timeIn),
+		fieldInfo(0),
+		defined(false),
+		timeSequence(0),
+		valueTypeSize(0),
+		componentStarts(fieldIn->number_of_components + 1, 0),
+		timeIndexOne(0),
+		timeIndexTwo(0),
+		timeXi(0.0),
+		timeIndexValid(false),
+		timeIndex(0)
+	{
+	}
+
+	/** @return  True if field is defined at node with VALUE for all components */
+	bool setNode(const FE_node *node)
+	{
+		if (node->fields != this->fieldInfo)
+		{
+			this->fieldInfo = node->fields;
+			this->defined = false;
+			const FE_node_field *node_field = (node->fields) ? FIND_BY_IDENTIFIER_IN_LIST(FE_node_field, field)(
+				this->field, node->fields->node_field_list) : 0;
+			if (node_field)
+			{
+				if (node_field->time_sequence != this->timeSequence)
+					this->updateTimeSequence(node_field->time_sequence);
+				this->valueTypeSize = get_Value_storage_size(this->field->value_type, node_field->time_sequence);
+				this->valueOffsets.clear();
+				this->defined = true;
+				const int componentCount = this->field->number_of_components;
+				for (int c = 0; c < componentCount; ++c)
+				{
+					this->componentStarts[c] = static_cast<int>(this->valueOffsets.size());
+					const FE_node_field_template *nft = node_field->getComponent(c);
+					const int versionsCount = nft->getValueNumberOfVersions(CMZN_NODE_VALUE_LABEL_VALUE);
+					if (versionsCount < 1)
+						this->defined = false;
+					for (int v = 0; v < versionsCount; ++v)
+						this->valueOffsets.push_back(nft->getValuesOffset() +
+							nft->getValueIndex(CMZN_NODE_VALUE_LABEL_VALUE, v)*this->valueTypeSize);
+				}
+				this->componentStarts[componentCount] = static_cast<int>(this->valueOffsets.size());
+			}
+		}
+		return this->defined;
+	}
+
+	/** Get version 1 VALUE of all components. Call only after setNode returns true. */
+	void getValues(const FE_node *node, FE_value *valuesOut) const
+	{
+		const int componentCount = this->field->number_of_components;
+		if (this->timeSequence)
+		{
+			if ((this->timeXi != 0.0) && (this->timeIndexOne != this->timeIndexTwo))
+			{
+				const FE_value oneMinusTimeXi = 1.0 - this->timeXi;
+				for (int c = 0; c < componentCount; ++c)
+				{
+					const FE_value *timeValues = *((const FE_value **)(node->values_storage + this->valueOffsets[this->componentStarts[c]]));
+					valuesOut[c] = timeValues[this->timeIndexOne]*oneMinusTimeXi + timeValues[this->timeIndexTwo]*this->timeXi;
+				}
+			}
+			else
+			{
+				// at a time in the sequence: only read parameters for that time
+				for (int c = 0; c < componentCount; ++c)
+					valuesOut[c] = (*((const FE_value **)(node->values_storage + this->valueOffsets[this->componentStarts[c]])))[this->timeIndexOne];
+			}
+		}
+		else
+		{
+			for (int c = 0; c < componentCount; ++c)
+				valuesOut[c] = *((const FE_value *)(node->values_storage + this->valueOffsets[this->componentStarts[c]]));
+		}
+	}
+
+	/** Set all versions of VALUE for all components. Call only after setNode
+	 * returns true. Caller must notify of changes.
+	 * @return  True on success, false if time-varying with no parameters at time. */
+	bool setValues(FE_node *node, const FE_value *valuesIn) const
+	{
+		const int componentCount = this->field->number_of_components;
+		if (this->timeSequence)
+		{
+			if (!this->timeIndexValid)
+				return false;
+			for (int c = 0; c < componentCount; ++c)
+				for (int i = this->componentStarts[c]; i < this->componentStarts[c + 1]; ++i)
+					(*((FE_value **)(node->values_storage + this->valueOffsets[i])))[this->timeIndex] = valuesIn[c];
+		}
+		else
+		{
+			for (int c = 0; c < componentCount; ++c)
+				for (int i = this->componentStarts[c]; i < this->componentStarts[c + 1]; ++i)
+					*((FE_value *)(node->values_storage + this->valueOffsets[i])) = valuesIn[c];
+		}
+		return true;
+	}
+
+};
+
+} // anonymous namespace
+
+int FE_nodeset_get_FE_field_FE_value_values(FE_nodeset *fe_nodeset,
+	DsLabelIterator *labelIterator, FE_field *field, FE_value time,
+	int valuesCount, FE_value *valuesOut, int *nodesCountOut, int *definedCountOut)
+{
+	if (!((fe_nodeset) && (labelIterator) && (field) && (field->fe_field_type == GENERAL_FE_FIELD)
+		&& (field->value_type == FE_VALUE_VALUE) && (valuesOut) && (nodesCountOut) && (definedCountOut)))
+	{
+		display_message(ERROR_MESSAGE, "FE_nodeset_get_FE_field_FE_value_values.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	const int componentCount = field->number_of_components;
+	FE_node_field_value_locator locator(field, time);
+	int nodesCount = 0;
+	int definedCount = 0;
+	FE_value *valueOut = valuesOut;
+	DsLabelIndex nodeIndex;
+	while ((nodeIndex = labelIterator->nextIndex()) != DS_LABEL_INDEX_INVALID)
+	{
+		if ((nodesCount + 1)*componentCount > valuesCount)
+		{
+			display_message(ERROR_MESSAGE, "FE_nodeset_get_FE_field_FE_value_values.  Values array is too small");
+			return CMZN_ERROR_ARGUMENT;
+		}
+		const FE_node *node = fe_nodeset->getNode(nodeIndex);
+		if ((node) && (node->values_storage) && locator.setNode(node))
+		{
+			locator.getValues(node, valueOut);
+			++definedCount;
+		}
+		++nodesCount;
+		valueOut += componentCount;
+	}
+	*nodesCountOut = nodesCount;
+	*definedCountOut = definedCount;
+	return CMZN_OK;
+}
+
+int FE_nodeset_set_FE_field_FE_value_values(FE_nodeset *fe_nodeset,
+	DsLabelIterator *labelIterator, FE_field *field, FE_value time,
+	int valuesCount, const FE_value *valuesIn, int *nodesCountOut, int *definedCountOut)
+{
+	if (!((fe_nodeset) && (labelIterator) && (field) && (field->fe_field_type == GENERAL_FE_FIELD)
+		&& (field->value_type == FE_VALUE_VALUE) && (valuesIn) && (nodesCountOut) && (definedCountOut)))
+	{
+		display_message(ERROR_MESSAGE, "FE_nodeset_set_FE_field_FE_value_values.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	const int componentCount = field->number_of_components;
+	FE_node_field_value_locator locator(field, time);
+	int nodesCount = 0;
+	int definedCount = 0;
+	const FE_value *valueIn = valuesIn;
+	FE_region_begin_change(fe_nodeset->get_FE_region());
+	int return_code = CMZN_OK;
+	DsLabelIndex nodeIndex;
+	while ((nodeIndex = labelIterator->nextIndex()) != DS_LABEL_INDEX_INVALID)
+	{
+		if ((nodesCount + 1)*componentCount > valuesCount)
+		{
+			display_message(ERROR_MESSAGE, "FE_nodeset_set_FE_field_FE_value_values.  Values array is too small");
+			return_code = CMZN_ERROR_ARGUMENT;
+			break;
+		}
+		FE_node *node = fe_nodeset->getNode(nodeIndex);
+		if ((node) && (node->values_storage) && locator.setNode(node) && locator.setValues(node, valueIn))
+		{
+			fe_nodeset->nodeFieldChange(node, field);
+			++definedCount;
+		}
+		++nodesCount;
+		valueIn += componentCount;
+	}
+	FE_region_end_change(fe_nodeset->get_FE_region());
+	*nodesCountOut = nodesCount;
+	*definedCountOut = definedCount;
+	return return_code;
+}
+
 int get_FE_nodal_element_xi_value(struct FE_node *node,
 	FE_field *field, int component_number,
 	cmzn_element **element, FE_value *xi)
@@ -10645,7 +10853,7 @@ int list_FE_node(struct FE_node *node)
 #if defined (DEBUG_CODE)
 		/*???debug*/
 		display_message(INFORMATION_MESSAGE,"  access count = %d\n",
-			node->access_count);
+			node->access_count.load());
 #endif /* defined (DEBUG_CODE) */
 	}
 	else
@@ -10869,6 +11077,16 @@ Returns true if the <element_field_values> are valid for calculating derivatives
 	return (return_code);
 } /* FE_element_field_values_have_derivatives_calculated */
 
+bool FE_element_field_values_is_time_dependent(
+	struct FE_element_field_values *element_field_values)
+{
+	if (element_field_values)
+		return (0 != element_field_values->time_dependent);
+	display_message(ERROR_MESSAGE,
+		"FE_element_field_values_is_time_dependent.  Invalid argument");
+	return false;
+}
+
 struct FE_element_shape *CREATE(FE_element_shape)(int dimension,
 	const int *type, struct FE_region *fe_region)
 /*******************************************************************************
@@ -12825,14 +13043,14 @@ structure unused for some time so it is not accessing objects.
 			(const Value_storage **)NULL;
 		element_field_values->component_base_grid_offset = (int *)NULL;
 		element_field_values->component_grid_offset_in_xi = (int **)NULL;
-		element_field_values->element_value_offsets = (int *)NULL;
 		element_field_values->component_values = (FE_value **)NULL;
 		element_field_values->component_standard_basis_functions =
 			(Standard_basis_function **)NULL;
 		element_field_values->component_standard_basis_function_arguments =
 			(int **)NULL;
-		element_field_values->basis_function_values = (FE_value *)NULL;
-		element_field_values->access_count = 0;
+		element_field_values->basis_function_values_size = 0;
+		// construct atomic in memory from ALLOCATE
+		new (&element_field_values->access_count) std::atomic<int>(0);
 	}
 	else
 	{
@@ -12853,7 +13071,7 @@ int calculate_FE_element_field_values(cmzn_element *element,
 		*derivative_value,*inherited_value,*inherited_values,scalar,
 		*second_derivative_value,*transformation,*value,**values_address;
 	int cn,**component_number_in_xi,
-		*component_base_grid_offset, *element_value_offsets, i,
+		*component_base_grid_offset, i,
 		j,k,grid_maximum_number_of_values, maximum_number_of_values,
 		number_of_grid_based_components,
 		number_of_inherited_values,number_of_polygon_verticies,number_of_values,
@@ -12919,14 +13137,13 @@ int calculate_FE_element_field_values(cmzn_element *element,
 				(const Value_storage **)NULL;
 			element_field_values->component_base_grid_offset=(int *)NULL;
 			element_field_values->component_grid_offset_in_xi=(int **)NULL;
-			element_field_values->element_value_offsets=(int *)NULL;
 			/* clear arrays not used for grid-based fields */
 			element_field_values->component_values=(FE_value **)NULL;
 			element_field_values->component_standard_basis_functions=
 				(Standard_basis_function **)NULL;
 			element_field_values->component_standard_basis_function_arguments=
 				(int **)NULL;
-			element_field_values->basis_function_values=(FE_value *)NULL;
+			element_field_values->basis_function_values_size = 0;
 			element_field_values->time_dependent = 0;
 			element_field_values->time = time;
 		} break;
@@ -12992,7 +13209,6 @@ int calculate_FE_element_field_values(cmzn_element *element,
 				element_field_values->component_grid_values_storage=
 					(const Value_storage **)NULL;
 				element_field_values->component_grid_offset_in_xi=(int **)NULL;
-				element_field_values->element_value_offsets=(int *)NULL;
 
 				element_field_values->component_values=values_address;
 				element_field_values->component_standard_basis_functions=
@@ -13045,9 +13261,8 @@ int calculate_FE_element_field_values(cmzn_element *element,
 							ALLOCATE(component_grid_values_storage, const Value_storage *, number_of_components);
 							ALLOCATE(component_base_grid_offset, int, number_of_components);
 							ALLOCATE(component_grid_offset_in_xi, int*, number_of_components);
-							ALLOCATE(element_value_offsets, int, grid_maximum_number_of_values);
 							if (component_grid_values_storage && component_base_grid_offset &&
-								component_grid_offset_in_xi && element_value_offsets)
+								component_grid_offset_in_xi)
 							{
 								for (cn = 0; (cn < number_of_components); cn++)
 								{
@@ -13058,7 +13273,6 @@ int calculate_FE_element_field_values(cmzn_element *element,
 								element_field_values->component_grid_values_storage = component_grid_values_storage;
 								element_field_values->component_base_grid_offset = component_base_grid_offset;
 								element_field_values->component_grid_offset_in_xi = component_grid_offset_in_xi;
-								element_field_values->element_value_offsets = element_value_offsets;
 							}
 							else
 							{
@@ -13457,13 +13671,16 @@ int calculate_FE_element_field_values(cmzn_element *element,
 				}
 				if (return_code)
 				{
-					if (!((maximum_number_of_values>0)&&
-						(ALLOCATE(element_field_values->basis_function_values,
-						FE_value,maximum_number_of_values))))
+					if (maximum_number_of_values>0)
+					{
+						element_field_values->basis_function_values_size=
+							maximum_number_of_values;
+					}
+					else
 					{
 						display_message(ERROR_MESSAGE,
 							"calculate_FE_element_field_values.  "
-							"Could not allocate basis_function_values");
+							"No basis function values");
 						return_code=0;
 					}
 				}
@@ -13638,10 +13855,6 @@ function must be called before calling calculate_FE_element_field_values again.
 			}
 			DEALLOCATE(element_field_values->component_grid_offset_in_xi);
 		}
-		if (element_field_values->element_value_offsets)
-		{
-			DEALLOCATE(element_field_values->element_value_offsets);
-		}
 		if (element_field_values->component_values)
 		{
 			component_values=element_field_values->component_values;
@@ -13676,10 +13889,7 @@ function must be called before calling calculate_FE_element_field_values again.
 		{
 			DEALLOCATE(element_field_values->component_standard_basis_functions);
 		}
-		if (element_field_values->basis_function_values)
-		{
-			DEALLOCATE(element_field_values->basis_function_values);
-		}
+		element_field_values->basis_function_values_size = 0;
 	}
 	else
 	{
@@ -14115,7 +14325,8 @@ int calculate_FE_element_field_nodes(struct FE_element *element,
 
 int calculate_FE_element_field(int component_number,
 	struct FE_element_field_values *element_field_values,
-	const FE_value *xi_coordinates, FE_value *values, FE_value *jacobian)
+	const FE_value *xi_coordinates, FE_value *values, FE_value *jacobian,
+	FE_xi_point_set *xi_point_set, int xi_point_index)
 /*******************************************************************************
 LAST MODIFIED : 5 August 2001
 
@@ -14127,6 +14338,9 @@ the derivatives values have been calculated).  Only the <component_number>+1
 component will be calculated if 0<=component_number<number of components.  For a
 single component, the value will be put in the first position of <values> and
 the derivatives will start at the first position of <jacobian>.
+If <xi_point_set> is supplied, <xi_coordinates> must be those of point
+<xi_point_index> in it, and standard basis function values are taken from its
+tables instead of being recalculated.
 ==============================================================================*/
 {
 	int cn,comp_no,*component_number_of_values,components_to_calculate,
@@ -14135,6 +14349,7 @@ the derivatives will start at the first position of <jacobian>.
 		return_code,size,this_comp_no,xi_offset;
 	FE_value *basis_value,*calculated_value,
 		**component_values,*derivative,*element_value,temp,xi_coordinate;
+	const FE_value *standard_basis_function_values = 0, *standard_basis_value;
 	Standard_basis_function *current_standard_basis_function,
 		**component_standard_basis_function;
 	struct FE_field *field;
@@ -14154,8 +14369,19 @@ the derivatives will start at the first position of <jacobian>.
 		(!jacobian||(jacobian&&(element_field_values->derivatives_calculated)))&&
 		(field=element_field_values->field)&&
 		((GENERAL_FE_FIELD != field->fe_field_type)||
-			(basis_function_values=element_field_values->basis_function_values)))
+			(0 < element_field_values->basis_function_values_size)))
 	{
+		if (GENERAL_FE_FIELD == field->fe_field_type)
+		{
+			/* working space is per thread so element_field_values is not modified */
+			static thread_local std::vector<FE_value> basisFunctionValuesWorkspace;
+			if (basisFunctionValuesWorkspace.size() <
+				static_cast<size_t>(element_field_values->basis_function_values_size))
+			{
+				basisFunctionValuesWorkspace.resize(element_field_values->basis_function_values_size);
+			}
+			basis_function_values = basisFunctionValuesWorkspace.data();
+		}
 		const int dimension = element_field_values->element->getDimension();
 		if ((0<=component_number)&&(component_number<field->number_of_components))
 		{
@@ -14274,7 +14500,7 @@ the derivatives will start at the first position of <jacobian>.
 				component_standard_basis_function += comp_no;
 				component_standard_basis_function_arguments += comp_no;
 				number_of_xi_coordinates = dimension;
-				int *element_value_offsets = 0;
+				int element_value_offsets[1 << MAXIMUM_ELEMENT_XI_DIMENSIONS];
 				int *element_value_offset = 0;
 				int number_of_values = 0;
 				int offset = 0;
@@ -14312,7 +14538,6 @@ the derivatives will start at the first position of <jacobian>.
 							i=0;
 							offset=element_field_values->component_base_grid_offset[this_comp_no];
 							*basis_function_values=1;
-							element_value_offsets = element_field_values->element_value_offsets;
 							*element_value_offsets=0;
 							m=1;
 							while (return_code&&(i<number_of_xi_coordinates))
@@ -14456,29 +14681,52 @@ the derivatives will start at the first position of <jacobian>.
 							current_standard_basis_function_arguments=
 								*component_standard_basis_function_arguments;
 							number_of_values= *component_number_of_values;
-							/* calculate the values for the standard basis functions */
-							if (!(current_standard_basis_function)(
+							if (xi_point_set)
+							{
+								/* look up tabulated values at the point */
+								standard_basis_function_values = xi_point_set->getBasisValues(
+									current_standard_basis_function,
+									current_standard_basis_function_arguments,
+									number_of_values, xi_point_index);
+								if (!standard_basis_function_values)
+								{
+									return_code=0;
+								}
+							}
+							/* calculate the values for the standard basis functions with
+								 kernel specialised for common bases */
+							else if ((standard_basis_function_get_kernel(
+								current_standard_basis_function,
+								current_standard_basis_function_arguments))(
 								current_standard_basis_function_arguments,xi_coordinates,
 								basis_function_values))
+							{
+								standard_basis_function_values = basis_function_values;
+							}
+							else
 							{
 								display_message(ERROR_MESSAGE,"calculate_FE_element_field.  "
 									"Error calculating standard basis");
 								return_code=0;
 							}
+							if (!return_code)
+							{
+								break;
+							}
 						}
 						/* calculate the element field value as a dot product of the element
 							 values and the basis function values */
-						basis_value=basis_function_values;
+						standard_basis_value=standard_basis_function_values;
 						element_value= *component_values;
 						sum=0;
 						for (j=number_of_values;j>0;j--)
 						{
 #if defined (DOUBLE_FOR_DOT_PRODUCT)
-							sum += (double)(*element_value)*(double)(*basis_value);
+							sum += (double)(*element_value)*(double)(*standard_basis_value);
 #else /* defined (DOUBLE_FOR_DOT_PRODUCT) */
-							sum += (*element_value)*(*basis_value);
+							sum += (*element_value)*(*standard_basis_value);
 #endif /* defined (DOUBLE_FOR_DOT_PRODUCT) */
-							basis_value++;
+							standard_basis_value++;
 							element_value++;
 						}
 						*calculated_value=(FE_value)sum;
@@ -14487,15 +14735,15 @@ the derivatives will start at the first position of <jacobian>.
 							for (k=number_of_xi_coordinates;k>0;k--)
 							{
 								sum=0;
-								basis_value=basis_function_values;
+								standard_basis_value=standard_basis_function_values;
 								for (j=number_of_values;j>0;j--)
 								{
 #if defined (DOUBLE_FOR_DOT_PRODUCT)
-									sum += (double)(*element_value)*(double)(*basis_value);
+									sum += (double)(*element_value)*(double)(*standard_basis_value);
 #else /* defined (DOUBLE_FOR_DOT_PRODUCT) */
-									sum += (*element_value)*(*basis_value);
+									sum += (*element_value)*(*standard_basis_value);
 #endif /* defined (DOUBLE_FOR_DOT_PRODUCT) */
-									basis_value++;
+									standard_basis_value++;
 									element_value++;
 								}
 								*derivative=(FE_value)sum;
@@ -14529,6 +14777,79 @@ the derivatives will start at the first position of <jacobian>.
 	return (return_code);
 } /* calculate_FE_element_field */
 
+bool FE_element_field_values_is_monomial(
+	struct FE_element_field_values *element_field_values)
+{
+	if (!(element_field_values && element_field_values->field &&
+		(GENERAL_FE_FIELD == element_field_values->field->fe_field_type) &&
+		element_field_values->component_standard_basis_functions &&
+		element_field_values->component_standard_basis_function_arguments))
+		return false;
+	for (int c = 0; c < element_field_values->number_of_components; ++c)
+	{
+		if ((element_field_values->component_number_in_xi &&
+				element_field_values->component_number_in_xi[c]) ||
+			(!standard_basis_function_is_monomial(
+				element_field_values->component_standard_basis_functions[c],
+				(void *)element_field_values->component_standard_basis_function_arguments[c])))
+			return false;
+	}
+	return true;
+}
+
+int calculate_FE_element_field_grid(
+	struct FE_element_field_values *element_field_values,
+	const int *numbers_of_points, const FE_value *grid_xi, FE_value *values,
+	FE_value *jacobian)
+{
+	if (!(FE_element_field_values_is_monomial(element_field_values) &&
+		numbers_of_points && grid_xi && values &&
+		((!jacobian) || element_field_values->derivatives_calculated)))
+	{
+		display_message(ERROR_MESSAGE,
+			"calculate_FE_element_field_grid.  Invalid argument(s)");
+		return 0;
+	}
+	const int dimension = element_field_values->element->getDimension();
+	const int number_of_components = element_field_values->number_of_components;
+	int number_of_points = 1;
+	for (int d = 0; d < dimension; ++d)
+		number_of_points *= numbers_of_points[d];
+	/* working space is per thread so element_field_values is not modified */
+	static thread_local std::vector<FE_value> grid_values_workspace;
+	if (grid_values_workspace.size() < static_cast<size_t>(number_of_points))
+		grid_values_workspace.resize(number_of_points);
+	FE_value *grid_values = grid_values_workspace.data();
+	for (int c = 0; c < number_of_components; ++c)
+	{
+		const int *arguments = element_field_values->component_standard_basis_function_arguments[c];
+		const int number_of_values = element_field_values->component_number_of_values[c];
+		/* values for derivatives with respect to each xi follow those for the field */
+		const FE_value *coefficients = element_field_values->component_values[c];
+		const int number_of_blocks = (jacobian) ? dimension + 1 : 1;
+		for (int b = 0; b < number_of_blocks; ++b)
+		{
+			if (!monomial_basis_evaluate_grid(arguments, coefficients,
+				numbers_of_points, grid_xi, grid_values))
+				return 0;
+			if (0 == b)
+			{
+				for (int p = 0; p < number_of_points; ++p)
+					values[p*number_of_components + c] = grid_values[p];
+			}
+			else
+			{
+				FE_value *derivative = jacobian + c*dimension + (b - 1);
+				const int stride = number_of_components*dimension;
+				for (int p = 0; p < number_of_points; ++p)
+					derivative[p*stride] = grid_values[p];
+			}
+			coefficients += number_of_values;
+		}
+	}
+	return 1;
+}
+
 int calculate_FE_element_field_as_string(int component_number,
 	struct FE_element_field_values *element_field_values,
 	const FE_value *xi_coordinates, char **string)
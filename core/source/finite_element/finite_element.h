@@ -45,6 +45,7 @@ class FE_nodeset;
  */
 class FE_mesh_field_data;
 class FE_mesh;
+class FE_xi_point_set;
 
 /**
  * FE_field and FE_element haves pointers to owning FE_region in shared field info.
@@ -563,7 +564,7 @@ DsLabelIndex get_FE_node_index(struct FE_node *node);
 
 /**
  * Set the index of the node in owning nodeset. Used only by FE_nodeset when
- * merging nodes from another region's nodeset.
+ * merging nodes from another region's nodeset or reordering nodes.
  * @param node  The node to modify.
  * @param index  The new index, non-negative. Value is not checked due
  * to use by privileged caller.
@@ -661,6 +662,8 @@ Destroys the element_field_values at *<element_field_info_address>. Frees the
 memory for the information and sets <*element_field_info_address> to NULL.
 ==============================================================================*/
 
+PROTOTYPE_OBJECT_FUNCTIONS(FE_element_field_values);
+
 PROTOTYPE_LIST_FUNCTIONS(FE_element_field_values);
 
 PROTOTYPE_FIND_BY_IDENTIFIER_IN_LIST_FUNCTION(FE_element_field_values,element,struct FE_element *);
@@ -716,6 +719,13 @@ Returns true if the <element_field_values> are valid for calculating
 derivatives.
 ==============================================================================*/
 
+/**
+ * @return  True if element_field_values were calculated at a particular time
+ * and are only valid at that time, false if valid at all times.
+ */
+bool FE_element_field_values_is_time_dependent(
+	struct FE_element_field_values *element_field_values);
+
 /**
  * The function allocates an array, <*element_field_nodes_array_address> to store the
  * pointers to the ACCESS'd element nodes.  Components that are not node-based are
@@ -743,7 +753,8 @@ int calculate_FE_element_field_nodes(struct FE_element *element,
 
 int calculate_FE_element_field(int component_number,
 	struct FE_element_field_values *element_field_values,
-	const FE_value *xi_coordinates, FE_value *values, FE_value *jacobian);
+	const FE_value *xi_coordinates, FE_value *values, FE_value *jacobian,
+	FE_xi_point_set *xi_point_set = 0, int xi_point_index = -1);
 /*******************************************************************************
 LAST MODIFIED : 2 October 1998
 
@@ -755,8 +766,39 @@ the derivatives values have been calculated).  Only the <component_number>+1
 component will be calculated if 0<=component_number<number of components.  For a
 single component, the value will be put in the first position of <values> and
 the derivatives will start at the first position of <jacobian>.
+If <xi_point_set> is supplied, <xi_coordinates> must be those of point
+<xi_point_index> in it, and standard basis function values are taken from its
+tables instead of being recalculated.
 ==============================================================================*/
 
+/**
+ * @return  True if all components of element_field_values are interpolated by
+ * tensor product monomial bases, hence can be evaluated by
+ * calculate_FE_element_field_grid.
+ */
+bool FE_element_field_values_is_monomial(
+	struct FE_element_field_values *element_field_values);
+
+/**
+ * Calculates values and optionally derivatives of all components of the field
+ * in element_field_values at a tensor product grid of xi points, by sum
+ * factorisation one xi direction at a time. Must only be called if
+ * FE_element_field_values_is_monomial.
+ * @param numbers_of_points  Number of grid points in each xi direction.
+ * @param grid_xi  Xi values of grid points in each direction: all points for
+ * xi1, followed by those for xi2 etc.
+ * @param values  Array to receive all components at each grid point in turn,
+ * with xi1 varying fastest.
+ * @param jacobian  Optional array to receive derivatives with respect to each
+ * xi for each component at each grid point in turn. Requires derivatives to
+ * have been calculated in element_field_values.
+ * @return  1 on success, 0 on failure.
+ */
+int calculate_FE_element_field_grid(
+	struct FE_element_field_values *element_field_values,
+	const int *numbers_of_points, const FE_value *grid_xi, FE_value *values,
+	FE_value *jacobian);
+
 int calculate_FE_element_field_as_string(int component_number,
 	struct FE_element_field_values *element_field_values,
 	const FE_value *xi_coordinates, char **string);
@@ -542,6 +542,183 @@ NB.  xi_1 is varying fastest (xi_n slowest)
 	return (return_code);
 } /* monomial_basis_functions */
 
+namespace {
+
+/* Monomial basis function kernels specialised at compile time for orders up
+	to cubic in up to 3 dimensions, covering all blended Lagrange, Hermite and
+	simplex bases in common use. Values are the same as those calculated by
+	monomial_basis_functions, in the same order with xi1 varying fastest. */
+
+const int MONOMIAL_KERNEL_MAXIMUM_ORDER = 3;
+
+template <int order> inline void monomial_powers(FE_value xi, FE_value *powers)
+{
+	powers[0] = 1.0;
+	for (int j = 1; j <= order; ++j)
+		powers[j] = powers[j - 1]*xi;
+}
+
+template <int order1> int monomial_basis_functions_1d(void * /*type_arguments*/,
+	const FE_value *xi_coordinates, FE_value *function_values)
+{
+	monomial_powers<order1>(xi_coordinates[0], function_values);
+	return 1;
+}
+
+template <int order1, int order2> int monomial_basis_functions_2d(
+	void * /*type_arguments*/, const FE_value *xi_coordinates, FE_value *function_values)
+{
+	FE_value powers1[order1 + 1], powers2[order2 + 1];
+	monomial_powers<order1>(xi_coordinates[0], powers1);
+	monomial_powers<order2>(xi_coordinates[1], powers2);
+	FE_value *value = function_values;
+	for (int j2 = 0; j2 <= order2; ++j2)
+		for (int j1 = 0; j1 <= order1; ++j1)
+			*(value++) = powers1[j1]*powers2[j2];
+	return 1;
+}
+
+template <int order1, int order2, int order3> int monomial_basis_functions_3d(
+	void * /*type_arguments*/, const FE_value *xi_coordinates, FE_value *function_values)
+{
+	FE_value powers1[order1 + 1], powers2[order2 + 1], powers3[order3 + 1];
+	monomial_powers<order1>(xi_coordinates[0], powers1);
+	monomial_powers<order2>(xi_coordinates[1], powers2);
+	monomial_powers<order3>(xi_coordinates[2], powers3);
+	FE_value *value = function_values;
+	for (int j3 = 0; j3 <= order3; ++j3)
+		for (int j2 = 0; j2 <= order2; ++j2)
+			for (int j1 = 0; j1 <= order1; ++j1)
+				*(value++) = powers1[j1]*powers2[j2]*powers3[j3];
+	return 1;
+}
+
+/* kernel tables indexed by order - 1 in each direction */
+
+Standard_basis_function *const monomial_kernels_1d[MONOMIAL_KERNEL_MAXIMUM_ORDER] =
+{
+	monomial_basis_functions_1d<1>,
+	monomial_basis_functions_1d<2>,
+	monomial_basis_functions_1d<3>
+};
+
+#define MONOMIAL_KERNELS_2D(order1) \
+	{ \
+		monomial_basis_functions_2d<order1, 1>, \
+		monomial_basis_functions_2d<order1, 2>, \
+		monomial_basis_functions_2d<order1, 3> \
+	}
+
+Standard_basis_function *const monomial_kernels_2d[MONOMIAL_KERNEL_MAXIMUM_ORDER][MONOMIAL_KERNEL_MAXIMUM_ORDER] =
+{
+	MONOMIAL_KERNELS_2D(1),
+	MONOMIAL_KERNELS_2D(2),
+	MONOMIAL_KERNELS_2D(3)
+};
+
+#define MONOMIAL_KERNELS_3D(order1, order2) \
+	{ \
+		monomial_basis_functions_3d<order1, order2, 1>, \
+		monomial_basis_functions_3d<order1, order2, 2>, \
+		monomial_basis_functions_3d<order1, order2, 3> \
+	}
+
+Standard_basis_function *const monomial_kernels_3d[MONOMIAL_KERNEL_MAXIMUM_ORDER][MONOMIAL_KERNEL_MAXIMUM_ORDER][MONOMIAL_KERNEL_MAXIMUM_ORDER] =
+{
+	{ MONOMIAL_KERNELS_3D(1, 1), MONOMIAL_KERNELS_3D(1, 2), MONOMIAL_KERNELS_3D(1, 3) },
+	{ MONOMIAL_KERNELS_3D(2, 1), MONOMIAL_KERNELS_3D(2, 2), MONOMIAL_KERNELS_3D(2, 3) },
+	{ MONOMIAL_KERNELS_3D(3, 1), MONOMIAL_KERNELS_3D(3, 2), MONOMIAL_KERNELS_3D(3, 3) }
+};
+
+#undef MONOMIAL_KERNELS_2D
+#undef MONOMIAL_KERNELS_3D
+
+} // anonymous namespace
+
+Standard_basis_function *standard_basis_function_get_kernel(
+	Standard_basis_function *function, const int *arguments)
+{
+	if ((monomial_basis_functions != function) || (!arguments))
+		return function;
+	const int dimension = arguments[0];
+	if ((dimension < 1) || (dimension > 3))
+		return function;
+	for (int d = 1; d <= dimension; ++d)
+		if ((arguments[d] < 1) || (arguments[d] > MONOMIAL_KERNEL_MAXIMUM_ORDER))
+			return function;
+	switch (dimension)
+	{
+	case 1:
+		return monomial_kernels_1d[arguments[1] - 1];
+	case 2:
+		return monomial_kernels_2d[arguments[1] - 1][arguments[2] - 1];
+	case 3:
+		return monomial_kernels_3d[arguments[1] - 1][arguments[2] - 1][arguments[3] - 1];
+	}
+	return function;
+}
+
+int monomial_basis_evaluate_grid(const int *type_arguments,
+	const FE_value *coefficients, const int *numbers_of_points,
+	const FE_value *grid_xi, FE_value *values)
+{
+	if (!(type_arguments && (1 <= type_arguments[0]) && coefficients &&
+		numbers_of_points && grid_xi && values))
+	{
+		display_message(ERROR_MESSAGE,
+			"monomial_basis_evaluate_grid.  Invalid argument(s)");
+		return 0;
+	}
+	const int number_of_xi_coordinates = type_arguments[0];
+	int in_size = 1;
+	for (int d = 0; d < number_of_xi_coordinates; ++d)
+		in_size *= type_arguments[d + 1] + 1;
+	/* working space is per thread; alternate between two buffers */
+	static thread_local std::vector<FE_value> workspace[2];
+	const FE_value *in = coefficients;
+	const FE_value *xi = grid_xi;
+	for (int d = 0; d < number_of_xi_coordinates; ++d)
+	{
+		/* contract the fastest varying index, the power of xi d, with the
+			values at each point in direction d, which becomes the slowest index */
+		const int m = type_arguments[d + 1] + 1;
+		const int r = in_size/m;
+		const int number_of_points = numbers_of_points[d];
+		const int out_size = r*number_of_points;
+		FE_value *out;
+		if (d == (number_of_xi_coordinates - 1))
+		{
+			out = values;
+		}
+		else
+		{
+			std::vector<FE_value>& buffer = workspace[d % 2];
+			if (buffer.size() < static_cast<size_t>(out_size))
+				buffer.resize(out_size);
+			out = buffer.data();
+		}
+		for (int p = 0; p < number_of_points; ++p)
+		{
+			const FE_value x = xi[p];
+			const FE_value *coefficient = in;
+			FE_value *out_value = out + r*p;
+			for (int k = 0; k < r; ++k)
+			{
+				/* Horner's rule */
+				FE_value sum = coefficient[m - 1];
+				for (int a = m - 2; a >= 0; --a)
+					sum = sum*x + coefficient[a];
+				out_value[k] = sum;
+				coefficient += m;
+			}
+		}
+		in = out;
+		in_size = out_size;
+		xi += number_of_points;
+	}
+	return 1;
+}
+
 int polygon_basis_functions(void *type_arguments,
 	const FE_value *xi_coordinates, FE_value *function_values)
 /*******************************************************************************
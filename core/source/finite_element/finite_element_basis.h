@@ -259,6 +259,44 @@ int FE_basis_is_non_linear(struct FE_basis *basis);
 int monomial_basis_functions(void *type_arguments,
 	const FE_value *xi_coordinates, FE_value *function_values);
 
+/**
+ * Get the kernel to call for evaluating a standard basis function with the
+ * given arguments. Monomial bases with orders from 1 to 3 in up to 3
+ * dimensions, i.e. blended linear, quadratic and cubic Lagrange, cubic
+ * Hermite and simplex bases, have kernels specialised at compile time.
+ * The returned kernel gives the same values as function, but function is
+ * still to be used for identifying the type of basis.
+ * Only the monomial values are specialised: Lagrange and Hermite values are
+ * still obtained by multiplying them by the basis blending matrix.
+ * @param function  The standard basis function.
+ * @param arguments  Its arguments, starting with the number of xi coordinates.
+ * @return  Specialised kernel if available, otherwise function.
+ */
+Standard_basis_function *standard_basis_function_get_kernel(
+	Standard_basis_function *function, const int *arguments);
+
+/**
+ * Evaluates a field interpolated by a tensor product monomial basis at a
+ * tensor product grid of xi points by sum factorisation: the monomial
+ * coefficients are contracted with the powers of one xi direction at a time,
+ * for all grid points in that direction. Cost is proportional to the number
+ * of coefficients times the number of points in the first direction, plus
+ * smaller terms, instead of their product.
+ * @param type_arguments  Monomial basis arguments: number of xi coordinates,
+ * then the order in each xi direction.
+ * @param coefficients  Coefficients of the monomial basis functions, in the
+ * order of values from monomial_basis_functions.
+ * @param numbers_of_points  Number of grid points in each xi direction.
+ * @param grid_xi  Xi values of the grid points in each direction: all points
+ * for xi1, followed by those for xi2 etc.
+ * @param values  Array to receive value at each grid point, with xi1 varying
+ * fastest.
+ * @return  1 on success, 0 on failure.
+ */
+int monomial_basis_evaluate_grid(const int *type_arguments,
+	const FE_value *coefficients, const int *numbers_of_points,
+	const FE_value *grid_xi, FE_value *values);
+
 /* exposed only for comparing function pointers */
 int polygon_basis_functions(void *type_arguments,
 	const FE_value *xi_coordinates, FE_value *function_values);
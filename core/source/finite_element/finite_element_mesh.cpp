@@ -17,6 +17,10 @@
 #include "general/debug.h"
 #include "general/message.h"
 #include "general/mystring.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
 
 /*
 Module types
@@ -308,7 +312,7 @@ cmzn_element::~cmzn_element()
 	if (0 != this->access_count)
 	{
 		display_message(ERROR_MESSAGE, "~cmzn_element.  Element destroyed with non-zero access count %d. Dimension %d Index %d",
-			this->access_count, this->mesh ? this->mesh->getDimension() : -1, this->index);
+			this->access_count.load(), this->mesh ? this->mesh->getDimension() : -1, this->index);
 	}
 }
 
@@ -414,6 +418,78 @@ void FE_mesh_element_field_template_data::decrementMeshfieldtemplateUsageCount(D
 		display_message(ERROR_MESSAGE, "FE_mesh_element_field_template_data::decrementMeshfieldtemplateUsageCount.  Missing count");
 }
 
+void FE_mesh_element_field_template_data::list_storage_details() const
+{
+	display_message(INFORMATION_MESSAGE, "  Element field template %d: %d local nodes, %d local scale factors\n",
+		this->eft->getIndexInMesh() + 1, this->localNodeCount, this->localScaleFactorCount);
+	if (0 < this->localNodeCount)
+	{
+		display_message(INFORMATION_MESSAGE, "    Local-to-global nodes: %s\n",
+			this->localToGlobalNodes.getStorageDetails().c_str());
+	}
+	if (0 < this->localScaleFactorCount)
+	{
+		display_message(INFORMATION_MESSAGE, "    Local-to-global scale factors: %s\n",
+			this->localToGlobalScaleFactors.getStorageDetails().c_str());
+	}
+	display_message(INFORMATION_MESSAGE, "    Usage counts: %lu bytes\n",
+		static_cast<unsigned long>(this->meshfieldtemplateUsageCount.getAllocatedBytes()));
+}
+
+std::shared_ptr<const FE_element_field_gather_plan> FE_mesh_element_field_template_data::getGatherPlan(
+	FE_field *field, int componentNumber, const FE_node_field_info *nodeFieldInfo,
+	unsigned int nodeFieldInfoGeneration) const
+{
+	std::lock_guard<std::mutex> lock(this->gatherPlansMutex);
+	for (std::vector<GatherPlanEntry>::const_iterator iter = this->gatherPlans.begin(); iter != this->gatherPlans.end(); ++iter)
+		if ((iter->field == field) && (iter->componentNumber == componentNumber) &&
+			(iter->nodeFieldInfo == nodeFieldInfo) && (iter->nodeFieldInfoGeneration == nodeFieldInfoGeneration))
+			return iter->plan;
+	return std::shared_ptr<const FE_element_field_gather_plan>();
+}
+
+void FE_mesh_element_field_template_data::setGatherPlan(FE_field *field, int componentNumber,
+	const FE_node_field_info *nodeFieldInfo, unsigned int nodeFieldInfoGeneration,
+	const std::shared_ptr<const FE_element_field_gather_plan>& plan)
+{
+	std::lock_guard<std::mutex> lock(this->gatherPlansMutex);
+	std::vector<GatherPlanEntry>::iterator iter = this->gatherPlans.begin();
+	while (iter != this->gatherPlans.end())
+	{
+		if ((iter->field == field) && (iter->componentNumber == componentNumber) &&
+			((iter->nodeFieldInfo == nodeFieldInfo) || (iter->nodeFieldInfoGeneration != nodeFieldInfoGeneration)))
+		{
+			DEACCESS(FE_field)(&(iter->field));
+			iter = this->gatherPlans.erase(iter);
+		}
+		else
+			++iter;
+	}
+	GatherPlanEntry entry;
+	entry.field = ACCESS(FE_field)(field);
+	entry.componentNumber = componentNumber;
+	entry.nodeFieldInfo = nodeFieldInfo;
+	entry.nodeFieldInfoGeneration = nodeFieldInfoGeneration;
+	entry.plan = plan;
+	this->gatherPlans.push_back(entry);
+}
+
+void FE_mesh_element_field_template_data::clearGatherPlans(FE_field *field)
+{
+	std::lock_guard<std::mutex> lock(this->gatherPlansMutex);
+	std::vector<GatherPlanEntry>::iterator iter = this->gatherPlans.begin();
+	while (iter != this->gatherPlans.end())
+	{
+		if ((!field) || (iter->field == field))
+		{
+			DEACCESS(FE_field)(&(iter->field));
+			iter = this->gatherPlans.erase(iter);
+		}
+		else
+			++iter;
+	}
+}
+
 DsLabelIndex FE_mesh_element_field_template_data::getElementFirstNodeIndex(DsLabelIndex elementIndex) const
 {
 	if (this->eft->getParameterMappingMode() != CMZN_ELEMENTFIELDTEMPLATE_PARAMETER_MAPPING_MODE_NODE)
@@ -463,6 +539,32 @@ DsLabelIndex FE_mesh_element_field_template_data::getElementIndexLimit() const
 	return elementIndexLimit;
 }
 
+void FE_mesh_element_field_template_data::permuteNodeIndexes(const DsLabelIndex *newNodeIndexes)
+{
+	if (this->localNodeCount <= 0)
+		return;
+	const DsLabelIndex elementIndexLimit = this->getElementIndexLimit();
+	for (DsLabelIndex elementIndex = this->getElementIndexStart(); elementIndex < elementIndexLimit; ++elementIndex)
+	{
+		DsLabelIndex *nodeIndexes = this->getElementNodeIndexes(elementIndex);
+		if (nodeIndexes)
+		{
+			for (int i = 0; i < this->localNodeCount; ++i)
+				if (nodeIndexes[i] >= 0)
+					nodeIndexes[i] = newNodeIndexes[nodeIndexes[i]];
+		}
+	}
+}
+
+bool FE_mesh_element_field_template_data::permuteElementIndexes(DsLabelIndex oldElementIndexSize,
+	const DsLabelIndex *newElementIndexes)
+{
+	// gather plans are per EFT, not per element, so remain valid
+	return this->localToGlobalNodes.permute(oldElementIndexSize, newElementIndexes)
+		&& this->localToGlobalScaleFactors.permute(oldElementIndexSize, newElementIndexes)
+		&& this->meshfieldtemplateUsageCount.permute(oldElementIndexSize, newElementIndexes);
+}
+
 /** @return  Lowest element index for which EFT is probably set */
 DsLabelIndex FE_mesh_element_field_template_data::getElementIndexStart() const
 {
@@ -591,6 +693,31 @@ int FE_mesh_element_field_template_data::setElementLocalNodes(
 	return CMZN_OK;
 }
 
+int FE_mesh_element_field_template_data::setNewElementLocalNodes(
+	DsLabelIndex elementIndex, const DsLabelIndex *nodeIndexes)
+{
+	FE_mesh *mesh = this->eft->getMesh();
+	FE_nodeset *nodeset = (mesh) ? mesh->getNodeset() : 0;
+	if (!nodeset)
+		return CMZN_ERROR_ARGUMENT;
+	DsLabelIndex *elementNodeIndexes = this->getOrCreateElementNodeIndexes(elementIndex);
+	if (!elementNodeIndexes)
+	{
+		display_message(ERROR_MESSAGE,
+			"FE_mesh_element_field_template_data::setNewElementLocalNodes.  Failed to create element node indexes");
+		return CMZN_ERROR_MEMORY;
+	}
+	for (int n = 0; n < this->localNodeCount; ++n)
+	{
+		if (nodeIndexes[n] >= 0)
+		{
+			nodeset->incrementElementUsageCount(nodeIndexes[n]);
+			elementNodeIndexes[n] = nodeIndexes[n];
+		}
+	}
+	return CMZN_OK;
+}
+
 int FE_mesh_element_field_template_data::setElementLocalNodesByIdentifier(
 	DsLabelIndex elementIndex, const DsLabelIdentifier *nodeIdentifiers)
 {
@@ -742,16 +869,20 @@ int FE_mesh_element_field_template_data::getElementLocalToGlobalNodeMapCount() c
 	return count;
 }
 
-/** Merges local-to-global node map, scale factors from source, finding target
-  * elements and nodes by identifier.
+/** Merges local-to-global node map, scale factors from source, into target
+  * elements and nodes with the same identifiers.
   * Used only by FE_mesh::merge to merge data from another region.
   * Must have already merged mesh field templates such that the target element field
   * template expects the right numbers of nodes, scale factors.
   * Warns about changes to element local nodes.
   * Should only call if source.hasElementVaryingData() returns true.
   * @param source  Source element field template data to merge.
+  * @param sourceToTargetElementIndexes  Target element index for each source element index.
+  * @param sourceToTargetNodeIndexes  Target node index for each source node index.
   * @return  True on success, false on failure. */
-bool FE_mesh_element_field_template_data::mergeElementVaryingData(const FE_mesh_element_field_template_data& source)
+bool FE_mesh_element_field_template_data::mergeElementVaryingData(const FE_mesh_element_field_template_data& source,
+	const std::vector<DsLabelIndex>& sourceToTargetElementIndexes,
+	const std::vector<DsLabelIndex>& sourceToTargetNodeIndexes)
 {
 	const FE_mesh *sourceMesh = source.eft->getMesh();
 	const FE_mesh *targetMesh = this->eft->getMesh();
@@ -761,19 +892,21 @@ bool FE_mesh_element_field_template_data::mergeElementVaryingData(const FE_mesh_
 	// the above should all exist at merge time
 	bool localNodeChange = false;
 	DsLabelIdentifier localNodeChangeElementIdentifier = DS_LABEL_IDENTIFIER_INVALID;
-	const DsLabelIndex sourceElementIndexLimit = source.getElementIndexLimit();
+	const DsLabelIndex sourceNodeIndexLimit = static_cast<DsLabelIndex>(sourceToTargetNodeIndexes.size());
+	DsLabelIndex sourceElementIndexLimit = source.getElementIndexLimit();
+	if (sourceElementIndexLimit > static_cast<DsLabelIndex>(sourceToTargetElementIndexes.size()))
+		sourceElementIndexLimit = static_cast<DsLabelIndex>(sourceToTargetElementIndexes.size());
 	for (DsLabelIndex sourceElementIndex = source.getElementIndexStart(); sourceElementIndex < sourceElementIndexLimit; ++sourceElementIndex)
 	{
-		const DsLabelIdentifier elementIdentifier = sourceMesh->getElementIdentifier(sourceElementIndex);
-		if (DS_LABEL_IDENTIFIER_INVALID == elementIdentifier)
+		const DsLabelIndex targetElementIndex = sourceToTargetElementIndexes[sourceElementIndex];
+		if (targetElementIndex < 0)
 			continue; // no element at that index
 		if (source.meshfieldtemplateUsageCount.getValue(sourceElementIndex) == 0)
 			continue; // no data at that index
-		const DsLabelIndex targetElementIndex = targetMesh->findIndexByIdentifier(elementIdentifier);
-		// the above must be valid if merge has got to this point, so not testing.
+		const DsLabelIdentifier elementIdentifier = sourceMesh->getElementIdentifier(sourceElementIndex);
 		if (this->localNodeCount > 0)
 		{
-			DsLabelIndex *sourceNodes = source.localToGlobalNodes.getArray(sourceElementIndex);
+			const DsLabelIndex *sourceNodes = source.localToGlobalNodes.getArray(sourceElementIndex);
 			if (!sourceNodes)
 			{
 				display_message(ERROR_MESSAGE, "FE_mesh_element_field_template_data::mergeElementVaryingData.  "
@@ -797,12 +930,12 @@ bool FE_mesh_element_field_template_data::mergeElementVaryingData(const FE_mesh_
 				}
 				else
 				{
-					const DsLabelIdentifier nodeIdentifier = sourceNodeset->getNodeIdentifier(sourceNodeIndex);
-					targetNodeIndex = targetNodeset->findIndexByIdentifier(nodeIdentifier);
+					targetNodeIndex = (sourceNodeIndex < sourceNodeIndexLimit) ?
+						sourceToTargetNodeIndexes[sourceNodeIndex] : DS_LABEL_INDEX_INVALID;
 					if (targetNodeIndex < 0)
 					{
 						display_message(ERROR_MESSAGE, "FE_mesh_element_field_template_data::mergeElementVaryingData.  "
-							"Missing target node %d in element %d", nodeIdentifier, elementIdentifier);
+							"Missing target node %d in element %d", sourceNodeset->getNodeIdentifier(sourceNodeIndex), elementIdentifier);
 						return false;
 					}
 				}
@@ -1094,11 +1227,14 @@ bool FE_mesh_field_template::setElementfieldtemplateIndex(DsLabelIndex elementIn
  * @param source  Source mesh field template to compare with.
  * @param sourceEFTIndexMap  Vector mapping eft index in source MFT's mesh to
  * eft indexes for this MFT's mesh.
+ * @param sourceToTargetElementIndexes  Vector mapping element index in source
+ * MFT's mesh to index of element with the same identifier in this MFT's mesh.
  * @param superset  If true, this MFT matches if superset of source, otherwise exact match.
  * @return  True if match, false if not.
  */
 bool FE_mesh_field_template::matchesWithEFTIndexMap(const FE_mesh_field_template &source,
-	const std::vector<EFTIndexType> &sourceEFTIndexMap, bool superset) const
+	const std::vector<EFTIndexType> &sourceEFTIndexMap,
+	const std::vector<DsLabelIndex> &sourceToTargetElementIndexes, bool superset) const
 {
 	// try to trivially reject first, since expensive to match
 	if (this->mapSize != source.mapSize)
@@ -1106,19 +1242,20 @@ bool FE_mesh_field_template::matchesWithEFTIndexMap(const FE_mesh_field_template
 	if ((0 == this->mesh) || (0 == source.mesh))
 		return false;
 	// iterate over source mesh elements as efficiently as possible, in index order
+	const DsLabelIndex sourceToTargetElementIndexCount = static_cast<DsLabelIndex>(sourceToTargetElementIndexes.size());
 	const DsLabelIndex sourceElementIndexLimit = source.getElementIndexLimit();
 	for (DsLabelIndex sourceElementIndex = source.getElementIndexStart(); sourceElementIndex < sourceElementIndexLimit; ++sourceElementIndex)
 	{
-		const DsLabelIdentifier elementIdentifier = source.mesh->getElementIdentifier(sourceElementIndex);
-		if (DS_LABEL_IDENTIFIER_INVALID == elementIdentifier)
-			continue; // no element at that index. Shouldn't happen when merging newly-read input file
 		EFTIndexType sourceEFTIndex;
 		if ((!source.eftDataMap.getValue(sourceElementIndex, sourceEFTIndex))
 			|| (sourceEFTIndex == ELEMENT_FIELD_TEMPLATE_DATA_INDEX_INVALID))
 			continue; // field template not defined at that index
-		const DsLabelIndex targetElementIndex = this->mesh->findIndexByIdentifier(elementIdentifier);
+		const DsLabelIndex targetElementIndex = (sourceElementIndex < sourceToTargetElementIndexCount) ?
+			sourceToTargetElementIndexes[sourceElementIndex] : DS_LABEL_INDEX_INVALID;
 		if (DS_LABEL_INDEX_INVALID == targetElementIndex)
 		{
+			if (DS_LABEL_IDENTIFIER_INVALID == source.mesh->getElementIdentifier(sourceElementIndex))
+				continue; // no element at that index. Shouldn't happen when merging newly-read input file
 			display_message(ERROR_MESSAGE, "FE_mesh_field_template::matchesWithEFTIndexMap.  Missing element.");
 			return false; // unexpected; element should exist at this stage of merge
 		}
@@ -1135,27 +1272,31 @@ bool FE_mesh_field_template::matchesWithEFTIndexMap(const FE_mesh_field_template
  * @param source  Source mesh field template to merge in.
  * @param sourceEFTIndexMap  Vector mapping eft index in source MFT's mesh to
  * eft indexes for this MFT's mesh.
+ * @param sourceToTargetElementIndexes  Vector mapping element index in source
+ * MFT's mesh to index of element with the same identifier in this MFT's mesh.
  * @return  True on success, false on failure.
  */
 bool FE_mesh_field_template::mergeWithEFTIndexMap(const FE_mesh_field_template &source,
-	const std::vector<EFTIndexType> &sourceEFTIndexMap)
+	const std::vector<EFTIndexType> &sourceEFTIndexMap,
+	const std::vector<DsLabelIndex> &sourceToTargetElementIndexes)
 {
 	if ((0 == this->mesh) || (0 == source.mesh))
 		return false;
+	const DsLabelIndex sourceToTargetElementIndexCount = static_cast<DsLabelIndex>(sourceToTargetElementIndexes.size());
 	// iterate over source mesh elements as efficiently as possible, in index order
 	const DsLabelIndex sourceElementIndexLimit = source.getElementIndexLimit();
 	for (DsLabelIndex sourceElementIndex = source.getElementIndexStart(); sourceElementIndex < sourceElementIndexLimit; ++sourceElementIndex)
 	{
-		const DsLabelIdentifier elementIdentifier = source.mesh->getElementIdentifier(sourceElementIndex);
-		if (DS_LABEL_IDENTIFIER_INVALID == elementIdentifier)
-			continue; // no element at that index. Shouldn't happen when merging newly-read input file
 		EFTIndexType sourceEFTIndex;
 		if ((!source.eftDataMap.getValue(sourceElementIndex, sourceEFTIndex))
 			|| (sourceEFTIndex == ELEMENT_FIELD_TEMPLATE_DATA_INDEX_INVALID))
 			continue; // field template not defined at that index
-		const DsLabelIndex targetElementIndex = this->mesh->findIndexByIdentifier(elementIdentifier);
+		const DsLabelIndex targetElementIndex = (sourceElementIndex < sourceToTargetElementIndexCount) ?
+			sourceToTargetElementIndexes[sourceElementIndex] : DS_LABEL_INDEX_INVALID;
 		if (DS_LABEL_INDEX_INVALID == targetElementIndex)
 		{
+			if (DS_LABEL_IDENTIFIER_INVALID == source.mesh->getElementIdentifier(sourceElementIndex))
+				continue; // no element at that index. Shouldn't happen when merging newly-read input file
 			display_message(ERROR_MESSAGE, "FE_mesh_field_template::mergeWithEFTIndexMap.  Missing element.");
 			return false; // unexpected; element should exist at this stage of merge
 		}
@@ -1229,6 +1370,21 @@ DsLabelIndex FE_mesh::ElementShapeFaces::getElementFace(DsLabelIndex elementInde
 	return faces[faceNumber];
 }
 
+void FE_mesh::ElementShapeFaces::permuteFaceIndexes(const DsLabelIndex *newFaceIndexes)
+{
+	const DsLabelIndex indexLimit = this->faces.getIndexLimit();
+	for (DsLabelIndex elementIndex = 0; elementIndex < indexLimit; ++elementIndex)
+	{
+		DsLabelIndex *faceIndexes = this->faces.getArray(elementIndex);
+		if (faceIndexes)
+		{
+			for (int i = 0; i < this->faceCount; ++i)
+				if (faceIndexes[i] >= 0)
+					faceIndexes[i] = newFaceIndexes[faceIndexes[i]];
+		}
+	}
+}
+
 FE_mesh::FE_mesh(FE_region *fe_regionIn, int dimensionIn) :
 	fe_region(fe_regionIn),
 	dimension(dimensionIn),
@@ -1242,8 +1398,8 @@ FE_mesh::FE_mesh(FE_region *fe_regionIn, int dimensionIn) :
 	parentMesh(0),
 	faceMesh(0),
 	changeLog(0),
-	element_type_node_sequence_list(0),
 	definingFaces(false),
+	neighbourTable(0),
 	activeElementIterators(0),
 	access_count(1)
 {
@@ -1282,6 +1438,8 @@ FE_mesh::~FE_mesh()
 	delete[] this->elementFieldTemplateData;
 	this->elementFieldTemplateDataCount = 0;
 	this->elementFieldTemplateData = 0;
+
+	delete this->neighbourTable;
 }
 
 /** Assumes called by FE_region destructor, and change notification is disabled. */
@@ -1515,7 +1673,19 @@ void FE_mesh::clearElementFieldData()
 	for (int i = 0; i < this->elementFieldTemplateDataCount; ++i)
 	{
 		if (this->elementFieldTemplateData[i])
+		{
 			this->elementFieldTemplateData[i]->clearAllElementVaryingData();
+			this->elementFieldTemplateData[i]->clearGatherPlans();
+		}
+	}
+}
+
+void FE_mesh::clearFieldGatherPlans(FE_field *field)
+{
+	for (int i = 0; i < this->elementFieldTemplateDataCount; ++i)
+	{
+		if (this->elementFieldTemplateData[i])
+			this->elementFieldTemplateData[i]->clearGatherPlans(field);
 	}
 }
 
@@ -1581,6 +1751,8 @@ void FE_mesh::clear()
 	this->scaleFactorsIndexSize = 0;
 
 	this->labels.clear();
+	if (this->neighbourTable)
+		this->neighbourTable->allChange();
 }
 
 /** Private: assumes current change log pointer is null or invalid */
@@ -1807,12 +1979,72 @@ void FE_mesh::list_btree_statistics()
 	{
 		display_message(INFORMATION_MESSAGE, "%d-D elements:\n", this->dimension);
 		this->labels.list_storage_details();
+		size_t eftElementDataBytes = 0;
+		for (int i = 0; i < this->elementFieldTemplateDataCount; ++i)
+		{
+			const FE_mesh_element_field_template_data *eftData = this->elementFieldTemplateData[i];
+			if (eftData)
+			{
+				eftData->list_storage_details();
+				eftElementDataBytes += eftData->getElementDataAllocatedBytes();
+			}
+		}
+		display_message(INFORMATION_MESSAGE, "  Element field template element data total = %lu bytes\n",
+			static_cast<unsigned long>(eftElementDataBytes));
+	}
+}
+
+void FE_mesh::getAllocatedBytes(size_t& labelsBytes, size_t& elementsBytes,
+	size_t& elementFieldTemplatesBytes, size_t& scaleFactorsBytes) const
+{
+	labelsBytes = this->labels.getAllocatedBytes();
+	elementsBytes = this->fe_elements.getAllocatedBytes()
+		+ static_cast<size_t>(this->labels.getSize())*sizeof(cmzn_element)
+		+ this->elementShapeMap.getAllocatedBytes()
+		+ this->parents.getAllocatedBytes();
+	for (int i = 0; i < this->elementShapeFacesCount; ++i)
+		elementsBytes += this->elementShapeFacesArray[i]->getAllocatedBytes();
+	if (this->neighbourTable)
+		elementsBytes += this->neighbourTable->getAllocatedBytes();
+	const DsLabelIndex parentsIndexLimit = this->parents.getBlockCount()*this->parents.getBlockLength();
+	for (DsLabelIndex index = 0; index < parentsIndexLimit; ++index)
+	{
+		const DsLabelIndex *parentsArray = this->parents.getValue(index);
+		if (parentsArray)
+			elementsBytes += (parentsArray[0] + 1)*sizeof(DsLabelIndex);
+	}
+	elementFieldTemplatesBytes = 0;
+	for (int i = 0; i < this->elementFieldTemplateDataCount; ++i)
+	{
+		const FE_mesh_element_field_template_data *eftData = this->elementFieldTemplateData[i];
+		if (eftData)
+			elementFieldTemplatesBytes += eftData->getElementDataAllocatedBytes();
+	}
+	for (std::list<FE_mesh_field_template*>::const_iterator iter = this->meshFieldTemplates.begin();
+		iter != this->meshFieldTemplates.end(); ++iter)
+		elementFieldTemplatesBytes += (*iter)->getAllocatedBytes();
+	scaleFactorsBytes = this->scaleFactors.getAllocatedBytes()
+		+ this->scaleFactorUsageCounts.getAllocatedBytes()
+		+ this->nodeScaleFactorsIndex.getAllocatedBytes();
+	const DsLabelIndex nodeIndexLimit = this->nodeScaleFactorsIndex.getBlockCount()*this->nodeScaleFactorsIndex.getBlockLength();
+	for (DsLabelIndex index = 0; index < nodeIndexLimit; ++index)
+	{
+		const DsLabelIndex *identifierIndexes = this->nodeScaleFactorsIndex.getValue(index);
+		if (identifierIndexes)
+		{
+			// zero-terminated array of identifier, index pairs
+			const DsLabelIndex *identifier = identifierIndexes;
+			while (*identifier)
+				identifier += 2;
+			scaleFactorsBytes += (identifier - identifierIndexes + 1)*sizeof(DsLabelIndex);
+		}
 	}
 }
 
 /** Remove iterator from linked list in this mesh */
 void FE_mesh::removeElementiterator(cmzn_elementiterator *iterator)
 {
+	std::lock_guard<std::mutex> lock(this->activeElementIteratorsMutex);
 	if (iterator == this->activeElementIterators)
 		this->activeElementIterators = iterator->nextIterator;
 	else
@@ -1842,6 +2074,7 @@ cmzn_elementiterator *FE_mesh::createElementiterator(DsLabelsGroup *labelsGroup)
 	cmzn_elementiterator *iterator = new cmzn_elementiterator(this, labelIterator);
 	if (iterator)
 	{
+		std::lock_guard<std::mutex> lock(this->activeElementIteratorsMutex);
 		iterator->nextIterator = this->activeElementIterators;
 		this->activeElementIterators = iterator;
 	}
@@ -1903,6 +2136,183 @@ int FE_mesh::for_each_FE_element(
 	return return_code;
 }
 
+void FE_mesh::appendElementNodeLists(std::vector<size_t>& listStarts,
+	std::vector<DsLabelIndex>& listNodeIndexes) const
+{
+	const DsLabelIndex elementIndexSize = this->labels.getIndexSize();
+	for (DsLabelIndex elementIndex = 0; elementIndex < elementIndexSize; ++elementIndex)
+	{
+		if (!this->labels.hasIndex(elementIndex))
+			continue;
+		const size_t listStart = listNodeIndexes.size();
+		for (int i = 0; i < this->elementFieldTemplateDataCount; ++i)
+		{
+			const FE_mesh_element_field_template_data *eftData = this->elementFieldTemplateData[i];
+			if ((!eftData) || (eftData->localNodeCount <= 0))
+				continue;
+			const DsLabelIndex *nodeIndexes = eftData->getElementNodeIndexes(elementIndex);
+			if (nodeIndexes)
+			{
+				for (int n = 0; n < eftData->localNodeCount; ++n)
+					if (nodeIndexes[n] >= 0)
+						listNodeIndexes.push_back(nodeIndexes[n]);
+			}
+		}
+		if (listNodeIndexes.size() > listStart)
+		{
+			std::sort(listNodeIndexes.begin() + listStart, listNodeIndexes.end());
+			listNodeIndexes.erase(std::unique(listNodeIndexes.begin() + listStart, listNodeIndexes.end()),
+				listNodeIndexes.end());
+			listStarts.push_back(listNodeIndexes.size());
+		}
+	}
+}
+
+bool FE_mesh::permuteNodeIndexes(DsLabelIndex oldNodeIndexSize, const DsLabelIndex *newNodeIndexes)
+{
+	for (int i = 0; i < this->elementFieldTemplateDataCount; ++i)
+		if (this->elementFieldTemplateData[i])
+			this->elementFieldTemplateData[i]->permuteNodeIndexes(newNodeIndexes);
+	return this->nodeScaleFactorsIndex.permute(oldNodeIndexSize, newNodeIndexes);
+}
+
+namespace {
+
+struct FE_field_permute_element_indexes_data
+{
+	FE_mesh *mesh;
+	DsLabelIndex oldElementIndexSize;
+	const DsLabelIndex *newElementIndexes;
+	bool success;
+};
+
+/** Move field parameters to new element indexes and record field as changed. */
+int FE_field_permute_element_indexes_iterator(FE_field *field, void *permute_data_void)
+{
+	FE_field_permute_element_indexes_data *permuteData = static_cast<FE_field_permute_element_indexes_data *>(permute_data_void);
+	FE_mesh_field_data *meshFieldData = FE_field_getMeshFieldData(field, permuteData->mesh);
+	if (meshFieldData)
+	{
+		if (!meshFieldData->permuteElementIndexes(permuteData->oldElementIndexSize, permuteData->newElementIndexes))
+			permuteData->success = false;
+		permuteData->mesh->get_FE_region()->FE_field_change(field, CHANGE_LOG_RELATED_OBJECT_CHANGED(FE_field));
+	}
+	return 1;
+}
+
+}
+
+int FE_mesh::reorderElements(bool keepIdentifiers)
+{
+	if (!this->fe_region)
+	{
+		display_message(ERROR_MESSAGE, "FE_mesh::reorderElements.  Mesh is not in a region");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if ((this->definingFaces) || ((this->parentMesh) && (this->parentMesh->isDefiningFaces())))
+	{
+		display_message(ERROR_MESSAGE, "FE_mesh::reorderElements.  Cannot reorder while defining faces");
+		return CMZN_ERROR_IN_USE;
+	}
+	const DsLabelIndex oldIndexSize = this->labels.getIndexSize();
+	if (0 == this->labels.getSize())
+		return CMZN_OK;
+	// sort by lowest node index, then existing order; elements without nodes go last
+	std::vector<std::pair<DsLabelIndex, DsLabelIndex> > sortKeys;
+	sortKeys.reserve(this->labels.getSize());
+	for (DsLabelIndex elementIndex = 0; elementIndex < oldIndexSize; ++elementIndex)
+	{
+		if (DS_LABEL_IDENTIFIER_INVALID == this->labels.getIdentifier(elementIndex))
+			continue;
+		DsLabelIndex lowestNodeIndex = std::numeric_limits<DsLabelIndex>::max();
+		for (int i = 0; i < this->elementFieldTemplateDataCount; ++i)
+		{
+			const FE_mesh_element_field_template_data *eftData = this->elementFieldTemplateData[i];
+			if ((!eftData) || (eftData->localNodeCount <= 0))
+				continue;
+			const DsLabelIndex *nodeIndexes = eftData->getElementNodeIndexes(elementIndex);
+			if (!nodeIndexes)
+				continue;
+			for (int n = 0; n < eftData->localNodeCount; ++n)
+				if ((nodeIndexes[n] >= 0) && (nodeIndexes[n] < lowestNodeIndex))
+					lowestNodeIndex = nodeIndexes[n];
+		}
+		sortKeys.push_back(std::make_pair(lowestNodeIndex, elementIndex));
+	}
+	std::sort(sortKeys.begin(), sortKeys.end());
+	std::vector<DsLabelIndex> newIndexes(oldIndexSize, DS_LABEL_INDEX_INVALID);
+	const DsLabelIndex elementCount = static_cast<DsLabelIndex>(sortKeys.size());
+	for (DsLabelIndex newIndex = 0; newIndex < elementCount; ++newIndex)
+		newIndexes[sortKeys[newIndex].second] = newIndex;
+	const DsLabelIndex *newIndexesArray = newIndexes.data();
+
+	FE_region_begin_change(this->fe_region);
+	// also remaps element groups and change logs
+	int return_code = this->labels.permuteIndexes(newIndexesArray, keepIdentifiers);
+	if (CMZN_OK != return_code)
+	{
+		display_message(ERROR_MESSAGE, "FE_mesh::reorderElements.  Failed to permute labels");
+		FE_region_end_change(this->fe_region);
+		return return_code;
+	}
+	bool success = this->fe_elements.permute(oldIndexSize, newIndexesArray)
+		&& this->elementShapeMap.permute(oldIndexSize, newIndexesArray)
+		&& this->parents.permute(oldIndexSize, newIndexesArray);
+	for (DsLabelIndex elementIndex = 0; elementIndex < elementCount; ++elementIndex)
+	{
+		cmzn_element *element = this->fe_elements.getValue(elementIndex);
+		if (element)
+			element->index = elementIndex;
+	}
+	for (int i = 0; i < this->elementShapeFacesCount; ++i)
+		if (!this->elementShapeFacesArray[i]->permuteElementIndexes(oldIndexSize, newIndexesArray))
+			success = false;
+	for (int i = 0; i < this->elementFieldTemplateDataCount; ++i)
+		if ((this->elementFieldTemplateData[i])
+			&& (!this->elementFieldTemplateData[i]->permuteElementIndexes(oldIndexSize, newIndexesArray)))
+			success = false;
+	for (std::list<FE_mesh_field_template*>::iterator iter = this->meshFieldTemplates.begin();
+		iter != this->meshFieldTemplates.end(); ++iter)
+		if (!(*iter)->eftDataMap.permute(oldIndexSize, newIndexesArray))
+			success = false;
+	FE_field_permute_element_indexes_data permuteData = { this, oldIndexSize, newIndexesArray, true };
+	FE_region_for_each_FE_field(this->fe_region, FE_field_permute_element_indexes_iterator, static_cast<void *>(&permuteData));
+	if (!permuteData.success)
+		success = false;
+	// parent elements store these elements as faces; face elements store these elements as parents
+	if (this->parentMesh)
+	{
+		for (int i = 0; i < this->parentMesh->elementShapeFacesCount; ++i)
+			this->parentMesh->elementShapeFacesArray[i]->permuteFaceIndexes(newIndexesArray);
+		if (this->parentMesh->neighbourTable)
+			this->parentMesh->neighbourTable->allChange();
+	}
+	if (this->faceMesh)
+	{
+		const DsLabelIndex faceIndexSize = this->faceMesh->labels.getIndexSize();
+		for (DsLabelIndex faceIndex = 0; faceIndex < faceIndexSize; ++faceIndex)
+		{
+			DsLabelIndex *faceParents = this->faceMesh->parents.getValue(faceIndex);
+			if (faceParents)
+				for (DsLabelIndex p = 1; p <= faceParents[0]; ++p)
+					faceParents[p] = newIndexes[faceParents[p]];
+		}
+	}
+	if (this->neighbourTable)
+		this->neighbourTable->allChange();
+	if (!success)
+	{
+		display_message(ERROR_MESSAGE, "FE_mesh::reorderElements.  Failed to move element data. Mesh is corrupt");
+		return_code = CMZN_ERROR_MEMORY;
+	}
+	// element data has moved even if identifiers are kept, so always notify
+	this->changeLog->setAllChange(DS_LABEL_CHANGE_TYPE_RELATED |
+		(keepIdentifiers ? DS_LABEL_CHANGE_TYPE_NONE : DS_LABEL_CHANGE_TYPE_IDENTIFIER));
+	this->fe_region->update();
+	FE_region_end_change(this->fe_region);
+	return return_code;
+}
+
 DsLabelsGroup *FE_mesh::createLabelsGroup()
 {
 	return DsLabelsGroup::create(&this->labels); // GRC dodgy taking address here
@@ -2052,6 +2462,134 @@ cmzn_element *FE_mesh::create_FE_element(int identifier, FE_element_template *el
 	return 0;
 }
 
+/**
+ * Create many elements as copies of element template, optionally setting
+ * their local nodes for an element field template. Faster than creating
+ * elements one at a time: the template is checked once, identifiers and nodes
+ * are checked before any element is created, element storage is reserved up
+ * front, and additions are recorded as a single ranged change.
+ * Note: assumes FE_region change cache is on.
+ *
+ * @param elementsCount  Number of elements to create, > 0.
+ * @param identifiers  Array of elementsCount unique non-negative identifiers
+ * not used by existing elements, or 0 to automatically generate identifiers.
+ * @param eft  Optional element field template from this mesh to set local
+ * nodes for, or 0 to not set nodes.
+ * @param nodeIdentifiers  If eft is supplied, array of elementsCount times
+ * the number of local nodes in eft node identifiers, varying fastest by local
+ * node. Negative values leave local nodes unset.
+ * @param firstElementIndex  On success, set to index of first new element.
+ * New elements have consecutive indexes.
+ * @param createdCount  On return, set to number of elements created.
+ * @return  Result OK on success, ERROR_ARGUMENT if any argument is invalid
+ * in which case no elements are created, otherwise any other error in which
+ * case elements created before the error remain.
+ */
+int FE_mesh::create_FE_elements(int elementsCount, const int *identifiers,
+	FE_element_template *elementTemplate, FE_element_field_template *eft,
+	const int *nodeIdentifiers, DsLabelIndex& firstElementIndex, int& createdCount)
+{
+	firstElementIndex = DS_LABEL_INDEX_INVALID;
+	createdCount = 0;
+	if (!((0 < elementsCount) && (elementTemplate) && elementTemplate->isValidated()
+		&& (elementTemplate->getMesh() == this) && (elementTemplate->getElementShape())
+		&& ((!eft) || (nodeIdentifiers))))
+	{
+		display_message(ERROR_MESSAGE, "FE_mesh::create_FE_elements.  Invalid arguments");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if (identifiers)
+	{
+		std::vector<int> sortedIdentifiers(identifiers, identifiers + elementsCount);
+		std::sort(sortedIdentifiers.begin(), sortedIdentifiers.end());
+		if (sortedIdentifiers[0] < 0)
+		{
+			display_message(ERROR_MESSAGE, "FE_mesh::create_FE_elements.  Negative identifier %d", sortedIdentifiers[0]);
+			return CMZN_ERROR_ARGUMENT;
+		}
+		std::vector<int>::iterator repeat = std::adjacent_find(sortedIdentifiers.begin(), sortedIdentifiers.end());
+		if (repeat != sortedIdentifiers.end())
+		{
+			display_message(ERROR_MESSAGE, "FE_mesh::create_FE_elements.  Identifier %d is repeated", *repeat);
+			return CMZN_ERROR_ARGUMENT;
+		}
+		for (int e = 0; e < elementsCount; ++e)
+		{
+			if (this->labels.findLabelByIdentifier(identifiers[e]) >= 0)
+			{
+				display_message(ERROR_MESSAGE, "FE_mesh::create_FE_elements.  Identifier %d is already used in %d-D mesh.",
+					identifiers[e], this->dimension);
+				return CMZN_ERROR_ARGUMENT;
+			}
+		}
+	}
+	FE_mesh_element_field_template_data *eftData = 0;
+	int localNodeCount = 0;
+	std::vector<DsLabelIndex> nodeIndexes;
+	if (eft)
+	{
+		eftData = this->getElementfieldtemplateData(eft);
+		localNodeCount = eft->getNumberOfLocalNodes();
+		if ((!eftData) || (localNodeCount <= 0) || (!this->nodeset))
+		{
+			display_message(ERROR_MESSAGE, "FE_mesh::create_FE_elements.  "
+				"Element field template is not used by mesh or has no local nodes");
+			return CMZN_ERROR_ARGUMENT;
+		}
+		const size_t nodeIdentifiersCount = static_cast<size_t>(elementsCount)*localNodeCount;
+		nodeIndexes.resize(nodeIdentifiersCount, DS_LABEL_INDEX_INVALID);
+		for (size_t i = 0; i < nodeIdentifiersCount; ++i)
+		{
+			if (nodeIdentifiers[i] >= 0)
+			{
+				nodeIndexes[i] = this->nodeset->findIndexByIdentifier(nodeIdentifiers[i]);
+				if (nodeIndexes[i] < 0)
+				{
+					display_message(ERROR_MESSAGE, "FE_mesh::create_FE_elements.  "
+						"Failed to find node %d to set as local node %d/%d in new element %d",
+						nodeIdentifiers[i], static_cast<int>(i % localNodeCount) + 1, localNodeCount,
+						static_cast<int>(i / localNodeCount) + 1);
+					return CMZN_ERROR_ARGUMENT;
+				}
+			}
+		}
+	}
+	const DsLabelIndex indexSize = this->labels.getIndexSize();
+	if (!this->fe_elements.reserve(indexSize + elementsCount))
+		return CMZN_ERROR_MEMORY;
+	int return_code = CMZN_OK;
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		const DsLabelIndex elementIndex = this->createElement((identifiers) ? identifiers[e] : -1);
+		if (elementIndex < 0)
+		{
+			display_message(ERROR_MESSAGE, "FE_mesh::create_FE_elements.  Could not create element");
+			return_code = CMZN_ERROR_MEMORY;
+			break;
+		}
+		if (!(this->setElementShapeFromElementTemplate(elementIndex, elementTemplate)
+			&& this->mergeFieldsFromElementTemplate(elementIndex, elementTemplate)
+			&& ((!eftData) || (CMZN_OK == eftData->setNewElementLocalNodes(elementIndex,
+				nodeIndexes.data() + static_cast<size_t>(e)*localNodeCount)))))
+		{
+			display_message(ERROR_MESSAGE, "FE_mesh::create_FE_elements.  Failed to set element shape, fields or nodes.");
+			this->destroyElementPrivate(elementIndex);
+			return_code = CMZN_ERROR_GENERAL;
+			break;
+		}
+		++createdCount;
+	}
+	if (0 < createdCount)
+	{
+		// new labels always take the next indexes
+		firstElementIndex = indexSize;
+		this->changeLog->setIndexRangeChange(indexSize, indexSize + createdCount - 1, DS_LABEL_CHANGE_TYPE_ADD);
+		if ((eftData) && (this->fe_region))
+			this->fe_region->FE_field_all_change(CHANGE_LOG_RELATED_OBJECT_CHANGED(FE_field));
+	}
+	return return_code;
+}
+
 /**
  * Convenience function returning an existing element with the identifier
  * from the mesh, or if none found or if identifier is -1, a new element with
@@ -2211,6 +2749,8 @@ void FE_mesh::clearElementFaces(DsLabelIndex elementIndex)
 		DsLabelIndex faceIndex = faces[i]; // must put in local variable since cleared by setElementFace
 		if (faceIndex >= 0)
 		{
+			if (this->neighbourTable)
+				this->neighbourTableFaceChange(faceIndex);
 			// don't notify parent modified since only called from removeElementPrivate or on shape change
 			this->faceMesh->removeElementParent(faceIndex, elementIndex);
 			faces[i] = DS_LABEL_INDEX_INVALID;
@@ -2222,6 +2762,16 @@ void FE_mesh::clearElementFaces(DsLabelIndex elementIndex)
 	elementShapeFaces->destroyElementFaces(elementIndex);
 }
 
+/** Record that neighbours of all parents of face may have changed.
+ * Private: call only if mesh has faceMesh and neighbour table */
+void FE_mesh::neighbourTableFaceChange(DsLabelIndex faceIndex)
+{
+	const DsLabelIndex *parents;
+	const int parentsCount = this->faceMesh->getElementParents(faceIndex, parents);
+	for (int i = 0; i < parentsCount; ++i)
+		this->neighbourTable->elementChange(parents[i]);
+}
+
 // set index of face element (from face mesh)
 int FE_mesh::setElementFace(DsLabelIndex elementIndex, int faceNumber, DsLabelIndex faceIndex)
 {
@@ -2239,6 +2789,14 @@ int FE_mesh::setElementFace(DsLabelIndex elementIndex, int faceNumber, DsLabelIn
 	const DsLabelIndex oldFaceIndex = faces[faceNumber];
 	if (oldFaceIndex != faceIndex)
 	{
+		if (this->neighbourTable)
+		{
+			this->neighbourTable->elementChange(elementIndex);
+			if (oldFaceIndex >= 0)
+				this->neighbourTableFaceChange(oldFaceIndex);
+			if (faceIndex >= 0)
+				this->neighbourTableFaceChange(faceIndex);
+		}
 		faces[faceNumber] = faceIndex;
 		if (oldFaceIndex >= 0)
 			this->faceMesh->removeElementParent(oldFaceIndex, elementIndex);
@@ -2436,7 +2994,7 @@ DsLabelIndex FE_mesh::getElementParentOnFace(DsLabelIndex elementIndex, cmzn_ele
  * Copes with element wrapping around and joining itself; will find the other face.
  * @param newFaceNumber  If neighbour found, this gives the face it is on.
  */
-DsLabelIndex FE_mesh::getElementFirstNeighbour(DsLabelIndex elementIndex, int faceNumber, int &newFaceNumber)
+DsLabelIndex FE_mesh::findElementFirstNeighbour(DsLabelIndex elementIndex, int faceNumber, int &newFaceNumber)
 {
 	ElementShapeFaces *elementShapeFaces;
 	const DsLabelIndex *faces;
@@ -2469,82 +3027,451 @@ DsLabelIndex FE_mesh::getElementFirstNeighbour(DsLabelIndex elementIndex, int fa
 	return DS_LABEL_INDEX_INVALID;
 }
 
+int FE_mesh::setNeighbourTableEnabled(bool enabled)
+{
+	if (enabled)
+	{
+		if (!this->neighbourTable)
+		{
+			this->neighbourTable = new FE_mesh_neighbour_table(this, &this->labels);
+			if (!this->neighbourTable->isValid())
+			{
+				display_message(ERROR_MESSAGE, "FE_mesh::setNeighbourTableEnabled.  Failed to create neighbour table");
+				delete this->neighbourTable;
+				this->neighbourTable = 0;
+				return CMZN_ERROR_MEMORY;
+			}
+		}
+	}
+	else if (this->neighbourTable)
+	{
+		delete this->neighbourTable;
+		this->neighbourTable = 0;
+	}
+	return CMZN_OK;
+}
+
+FE_mesh_neighbour_table::FE_mesh_neighbour_table(FE_mesh *meshIn, DsLabels *labelsIn) :
+	mesh(meshIn),
+	faceStride(0),
+	indexSize(0),
+	changedElements(DsLabelsChangeLog::create(labelsIn)),
+	updateNeeded(true)
+{
+	if (this->changedElements)
+		this->changedElements->setAllChange(DS_LABEL_CHANGE_TYPE_RELATED);
+}
+
+FE_mesh_neighbour_table::~FE_mesh_neighbour_table()
+{
+	cmzn::Deaccess(this->changedElements);
+}
+
+/** Recalculate row of neighbours for element, which need not exist.
+ * Private: assumes table is sized for elementIndex */
+void FE_mesh_neighbour_table::calculateElementNeighbours(DsLabelIndex elementIndex)
+{
+	const size_t rowStart = static_cast<size_t>(elementIndex)*this->faceStride;
+	DsLabelIndex *neighbours = this->neighbourElements.data() + rowStart;
+	signed char *faceNumbers = this->neighbourFaceNumbers.data() + rowStart;
+	int faceCount = 0;
+	if (this->mesh->getLabels().hasIndex(elementIndex))
+	{
+		const FE_mesh::ElementShapeFaces *elementShapeFaces = this->mesh->getElementShapeFaces(elementIndex);
+		if (elementShapeFaces)
+			faceCount = elementShapeFaces->getFaceCount();
+	}
+	for (int faceNumber = 0; faceNumber < faceCount; ++faceNumber)
+	{
+		int newFaceNumber = -1;
+		neighbours[faceNumber] = this->mesh->findElementFirstNeighbour(elementIndex, faceNumber, newFaceNumber);
+		faceNumbers[faceNumber] = static_cast<signed char>((neighbours[faceNumber] >= 0) ? newFaceNumber : -1);
+	}
+	for (int faceNumber = faceCount; faceNumber < this->faceStride; ++faceNumber)
+	{
+		neighbours[faceNumber] = DS_LABEL_INDEX_INVALID;
+		faceNumbers[faceNumber] = -1;
+	}
+}
+
+/** Recalculate rows of changed elements, or all rows if all changed or the
+ * maximum face count has changed. Safe to call from concurrent threads. */
+void FE_mesh_neighbour_table::update()
+{
+	std::lock_guard<std::mutex> lock(this->updateMutex);
+	if (!this->updateNeeded)
+		return;
+	const DsLabelIndex newIndexSize = this->mesh->getLabels().getIndexSize();
+	const int newFaceStride = this->mesh->getMaximumElementFaceCount();
+	const bool rebuild = this->changedElements->isAllChange() || (newFaceStride != this->faceStride);
+	if (rebuild || (newIndexSize > this->indexSize))
+	{
+		if (rebuild)
+		{
+			this->neighbourElements.clear();
+			this->neighbourFaceNumbers.clear();
+			this->faceStride = newFaceStride;
+			this->indexSize = 0;
+		}
+		// new rows are empty until calculated; elements without faces have no neighbours
+		const size_t size = static_cast<size_t>(newIndexSize)*this->faceStride;
+		this->neighbourElements.resize(size, DS_LABEL_INDEX_INVALID);
+		this->neighbourFaceNumbers.resize(size, -1);
+		this->indexSize = newIndexSize;
+	}
+	if (rebuild)
+	{
+		for (DsLabelIndex elementIndex = 0; elementIndex < this->indexSize; ++elementIndex)
+			this->calculateElementNeighbours(elementIndex);
+	}
+	else
+	{
+		DsLabelsGroup *changedGroup = this->changedElements->getLabelsGroup();
+		DsLabelIndex elementIndex = DS_LABEL_INDEX_INVALID;
+		while (changedGroup->incrementIndex(elementIndex))
+			if (elementIndex < this->indexSize)
+				this->calculateElementNeighbours(elementIndex);
+	}
+	DsLabelsChangeLog *newChangedElements = DsLabelsChangeLog::create(this->changedElements->getLabels());
+	if (newChangedElements)
+	{
+		cmzn::Deaccess(this->changedElements);
+		this->changedElements = newChangedElements;
+		this->updateNeeded = false;
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "FE_mesh_neighbour_table::update.  Failed to create change log");
+		this->changedElements->setAllChange(DS_LABEL_CHANGE_TYPE_RELATED);
+	}
+}
+
+DsLabelIndex FE_mesh_neighbour_table::getNeighbour(DsLabelIndex elementIndex, int faceNumber, int &newFaceNumber)
+{
+	if (this->updateNeeded)
+		this->update();
+	if ((elementIndex >= this->indexSize) || (faceNumber >= this->faceStride))
+		return DS_LABEL_INDEX_INVALID;
+	const size_t offset = static_cast<size_t>(elementIndex)*this->faceStride + faceNumber;
+	const DsLabelIndex neighbourIndex = this->neighbourElements[offset];
+	if (neighbourIndex >= 0)
+		newFaceNumber = this->neighbourFaceNumbers[offset];
+	return neighbourIndex;
+}
+
+size_t FE_mesh_neighbour_table::getAllocatedBytes() const
+{
+	return this->neighbourElements.capacity()*sizeof(DsLabelIndex)
+		+ this->neighbourFaceNumbers.capacity()*sizeof(signed char)
+		+ this->changedElements->getLabelsGroup()->getAllocatedBytes();
+}
+
+namespace {
+
+/* minimum number of elements worth calculating face keys for in each thread */
+const size_t FE_MESH_FACE_KEYS_MINIMUM_ELEMENTS_PER_THREAD = 1024;
+
+/* number of elements face keys are calculated for at a time, limiting memory
+ * used to hold them before faces are found or created in element order */
+const size_t FE_MESH_FACE_KEYS_ELEMENTS_PER_CHUNK = 65536;
+
+}
+
+/**
+ * Sorted node identifiers of elements or their faces, calculated in advance
+ * of finding or creating faces so the expensive calculation can be done
+ * concurrently. Keys are held in element order, with one key for each face of
+ * an element if calculated for faces, otherwise one key for the element.
+ */
+class FE_mesh_face_keys
+{
+	std::vector<size_t> elementKeyStarts; // index of first key of each element, plus end
+	std::vector<size_t> keyNodeStarts; // index of first node identifier of each key, plus end
+	std::vector<int> keyResults; // result of calculating each key
+	std::vector<int> nodeIdentifiers;
+
+public:
+
+	FE_mesh_face_keys()
+	{
+		this->clear();
+	}
+
+	void clear()
+	{
+		this->elementKeyStarts.assign(1, 0);
+		this->keyNodeStarts.assign(1, 0);
+		this->keyResults.clear();
+		this->nodeIdentifiers.clear();
+	}
+
+	size_t getElementCount() const
+	{
+		return this->elementKeyStarts.size() - 1;
+	}
+
+	void addKey(int result, const std::vector<int>& keyNodeIdentifiers)
+	{
+		this->keyResults.push_back(result);
+		this->nodeIdentifiers.insert(this->nodeIdentifiers.end(),
+			keyNodeIdentifiers.begin(), keyNodeIdentifiers.end());
+		this->keyNodeStarts.push_back(this->nodeIdentifiers.size());
+	}
+
+	/** Call after adding all keys for the next element */
+	void endElement()
+	{
+		this->elementKeyStarts.push_back(this->keyResults.size());
+	}
+
+	/** Append keys for elements following those already held */
+	void append(const FE_mesh_face_keys& source)
+	{
+		const size_t keyOffset = this->keyResults.size();
+		const size_t nodeOffset = this->nodeIdentifiers.size();
+		for (size_t i = 1; i < source.elementKeyStarts.size(); ++i)
+			this->elementKeyStarts.push_back(keyOffset + source.elementKeyStarts[i]);
+		for (size_t i = 1; i < source.keyNodeStarts.size(); ++i)
+			this->keyNodeStarts.push_back(nodeOffset + source.keyNodeStarts[i]);
+		this->keyResults.insert(this->keyResults.end(),
+			source.keyResults.begin(), source.keyResults.end());
+		this->nodeIdentifiers.insert(this->nodeIdentifiers.end(),
+			source.nodeIdentifiers.begin(), source.nodeIdentifiers.end());
+	}
+
+	/**
+	 * Get key for element and face number, or 0 for element itself.
+	 * @param keyNodeIdentifiers  On success, set to sorted node identifiers.
+	 * @return  Result of calculating key, or ERROR_ARGUMENT if not held.
+	 */
+	int getKey(size_t elementNumber, int keyNumber, std::vector<int>& keyNodeIdentifiers) const
+	{
+		if ((elementNumber >= this->getElementCount()) || (keyNumber < 0))
+			return CMZN_ERROR_ARGUMENT;
+		const size_t key = this->elementKeyStarts[elementNumber] + keyNumber;
+		if (key >= this->elementKeyStarts[elementNumber + 1])
+			return CMZN_ERROR_ARGUMENT;
+		keyNodeIdentifiers.assign(this->nodeIdentifiers.begin() + this->keyNodeStarts[key],
+			this->nodeIdentifiers.begin() + this->keyNodeStarts[key + 1]);
+		return this->keyResults[key];
+	}
+
+};
+
+unsigned int FE_mesh_face_table::hashKey(const int *nodeIdentifiers, int nodeCount)
+{
+	// FNV-1a style mixing of whole identifiers
+	unsigned int hash = 2166136261u;
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		hash ^= static_cast<unsigned int>(nodeIdentifiers[i]);
+		hash *= 16777619u;
+		hash ^= hash >> 15;
+	}
+	return hash;
+}
+
+size_t FE_mesh_face_table::findSlot(const int *nodeIdentifiers, int nodeCount, unsigned int hash) const
+{
+	const size_t mask = this->slots.size() - 1;
+	size_t slot = static_cast<size_t>(hash) & mask;
+	while (true)
+	{
+		const size_t entryNumber = this->slots[slot];
+		if (0 == entryNumber)
+			break;
+		const Entry& entry = this->entries[entryNumber - 1];
+		if ((entry.hash == hash) && (entry.keySize == nodeCount) &&
+			std::equal(nodeIdentifiers, nodeIdentifiers + nodeCount,
+				this->keyNodeIdentifiers.begin() + entry.keyStart))
+			break;
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void FE_mesh_face_table::rehash(size_t slotCount)
+{
+	this->slots.assign(slotCount, 0);
+	const size_t mask = slotCount - 1;
+	const size_t entryCount = this->entries.size();
+	for (size_t e = 0; e < entryCount; ++e)
+	{
+		size_t slot = static_cast<size_t>(this->entries[e].hash) & mask;
+		while (this->slots[slot])
+			slot = (slot + 1) & mask;
+		this->slots[slot] = e + 1;
+	}
+}
+
+void FE_mesh_face_table::clear()
+{
+	// swap to release memory
+	std::vector<int>().swap(this->keyNodeIdentifiers);
+	std::vector<Entry>().swap(this->entries);
+	std::vector<size_t>().swap(this->slots);
+}
+
+DsLabelIndex FE_mesh_face_table::find(const int *nodeIdentifiers, int nodeCount) const
+{
+	if (this->slots.empty())
+		return DS_LABEL_INDEX_INVALID;
+	const size_t entryNumber = this->slots[this->findSlot(nodeIdentifiers, nodeCount,
+		FE_mesh_face_table::hashKey(nodeIdentifiers, nodeCount))];
+	if (0 == entryNumber)
+		return DS_LABEL_INDEX_INVALID;
+	return this->entries[entryNumber - 1].elementIndex;
+}
+
+bool FE_mesh_face_table::insert(const int *nodeIdentifiers, int nodeCount, DsLabelIndex elementIndex)
+{
+	// keep load factor at most 1/2
+	if (2*(this->entries.size() + 1) > this->slots.size())
+		this->rehash((this->slots.empty()) ? 1024 : 2*this->slots.size());
+	const unsigned int hash = FE_mesh_face_table::hashKey(nodeIdentifiers, nodeCount);
+	const size_t slot = this->findSlot(nodeIdentifiers, nodeCount, hash);
+	if (this->slots[slot])
+		return false;
+	Entry entry;
+	entry.keyStart = this->keyNodeIdentifiers.size();
+	entry.keySize = nodeCount;
+	entry.hash = hash;
+	entry.elementIndex = elementIndex;
+	this->keyNodeIdentifiers.insert(this->keyNodeIdentifiers.end(), nodeIdentifiers, nodeIdentifiers + nodeCount);
+	this->entries.push_back(entry);
+	this->slots[slot] = this->entries.size();
+	return true;
+}
+
 /**
  * Find or create an element in this mesh that can be used on face number of
  * the parent element. The face is added to the parent.
  * The new face element is added to this mesh, but without adding faces.
  * Must be between calls to begin_define_faces/end_define_faces.
- * Can only match faces correctly for coordinate fields with standard node
- * to element maps and no versions.
- * The element type node sequence list is updated with any new face.
+ * The face table is updated with any new face.
  *
  * @param parentIndex  Index of parent element in parentMesh, to find or create
  * face for.
  * @param faceNumber  Face number on parent, starting at 0.
+ * @param faceNodeIdentifiers  Sorted identifiers of nodes on face, from
+ * calculate_FE_element_sorted_node_identifiers.
  * @param faceIndex  On successful return, set to new faceIndex or
  * DS_LABEL_INDEX_INVALID if no face needed (for collapsed element face).
- * @return  Index of new face or DS_LABEL_INDEX_INVALID if failed.
- * @return  Result OK on success, ERROR_NOT_FOUND if no nodes available
- * for defining faces, otherwise any other error.
+ * @return  Result OK on success, otherwise any other error.
  */
-int FE_mesh::findOrCreateFace(DsLabelIndex parentIndex, int faceNumber, DsLabelIndex& faceIndex)
+int FE_mesh::findOrCreateFace(DsLabelIndex parentIndex, int faceNumber,
+	const std::vector<int>& faceNodeIdentifiers, DsLabelIndex& faceIndex)
 {
 	faceIndex = DS_LABEL_INDEX_INVALID;
-	cmzn_element *parentElement = this->parentMesh->getElement(parentIndex);
-	int return_code = CMZN_OK;
-	FE_element_type_node_sequence *element_type_node_sequence =
-		CREATE(FE_element_type_node_sequence)(return_code, parentElement, faceNumber);
-	if (!element_type_node_sequence)
+	const int nodeCount = static_cast<int>(faceNodeIdentifiers.size());
+	// no face for collapsed faces with <= 2 unique nodes, or lines with 1 unique node
+	if (((2 == this->dimension) && (nodeCount <= 2)) ||
+		((1 == this->dimension) && (nodeCount <= 1)))
 	{
-		return return_code;
+		return CMZN_OK;
 	}
+	faceIndex = this->faceTable.find(faceNodeIdentifiers.data(), nodeCount);
+	if (faceIndex >= 0)
+		return this->parentMesh->setElementFace(parentIndex, faceNumber, faceIndex);
+	FE_element_shape *parentShape = this->parentMesh->getElementShape(parentIndex);
+	FE_element_shape *faceShape = get_FE_element_shape_of_face(parentShape, faceNumber, this->fe_region);
+	if (!faceShape)
+		return CMZN_ERROR_GENERAL;
+	cmzn_element *face = this->get_or_create_FE_element_with_identifier(/*identifier*/-1, faceShape);
+	if (!face)
+		return CMZN_ERROR_GENERAL;
+	faceIndex = face->getIndex();
+	int return_code = this->parentMesh->setElementFace(parentIndex, faceNumber, faceIndex);
+	if (CMZN_OK == return_code)
+	{
+		if (!this->faceTable.insert(faceNodeIdentifiers.data(), nodeCount, faceIndex))
+			return_code = CMZN_ERROR_GENERAL;
+	}
+	cmzn_element::deaccess(face);
+	return return_code;
+}
 
-	ACCESS(FE_element_type_node_sequence)(element_type_node_sequence);
-	if (!FE_element_type_node_sequence_is_collapsed(element_type_node_sequence))
+/**
+ * Calculate sorted node identifiers for each face of the elements, or the
+ * elements themselves. Keys for faces already defined are not calculated and
+ * have result ERROR_ALREADY_EXISTS. Only reads the mesh so may be called
+ * concurrently for different elements.
+ * @param ofFaces  True to calculate keys for faces of elements, false for
+ * elements themselves.
+ * @param faceKeys  Cleared and filled with keys in element order.
+ */
+void FE_mesh::calculateFaceKeys(const DsLabelIndex *elementIndexes, size_t elementCount,
+	bool ofFaces, FE_mesh_face_keys& faceKeys) const
+{
+	faceKeys.clear();
+	std::vector<int> keyNodeIdentifiers;
+	for (size_t i = 0; i < elementCount; ++i)
 	{
-		FE_element_type_node_sequence *existing_element_type_node_sequence =
-			FE_element_type_node_sequence_list_find_match(
-			this->element_type_node_sequence_list, element_type_node_sequence);
-		if (existing_element_type_node_sequence)
-		{
-			cmzn_element *face = FE_element_type_node_sequence_get_FE_element(existing_element_type_node_sequence);
-			if (!face)
-				return_code = CMZN_ERROR_GENERAL;
-			else
-			{
-				faceIndex = face->getIndex();
-				return_code = this->parentMesh->setElementFace(parentIndex, faceNumber, faceIndex);
-			}
-		}
-		else
+		const DsLabelIndex elementIndex = elementIndexes[i];
+		cmzn_element *element = this->getElement(elementIndex);
+		if (ofFaces)
 		{
-			FE_element_shape *parentShape = this->parentMesh->getElementShape(parentIndex);
-			FE_element_shape *faceShape = get_FE_element_shape_of_face(parentShape, faceNumber, this->fe_region);
-			if (!faceShape)
-				return_code = CMZN_ERROR_GENERAL;
-			else
+			const ElementShapeFaces *elementShapeFaces = this->getElementShapeFaces(elementIndex);
+			const int faceCount = (elementShapeFaces) ? elementShapeFaces->getFaceCount() : 0;
+			const DsLabelIndex *faces = (elementShapeFaces) ? elementShapeFaces->getElementFaces(elementIndex) : 0;
+			for (int faceNumber = 0; faceNumber < faceCount; ++faceNumber)
 			{
-				cmzn_element *face = this->get_or_create_FE_element_with_identifier(/*identifier*/-1, faceShape);
-				if (!face)
-					return_code = CMZN_ERROR_GENERAL;
+				if ((faces) && (faces[faceNumber] >= 0))
+				{
+					keyNodeIdentifiers.clear();
+					faceKeys.addKey(CMZN_ERROR_ALREADY_EXISTS, keyNodeIdentifiers);
+				}
 				else
 				{
-					FE_element_type_node_sequence_set_FE_element(element_type_node_sequence, face);
-					faceIndex = face->getIndex();
-					return_code = this->parentMesh->setElementFace(parentIndex, faceNumber, faceIndex);
-					if (CMZN_OK == return_code)
-					{
-						if (!ADD_OBJECT_TO_LIST(FE_element_type_node_sequence)(
-								element_type_node_sequence, this->element_type_node_sequence_list))
-							return_code = CMZN_ERROR_GENERAL;
-					}
-					cmzn_element::deaccess(face);
+					const int result = calculate_FE_element_sorted_node_identifiers(element, faceNumber, keyNodeIdentifiers);
+					faceKeys.addKey(result, keyNodeIdentifiers);
 				}
 			}
 		}
+		else
+		{
+			const int result = calculate_FE_element_sorted_node_identifiers(element, /*face_number*/-1, keyNodeIdentifiers);
+			faceKeys.addKey(result, keyNodeIdentifiers);
+		}
+		faceKeys.endElement();
 	}
-	DEACCESS(FE_element_type_node_sequence)(&element_type_node_sequence);
-	return return_code;
+}
+
+/**
+ * Calculate face keys for elements as for calculateFaceKeys, dividing elements
+ * into contiguous ranges calculated in concurrent threads. Keys are returned
+ * in the order of elementIndexes, so faces are subsequently found or created
+ * in the same order whatever the number of threads.
+ */
+void FE_mesh::calculateFaceKeysConcurrently(const std::vector<DsLabelIndex>& elementIndexes,
+	bool ofFaces, FE_mesh_face_keys& faceKeys) const
+{
+	const size_t elementCount = elementIndexes.size();
+	size_t threadCount = std::thread::hardware_concurrency();
+	const size_t maximumThreadCount = elementCount / FE_MESH_FACE_KEYS_MINIMUM_ELEMENTS_PER_THREAD;
+	if (threadCount > maximumThreadCount)
+		threadCount = maximumThreadCount;
+	if (threadCount < 2)
+	{
+		this->calculateFaceKeys(elementIndexes.data(), elementCount, ofFaces, faceKeys);
+		return;
+	}
+	const size_t elementsPerThread = (elementCount + threadCount - 1) / threadCount;
+	std::vector<FE_mesh_face_keys> threadFaceKeys(threadCount);
+	std::vector<std::thread> threads;
+	for (size_t t = 1; t < threadCount; ++t)
+	{
+		const size_t start = std::min(t*elementsPerThread, elementCount);
+		const size_t end = std::min(start + elementsPerThread, elementCount);
+		threads.push_back(std::thread(&FE_mesh::calculateFaceKeys, this,
+			elementIndexes.data() + start, end - start, ofFaces, std::ref(threadFaceKeys[t])));
+	}
+	this->calculateFaceKeys(elementIndexes.data(), elementsPerThread, ofFaces, threadFaceKeys[0]);
+	for (size_t t = 0; t < threads.size(); ++t)
+		threads[t].join();
+	faceKeys.clear();
+	for (size_t t = 0; t < threadCount; ++t)
+		faceKeys.append(threadFaceKeys[t]);
 }
 
 /**
@@ -2555,9 +3482,13 @@ int FE_mesh::findOrCreateFace(DsLabelIndex parentIndex, int faceNumber, DsLabelI
  * Always call between FE_region_begin/end_changes.
  * Function ensures that elements share existing faces and lines in preference to
  * creating new ones if they have matching dimension and nodes.
+ * @param faceKeys  Optional keys for faces of element calculated in advance.
+ * If 0, face keys are calculated here.
+ * @param elementNumber  Number of element in faceKeys, if supplied.
  * @return  CMZN_OK on success, otherwise any error code.
  */
-int FE_mesh::defineElementFaces(DsLabelIndex elementIndex)
+int FE_mesh::defineElementFacesPrivate(DsLabelIndex elementIndex,
+	const FE_mesh_face_keys *faceKeys, size_t elementNumber)
 {
 	if (!(this->faceMesh && this->definingFaces && (elementIndex >= 0)))
 		return CMZN_ERROR_ARGUMENT;
@@ -2575,12 +3506,19 @@ int FE_mesh::defineElementFaces(DsLabelIndex elementIndex)
 		return CMZN_ERROR_GENERAL;
 	int return_code = CMZN_OK;
 	int newFaceCount = 0;
+	std::vector<int> faceNodeIdentifiers;
 	for (int faceNumber = 0; faceNumber < faceCount; ++faceNumber)
 	{
 		DsLabelIndex faceIndex = faces[faceNumber];
 		if (faceIndex < 0)
 		{
-			return_code = this->faceMesh->findOrCreateFace(elementIndex, faceNumber, faceIndex);
+			if (faceKeys)
+				return_code = faceKeys->getKey(elementNumber, faceNumber, faceNodeIdentifiers);
+			else
+				return_code = calculate_FE_element_sorted_node_identifiers(this->getElement(elementIndex),
+					faceNumber, faceNodeIdentifiers);
+			if (CMZN_OK == return_code)
+				return_code = this->faceMesh->findOrCreateFace(elementIndex, faceNumber, faceNodeIdentifiers, faceIndex);
 			if (CMZN_OK != return_code)
 			{
 				if (CMZN_ERROR_NOT_FOUND == return_code)
@@ -2595,7 +3533,7 @@ int FE_mesh::defineElementFaces(DsLabelIndex elementIndex)
 		if ((this->dimension > 2) && (DS_LABEL_INDEX_INVALID != faceIndex))
 		{
 			// recursively add faces of faces, whether existing or new
-			return_code = this->faceMesh->defineElementFaces(faceIndex);
+			return_code = this->faceMesh->defineElementFacesPrivate(faceIndex, /*faceKeys*/0, 0);
 			if (CMZN_OK != return_code)
 			{
 				break;
@@ -2619,81 +3557,91 @@ int FE_mesh::defineElementFaces(DsLabelIndex elementIndex)
 }
 
 /**
- * Creates a list of FE_element_type_node_sequence, and
- * if mesh dimension < MAXIMUM_ELEMENT_XI_DIMENSIONS fills it with sequences
- * for this element. Fails if any two faces have the same shape and nodes.
+ * Starts defining faces, and if mesh dimension < MAXIMUM_ELEMENT_XI_DIMENSIONS
+ * fills the face table with sorted node identifiers of existing elements so
+ * they are used as faces of parent elements. Warns if any two elements have
+ * the same nodes.
  */
 int FE_mesh::begin_define_faces()
 {
-	if (this->element_type_node_sequence_list)
+	if (this->definingFaces)
 	{
 		display_message(ERROR_MESSAGE, "FE_mesh::begin_define_faces.  Already defining faces");
 		return CMZN_ERROR_ALREADY_EXISTS;
 	}
-	this->element_type_node_sequence_list = CREATE(LIST(FE_element_type_node_sequence))();
-	if (!this->element_type_node_sequence_list)
-	{
-		display_message(ERROR_MESSAGE, "FE_mesh::begin_define_faces.  Could not create node sequence list");
-		return CMZN_ERROR_MEMORY;
-	}
+	this->faceTable.clear();
 	this->definingFaces = true;
 	int return_code = CMZN_OK;
 	if (this->dimension < MAXIMUM_ELEMENT_XI_DIMENSIONS)
 	{
-		cmzn_elementiterator_id iter = this->createElementiterator();
-		cmzn_element_id element = 0;
-		FE_element_type_node_sequence *element_type_node_sequence;
-		while (0 != (element = cmzn_elementiterator_next_non_access(iter)))
+		DsLabelIterator *iter = this->labels.createLabelIterator();
+		if (!iter)
+			return CMZN_ERROR_MEMORY;
+		std::vector<DsLabelIndex> elementIndexes;
+		FE_mesh_face_keys elementKeys;
+		std::vector<int> nodeIdentifiers;
+		DsLabelIndex elementIndex = iter->nextIndex();
+		while ((CMZN_OK == return_code) && (elementIndex != DS_LABEL_INDEX_INVALID))
 		{
-			element_type_node_sequence = CREATE(FE_element_type_node_sequence)(return_code, element);
-			if (!element_type_node_sequence)
+			elementIndexes.clear();
+			while ((elementIndex != DS_LABEL_INDEX_INVALID) &&
+				(elementIndexes.size() < FE_MESH_FACE_KEYS_ELEMENTS_PER_CHUNK))
 			{
-				if (CMZN_ERROR_NOT_FOUND == return_code)
-				{
-					return_code = CMZN_OK;
-					continue;
-				}
-				display_message(ERROR_MESSAGE, "FE_mesh::begin_define_faces.  "
-					"Could not create FE_element_type_node_sequence for %d-D element %d",
-					this->dimension, get_FE_element_identifier(element));
-				break;
+				elementIndexes.push_back(elementIndex);
+				elementIndex = iter->nextIndex();
 			}
-			if (!ADD_OBJECT_TO_LIST(FE_element_type_node_sequence)(
-				element_type_node_sequence, this->element_type_node_sequence_list))
+			this->calculateFaceKeysConcurrently(elementIndexes, /*ofFaces*/false, elementKeys);
+			const size_t elementCount = elementIndexes.size();
+			for (size_t i = 0; i < elementCount; ++i)
 			{
-				display_message(WARNING_MESSAGE, "FE_mesh::begin_define_faces.  "
-					"Could not add FE_element_type_node_sequence for %d-D element %d.",
-					this->dimension, get_FE_element_identifier(element));
-				FE_element_type_node_sequence *existing_element_type_node_sequence =
-					FE_element_type_node_sequence_list_find_match(
-						this->element_type_node_sequence_list, element_type_node_sequence);
-				if (existing_element_type_node_sequence)
+				return_code = elementKeys.getKey(i, 0, nodeIdentifiers);
+				if (CMZN_OK != return_code)
 				{
-					display_message(WARNING_MESSAGE,
-						"Reason: Existing %d-D element %d uses same node list, and will be used for face matching.",
-						this->dimension, get_FE_element_identifier(
-							FE_element_type_node_sequence_get_FE_element(existing_element_type_node_sequence)));
+					if (CMZN_ERROR_NOT_FOUND == return_code)
+					{
+						return_code = CMZN_OK;
+						continue;
+					}
+					display_message(ERROR_MESSAGE, "FE_mesh::begin_define_faces.  "
+						"Could not get nodes for %d-D element %d",
+						this->dimension, this->getElementIdentifier(elementIndexes[i]));
+					break;
+				}
+				const int nodeCount = static_cast<int>(nodeIdentifiers.size());
+				if (!this->faceTable.insert(nodeIdentifiers.data(), nodeCount, elementIndexes[i]))
+				{
+					display_message(WARNING_MESSAGE, "FE_mesh::begin_define_faces.  "
+						"Could not add nodes for %d-D element %d to face table.",
+						this->dimension, this->getElementIdentifier(elementIndexes[i]));
+					const DsLabelIndex existingIndex = this->faceTable.find(nodeIdentifiers.data(), nodeCount);
+					if (existingIndex >= 0)
+					{
+						display_message(WARNING_MESSAGE,
+							"Reason: Existing %d-D element %d uses same node list, and will be used for face matching.",
+							this->dimension, this->getElementIdentifier(existingIndex));
+					}
 				}
-				DESTROY(FE_element_type_node_sequence)(&element_type_node_sequence);
 			}
 		}
-		cmzn_elementiterator_destroy(&iter);
+		cmzn::Deaccess(iter);
 	}
 	return return_code;
 }
 
 void FE_mesh::end_define_faces()
 {
-	if (this->element_type_node_sequence_list)
-		DESTROY(LIST(FE_element_type_node_sequence))(&this->element_type_node_sequence_list);
-	else
+	if (!this->definingFaces)
 		display_message(ERROR_MESSAGE, "FE_mesh::end_define_faces.  Wasn't defining faces");
+	this->faceTable.clear();
 	this->definingFaces = false;
 }
 
 /**
  * Ensures faces of elements in mesh exist in face mesh.
  * Recursively does same for faces in face mesh.
+ * Node identifiers of faces are calculated concurrently for chunks of
+ * elements, then faces are found or created serially in element order so
+ * new face and line identifiers do not depend on the number of threads.
  * Call between begin/end_define_faces and begin/end_change.
  */
 int FE_mesh::define_faces()
@@ -2702,21 +3650,37 @@ int FE_mesh::define_faces()
 	if (!iter)
 		return CMZN_ERROR_GENERAL;
 	int return_code = CMZN_OK;
-	DsLabelIndex elementIndex;
 	int successCount = 0;
-	while ((elementIndex = iter->nextIndex()) != DS_LABEL_INDEX_INVALID)
-	{
-		const int result = this->defineElementFaces(elementIndex);
-		if (result != CMZN_OK)
+	std::vector<DsLabelIndex> elementIndexes;
+	FE_mesh_face_keys faceKeys;
+	DsLabelIndex elementIndex = iter->nextIndex();
+	while (elementIndex != DS_LABEL_INDEX_INVALID)
+	{
+		elementIndexes.clear();
+		while ((elementIndex != DS_LABEL_INDEX_INVALID) &&
+			(elementIndexes.size() < FE_MESH_FACE_KEYS_ELEMENTS_PER_CHUNK))
+		{
+			elementIndexes.push_back(elementIndex);
+			elementIndex = iter->nextIndex();
+		}
+		this->calculateFaceKeysConcurrently(elementIndexes, /*ofFaces*/true, faceKeys);
+		const size_t elementCount = elementIndexes.size();
+		for (size_t i = 0; i < elementCount; ++i)
 		{
-			return_code = result;
-			if (result == CMZN_ERROR_NOT_FOUND)
+			const int result = this->defineElementFacesPrivate(elementIndexes[i], &faceKeys, i);
+			if (result != CMZN_OK)
 			{
-				continue;
+				return_code = result;
+				if (result == CMZN_ERROR_NOT_FOUND)
+				{
+					continue;
+				}
+				break;
 			}
-			break;
+			++successCount;
 		}
-		++successCount;
+		if ((return_code != CMZN_OK) && (return_code != CMZN_ERROR_NOT_FOUND))
+			break;
 	}
 	cmzn::Deaccess(iter);
 	if ((return_code == CMZN_ERROR_NOT_FOUND) && successCount)
@@ -3403,6 +4367,122 @@ int FE_field_addMeshFieldComponentMergeData(struct FE_field *sourceField, void *
 	return 1;
 }
 
+/* minimum number of labels worth finding merge target indexes for in each thread */
+const DsLabelIndex FE_MESH_MERGE_MINIMUM_LABELS_PER_THREAD = 4096;
+
+/* minimum number of source elements times field components worth merging
+ * element values for in each thread */
+const size_t FE_MESH_MERGE_MINIMUM_ELEMENT_VALUES_PER_THREAD = 65536;
+
+/** Get index of label with the same identifier in targetLabels for source
+  * label indexes from startIndex to endIndex - 1, or DS_LABEL_INDEX_INVALID
+  * if none. Only reads labels so can be called concurrently. */
+void getMergeTargetLabelIndexesRange(const DsLabels *sourceLabels, const DsLabels *targetLabels,
+	DsLabelIndex startIndex, DsLabelIndex endIndex, DsLabelIndex *targetIndexes)
+{
+	for (DsLabelIndex index = startIndex; index < endIndex; ++index)
+	{
+		const DsLabelIdentifier identifier = sourceLabels->getIdentifier(index);
+		targetIndexes[index] = (DS_LABEL_IDENTIFIER_INVALID == identifier) ? DS_LABEL_INDEX_INVALID :
+			targetLabels->findLabelByIdentifier(identifier);
+	}
+}
+
+/** Get map from every source label index to the index of the label with the
+  * same identifier in targetLabels, or DS_LABEL_INDEX_INVALID if none, so merge
+  * does not repeatedly look up identifiers. Contiguous ranges of indexes are
+  * found in concurrent threads. */
+void getMergeTargetLabelIndexes(const DsLabels& sourceLabels, const DsLabels& targetLabels,
+	std::vector<DsLabelIndex>& targetIndexes)
+{
+	const DsLabelIndex indexSize = sourceLabels.getIndexSize();
+	targetIndexes.assign(indexSize, DS_LABEL_INDEX_INVALID);
+	DsLabelIndex threadCount = static_cast<DsLabelIndex>(std::thread::hardware_concurrency());
+	const DsLabelIndex maximumThreadCount = indexSize / FE_MESH_MERGE_MINIMUM_LABELS_PER_THREAD;
+	if (threadCount > maximumThreadCount)
+		threadCount = maximumThreadCount;
+	if (threadCount < 2)
+	{
+		getMergeTargetLabelIndexesRange(&sourceLabels, &targetLabels, 0, indexSize, targetIndexes.data());
+		return;
+	}
+	const DsLabelIndex indexesPerThread = (indexSize + threadCount - 1) / threadCount;
+	std::vector<std::thread> threads;
+	for (DsLabelIndex t = 1; t < threadCount; ++t)
+	{
+		const DsLabelIndex start = std::min(t*indexesPerThread, indexSize);
+		const DsLabelIndex end = std::min(start + indexesPerThread, indexSize);
+		threads.push_back(std::thread(getMergeTargetLabelIndexesRange, &sourceLabels, &targetLabels,
+			start, end, targetIndexes.data()));
+	}
+	getMergeTargetLabelIndexesRange(&sourceLabels, &targetLabels, 0, indexesPerThread, targetIndexes.data());
+	for (size_t t = 0; t < threads.size(); ++t)
+		threads[t].join();
+}
+
+struct MeshFieldComponentValuesMergeData
+{
+	FE_mesh_field_data::ComponentBase *targetComponent;
+	const FE_mesh_field_data::ComponentBase *sourceComponent;
+};
+
+/** Merge element values for field components from startIndex to endIndex - 1.
+  * Each only modifies its target component so ranges can be merged concurrently.
+  * @param result  Set to 1 on success, 0 on failure. */
+void mergeElementValuesRange(const MeshFieldComponentValuesMergeData *valuesMergeData,
+	size_t startIndex, size_t endIndex, const std::vector<DsLabelIndex> *sourceToTargetElementIndexes,
+	int *result)
+{
+	*result = 1;
+	for (size_t i = startIndex; i < endIndex; ++i)
+	{
+		if (!valuesMergeData[i].targetComponent->mergeElementValues(
+			valuesMergeData[i].sourceComponent, *sourceToTargetElementIndexes))
+		{
+			*result = 0;
+			break;
+		}
+	}
+}
+
+/** Merge element values for all field components, dividing them into
+  * contiguous ranges merged in concurrent threads.
+  * @param sourceElementCount  Number of elements in source mesh, to estimate work.
+  * @return  True on success, false on failure. */
+bool mergeElementValuesConcurrently(const std::vector<MeshFieldComponentValuesMergeData>& valuesMergeData,
+	DsLabelIndex sourceElementCount, const std::vector<DsLabelIndex>& sourceToTargetElementIndexes)
+{
+	const size_t componentCount = valuesMergeData.size();
+	size_t threadCount = std::thread::hardware_concurrency();
+	const size_t maximumThreadCount = std::min(componentCount,
+		componentCount*static_cast<size_t>(sourceElementCount) / FE_MESH_MERGE_MINIMUM_ELEMENT_VALUES_PER_THREAD);
+	if (threadCount > maximumThreadCount)
+		threadCount = maximumThreadCount;
+	if (threadCount < 2)
+		threadCount = 1;
+	const size_t componentsPerThread = (componentCount + threadCount - 1) / threadCount;
+	std::vector<int> threadResults(threadCount, 0);
+	std::vector<std::thread> threads;
+	for (size_t t = 1; t < threadCount; ++t)
+	{
+		const size_t start = std::min(t*componentsPerThread, componentCount);
+		const size_t end = std::min(start + componentsPerThread, componentCount);
+		threads.push_back(std::thread(mergeElementValuesRange, valuesMergeData.data(), start, end,
+			&sourceToTargetElementIndexes, &(threadResults[t])));
+	}
+	mergeElementValuesRange(valuesMergeData.data(), 0, std::min(componentsPerThread, componentCount),
+		&sourceToTargetElementIndexes, &(threadResults[0]));
+	bool result = true;
+	for (size_t t = 0; t < threadCount; ++t)
+	{
+		if (t > 0)
+			threads[t - 1].join();
+		if (!threadResults[t])
+			result = false;
+	}
+	return result;
+}
+
 }
 
 /**
@@ -3534,13 +4614,20 @@ bool FE_mesh::mergePart2Fields(const FE_mesh &source)
 		return false;
 
 	bool result = true;
+	// map source to target element indexes once, rather than finding by identifier for each field
+	std::vector<DsLabelIndex> sourceToTargetElementIndexes;
+	getMergeTargetLabelIndexes(source.labels, this->labels, sourceToTargetElementIndexes);
+
 	// make table of source to merged target EFT data index
 	std::vector<FE_mesh_field_template::EFTIndexType> sourceToTargetEFTDataIndex;
+	bool sourceHasElementValues = false;
 	for (int i = 0; i < source.elementFieldTemplateDataCount; ++i)
 	{
 		FE_mesh_field_template::EFTIndexType targetEftIndex = FE_mesh_field_template::ELEMENT_FIELD_TEMPLATE_DATA_INDEX_INVALID;
 		if (source.elementFieldTemplateData[i])
 		{
+			if (source.elementFieldTemplateData[i]->getElementfieldtemplate()->getNumberOfElementDOFs() > 0)
+				sourceHasElementValues = true;
 			// must clone otherwise attempting to merge into a different mesh
 			FE_element_field_template *sourceEFT = source.elementFieldTemplateData[i]->getElementfieldtemplate()->cloneForNewMesh(this);
 			FE_element_field_template *targetEFT = this->mergeElementfieldtemplate(sourceEFT);
@@ -3568,6 +4655,8 @@ bool FE_mesh::mergePart2Fields(const FE_mesh &source)
 		}
 	}
 
+	// element values are merged after all field components have their final mesh field templates
+	std::vector<MeshFieldComponentValuesMergeData> valuesMergeData;
 	const int fieldComponentCount = static_cast<int>(fieldComponentMergeData.size());
 	for (int fc = 0; fc < fieldComponentCount; ++fc)
 	{
@@ -3586,7 +4675,7 @@ bool FE_mesh::mergePart2Fields(const FE_mesh &source)
 			{
 				// can use current targetMFT if it is a superset of sourceMFT
 				if (fieldComponentData.targetMFT->matchesWithEFTIndexMap(*fieldComponentData.sourceMFT,
-					sourceToTargetEFTDataIndex, /*superset*/true))
+					sourceToTargetEFTDataIndex, sourceToTargetElementIndexes, /*superset*/true))
 				{
 					finalMFT = fieldComponentData.targetMFT->access();
 				}
@@ -3628,7 +4717,8 @@ bool FE_mesh::mergePart2Fields(const FE_mesh &source)
 					iter != this->meshFieldTemplates.end(); ++iter)
 				{
 					FE_mesh_field_template *mft = *iter;
-					if (mft->matchesWithEFTIndexMap(*fieldComponentData.sourceMFT, sourceToTargetEFTDataIndex, /*superset*/false))
+					if (mft->matchesWithEFTIndexMap(*fieldComponentData.sourceMFT, sourceToTargetEFTDataIndex,
+						sourceToTargetElementIndexes, /*superset*/false))
 					{
 						finalMFT = mft->access();
 						break;
@@ -3647,7 +4737,8 @@ bool FE_mesh::mergePart2Fields(const FE_mesh &source)
 			}
 			if (mergeSourceMFT)
 			{
-				if (!finalMFT->mergeWithEFTIndexMap(*fieldComponentData.sourceMFT, sourceToTargetEFTDataIndex))
+				if (!finalMFT->mergeWithEFTIndexMap(*fieldComponentData.sourceMFT, sourceToTargetEFTDataIndex,
+					sourceToTargetElementIndexes))
 				{
 					display_message(ERROR_MESSAGE, "FE_mesh::merge.  Failed to merge mesh field template");
 					FE_mesh_field_template::deaccess(finalMFT);
@@ -3685,14 +4776,14 @@ bool FE_mesh::mergePart2Fields(const FE_mesh &source)
 		FE_mesh_field_template::deaccess(finalMFT);
 		if (!result)
 			break;
-		FE_mesh_field_data::ComponentBase *sourceComponent = sourceMeshFieldData->components[fieldComponentData.componentNumber];
-		FE_mesh_field_data::ComponentBase *targetComponent = targetMeshFieldData->components[fieldComponentData.componentNumber];
-		// future optimisation: avoid following if no source EFTs have element values
-		if (!targetComponent->mergeElementValues(sourceComponent))
+		if (sourceHasElementValues)
 		{
-			display_message(ERROR_MESSAGE, "FE_mesh::merge.  Failed to merge element values");
-			result = false;
-			break;
+			MeshFieldComponentValuesMergeData componentValuesMergeData =
+			{
+				targetMeshFieldData->components[fieldComponentData.componentNumber],
+				sourceMeshFieldData->components[fieldComponentData.componentNumber]
+			};
+			valuesMergeData.push_back(componentValuesMergeData);
 		}
 		if (0 == fieldComponentData.componentNumber)
 		{
@@ -3700,13 +4791,25 @@ bool FE_mesh::mergePart2Fields(const FE_mesh &source)
 		}
 	}
 
+	if ((result) && (!valuesMergeData.empty()) &&
+		(!mergeElementValuesConcurrently(valuesMergeData, source.getSize(), sourceToTargetElementIndexes)))
+	{
+		display_message(ERROR_MESSAGE, "FE_mesh::merge.  Failed to merge element values");
+		result = false;
+	}
+	if (!result)
+		return false;
+
 	// 3. merge shared element local-to-global node map and scale factors
 
+	std::vector<DsLabelIndex> sourceToTargetNodeIndexes; // found when first needed
 	for (int sourceEFTIndex = 0; sourceEFTIndex < source.elementFieldTemplateDataCount; ++sourceEFTIndex)
 	{
 		const FE_mesh_element_field_template_data *sourceEFTData = source.elementFieldTemplateData[sourceEFTIndex];
 		if ((sourceEFTData) && sourceEFTData->hasElementVaryingData())
 		{
+			if ((sourceToTargetNodeIndexes.empty()) && (source.nodeset) && (this->nodeset))
+				getMergeTargetLabelIndexes(source.nodeset->getLabels(), this->nodeset->getLabels(), sourceToTargetNodeIndexes);
 			FE_mesh_element_field_template_data *targetEFTData = this->elementFieldTemplateData[sourceToTargetEFTDataIndex[sourceEFTIndex]];
 			if (!targetEFTData)
 			{
@@ -3714,7 +4817,8 @@ bool FE_mesh::mergePart2Fields(const FE_mesh &source)
 				result = false;
 				break;
 			}
-			if (!targetEFTData->mergeElementVaryingData(*sourceEFTData))
+			if (!targetEFTData->mergeElementVaryingData(*sourceEFTData,
+				sourceToTargetElementIndexes, sourceToTargetNodeIndexes))
 			{
 				display_message(ERROR_MESSAGE, "FE_mesh::merge.  Failed to merge element local-to-global maps");
 				result = false;
@@ -20,15 +20,142 @@
 #include "general/block_array.hpp"
 #include "general/list.h"
 #include <algorithm>
+#include <atomic>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
+struct FE_element_field_gather_plan;
+
+struct FE_node_field_info;
+
 class FE_mesh;
 
+class FE_mesh_face_keys;
+
 class FE_mesh_field_template;
 
+/**
+ * Hash table mapping the ascending node identifiers of elements in a mesh to
+ * their indexes, used to find faces shared by parent elements while defining
+ * faces. Keys are stored contiguously in a single array and found by open
+ * addressing, so no objects are allocated per element.
+ */
+class FE_mesh_face_table
+{
+	struct Entry
+	{
+		size_t keyStart; // index of first node identifier in keyNodeIdentifiers
+		int keySize; // number of node identifiers in key
+		unsigned int hash;
+		DsLabelIndex elementIndex;
+	};
+
+	std::vector<int> keyNodeIdentifiers;
+	std::vector<Entry> entries;
+	// entry number + 1 for each slot, or 0 if empty; size is a power of 2
+	std::vector<size_t> slots;
+
+	static unsigned int hashKey(const int *nodeIdentifiers, int nodeCount);
+
+	/** @return  Index of slot holding key, or first empty slot in its probe
+	 * sequence if not found. Slots must not be empty. */
+	size_t findSlot(const int *nodeIdentifiers, int nodeCount, unsigned int hash) const;
+
+	void rehash(size_t slotCount);
+
+public:
+
+	void clear();
+
+	/** @return  Number of keys in table */
+	size_t size() const
+	{
+		return this->entries.size();
+	}
+
+	/** @return  Index of element with key, or DS_LABEL_INDEX_INVALID if none */
+	DsLabelIndex find(const int *nodeIdentifiers, int nodeCount) const;
+
+	/**
+	 * Add element with key if key not already in table.
+	 * @param nodeIdentifiers  Node identifiers in ascending order. Copied.
+	 * @return  True if added, false if key already in table.
+	 */
+	bool insert(const int *nodeIdentifiers, int nodeCount, DsLabelIndex elementIndex);
+
+};
+
+/**
+ * Optional table of the first neighbour element across each face of every
+ * element in a mesh, and the face number of the neighbour it is on. Stored as
+ * flat arrays with a fixed stride of the maximum face count per element, so
+ * each query is a constant time lookup. The mesh records elements whose own
+ * faces or whose faces' other parents change in a change log, and only those
+ * rows are recalculated before the next query.
+ */
+class FE_mesh_neighbour_table
+{
+	FE_mesh *mesh; // not accessed
+	int faceStride; // maximum face count of element shapes when last updated
+	DsLabelIndex indexSize; // number of element indexes with rows
+	std::vector<DsLabelIndex> neighbourElements;
+	std::vector<signed char> neighbourFaceNumbers;
+	// elements whose rows must be recalculated, or all change if table not built
+	DsLabelsChangeLog *changedElements;
+	std::atomic<bool> updateNeeded;
+	// guards update of table by concurrent evaluation threads
+	std::mutex updateMutex;
+
+	FE_mesh_neighbour_table(const FE_mesh_neighbour_table&); // not implemented
+	FE_mesh_neighbour_table& operator=(const FE_mesh_neighbour_table&); // not implemented
+
+	void calculateElementNeighbours(DsLabelIndex elementIndex);
+
+	void update();
+
+public:
+
+	/** Table is built when first queried. Check isValid() after construction.
+	 * @param labelsIn  Element labels of meshIn. */
+	FE_mesh_neighbour_table(FE_mesh *meshIn, DsLabels *labelsIn);
+
+	~FE_mesh_neighbour_table();
+
+	bool isValid() const
+	{
+		return 0 != this->changedElements;
+	}
+
+	/** Record that neighbours of element may have changed. */
+	void elementChange(DsLabelIndex elementIndex)
+	{
+		this->changedElements->setIndexChange(elementIndex, DS_LABEL_CHANGE_TYPE_RELATED);
+		this->updateNeeded = true;
+	}
+
+	/** Record that neighbours of all elements may have changed. */
+	void allChange()
+	{
+		this->changedElements->setAllChange(DS_LABEL_CHANGE_TYPE_RELATED);
+		this->updateNeeded = true;
+	}
+
+	/**
+	 * Get neighbour of element across face, updating table if needed.
+	 * Result is as for FE_mesh::findElementFirstNeighbour.
+	 * @param elementIndex  Valid element index >= 0.
+	 * @param faceNumber  Valid face number for element shape >= 0.
+	 */
+	DsLabelIndex getNeighbour(DsLabelIndex elementIndex, int faceNumber, int &newFaceNumber);
+
+	size_t getAllocatedBytes() const;
+
+};
+
 /**
  * Template for creating a new element in the given FE_mesh, or redefining
  * an existing element by merging into it.
@@ -197,7 +324,8 @@ private:
 	// index into mesh labels, maps to unique identifier
 	DsLabelIndex index;
 	// the number of references held to this element; destroyed once reduces to 0
-	int access_count;
+	// atomic as elements are accessed by locations in concurrent evaluation
+	std::atomic<int> access_count;
 
 	cmzn_element(FE_mesh *meshIn, DsLabelIndex indexIn) :
 		mesh(meshIn),
@@ -285,6 +413,20 @@ class FE_mesh_element_field_template_data
 	typedef unsigned short MeshfieldtemplateUsageCountType; // internal use only
 	block_array<DsLabelIndex, MeshfieldtemplateUsageCountType> meshfieldtemplateUsageCount;
 
+	struct GatherPlanEntry
+	{
+		FE_field *field; // accessed
+		int componentNumber;
+		const FE_node_field_info *nodeFieldInfo; // not accessed; checked against generation
+		unsigned int nodeFieldInfoGeneration; // from nodeset when plan was made
+		std::shared_ptr<const FE_element_field_gather_plan> plan;
+	};
+	// plans for gathering element parameters of field components using this eft
+	// from nodes with a given node field info, see global_to_element_map_values.
+	// Mutex as built during evaluation
+	std::vector<GatherPlanEntry> gatherPlans;
+	mutable std::mutex gatherPlansMutex;
+
 	FE_mesh_element_field_template_data(const FE_mesh_element_field_template_data &source); // not implemented
 	FE_mesh_element_field_template_data& operator=(const FE_mesh_element_field_template_data &source); // not implemented
 
@@ -304,6 +446,7 @@ public:
 
 	~FE_mesh_element_field_template_data()
 	{
+		this->clearGatherPlans();
 		clearAllElementVaryingData();
 		FE_element_field_template::deaccess(this->eft);
 	}
@@ -369,6 +512,14 @@ public:
 	  * @return  Result OK on success, any other value on failure. */
 	int setElementLocalNodes(DsLabelIndex elementIndex, const DsLabelIndex *nodeIndexes);
 
+	/** Set all local nodes for a new element with no nodes set, for bulk
+	  * element creation. Does not record or notify changes.
+	  * @param elementIndex  Element index. Not checked.
+	  * @param nodeIndexes  Array of nodeIndexes to set, size equal to
+	  * localNodeCount for EFT. Negative to leave a local node unset.
+	  * @return  Result OK on success, any other value on failure. */
+	int setNewElementLocalNodes(DsLabelIndex elementIndex, const DsLabelIndex *nodeIndexes);
+
 	/** Set all local nodes for the given element, by identifier.
 	  * @param elementIndex  Element index. Not checked.
 	  * @param nodeIdentifiers  Array of identifiers of nodes to set, size equal to
@@ -432,6 +583,38 @@ public:
 
 	void decrementMeshfieldtemplateUsageCount(DsLabelIndex elementIndex);
 
+	/** @return  Bytes allocated for per-element data: local-to-global node and
+	  * scale factor maps, and usage counts. */
+	size_t getElementDataAllocatedBytes() const
+	{
+		return this->localToGlobalNodes.getAllocatedBytes()
+			+ this->localToGlobalScaleFactors.getAllocatedBytes()
+			+ this->meshfieldtemplateUsageCount.getAllocatedBytes();
+	}
+
+	/** List numbers of elements and bytes used by per-element data. */
+	void list_storage_details() const;
+
+	/** Get cached plan for gathering element parameters of field component
+	  * from nodes with the node field info.
+	  * @param nodeFieldInfoGeneration  Current node field info generation of
+	  * the nodeset; plans made with an earlier generation are not returned.
+	  * @return  Shared plan, or empty if none. */
+	std::shared_ptr<const FE_element_field_gather_plan> getGatherPlan(FE_field *field,
+		int componentNumber, const FE_node_field_info *nodeFieldInfo,
+		unsigned int nodeFieldInfoGeneration) const;
+
+	/** Set or replace cached plan for gathering element parameters of field
+	  * component from nodes with the node field info. Plans for the field
+	  * component made with other generations are discarded. */
+	void setGatherPlan(FE_field *field, int componentNumber,
+		const FE_node_field_info *nodeFieldInfo, unsigned int nodeFieldInfoGeneration,
+		const std::shared_ptr<const FE_element_field_gather_plan>& plan);
+
+	/** Discard gather plans for field, releasing its access.
+	  * @param field  The field to remove plans for, or 0 for all fields. */
+	void clearGatherPlans(FE_field *field = 0);
+
 	DsLabelIndex getElementIndexLimit() const;
 
 	DsLabelIndex getElementIndexStart() const;
@@ -443,9 +626,22 @@ public:
 
 	bool localToGlobalNodesIsDense() const;
 
+	/** Replace all global node indexes in local-to-global node map with
+	  * new indexes after nodes are reordered.
+	  * @param newNodeIndexes  New index for each old node index. */
+	void permuteNodeIndexes(const DsLabelIndex *newNodeIndexes);
+
+	/** Move per-element data to new element indexes after elements are reordered.
+	  * @param oldElementIndexSize  Size of newElementIndexes.
+	  * @param newElementIndexes  New index for each old element index.
+	  * @return  True on success, false if failed. */
+	bool permuteElementIndexes(DsLabelIndex oldElementIndexSize, const DsLabelIndex *newElementIndexes);
+
 	int getElementLocalToGlobalNodeMapCount() const;
 
-	bool mergeElementVaryingData(const FE_mesh_element_field_template_data& source);
+	bool mergeElementVaryingData(const FE_mesh_element_field_template_data& source,
+		const std::vector<DsLabelIndex>& sourceToTargetElementIndexes,
+		const std::vector<DsLabelIndex>& sourceToTargetNodeIndexes);
 
 private:
 
@@ -555,6 +751,12 @@ public:
 		return this->access_count;
 	}
 
+	/** @return  Bytes allocated for map from element to element field template. */
+	size_t getAllocatedBytes() const
+	{
+		return this->eftDataMap.getAllocatedBytes();
+	}
+
 	inline EFTIndexType getElementEFTIndex(DsLabelIndex elementIndex) const
 	{
 		return this->eftDataMap.getValue(elementIndex);
@@ -585,10 +787,12 @@ public:
 	}
 
 	bool matchesWithEFTIndexMap(const FE_mesh_field_template &source,
-		const std::vector<EFTIndexType> &sourceEFTIndexMap, bool superset) const;
+		const std::vector<EFTIndexType> &sourceEFTIndexMap,
+		const std::vector<DsLabelIndex> &sourceToTargetElementIndexes, bool superset) const;
 
 	bool mergeWithEFTIndexMap(const FE_mesh_field_template &source,
-		const std::vector<EFTIndexType> &sourceEFTIndexMap);
+		const std::vector<EFTIndexType> &sourceEFTIndexMap,
+		const std::vector<DsLabelIndex> &sourceToTargetElementIndexes);
 
 	bool usesNonLinearBasis() const;
 
@@ -679,6 +883,23 @@ public:
 		/** convenient function for getting a single face for an element */
 		DsLabelIndex getElementFace(DsLabelIndex elementIndex, int faceNumber);
 
+		/** Move face arrays to new element indexes after elements are reordered.
+		  * @return  True on success, false if failed. */
+		bool permuteElementIndexes(DsLabelIndex oldElementIndexSize, const DsLabelIndex *newElementIndexes)
+		{
+			return this->faces.permute(oldElementIndexSize, newElementIndexes);
+		}
+
+		/** Replace face element indexes with new indexes after face mesh is reordered.
+		  * @param newFaceIndexes  New index for each old face element index. */
+		void permuteFaceIndexes(const DsLabelIndex *newFaceIndexes);
+
+		/** @return  Bytes allocated for face maps of elements with this shape */
+		size_t getAllocatedBytes() const
+		{
+			return this->faces.getAllocatedBytes();
+		}
+
 	};
 
 private:
@@ -731,15 +952,20 @@ private:
 	DsLabelsChangeLog *changeLog;
 
 	/* information for defining faces */
-	/* existence of element_type_node_sequence_list can tell us whether faces
-		 are being defined */
-	struct LIST(FE_element_type_node_sequence) *element_type_node_sequence_list;
+	// maps sorted node identifiers to existing elements, for finding faces
+	FE_mesh_face_table faceTable;
 	bool definingFaces;
 
+	// optional table of neighbours across element faces, or 0 if not enabled
+	FE_mesh_neighbour_table *neighbourTable;
+
 	// list of element iterators to invalidate when mesh destroyed
 	cmzn_elementiterator *activeElementIterators;
+	// guards activeElementIterators as iterators are created and destroyed by
+	// concurrent evaluation threads
+	std::mutex activeElementIteratorsMutex;
 
-	mutable int access_count;
+	mutable std::atomic<int> access_count;
 
 private:
 
@@ -749,7 +975,17 @@ private:
 
 	void createChangeLog();
 
-	int findOrCreateFace(DsLabelIndex parentIndex, int faceNumber, DsLabelIndex& faceIndex);
+	int findOrCreateFace(DsLabelIndex parentIndex, int faceNumber,
+		const std::vector<int>& faceNodeIdentifiers, DsLabelIndex& faceIndex);
+
+	void calculateFaceKeys(const DsLabelIndex *elementIndexes, size_t elementCount,
+		bool ofFaces, FE_mesh_face_keys& faceKeys) const;
+
+	void calculateFaceKeysConcurrently(const std::vector<DsLabelIndex>& elementIndexes,
+		bool ofFaces, FE_mesh_face_keys& faceKeys) const;
+
+	int defineElementFacesPrivate(DsLabelIndex elementIndex,
+		const FE_mesh_face_keys *faceKeys, size_t elementNumber);
 
 	int removeElementPrivate(DsLabelIndex elementIndex);
 
@@ -771,6 +1007,8 @@ private:
 
 	void clearElementFaces(DsLabelIndex elementIndex);
 
+	void neighbourTableFaceChange(DsLabelIndex faceIndex);
+
 	ElementShapeFaces *setElementShape(DsLabelIndex elementIndex, FE_element_shape *element_shape);
 
 	bool setElementShapeFromElementTemplate(DsLabelIndex elementIndex, FE_element_template *element_template);
@@ -818,6 +1056,10 @@ public:
 		return this->elementFieldTemplateDataCount;
 	}
 
+	/** Discard plans for gathering element parameters of field from nodes with
+	  * all element field templates, e.g. when field is removed or redefined. */
+	void clearFieldGatherPlans(FE_field *field);
+
 	/** @param eftIndex  Index of EFT in this mesh. Not checked.
 	  * @return  Non-accessed mesh element field template data, or 0 if none. */
 	const FE_mesh_element_field_template_data *getElementfieldtemplateData(int eftIndex) const
@@ -871,8 +1113,7 @@ public:
 	{
 		if (mesh)
 		{
-			--(mesh->access_count);
-			if (mesh->access_count <= 0)
+			if (--(mesh->access_count) <= 0)
 				delete mesh;
 			mesh = 0;
 		}
@@ -882,8 +1123,7 @@ public:
 	{
 		if (mesh)
 		{
-			--(mesh->access_count);
-			if (mesh->access_count <= 0)
+			if (--(mesh->access_count) <= 0)
 				delete mesh;
 			mesh = 0;
 		}
@@ -909,6 +1149,8 @@ public:
 	void setFaceMesh(FE_mesh *faceMeshIn)
 	{
 		this->faceMesh = faceMeshIn;
+		if (this->neighbourTable)
+			this->neighbourTable->allChange();
 	}
 
 	FE_mesh *getParentMesh() const
@@ -932,6 +1174,46 @@ public:
 		return this->nodeset;
 	}
 
+	bool isDefiningFaces() const
+	{
+		return this->definingFaces;
+	}
+
+	/**
+	 * Append list of distinct node indexes used by each element in index
+	 * order, over all element field templates, for calculating node orderings.
+	 * Elements without nodes are skipped.
+	 * @param listStarts  Vector of list starts in listNodeIndexes, to append
+	 * end of each element's list to. Caller initialises it with 0.
+	 * @param listNodeIndexes  Vector to append node indexes to.
+	 */
+	void appendElementNodeLists(std::vector<size_t>& listStarts,
+		std::vector<DsLabelIndex>& listNodeIndexes) const;
+
+	/**
+	 * Move per-node data and node indexes used by elements to new node indexes
+	 * after the nodeset is reordered.
+	 * @param oldNodeIndexSize  Size of newNodeIndexes.
+	 * @param newNodeIndexes  New index for each old node index.
+	 * @return  True on success, false if failed.
+	 */
+	bool permuteNodeIndexes(DsLabelIndex oldNodeIndexSize, const DsLabelIndex *newNodeIndexes);
+
+	/**
+	 * Reorder elements in memory so elements using nearby nodes are stored
+	 * close together, and compact storage left unused by destroyed elements.
+	 * Elements are sorted by their lowest node index, so reorder nodes first;
+	 * elements without nodes follow in their existing order. Moves all
+	 * per-element data including field parameters, and updates face and
+	 * parent maps of adjacent meshes. Notifies all elements and fields
+	 * defined on the mesh as changed.
+	 * @param keepIdentifiers  If true, elements keep their identifiers. If
+	 * false, elements are renumbered from 1 in the new order.
+	 * @return  Result OK on success, ERROR_IN_USE if faces are being defined,
+	 * otherwise any other error code.
+	 */
+	int reorderElements(bool keepIdentifiers);
+
 	const char *getName() const;
 
 	const DsLabels& getLabels() const
@@ -1047,6 +1329,19 @@ public:
 
 	void list_btree_statistics();
 
+	/**
+	 * Get bytes allocated for storage in this mesh, excluding per-element
+	 * field values which are owned by fields. Excludes allocator overheads.
+	 * @param labelsBytes  Set to bytes for element identifier labels.
+	 * @param elementsBytes  Set to bytes for element objects, and maps from
+	 * element to shape, faces and parents.
+	 * @param elementFieldTemplatesBytes  Set to bytes for element field
+	 * template local-to-global maps and mesh field template maps.
+	 * @param scaleFactorsBytes  Set to bytes for scale factors and their maps.
+	 */
+	void getAllocatedBytes(size_t& labelsBytes, size_t& elementsBytes,
+		size_t& elementFieldTemplatesBytes, size_t& scaleFactorsBytes) const;
+
 	bool containsElement(cmzn_element *element) const
 	{
 		return (element) && (element->getMesh() == this) && (element->getIndex() >= 0);
@@ -1080,6 +1375,10 @@ public:
 
 	cmzn_element *create_FE_element(int identifier, FE_element_template *elementTemplate);
 
+	int create_FE_elements(int elementsCount, const int *identifiers,
+		FE_element_template *elementTemplate, FE_element_field_template *eft,
+		const int *nodeIdentifiers, DsLabelIndex& firstElementIndex, int& createdCount);
+
 	cmzn_element *get_or_create_FE_element_with_identifier(int identifier,
 		struct FE_element_shape *element_shape);
 
@@ -1175,9 +1474,45 @@ public:
 		* or the parent is on the given face of a top-level element. */
 	DsLabelIndex getElementParentOnFace(DsLabelIndex elementIndex, cmzn_element_face_type faceType);
 
-	DsLabelIndex getElementFirstNeighbour(DsLabelIndex elementIndex, int faceNumber, int &newFaceNumber);
+	DsLabelIndex findElementFirstNeighbour(DsLabelIndex elementIndex, int faceNumber, int &newFaceNumber);
 
-	int defineElementFaces(DsLabelIndex elementIndex);
+	/** return index of neighbour element on faceNumber, if any, and the face
+	 * number it is on in newFaceNumber. Looked up in neighbour table if enabled.
+	 * @see findElementFirstNeighbour */
+	DsLabelIndex getElementFirstNeighbour(DsLabelIndex elementIndex, int faceNumber, int &newFaceNumber)
+	{
+		if (this->neighbourTable)
+			return this->neighbourTable->getNeighbour(elementIndex, faceNumber, newFaceNumber);
+		return this->findElementFirstNeighbour(elementIndex, faceNumber, newFaceNumber);
+	}
+
+	/** @return  Maximum number of faces of any element shape in mesh */
+	int getMaximumElementFaceCount() const
+	{
+		int maximumFaceCount = 0;
+		for (int i = 0; i < this->elementShapeFacesCount; ++i)
+			if (this->elementShapeFacesArray[i]->getFaceCount() > maximumFaceCount)
+				maximumFaceCount = this->elementShapeFacesArray[i]->getFaceCount();
+		return maximumFaceCount;
+	}
+
+	bool isNeighbourTableEnabled() const
+	{
+		return 0 != this->neighbourTable;
+	}
+
+	/**
+	 * Enable or disable table of neighbours across element faces. When enabled
+	 * the table is built when first used and afterwards updated only for
+	 * elements whose neighbours may have changed. Disabling frees the table.
+	 * @return  Result OK on success, otherwise ERROR_MEMORY.
+	 */
+	int setNeighbourTableEnabled(bool enabled);
+
+	int defineElementFaces(DsLabelIndex elementIndex)
+	{
+		return this->defineElementFacesPrivate(elementIndex, /*faceKeys*/0, 0);
+	}
 
 	int begin_define_faces();
 
@@ -1387,7 +1722,17 @@ public:
 			this->meshFieldTemplate = meshFieldTemplateIn;
 		}
 
-		virtual bool mergeElementValues(const ComponentBase *sourceBase) = 0;
+		virtual bool mergeElementValues(const ComponentBase *sourceBase,
+			const std::vector<DsLabelIndex>& sourceToTargetElementIndexes) = 0;
+
+		/** Move per-element values to new element indexes after elements are
+		  * reordered. Does not permute the shared mesh field template.
+		  * @return  True on success, false if failed. */
+		virtual bool permuteElementIndexes(DsLabelIndex oldElementIndexSize,
+			const DsLabelIndex *newElementIndexes) = 0;
+
+		/** @return  Bytes allocated for per-element values. */
+		virtual size_t getAllocatedBytes() const = 0;
 
 	};
 
@@ -1484,13 +1829,16 @@ public:
 			return true;
 		}
 
-		/** Copy element values from source component, finding target elements by identifier.
+		/** Copy element values from source component to target elements with the same identifiers.
 		  * Used only by FE_mesh::merge to merge values from another region.
 		  * Must have already merged mesh field template for component, so target element
 		  * field template is guaranteed to be the same for each element in source.
+		  * Only modifies this component, so different components may be merged concurrently.
 		  * @param sourceBase  Source component as base class. Must of same ValueType.
+		  * @param sourceToTargetElementIndexes  Target element index for each source element index.
 		  * @return  True on success, false on failure. */
-		virtual bool mergeElementValues(const ComponentBase *sourceBase)
+		virtual bool mergeElementValues(const ComponentBase *sourceBase,
+			const std::vector<DsLabelIndex>& sourceToTargetElementIndexes)
 		{
 			const Component *source = dynamic_cast<const Component<ValueType> *>(sourceBase);
 			if (!source)
@@ -1498,14 +1846,14 @@ public:
 				display_message(ERROR_MESSAGE, "FE_mesh_field_data::Component::mergeElementDOFs.  Invalid source");
 				return false;
 			}
-			const FE_mesh *sourceMesh = source->meshFieldTemplate->getMesh();
-			const FE_mesh *targetMesh = this->meshFieldTemplate->getMesh();
 			DsLabelIndex sourceElementIndexLimit = source->meshFieldTemplate->getElementIndexLimit();
+			if (sourceElementIndexLimit > static_cast<DsLabelIndex>(sourceToTargetElementIndexes.size()))
+				sourceElementIndexLimit = static_cast<DsLabelIndex>(sourceToTargetElementIndexes.size());
 			for (DsLabelIndex sourceElementIndex = source->meshFieldTemplate->getElementIndexStart();
 				sourceElementIndex < sourceElementIndexLimit; ++sourceElementIndex)
 			{
-				const DsLabelIdentifier elementIdentifier = sourceMesh->getElementIdentifier(sourceElementIndex);
-				if (DS_LABEL_IDENTIFIER_INVALID == elementIdentifier)
+				const DsLabelIndex targetElementIndex = sourceToTargetElementIndexes[sourceElementIndex];
+				if (targetElementIndex < 0)
 					continue; // no element at that index
 				FE_element_field_template *sourceElementfieldtemplate = source->meshFieldTemplate->getElementfieldtemplate(sourceElementIndex);
 				if (!sourceElementfieldtemplate)
@@ -1519,14 +1867,40 @@ public:
 					display_message(ERROR_MESSAGE, "FE_mesh_field_data::Component::mergeElementDOFs.  Missing source DOFs");
 					return false;
 				}
-				const DsLabelIndex targetElementIndex = targetMesh->findIndexByIdentifier(elementIdentifier);
-				// the above must be valid if merge has got to this point, so not testing.
 				if (!this->setElementValues(targetElementIndex, valuesCount, sourceValues))
 					return false;
 			}
 			return true;
 		}
 
+		virtual bool permuteElementIndexes(DsLabelIndex oldElementIndexSize,
+			const DsLabelIndex *newElementIndexes)
+		{
+			// vector values are moved, keeping ownership
+			return this->elementScalarDOFs.permute(oldElementIndexSize, newElementIndexes)
+				&& this->elementVectorDOFs.permute(oldElementIndexSize, newElementIndexes);
+		}
+
+		/** @return  Bytes allocated for scalar and vector element values,
+		  * including each element's vector of values. */
+		virtual size_t getAllocatedBytes() const
+		{
+			size_t bytes = this->elementScalarDOFs.getAllocatedBytes()
+				+ this->elementVectorDOFs.getAllocatedBytes();
+			const DsLabelIndex elementIndexLimit = this->meshFieldTemplate->getElementIndexLimit();
+			for (DsLabelIndex elementIndex = this->meshFieldTemplate->getElementIndexStart();
+				elementIndex < elementIndexLimit; ++elementIndex)
+			{
+				if (this->elementVectorDOFs.getValue(elementIndex))
+				{
+					const FE_element_field_template *eft = this->meshFieldTemplate->getElementfieldtemplate(elementIndex);
+					if (eft)
+						bytes += eft->getNumberOfElementDOFs()*sizeof(ValueType);
+				}
+			}
+			return bytes;
+		}
+
 	};
 
 	/** Simple component type for types without element varying quantities e.g. indexed string */
@@ -1547,11 +1921,21 @@ public:
 		{
 		}
 
-		virtual bool mergeElementValues(const ComponentBase *)
+		virtual bool mergeElementValues(const ComponentBase *, const std::vector<DsLabelIndex>&)
 		{
 			return true;
 		}
 
+		virtual bool permuteElementIndexes(DsLabelIndex, const DsLabelIndex *)
+		{
+			return true;
+		}
+
+		virtual size_t getAllocatedBytes() const
+		{
+			return 0;
+		}
+
 	};
 
 
@@ -1596,6 +1980,17 @@ public:
 			this->components[c]->clearElementData(elementIndex);
 	}
 
+	/** Move element data for all components to new element indexes.
+	  * @return  True on success, false if failed. */
+	bool permuteElementIndexes(DsLabelIndex oldElementIndexSize, const DsLabelIndex *newElementIndexes)
+	{
+		bool success = true;
+		for (int c = 0; c < this->componentCount; ++c)
+			if (!this->components[c]->permuteElementIndexes(oldElementIndexSize, newElementIndexes))
+				success = false;
+		return success;
+	}
+
 	/** @param componentNumber  From 0 to componentCount - 1, not checked
 	  * @return  Non-accessed component base */
 	ComponentBase *getComponentBase(int componentNumber) const
@@ -1628,6 +2023,16 @@ public:
 		return !this->components[0]->getMeshfieldtemplate()->isBlank();
 	}
 
+	/** @return  Bytes allocated for per-element values of all components.
+	  * Excludes mesh field templates, which are shared and owned by the mesh. */
+	size_t getAllocatedBytes() const
+	{
+		size_t bytes = 0;
+		for (int c = 0; c < this->componentCount; ++c)
+			bytes += this->components[c]->getAllocatedBytes();
+		return bytes;
+	}
+
 	/** @return  True if any element of any component uses a non-linear basis in any direction */
 	bool usesNonLinearBasis() const
 	{
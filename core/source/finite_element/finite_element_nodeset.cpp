@@ -9,6 +9,7 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <vector>
@@ -48,6 +49,7 @@ FE_nodeset::FE_nodeset(FE_region *fe_region) :
 	domainType(CMZN_FIELD_DOMAIN_TYPE_INVALID),
 	node_field_info_list(CREATE(LIST(FE_node_field_info))()),
 	last_fe_node_field_info(0),
+	nodeFieldInfoGeneration(0),
 	changeLog(0),
 	activeNodeIterators(0),
 	access_count(1)
@@ -292,6 +294,7 @@ void FE_nodeset::detach_from_FE_region()
 /** Remove iterator from linked list in this nodeset */
 void FE_nodeset::removeNodeiterator(cmzn_nodeiterator *iterator)
 {
+	std::lock_guard<std::mutex> lock(this->activeNodeIteratorsMutex);
 	if (iterator == this->activeNodeIterators)
 		this->activeNodeIterators = iterator->nextIterator;
 	else
@@ -321,6 +324,7 @@ cmzn_nodeiterator *FE_nodeset::createNodeiterator(DsLabelsGroup *labelsGroup)
 	cmzn_nodeiterator *iterator = new cmzn_nodeiterator(this, labelIterator);
 	if (iterator)
 	{
+		std::lock_guard<std::mutex> lock(this->activeNodeIteratorsMutex);
 		iterator->nextIterator = this->activeNodeIterators;
 		this->activeNodeIterators = iterator;
 	}
@@ -614,6 +618,270 @@ FE_node *FE_nodeset::create_FE_node(DsLabelIdentifier identifier, FE_node_templa
 	return (new_node);
 }
 
+int FE_nodeset::create_FE_nodes(int nodesCount, const int *identifiers,
+	FE_node_template *node_template, int fieldsCount, FE_field **fields,
+	int valuesCount, const FE_value *values, DsLabelIndex& firstNodeIndex, int& createdCount)
+{
+	firstNodeIndex = DS_LABEL_INDEX_INVALID;
+	createdCount = 0;
+	if (!((0 < nodesCount) && (node_template) && (node_template->nodeset == this)
+		&& (0 <= fieldsCount) && ((0 == fieldsCount) || ((fields) && (values)))))
+	{
+		display_message(ERROR_MESSAGE, "FE_nodeset::create_FE_nodes.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if (identifiers)
+	{
+		std::vector<int> sortedIdentifiers(identifiers, identifiers + nodesCount);
+		std::sort(sortedIdentifiers.begin(), sortedIdentifiers.end());
+		if (sortedIdentifiers[0] < 0)
+		{
+			display_message(ERROR_MESSAGE, "FE_nodeset::create_FE_nodes.  Negative identifier %d", sortedIdentifiers[0]);
+			return CMZN_ERROR_ARGUMENT;
+		}
+		std::vector<int>::iterator repeat = std::adjacent_find(sortedIdentifiers.begin(), sortedIdentifiers.end());
+		if (repeat != sortedIdentifiers.end())
+		{
+			display_message(ERROR_MESSAGE, "FE_nodeset::create_FE_nodes.  Identifier %d is repeated", *repeat);
+			return CMZN_ERROR_ARGUMENT;
+		}
+		for (int n = 0; n < nodesCount; ++n)
+		{
+			if (this->labels.findLabelByIdentifier(identifiers[n]) >= 0)
+			{
+				display_message(ERROR_MESSAGE, "FE_nodeset::create_FE_nodes.  Identifier %d is already used in nodeset.",
+					identifiers[n]);
+				return CMZN_ERROR_ARGUMENT;
+			}
+		}
+	}
+	// all new nodes share the template's field info so parameter offsets are resolved once
+	FE_node *template_node = node_template->get_template_node();
+	std::vector<int> offsets;
+	for (int f = 0; f < fieldsCount; ++f)
+	{
+		const int result = FE_node_get_FE_value_parameter_offsets(template_node, fields[f], offsets);
+		if (CMZN_OK != result)
+			return CMZN_ERROR_ARGUMENT;
+	}
+	const int valuesPerNode = static_cast<int>(offsets.size());
+	if ((0 < fieldsCount) && (static_cast<size_t>(valuesCount) != static_cast<size_t>(nodesCount)*valuesPerNode))
+	{
+		display_message(ERROR_MESSAGE, "FE_nodeset::create_FE_nodes.  "
+			"%d values supplied, %d nodes x %d parameters are required", valuesCount, nodesCount, valuesPerNode);
+		return CMZN_ERROR_ARGUMENT;
+	}
+	const DsLabelIndex indexSize = this->labels.getIndexSize();
+	if (!this->fe_nodes.reserve(indexSize + nodesCount))
+		return CMZN_ERROR_MEMORY;
+	int return_code = CMZN_OK;
+	for (int n = 0; n < nodesCount; ++n)
+	{
+		const DsLabelIndex nodeIndex = (identifiers) ? this->labels.createLabel(identifiers[n]) : this->labels.createLabel();
+		if (nodeIndex < 0)
+		{
+			display_message(ERROR_MESSAGE, "FE_nodeset::create_FE_nodes.  Could not create label");
+			return_code = CMZN_ERROR_MEMORY;
+			break;
+		}
+		FE_node *new_node = ::create_FE_node_from_template(nodeIndex, template_node);
+		if ((new_node) && this->fe_nodes.setValue(nodeIndex, new_node))
+		{
+			if (0 < valuesPerNode)
+				FE_node_set_FE_value_parameters_at_offsets(new_node, valuesPerNode,
+					offsets.data(), values + static_cast<size_t>(n)*valuesPerNode);
+			// access from creation is kept by fe_nodes
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE, "FE_nodeset::create_FE_nodes.  Failed to add node to list.");
+			DEACCESS(FE_node)(&new_node);
+			this->labels.removeLabel(nodeIndex);
+			return_code = CMZN_ERROR_MEMORY;
+			break;
+		}
+		++createdCount;
+	}
+	if (0 < createdCount)
+	{
+		// new labels always take the next indexes
+		firstNodeIndex = indexSize;
+		if ((this->fe_region) && (this->changeLog))
+		{
+			this->changeLog->setIndexRangeChange(indexSize, indexSize + createdCount - 1, DS_LABEL_CHANGE_TYPE_ADD);
+			struct FE_node_field_info *node_field_info = FE_node_get_FE_node_field_info(template_node);
+			if (node_field_info != this->last_fe_node_field_info)
+			{
+				FE_node_field_info_log_FE_field_changes(node_field_info, this->fe_region->fe_field_changes);
+				this->last_fe_node_field_info = node_field_info;
+			}
+			this->fe_region->update();
+		}
+	}
+	return return_code;
+}
+
+void FE_nodeset::calculateReverseCuthillMcKeeOrder(std::vector<DsLabelIndex>& newIndexes)
+{
+	const DsLabelIndex nodeIndexSize = this->labels.getIndexSize();
+	newIndexes.assign(nodeIndexSize, DS_LABEL_INDEX_INVALID);
+	// lists of nodes in each element of all meshes using this nodeset
+	std::vector<size_t> listStarts(1, 0);
+	std::vector<DsLabelIndex> listNodeIndexes;
+	for (int d = 0; d < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++d)
+	{
+		FE_mesh *mesh = this->fe_region->meshes[d];
+		if ((mesh) && (mesh->getNodeset() == this))
+			mesh->appendElementNodeLists(listStarts, listNodeIndexes);
+	}
+	const size_t listCount = listStarts.size() - 1;
+	// invert to lists containing each node, and approximate node degree
+	// by the number of other nodes in the lists it is in
+	std::vector<size_t> nodeListStarts(nodeIndexSize + 1, 0);
+	for (size_t i = 0; i < listNodeIndexes.size(); ++i)
+		if (listNodeIndexes[i] < nodeIndexSize)
+			++nodeListStarts[listNodeIndexes[i] + 1];
+	for (DsLabelIndex n = 0; n < nodeIndexSize; ++n)
+		nodeListStarts[n + 1] += nodeListStarts[n];
+	std::vector<size_t> nodeLists(nodeListStarts[nodeIndexSize]);
+	std::vector<size_t> nodeListFill(nodeListStarts.begin(), nodeListStarts.end() - 1);
+	std::vector<size_t> degree(nodeIndexSize, 0);
+	for (size_t l = 0; l < listCount; ++l)
+	{
+		const size_t listSize = listStarts[l + 1] - listStarts[l];
+		for (size_t i = listStarts[l]; i < listStarts[l + 1]; ++i)
+		{
+			const DsLabelIndex nodeIndex = listNodeIndexes[i];
+			if (nodeIndex < nodeIndexSize)
+			{
+				nodeLists[nodeListFill[nodeIndex]++] = l;
+				degree[nodeIndex] += listSize - 1;
+			}
+		}
+	}
+	struct LowerDegree
+	{
+		const std::vector<size_t>& degree;
+		LowerDegree(const std::vector<size_t>& degreeIn) : degree(degreeIn) {}
+		bool operator()(DsLabelIndex a, DsLabelIndex b) const
+		{
+			return this->degree[a] < this->degree[b];
+		}
+	} lowerDegree(degree);
+	// start each connected set of nodes from a node of lowest degree
+	std::vector<DsLabelIndex> startNodes;
+	for (DsLabelIndex n = 0; n < nodeIndexSize; ++n)
+		if ((nodeListStarts[n + 1] > nodeListStarts[n]) && this->labels.hasIndex(n))
+			startNodes.push_back(n);
+	std::stable_sort(startNodes.begin(), startNodes.end(), lowerDegree);
+	std::vector<char> visited(nodeIndexSize, 0);
+	std::vector<DsLabelIndex> order;
+	order.reserve(this->labels.getSize());
+	for (size_t s = 0; s < startNodes.size(); ++s)
+	{
+		if (visited[startNodes[s]])
+			continue;
+		visited[startNodes[s]] = 1;
+		size_t head = order.size();
+		order.push_back(startNodes[s]);
+		while (head < order.size())
+		{
+			const DsLabelIndex nodeIndex = order[head++];
+			const size_t neighboursStart = order.size();
+			for (size_t j = nodeListStarts[nodeIndex]; j < nodeListStarts[nodeIndex + 1]; ++j)
+			{
+				const size_t l = nodeLists[j];
+				for (size_t i = listStarts[l]; i < listStarts[l + 1]; ++i)
+				{
+					const DsLabelIndex neighbourIndex = listNodeIndexes[i];
+					if ((neighbourIndex < nodeIndexSize) && (!visited[neighbourIndex]))
+					{
+						visited[neighbourIndex] = 1;
+						order.push_back(neighbourIndex);
+					}
+				}
+			}
+			std::stable_sort(order.begin() + neighboursStart, order.end(), lowerDegree);
+		}
+	}
+	std::reverse(order.begin(), order.end());
+	// nodes not used by elements go last in their current order
+	for (DsLabelIndex n = 0; n < nodeIndexSize; ++n)
+		if ((!visited[n]) && this->labels.hasIndex(n))
+			order.push_back(n);
+	const DsLabelIndex orderSize = static_cast<DsLabelIndex>(order.size());
+	for (DsLabelIndex newIndex = 0; newIndex < orderSize; ++newIndex)
+		newIndexes[order[newIndex]] = newIndex;
+}
+
+namespace {
+
+/** Record all fields in node field info as changed */
+int FE_node_field_info_log_FE_field_changes_iterator(FE_node_field_info *node_field_info,
+	void *fe_field_change_log_void)
+{
+	FE_node_field_info_log_FE_field_changes(node_field_info,
+		static_cast<CHANGE_LOG(FE_field) *>(fe_field_change_log_void));
+	return 1;
+}
+
+}
+
+int FE_nodeset::reorderNodes(bool keepIdentifiers)
+{
+	if (!this->fe_region)
+	{
+		display_message(ERROR_MESSAGE, "FE_nodeset::reorderNodes.  Nodeset is detached from region");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	for (int d = 0; d < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++d)
+	{
+		FE_mesh *mesh = this->fe_region->meshes[d];
+		if ((mesh) && (mesh->getNodeset() == this) && mesh->isDefiningFaces())
+		{
+			display_message(ERROR_MESSAGE, "FE_nodeset::reorderNodes.  Cannot reorder while defining faces");
+			return CMZN_ERROR_IN_USE;
+		}
+	}
+	if (0 == this->labels.getSize())
+		return CMZN_OK;
+	std::vector<DsLabelIndex> newIndexes;
+	this->calculateReverseCuthillMcKeeOrder(newIndexes);
+	const DsLabelIndex oldIndexSize = this->labels.getIndexSize();
+	FE_region_begin_change(this->fe_region);
+	// also remaps node groups and change log
+	int return_code = this->labels.permuteIndexes(newIndexes.data(), keepIdentifiers);
+	if ((CMZN_OK == return_code) && !(this->fe_nodes.permute(oldIndexSize, newIndexes.data())
+		&& this->elementUsageCount.permute(oldIndexSize, newIndexes.data())))
+		return_code = CMZN_ERROR_MEMORY;
+	const DsLabelIndex indexSize = this->labels.getIndexSize();
+	for (DsLabelIndex nodeIndex = 0; nodeIndex < indexSize; ++nodeIndex)
+	{
+		FE_node *node = this->getNode(nodeIndex);
+		if (node)
+			set_FE_node_index(node, nodeIndex);
+	}
+	for (int d = 0; d < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++d)
+	{
+		FE_mesh *mesh = this->fe_region->meshes[d];
+		if ((mesh) && (mesh->getNodeset() == this) && (!mesh->permuteNodeIndexes(oldIndexSize, newIndexes.data())))
+			return_code = CMZN_ERROR_MEMORY;
+	}
+	if (CMZN_OK != return_code)
+		display_message(ERROR_MESSAGE, "FE_nodeset::reorderNodes.  Failed to move node data; nodeset is corrupt");
+	// node data has moved even if identifiers are kept, so always notify
+	if (this->changeLog)
+	{
+		this->changeLog->setAllChange(DS_LABEL_CHANGE_TYPE_RELATED |
+			(keepIdentifiers ? DS_LABEL_CHANGE_TYPE_NONE : DS_LABEL_CHANGE_TYPE_IDENTIFIER));
+		FOR_EACH_OBJECT_IN_LIST(FE_node_field_info)(FE_node_field_info_log_FE_field_changes_iterator,
+			static_cast<void *>(this->fe_region->fe_field_changes), this->node_field_info_list);
+		this->fe_region->update();
+	}
+	FE_region_end_change(this->fe_region);
+	return return_code;
+}
+
 int FE_nodeset::merge_FE_node_template(struct FE_node *destination, FE_node_template *fe_node_template)
 {
 	if (fe_node_template
@@ -825,6 +1093,32 @@ void FE_nodeset::list_btree_statistics()
 	}
 }
 
+void FE_nodeset::getAllocatedBytes(size_t& labelsBytes, size_t& nodesBytes,
+	size_t& valuesBytes, std::map<FE_field *, size_t>& fieldValuesBytes) const
+{
+	labelsBytes = this->labels.getAllocatedBytes();
+	nodesBytes = this->fe_nodes.getAllocatedBytes() + this->elementUsageCount.getAllocatedBytes();
+	valuesBytes = 0;
+	// count nodes using each node field info so field values are summed once per info
+	std::map<FE_node_field_info *, size_t> nodeFieldInfoNodesCount;
+	const DsLabelIndex indexSize = this->labels.getIndexSize();
+	for (DsLabelIndex nodeIndex = 0; nodeIndex < indexSize; ++nodeIndex)
+	{
+		cmzn_node *node = this->getNode(nodeIndex);
+		if (node)
+		{
+			size_t nodeBytes, nodeValuesBytes;
+			FE_node_get_allocated_bytes(node, nodeBytes, nodeValuesBytes);
+			nodesBytes += nodeBytes;
+			valuesBytes += nodeValuesBytes;
+			++nodeFieldInfoNodesCount[FE_node_get_FE_node_field_info(node)];
+		}
+	}
+	for (std::map<FE_node_field_info *, size_t>::iterator iter = nodeFieldInfoNodesCount.begin();
+		iter != nodeFieldInfoNodesCount.end(); ++iter)
+		FE_node_field_info_add_field_values_allocated_bytes(iter->first, iter->second, fieldValuesBytes);
+}
+
 /**
  * Data for passing to FE_nodeset::merge_FE_node_external.
  */
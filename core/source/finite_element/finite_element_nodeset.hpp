@@ -18,6 +18,8 @@
 #include "finite_element/finite_element.h"
 #include "general/block_array.hpp"
 #include "general/list.h"
+#include <atomic>
+#include <mutex>
 
 /**
 * Template for creating a new node in the given FE_nodeset
@@ -72,14 +74,20 @@ class FE_nodeset
 
 	struct LIST(FE_node_field_info) *node_field_info_list;
 	struct FE_node_field_info *last_fe_node_field_info;
+	// incremented whenever any node field info is destroyed or has its node
+	// fields modified in place, to invalidate element gather plans using them
+	std::atomic<unsigned int> nodeFieldInfoGeneration;
 
 	// log of nodes added, removed or otherwise changed
 	DsLabelsChangeLog *changeLog;
 
 	// list of node iterators to invalidate when nodeset destroyed
 	cmzn_nodeiterator *activeNodeIterators;
+	// guards activeNodeIterators as iterators are created and destroyed by
+	// concurrent evaluation threads
+	std::mutex activeNodeIteratorsMutex;
 
-	int access_count;
+	std::atomic<int> access_count;
 
 	FE_nodeset(FE_region *fe_region);
 
@@ -89,6 +97,13 @@ class FE_nodeset
 
 	int remove_FE_node_private(struct FE_node *node);
 
+	/** Calculate reverse Cuthill-McKee ordering of nodes from their adjacency
+	  * through elements of meshes using this nodeset, for locality of element
+	  * node data. Nodes not used by elements are ordered last.
+	  * @param newIndexes  On return, new index for each node index, or
+	  * DS_LABEL_INDEX_INVALID for unused indexes. */
+	void calculateReverseCuthillMcKeeOrder(std::vector<DsLabelIndex>& newIndexes);
+
 	struct Merge_FE_node_external_data;
 	int merge_FE_node_external(struct FE_node *node,
 		Merge_FE_node_external_data &data);
@@ -114,8 +129,7 @@ public:
 	{
 		if (nodeset)
 		{
-			--(nodeset->access_count);
-			if (nodeset->access_count <= 0)
+			if (--(nodeset->access_count) <= 0)
 				delete nodeset;
 			nodeset = 0;
 		}
@@ -192,6 +206,18 @@ public:
 
 	int remove_FE_node_field_info(struct FE_node_field_info *fe_node_field_info);
 
+	unsigned int getNodeFieldInfoGeneration() const
+	{
+		return this->nodeFieldInfoGeneration;
+	}
+
+	/** Call when a node field info of this nodeset is destroyed or has its
+	  * node fields modified in place. */
+	void nodeFieldInfoChange()
+	{
+		++(this->nodeFieldInfoGeneration);
+	}
+
 	bool is_FE_field_in_use(struct FE_field *fe_field);
 
 	int getElementUsageCount(DsLabelIndex nodeIndex);
@@ -225,6 +251,18 @@ public:
 
 	void list_btree_statistics();
 
+	/**
+	 * Get bytes allocated for storage in this nodeset. Excludes allocator
+	 * overheads, and arrays and strings pointed to from values storage.
+	 * @param labelsBytes  Set to bytes for node identifier labels.
+	 * @param nodesBytes  Set to bytes for node objects and maps from node.
+	 * @param valuesBytes  Set to bytes for values storage at all nodes.
+	 * @param fieldValuesBytes  Bytes for values storage of each field at all
+	 * nodes, including values at times, are added to this map.
+	 */
+	void getAllocatedBytes(size_t& labelsBytes, size_t& nodesBytes, size_t& valuesBytes,
+		std::map<FE_field *, size_t>& fieldValuesBytes) const;
+
 	bool containsNode(FE_node *node) const
 	{
 		return (FE_node_get_FE_nodeset(node) == this) && (get_FE_node_index(node) >= 0);
@@ -259,8 +297,41 @@ public:
 
 	FE_node *create_FE_node(DsLabelIdentifier identifier, FE_node_template *node_template);
 
+	/**
+	 * Create many nodes from the node template in one call, optionally setting
+	 * all parameters of real-valued fields from a flat array. All arguments are
+	 * checked before creating any nodes. New nodes share the template's node
+	 * field info and take consecutive indexes, logged as a single change.
+	 * @param identifiers  Array of nodesCount unique, unused non-negative
+	 * identifiers, or 0 to automatically generate.
+	 * @param fields  Array of fieldsCount real-valued, non-time-varying fields
+	 * defined by node_template.
+	 * @param values  Parameters of each field in turn for each node in turn,
+	 * with valuesCount = nodesCount*sum of parameters of fields per node.
+	 * @param firstNodeIndex  On return, index of first node created.
+	 * @param createdCount  On return, number of nodes created.
+	 * @return  Result OK on success, ERROR_ARGUMENT if an argument is invalid
+	 * in which case no nodes are created, otherwise any other error code.
+	 */
+	int create_FE_nodes(int nodesCount, const int *identifiers,
+		FE_node_template *node_template, int fieldsCount, FE_field **fields,
+		int valuesCount, const FE_value *values, DsLabelIndex& firstNodeIndex, int& createdCount);
+
 	int merge_FE_node_template(struct FE_node *destination, FE_node_template *fe_node_template);
 
+	/**
+	 * Reorder node indexes by reverse Cuthill-McKee ordering so nodes sharing
+	 * elements are close in memory, compacting out unused indexes. Moves all
+	 * per-node data, node groups and element local nodes to the new indexes.
+	 * Iterators over nodes are invalidated. Notifies all nodes and fields
+	 * defined on them as changed.
+	 * @param keepIdentifiers  If true, nodes keep their identifiers, otherwise
+	 * they are renumbered from 1 in the new order.
+	 * @return  Result OK on success, ERROR_IN_USE if faces are being defined,
+	 * otherwise any other error code.
+	 */
+	int reorderNodes(bool keepIdentifiers);
+
 	int undefineFieldAtNode(struct FE_node *node, struct FE_field *fe_field);
 
 	int destroyNode(struct FE_node *node);
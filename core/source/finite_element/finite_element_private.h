@@ -23,12 +23,16 @@ modules such as finite_element_region.c.
 #include "general/indexed_list_stl_private.hpp"
 #include "general/list.h"
 #include "general/object.h"
+#include <map>
+#include <vector>
 
 /*
 Global types
 ------------
 */
 
+class DsLabelIterator;
+
 struct FE_node_field_info;
 /*******************************************************************************
 LAST MODIFIED : 4 October 2002
@@ -40,29 +44,6 @@ cmzn_node structures.
 
 DECLARE_LIST_TYPES(FE_node_field_info);
 
-struct FE_element_type_node_sequence_identifier;
-/*******************************************************************************
-LAST MODIFIED : 13 February 2003
-
-DESCRIPTION :
-See struct FE_element_type_node_sequence.
-==============================================================================*/
-
-struct FE_element_type_node_sequence;
-/*******************************************************************************
-LAST MODIFIED : 13 February 2003
-
-DESCRIPTION :
-Structure for storing an element with its identifier being its cm_type and the
-number and list - in ascending order - of the nodes referred to by the default
-coordinate field of the element. Indexed lists, indexed using function
-compare_FE_element_type_node_sequence_identifier ensure that recalling a line or
-face with the same nodes is extremely rapid. FE_mesh
-uses them to find faces and lines for elements without them, if they exist.
-==============================================================================*/
-
-DECLARE_LIST_TYPES(FE_element_type_node_sequence);
-
 /*
 Private functions
 -----------------
@@ -418,6 +399,45 @@ cmzn_node *create_template_FE_node(FE_node_field_info *node_field_info);
  */
 cmzn_node *create_FE_node_from_template(DsLabelIndex index, cmzn_node *template_node);
 
+/**
+ * Append offsets into the values storage of node of all parameters of a
+ * real-valued, non-time-varying field, for each component in turn in the
+ * order of cmzn_node_set_field_component_FE_value_values. Offsets apply to
+ * all nodes sharing the node's field info.
+ * @param offsets  Vector to append offsets to.
+ * @return  Result OK on success, ERROR_NOT_FOUND if field not defined at
+ * node, ERROR_ARGUMENT if field is not real-valued or is time-varying.
+ */
+int FE_node_get_FE_value_parameter_offsets(cmzn_node *node, FE_field *field,
+	std::vector<int>& offsets);
+
+/**
+ * Set real parameters in the values storage of node at offsets obtained from
+ * FE_node_get_FE_value_parameter_offsets. No checks or change notification;
+ * for bulk initialisation of new nodes only.
+ */
+void FE_node_set_FE_value_parameters_at_offsets(cmzn_node *node, int valuesCount,
+	const int *offsets, const FE_value *valuesIn);
+
+/**
+ * Get bytes allocated for node object and its values storage.
+ * @param nodeBytes  Set to bytes for the node object.
+ * @param valuesBytes  Set to bytes for the values storage, excluding arrays
+ * and strings pointed to from it.
+ */
+void FE_node_get_allocated_bytes(cmzn_node *node, size_t& nodeBytes, size_t& valuesBytes);
+
+/**
+ * Add bytes allocated for values storage of each field at nodes with the
+ * node field info to the map, including values at times for time-varying
+ * fields. Excludes contents of array and string values.
+ * @param nodesCount  Number of nodes using the node field info.
+ * @param fieldValuesBytes  Map from field to bytes to add to.
+ */
+void FE_node_field_info_add_field_values_allocated_bytes(
+	struct FE_node_field_info *node_field_info, size_t nodesCount,
+	std::map<FE_field *, size_t>& fieldValuesBytes);
+
 /**
  * Clear content of node and disconnect it from owning nodeset.
  * Use when removing node from nodeset or deleting nodeset to safely orphan any
@@ -455,6 +475,42 @@ Private function only to be called by FE_region when merging FE_regions!
 const FE_node_field *cmzn_node_get_FE_node_field(cmzn_node *node,
 	struct FE_field *field);
 
+/**
+ * Bulk get version 1 VALUE parameters of all components of a general real
+ * field at every node from labelIterator, in iteration order. The location
+ * of parameters in node values storage is only recomputed when the node field
+ * definition changes so this is much faster than getting values per node.
+ * @param labelIterator  Iterator over nodes in fe_nodeset; must be at start.
+ * @param field  General FE_VALUE field to get values for.
+ * @param time  Time to interpolate time-varying parameters at.
+ * @param valuesCount  Size of valuesOut; must be at least the number of
+ * nodes iterated over times the number of field components.
+ * @param valuesOut  Array to receive values for each node in turn. Values for
+ * nodes where field is not defined with VALUE for all components are not set.
+ * @param nodesCountOut  On success, set to the number of nodes iterated over.
+ * @param definedCountOut  On success, set to the number of nodes values were
+ * obtained for.
+ * @return  Result OK on success, otherwise an error code.
+ */
+int FE_nodeset_get_FE_field_FE_value_values(FE_nodeset *fe_nodeset,
+	DsLabelIterator *labelIterator, struct FE_field *field, FE_value time,
+	int valuesCount, FE_value *valuesOut, int *nodesCountOut, int *definedCountOut);
+
+/**
+ * Bulk set all versions of VALUE parameters of all components of a general
+ * real field at every node from labelIterator, in iteration order, with
+ * change notification. Counterpart of FE_nodeset_get_FE_field_FE_value_values.
+ * @param valuesIn  Values for each node in turn. Nodes where the field is not
+ * defined with VALUE for all components, or has no parameters at time, are
+ * skipped.
+ * @param definedCountOut  On return, set to the number of nodes values were
+ * set for.
+ * @return  Result OK on success, otherwise an error code.
+ */
+int FE_nodeset_set_FE_field_FE_value_values(FE_nodeset *fe_nodeset,
+	DsLabelIterator *labelIterator, struct FE_field *field, FE_value time,
+	int valuesCount, const FE_value *valuesIn, int *nodesCountOut, int *definedCountOut);
+
 /**
  * Merges the fields from <source> into <destination>. Existing fields in the
  * <destination> keep the same node field description as before with new field
@@ -469,76 +525,20 @@ const FE_node_field *cmzn_node_get_FE_node_field(cmzn_node *node,
 int merge_FE_node(cmzn_node *destination, cmzn_node *source, int optimised_merge = 0);
 
 /**
- * Create structure storing an element with its identifier being its cm_type
- * and the number and list - in ascending order - of the nodes referred to by
- * the default coordinate field of the element. Indexed lists, indexed using
- * function compare_FE_element_type_node_sequence_identifier ensure that
- * recalling a line or face with the same nodes is extremely rapid.
- * FE_mesh uses them to find faces and lines for elements without them,
- * if they exist.
+ * Get identifiers of the nodes referred to by the default coordinate field of
+ * the element or its face, in ascending order with no repeats. Elements and
+ * faces with the same sorted node identifiers are taken to be the same,
+ * which FE_mesh uses to find faces and lines for elements without them.
+ * Can only match faces correctly for coordinate fields with standard node to
+ * element maps and no versions; a grid-based coordinate field has no nodes.
+ * Safe to call from concurrent threads while elements are not being modified.
  * @param face_number  If non-negative, calculate nodes for face number of
- * element, as if the face element were supplied to this function. If so, the
- * returned structure accesses the supplied element. It is assumed this is
- * only used when creating new faces, and the face should be set as soon as
- * created.
- * @param result  Result OK on success, otherwise ERROR_NOT_FOUND if
- * nodes not obtainable, otherwise any other error.
- * @return  On success, newly created sequence.
- */
-struct FE_element_type_node_sequence *CREATE(FE_element_type_node_sequence)(
-	int &result, struct FE_element *element, int face_number = -1);
-
-int DESTROY(FE_element_type_node_sequence)(
-	struct FE_element_type_node_sequence **element_type_node_sequence_address);
-/*******************************************************************************
-LAST MODIFIED : 13 February 2003
-
-DESCRIPTION :
-Cleans up memory used by the FE_element_type_node_sequence.
-==============================================================================*/
-
-int FE_element_type_node_sequence_is_collapsed(
-	struct FE_element_type_node_sequence *element_type_node_sequence);
-/*******************************************************************************
-LAST MODIFIED : 13 February 2003
-
-DESCRIPTION :
-Returns true if the <element_type_node_sequence> represents an element that
-has collapsed, ie, is a face with <= 2 unique nodes, or a line with 1 unique
-node.
-???RC Note that repeated nodes in the face/line are not put in the node_numbers
-array twice, facilitating the simple logic in this function. If they were, then
-this function would have to be modified extensively.
-==============================================================================*/
-
-/**
- * Gets the FE_element from the <element_type_node_sequence>.
- */
-struct FE_element *FE_element_type_node_sequence_get_FE_element(
-	struct FE_element_type_node_sequence *element_type_node_sequence);
-
-/**
- * Sets the FE_element in the <element_type_node_sequence>. Use only to
- * substitute face element when sequence was created from face number of
- * parent element.
- */
-void FE_element_type_node_sequence_set_FE_element(
-	struct FE_element_type_node_sequence *element_type_node_sequence,
-	struct FE_element *element);
-
-/**
- * Returns existing FE_element_type_node_sequence from list with matching
- * identifier to supplied one.
+ * element, as if the face element were supplied to this function.
+ * @param nodeIdentifiers  On return, the sorted node identifiers.
+ * @return  Result OK on success, ERROR_NOT_FOUND if nodes not obtainable,
+ * otherwise any other error.
  */
-FE_element_type_node_sequence *FE_element_type_node_sequence_list_find_match(
-	struct LIST(FE_element_type_node_sequence) *element_type_node_sequence_list,
-	FE_element_type_node_sequence *element_type_node_sequence);
-
-PROTOTYPE_OBJECT_FUNCTIONS(FE_element_type_node_sequence);
-
-PROTOTYPE_LIST_FUNCTIONS(FE_element_type_node_sequence);
-
-PROTOTYPE_FIND_BY_IDENTIFIER_IN_LIST_FUNCTION(FE_element_type_node_sequence, \
-	identifier, FE_element_type_node_sequence_identifier&);
+int calculate_FE_element_sorted_node_identifiers(struct FE_element *element,
+	int face_number, std::vector<int>& nodeIdentifiers);
 
 #endif /* !defined (FINITE_ELEMENT_PRIVATE_H) */
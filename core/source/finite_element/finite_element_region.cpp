@@ -18,6 +18,7 @@ finite element fields defined on or interpolated over them.
 #include <vector>
 #include "opencmiss/zinc/element.h"
 #include "opencmiss/zinc/node.h"
+#include "finite_element/element_field_values_cache.hpp"
 #include "finite_element/finite_element.h"
 #include "finite_element/finite_element_mesh.hpp"
 #include "finite_element/finite_element_nodeset.hpp"
@@ -213,6 +214,7 @@ FE_region::FE_region(FE_region *base_fe_region) :
 	fe_field_list(CREATE(LIST(FE_field))()),
 	fe_field_info(0),
 	bases_and_shapes(base_fe_region ? base_fe_region->bases_and_shapes->access() : FE_region_bases_and_shapes::create()),
+	element_field_values_cache(new FE_element_field_values_cache()),
 	change_level(0),
 	fe_field_changes(0),
 	informed_make_cmiss_number_field(false),
@@ -245,6 +247,10 @@ FE_region::~FE_region()
 
 	this->change_level = 1; // so no notifications
 
+	// cached element field values access elements and fields
+	delete this->element_field_values_cache;
+	this->element_field_values_cache = 0;
+
 	// detach first to clean up some dynamic data and remove pointers back to FE_region
 	for (int n = 0; n < 2; ++n)
 		this->nodesets[n]->detach_from_FE_region();
@@ -396,6 +402,14 @@ bool FE_field_has_cached_changes(FE_field *fe_field)
 	return false;
 }
 
+FE_element_field_values_cache *FE_region_get_element_field_values_cache(
+	struct FE_region *fe_region)
+{
+	if (fe_region)
+		return fe_region->element_field_values_cache;
+	return 0;
+}
+
 int FE_region_clear(struct FE_region *fe_region)
 // This could be made faster.
 {
@@ -501,6 +515,10 @@ struct FE_field *FE_region_merge_FE_field(struct FE_region *fe_region,
 				/* no change needs to be noted if fields are exactly the same */
 				if (!FE_fields_match_exact(merged_fe_field, fe_field))
 				{
+					// release element field values and gather plans cached for old definition
+					fe_region->element_field_values_cache->removeField(merged_fe_field);
+					for (int dim = 0; dim < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++dim)
+						fe_region->meshes[dim]->clearFieldGatherPlans(merged_fe_field);
 					/* can only change fundamentals -- number of components, value type
 						 if merged_fe_field is not accessed by any other objects */
 					if ((1 == FE_field_get_access_count(merged_fe_field)) ||
@@ -631,6 +649,8 @@ Fields can only be removed if not defined on any nodes and element in
 			{
 				/* access field in case it is only accessed here */
 				ACCESS(FE_field)(fe_field);
+				for (int dim = 0; dim < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++dim)
+					fe_region->meshes[dim]->clearFieldGatherPlans(fe_field);
 				return_code = REMOVE_OBJECT_FROM_LIST(FE_field)(fe_field,
 					fe_region->fe_field_list);
 				if (return_code)
@@ -33,6 +33,8 @@ struct FE_region;
 
 class DsLabelsChangeLog;
 
+class FE_element_field_values_cache;
+
 /**
  * Structure describing FE_region field, node and element changes, for passing
  * back to owner region.
@@ -208,6 +210,14 @@ int FE_region_end_change_no_notify(struct FE_region *fe_region);
  */
 bool FE_field_has_cached_changes(FE_field *fe_field);
 
+/**
+ * Get the cache of element field values shared by all field caches evaluating
+ * finite element fields of the region.
+ * @return  Non-accessed cache owned by fe_region, or 0 if invalid argument.
+ */
+FE_element_field_values_cache *FE_region_get_element_field_values_cache(
+	struct FE_region *fe_region);
+
 /**
  * Removes all the fields, nodes and elements from <fe_region>.
  * Note this function uses FE_region_begin/end_change so it sends a single change
@@ -81,6 +81,10 @@ struct FE_region
 	/* FE bases and shapes shared by all regions */
 	FE_region_bases_and_shapes *bases_and_shapes;
 
+	/* element field values shared by field caches of region, for fast
+	 * evaluation of finite element fields */
+	FE_element_field_values_cache *element_field_values_cache;
+
 	/* lists of nodes and elements in this region */
 	FE_nodeset *nodesets[2];
 	FE_mesh *meshes[MAXIMUM_ELEMENT_XI_DIMENSIONS];
@@ -12,6 +12,7 @@ Representing time in finite elements.
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include <math.h>
+#include <atomic>
 
 #include "opencmiss/zinc/timesequence.h"
 #include "opencmiss/zinc/status.h"
@@ -52,6 +53,9 @@ DESCRIPTION :
 	/* For FE_TIME_SEQUENCE */
 	int number_of_times;
 	FE_value *times;
+	/* unique to this sequence and its current times, identifying cached
+		interpolations for time. Never 0 */
+	unsigned int serial;
 
 	/* A pointer to itself so that we can make the INDEX functions work with
 		multiple parts of the object as the identifier */
@@ -74,6 +78,30 @@ Module functions
 */
 DECLARE_OBJECT_FUNCTIONS(FE_time_sequence_package)
 
+namespace {
+
+std::atomic<unsigned int> FE_time_sequence_next_serial(1);
+
+/** @return  New non-zero serial for a time sequence or its changed times */
+unsigned int FE_time_sequence_get_new_serial()
+{
+	unsigned int serial;
+	while (0 == (serial = FE_time_sequence_next_serial++))
+		;
+	return serial;
+}
+
+}
+
+thread_local FE_time_sequence_interpolation_cache *FE_time_sequence_interpolation_cache::current = 0;
+
+FE_time_sequence_interpolation_cache::FE_time_sequence_interpolation_cache() :
+	next(0)
+{
+	for (int i = 0; i < size; ++i)
+		this->interpolations[i].serial = 0;
+}
+
 DECLARE_INDEXED_LIST_MODULE_FUNCTIONS(FE_time_sequence,self,struct FE_time_sequence *,
 	compare_FE_time_sequence)
 
@@ -258,6 +286,7 @@ Creates a basic FE_time_sequence.
 		fe_time_sequence->type = FE_TIME_SEQUENCE;
 		fe_time_sequence->number_of_times = 0;
 		fe_time_sequence->times = (FE_value *)NULL;
+		fe_time_sequence->serial = FE_time_sequence_get_new_serial();
 
 		fe_time_sequence->self = fe_time_sequence;
 
@@ -465,14 +494,14 @@ and 1 if it is.
 	return (return_code);
 } /* FE_time_sequence_get_index_for_time */
 
-int FE_time_sequence_get_interpolation_for_time(
+static int FE_time_sequence_calculate_interpolation_for_time(
 	struct FE_time_sequence *fe_time_sequence, FE_value time, int *time_index_one,
 	int *time_index_two, FE_value *xi)
 /*******************************************************************************
 LAST MODIFIED : 20 November 2001
 
 DESCRIPTION :
-Returns the two integers <time_index_one> and <time_index_two> which index into
+Searches for and returns the two integers <time_index_one> and <time_index_two> which index into
 the time array bracketing the supplied <time>, the <xi> value is set between 0
 and 1 to indicate what fraction of the way between <time_index_one> and
 <time_index_two> the value is found.  Returns 0 if time is outside the range
@@ -483,7 +512,7 @@ be either the minimum or maximum value as appropriate.
 	int array_index,done,index_high,index_low,number_of_times,return_code,step;
 	FE_value first_time,last_time,this_time,fe_value_index,time_high,time_low;
 
-	ENTER(FE_time_sequence_get_index_for_time);
+	ENTER(FE_time_sequence_calculate_interpolation_for_time);
 
 	if (fe_time_sequence)
 	{
@@ -662,14 +691,52 @@ be either the minimum or maximum value as appropriate.
 	else
 	{
 		display_message(ERROR_MESSAGE,
-			"FE_time_sequence_get_interpolation_for_time.  "
+			"FE_time_sequence_calculate_interpolation_for_time.  "
 			"Invalid arguments time out of range");
 		return_code=0;
 	}
 	LEAVE;
 
 	return (return_code);
-} /* FE_time_sequence_get_interpolation_for_time */
+} /* FE_time_sequence_calculate_interpolation_for_time */
+
+int FE_time_sequence_get_interpolation_for_time(
+	struct FE_time_sequence *fe_time_sequence, FE_value time, int *time_index_one,
+	int *time_index_two, FE_value *xi)
+{
+	if (!fe_time_sequence)
+	{
+		display_message(ERROR_MESSAGE,
+			"FE_time_sequence_get_interpolation_for_time.  Invalid arguments");
+		return 0;
+	}
+	FE_time_sequence_interpolation_cache *cache = FE_time_sequence_interpolation_cache::current;
+	if (!cache)
+		return FE_time_sequence_calculate_interpolation_for_time(
+			fe_time_sequence, time, time_index_one, time_index_two, xi);
+	for (int i = 0; i < FE_time_sequence_interpolation_cache::size; ++i)
+	{
+		const FE_time_sequence_interpolation_cache::Interpolation& interpolation = cache->interpolations[i];
+		if ((interpolation.serial == fe_time_sequence->serial) && (interpolation.time == time))
+		{
+			*time_index_one = interpolation.time_index_one;
+			*time_index_two = interpolation.time_index_two;
+			*xi = interpolation.xi;
+			return interpolation.return_code;
+		}
+	}
+	const int return_code = FE_time_sequence_calculate_interpolation_for_time(
+		fe_time_sequence, time, time_index_one, time_index_two, xi);
+	FE_time_sequence_interpolation_cache::Interpolation& interpolation = cache->interpolations[cache->next];
+	interpolation.serial = fe_time_sequence->serial;
+	interpolation.time = time;
+	interpolation.time_index_one = *time_index_one;
+	interpolation.time_index_two = *time_index_two;
+	interpolation.xi = *xi;
+	interpolation.return_code = return_code;
+	cache->next = (cache->next + 1) % FE_time_sequence_interpolation_cache::size;
+	return return_code;
+}
 
 int FE_time_sequence_get_nearest_time_index_for_time(
 	struct FE_time_sequence *fe_time_sequence, FE_value time)
@@ -745,6 +812,8 @@ be expanded and the unspecified times also set to <time>.
 		if (time_index >= 0)
 		{
 			return_code = CMZN_OK;
+			// invalidate cached interpolations
+			fe_time_sequence->serial = FE_time_sequence_get_new_serial();
 			if (time_index >= fe_time_sequence->number_of_times)
 			{
 				if (REALLOCATE(new_times, fe_time_sequence->times,
@@ -212,8 +212,69 @@ the time array bracketing the supplied <time>, the <xi> value is set between 0
 and 1 to indicate what fraction of the way between <time_index_one> and 
 <time_index_two> the value is found.  Returns 0 if time is outside the range
 of the time index array.
+The last few results are cached in any current
+FE_time_sequence_interpolation_cache, so evaluating many nodes or elements at
+the same time with one field cache only searches once.
 ==============================================================================*/
 
+/**
+ * Recent results of FE_time_sequence_get_interpolation_for_time for any time
+ * sequences, replaced in turn. Owned by each field cache and made current for
+ * the evaluating thread while it evaluates finite element fields, since the
+ * lookups happen deep in node and element parameter code. Results are keyed
+ * by a serial renewed whenever the times of a sequence change, so are never
+ * stale. Like its field cache, must only be used by one thread at a time.
+ */
+class FE_time_sequence_interpolation_cache
+{
+	friend int FE_time_sequence_get_interpolation_for_time(
+		struct FE_time_sequence *fe_time_sequence, FE_value time, int *time_index_one,
+		int *time_index_two, FE_value *xi);
+
+	static const int size = 4;
+
+	struct Interpolation
+	{
+		unsigned int serial; // serial of time sequence, or 0 if unused
+		FE_value time;
+		int time_index_one, time_index_two;
+		FE_value xi;
+		int return_code;
+	};
+
+	Interpolation interpolations[size];
+	int next;
+
+	static thread_local FE_time_sequence_interpolation_cache *current;
+
+	FE_time_sequence_interpolation_cache(const FE_time_sequence_interpolation_cache&); // not implemented
+	FE_time_sequence_interpolation_cache& operator=(const FE_time_sequence_interpolation_cache&); // not implemented
+
+public:
+
+	FE_time_sequence_interpolation_cache();
+
+	/** Makes cache current for interpolation lookups in this thread for the
+	  * lifetime of the scope object, then restores the previous cache. */
+	class Scope
+	{
+		FE_time_sequence_interpolation_cache *previous;
+
+	public:
+		Scope(FE_time_sequence_interpolation_cache& cache) :
+			previous(FE_time_sequence_interpolation_cache::current)
+		{
+			FE_time_sequence_interpolation_cache::current = &cache;
+		}
+
+		~Scope()
+		{
+			FE_time_sequence_interpolation_cache::current = this->previous;
+		}
+	};
+
+};
+
 /** @return  Nearest time index to time for time sequence */
 int FE_time_sequence_get_nearest_time_index_for_time(
 	struct FE_time_sequence *fe_time_sequence, FE_value time);
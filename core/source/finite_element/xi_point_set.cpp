@@ -0,0 +1,95 @@
+/**
+ * FILE : xi_point_set.cpp
+ *
+ * Fixed set of element chart (xi) points, e.g. quadrature points, with tables
+ * of standard basis function values at them.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "finite_element/xi_point_set.hpp"
+#include "general/message.h"
+
+FE_xi_point_set::FE_xi_point_set(int dimensionIn, int numberOfPointsIn, const FE_value *xiIn) :
+	dimension(dimensionIn),
+	numberOfPoints(numberOfPointsIn),
+	xi(xiIn, xiIn + numberOfPointsIn*dimensionIn)
+{
+	for (int i = 0; i < publishedTablesSize; ++i)
+		this->publishedTables[i].store(0, std::memory_order_relaxed);
+}
+
+const FE_xi_point_set::BasisTable *FE_xi_point_set::findOrCreateBasisTable(
+	Standard_basis_function *basisFunction, const int *basisArguments, int numberOfValues)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	for (std::list<BasisTable>::const_iterator iter = this->basisTables.begin();
+		iter != this->basisTables.end(); ++iter)
+	{
+		if (iter->matches(basisFunction, basisArguments))
+			return &(*iter);
+	}
+	BasisTable table;
+	table.basisFunction = basisFunction;
+	// arguments start with dimension, followed by that many values
+	table.basisArguments.assign(basisArguments, basisArguments + basisArguments[0] + 1);
+	table.numberOfValues = numberOfValues;
+	table.values.resize(this->numberOfPoints*numberOfValues);
+	Standard_basis_function *kernel = standard_basis_function_get_kernel(basisFunction, basisArguments);
+	for (int p = 0; p < this->numberOfPoints; ++p)
+	{
+		if (!(kernel)(const_cast<int *>(basisArguments), this->getPointXi(p),
+			table.values.data() + p*numberOfValues))
+		{
+			display_message(ERROR_MESSAGE, "FE_xi_point_set::getBasisValues.  "
+				"Error calculating standard basis");
+			return 0;
+		}
+	}
+	this->basisTables.push_back(table);
+	const BasisTable *newTable = &(this->basisTables.back());
+	// publish after table is complete; slots are only written under the mutex
+	const int tableIndex = static_cast<int>(this->basisTables.size()) - 1;
+	if (tableIndex < publishedTablesSize)
+		this->publishedTables[tableIndex].store(newTable, std::memory_order_release);
+	return newTable;
+}
+
+const FE_value *FE_xi_point_set::getBasisValues(Standard_basis_function *basisFunction,
+	const int *basisArguments, int numberOfValues, int pointIndex)
+{
+	if ((!basisFunction) || (!basisArguments) || (numberOfValues <= 0) ||
+		(pointIndex < 0) || (pointIndex >= this->numberOfPoints))
+	{
+		display_message(ERROR_MESSAGE, "FE_xi_point_set::getBasisValues.  Invalid argument(s)");
+		return 0;
+	}
+	const BasisTable *table = 0;
+	for (int i = 0; i < publishedTablesSize; ++i)
+	{
+		const BasisTable *publishedTable = this->publishedTables[i].load(std::memory_order_acquire);
+		if (!publishedTable)
+			break;
+		if (publishedTable->matches(basisFunction, basisArguments))
+		{
+			table = publishedTable;
+			break;
+		}
+	}
+	if (!table)
+	{
+		table = this->findOrCreateBasisTable(basisFunction, basisArguments, numberOfValues);
+		if (!table)
+			return 0;
+	}
+	if (table->numberOfValues != numberOfValues)
+	{
+		display_message(ERROR_MESSAGE, "FE_xi_point_set::getBasisValues.  "
+			"Inconsistent number of basis function values");
+		return 0;
+	}
+	return table->values.data() + pointIndex*numberOfValues;
+}
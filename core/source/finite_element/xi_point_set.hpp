@@ -0,0 +1,105 @@
+/**
+ * FILE : xi_point_set.hpp
+ *
+ * Fixed set of element chart (xi) points, e.g. quadrature points, with tables
+ * of standard basis function values at them.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (CMZN_XI_POINT_SET_HPP)
+#define CMZN_XI_POINT_SET_HPP
+
+#include "finite_element/finite_element_basis.h"
+#include "general/value.h"
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+/**
+ * Set of xi points evaluated on many elements of the same shape. Values of
+ * each standard basis function used to interpolate fields are calculated at
+ * all points on first use and kept in a table, so interpolation at the points
+ * needs only a dot product of the element values with a table row.
+ * Tables are keyed by basis function and the contents of its arguments, since
+ * argument arrays are not shared by all elements using the same basis.
+ * Tables are never moved or freed until the point set is destroyed. The first
+ * few are published in a fixed array read without locking, so the common
+ * lookup compares pointers and a few integers only; creating tables and
+ * finding any beyond these takes a mutex so the point set may be used from
+ * concurrent threads.
+ */
+class FE_xi_point_set
+{
+	struct BasisTable
+	{
+		Standard_basis_function *basisFunction;
+		std::vector<int> basisArguments; // starting with dimension
+		int numberOfValues; // number of basis function values per point
+		std::vector<FE_value> values;
+
+		/** @param basisArgumentsIn  Not checked; starts with dimension. */
+		bool matches(Standard_basis_function *basisFunctionIn, const int *basisArgumentsIn) const
+		{
+			// compare dimension first so no more arguments are read than supplied
+			return (this->basisFunction == basisFunctionIn) &&
+				(this->basisArguments[0] == basisArgumentsIn[0]) &&
+				std::equal(this->basisArguments.begin(), this->basisArguments.end(), basisArgumentsIn);
+		}
+	};
+
+	static const int publishedTablesSize = 8;
+
+	const int dimension;
+	const int numberOfPoints;
+	std::vector<FE_value> xi;
+	std::list<BasisTable> basisTables; // list so addresses are stable
+	std::atomic<const BasisTable *> publishedTables[publishedTablesSize];
+	mutable std::mutex mutex;
+
+	FE_xi_point_set(const FE_xi_point_set& source);
+	FE_xi_point_set& operator=(const FE_xi_point_set& source);
+
+	const BasisTable *findOrCreateBasisTable(Standard_basis_function *basisFunction,
+		const int *basisArguments, int numberOfValues);
+
+public:
+
+	/** @param xiIn  Array of numberOfPointsIn*dimensionIn xi coordinates,
+	 * varying fastest with dimension. Copied. */
+	FE_xi_point_set(int dimensionIn, int numberOfPointsIn, const FE_value *xiIn);
+
+	int getDimension() const
+	{
+		return this->dimension;
+	}
+
+	int getNumberOfPoints() const
+	{
+		return this->numberOfPoints;
+	}
+
+	const FE_value *getPointXi(int pointIndex) const
+	{
+		return this->xi.data() + pointIndex*this->dimension;
+	}
+
+	/**
+	 * Get values of standard basis function at point, calculating them at all
+	 * points if not already tabulated.
+	 * @param basisFunction  Standard basis function.
+	 * @param basisArguments  Basis function arguments starting with dimension.
+	 * @param numberOfValues  Number of values the basis function calculates.
+	 * @param pointIndex  Index of point from 0 to number of points - 1.
+	 * @return  Pointer to numberOfValues basis function values, or 0 if failed.
+	 */
+	const FE_value *getBasisValues(Standard_basis_function *basisFunction,
+		const int *basisArguments, int numberOfValues, int pointIndex);
+
+};
+
+#endif /* !defined (CMZN_XI_POINT_SET_HPP) */
@@ -13,9 +13,10 @@
 #define BLOCK_ARRAY_HPP
 
 #include "general/debug.h"
+#include <atomic>
 #include <cstring>
 
-// DsMapArray assumes following is > 128:
+// DsMapArray packs arrays smaller than this into shared blocks:
 #define CMZN_BLOCK_ARRAY_DEFAULT_BLOCK_SIZE_BYTES 1024
 
 // IndexType = array index type
@@ -25,10 +26,94 @@ template <typename IndexType, typename EntryType> class block_array
 protected:
 	// Note: any new attributes must be handled by swap() and all constructors
 	EntryType **blocks;
+	// Copies share blocks until written to. If non-NULL, array of blockCount
+	// pointers to count of block_arrays sharing each block, NULL if not shared.
+	// Counts are atomic so copies sharing blocks may be used and destroyed in
+	// different threads; each block_array object itself is not thread safe.
+	// Mutable as the copy constructor marks blocks of the source as shared.
+	mutable std::atomic<int> **blockShareCounts;
 	IndexType blockCount;
 	IndexType blockLength;
 	EntryType allocInitValue;
 
+	/** Grow array of block pointers to at least newBlockCount */
+	bool growBlocks(IndexType newBlockCount)
+	{
+		if (newBlockCount <= this->blockCount)
+			return true;
+		EntryType **newBlocks = new EntryType*[newBlockCount];
+		if (!newBlocks)
+			return false;
+		if (this->blockShareCounts)
+		{
+			std::atomic<int> **newBlockShareCounts = new std::atomic<int>*[newBlockCount];
+			if (!newBlockShareCounts)
+			{
+				delete[] newBlocks;
+				return false;
+			}
+			memcpy(newBlockShareCounts, this->blockShareCounts, this->blockCount*sizeof(std::atomic<int>*));
+			for (IndexType i = blockCount; i < newBlockCount; ++i)
+				newBlockShareCounts[i] = 0;
+			delete[] this->blockShareCounts;
+			this->blockShareCounts = newBlockShareCounts;
+		}
+		memcpy(newBlocks, this->blocks, this->blockCount*sizeof(EntryType*));
+		for (IndexType i = blockCount; i < newBlockCount; ++i)
+			newBlocks[i] = 0;
+		delete[] this->blocks;
+		this->blocks = newBlocks;
+		this->blockCount = newBlockCount;
+		return true;
+	}
+
+	/** @param  blockIndex  From 0 to block count - 1. Not checked.
+	  * @return  Number of block_arrays sharing block, 1 if not shared. */
+	int getBlockShareCount(IndexType blockIndex) const
+	{
+		if ((this->blockShareCounts) && (this->blockShareCounts[blockIndex]))
+			return *(this->blockShareCounts[blockIndex]);
+		return 1;
+	}
+
+	/** Stop sharing block, if shared. Only the last sharer keeps it; others
+	  * forget it and must copy or replace it.
+	  * @param  blockIndex  From 0 to block count - 1. Not checked.
+	  * @return  True if this was the last sharer or block was not shared. */
+	bool releaseBlockShare(IndexType blockIndex)
+	{
+		if ((this->blockShareCounts) && (this->blockShareCounts[blockIndex]))
+		{
+			std::atomic<int> *shareCount = this->blockShareCounts[blockIndex];
+			this->blockShareCounts[blockIndex] = 0;
+			// decrement and test in one operation as sharers may release concurrently
+			if (1 < (shareCount->fetch_sub(1)))
+				return false;
+			delete shareCount;
+		}
+		return true;
+	}
+
+	/** Get block for writing, copying it first if shared with other block_arrays.
+	  * @param  blockIndex  From 0 to block count - 1. Not checked.
+	  * @return  Block, or 0 if none or failed to copy. */
+	EntryType* getWritableBlock(IndexType blockIndex)
+	{
+		EntryType *block = this->blocks[blockIndex];
+		if ((block) && (1 < this->getBlockShareCount(blockIndex)))
+		{
+			EntryType *blockCopy = new EntryType[this->blockLength];
+			if (!blockCopy)
+				return 0;
+			memcpy(blockCopy, block, this->blockLength*sizeof(EntryType));
+			// other sharers may have released block meanwhile
+			if (this->releaseBlockShare(blockIndex))
+				delete[] block;
+			this->blocks[blockIndex] = block = blockCopy;
+		}
+		return block;
+	}
+
 	EntryType* getOrCreateBlock(IndexType blockIndex)
 	{
 		if (blockIndex >= this->blockCount)
@@ -36,18 +121,11 @@ protected:
 			IndexType newBlockCount = blockIndex + 1;
 			if (newBlockCount < this->blockCount*2)
 				newBlockCount = this->blockCount*2; // double number of blocks each time at a minimum
-			EntryType **newBlocks = new EntryType*[newBlockCount];
-			if (!newBlocks)
+			if (!this->growBlocks(newBlockCount))
 				return 0;
-			memcpy(newBlocks, this->blocks, this->blockCount*sizeof(EntryType*));
-			for (IndexType i = blockCount; i < newBlockCount; ++i)
-				newBlocks[i] = 0;
-			delete[] this->blocks;
-			this->blocks = newBlocks;
-			this->blockCount = newBlockCount;
 		}
-		EntryType *block = this->blocks[blockIndex];
-		if (!block)
+		EntryType *block = this->getWritableBlock(blockIndex);
+		if ((!block) && (!this->blocks[blockIndex]))
 		{
 			block = new EntryType[this->blockLength];
 			if (block)
@@ -75,6 +153,7 @@ public:
 	 */
 	block_array(IndexType blockLengthIn = CMZN_BLOCK_ARRAY_DEFAULT_BLOCK_SIZE_BYTES/sizeof(EntryType), EntryType allocInitValueIn = 0) :
 		blocks(0),
+		blockShareCounts(0),
 		blockCount(0),
 		blockLength(blockLengthIn),
 		allocInitValue(allocInitValueIn)
@@ -83,21 +162,35 @@ public:
 			this->blockLength = 1;
 	}
 
+	/** Copy shares all blocks with source, only copying a block when either
+	  * array next writes to it. Source must not be in use by other threads
+	  * while copying. */
 	block_array(const block_array& source) :
 		blocks(new EntryType*[source.blockCount]),
+		blockShareCounts(new std::atomic<int>*[source.blockCount]),
 		blockCount(source.blockCount),
 		blockLength(source.blockLength),
 		allocInitValue(source.allocInitValue)
 	{
-		for (int i = 0; i < this->blockCount; ++i)
+		if ((!source.blockShareCounts) && (0 < source.blockCount))
+		{
+			source.blockShareCounts = new std::atomic<int>*[source.blockCount];
+			for (IndexType i = 0; i < source.blockCount; ++i)
+				source.blockShareCounts[i] = 0;
+		}
+		for (IndexType i = 0; i < this->blockCount; ++i)
 		{
+			this->blocks[i] = source.blocks[i];
+			std::atomic<int> *shareCount = 0;
 			if (source.blocks[i])
 			{
-				this->blocks[i] = new EntryType[this->blockLength];
-				memcpy(this->blocks[i], source.blocks[i], this->blockLength*sizeof(EntryType));
+				shareCount = source.blockShareCounts[i];
+				if (shareCount)
+					++(*shareCount);
+				else
+					source.blockShareCounts[i] = shareCount = new std::atomic<int>(2);
 			}
-			else
-				this->blocks[i] = 0;
+			this->blockShareCounts[i] = shareCount;
 		}
 	}
 
@@ -109,22 +202,27 @@ public:
 	virtual void clear()
 	{
 		for (IndexType i = 0; i < this->blockCount; ++i)
-			delete[] this->blocks[i];
+			this->destroyBlock(i);
 		delete[] this->blocks;
 		this->blocks = 0;
+		delete[] this->blockShareCounts;
+		this->blockShareCounts = 0;
 		this->blockCount = 0;
 	}
 
-	/** @param  blockIndex  From 0 to block count - 1. Not checked. */
+	/** Get block for writing; copies block if shared.
+	  * @param  blockIndex  From 0 to block count - 1. Not checked. */
 	EntryType* getBlock(IndexType blockIndex)
 	{
-		return this->blocks[blockIndex];
+		return this->getWritableBlock(blockIndex);
 	}
 
-	/** @param  blockIndex  From 0 to block count - 1. Not checked. */
+	/** Destroy block, or just stop sharing it if shared.
+	  * @param  blockIndex  From 0 to block count - 1. Not checked. */
 	void destroyBlock(IndexType blockIndex)
 	{
-		delete[] this->blocks[blockIndex];
+		if (this->releaseBlockShare(blockIndex))
+			delete[] this->blocks[blockIndex];
 		this->blocks[blockIndex] = 0;
 	}
 
@@ -163,20 +261,52 @@ public:
 		return 0; // fall back to first
 	}
 
+	/** @return  Number of blocks allocated, not counting unallocated gaps. */
+	IndexType getAllocatedBlockCount() const
+	{
+		IndexType allocatedBlockCount = 0;
+		for (IndexType blockIndex = 0; blockIndex < this->blockCount; ++blockIndex)
+		{
+			if (this->blocks[blockIndex])
+				++allocatedBlockCount;
+		}
+		return allocatedBlockCount;
+	}
+
+	/** @return  Bytes allocated for blocks and the array of block pointers.
+	  * Bytes of blocks shared with copies are divided between the sharers.
+	  * Excludes memory pointed to by entries, and allocator overheads. */
+	size_t getAllocatedBytes() const
+	{
+		const size_t blockBytes = static_cast<size_t>(this->blockLength)*sizeof(EntryType);
+		size_t allocatedBytes = static_cast<size_t>(this->blockCount)*sizeof(EntryType *);
+		if (this->blockShareCounts)
+			allocatedBytes += static_cast<size_t>(this->blockCount)*sizeof(std::atomic<int> *);
+		for (IndexType blockIndex = 0; blockIndex < this->blockCount; ++blockIndex)
+		{
+			if (this->blocks[blockIndex])
+				allocatedBytes += blockBytes / this->getBlockShareCount(blockIndex);
+		}
+		return allocatedBytes;
+	}
+
 	/** Swaps all data with other block_array. Cannot fail. */
 	void swap(block_array& other)
 	{
 		swap_value(this->blocks, other.blocks);
+		swap_value(this->blockShareCounts, other.blockShareCounts);
 		swap_value(this->blockCount, other.blockCount);
 		swap_value(this->blockLength, other.blockLength);
 		swap_value(this->allocInitValue, other.allocInitValue);
 	}
 
 	/**
+	 * Get address of value for reading only, as block may be shared with a
+	 * copy; use non-const variant to write to it.
 	 * @param index  The index of the address to retrieve, starting at 0.
 	 * @return  The address for value for given index, or 0 if none.
 	 */
-	EntryType *getAddress(IndexType index) const
+	const EntryType *getAddress(IndexType index) const
 	{
 		IndexType blockIndex = index / blockLength;
 		if (blockIndex < blockCount)
@@ -188,6 +318,23 @@ public:
 		return 0;
 	}
 
+	/**
+	 * Get address of value for reading or writing. Copies block if shared.
+	 * @param index  The index of the address to retrieve, starting at 0.
+	 * @return  The address for value for given index, or 0 if none or failed.
+	 */
+	EntryType *getAddress(IndexType index)
+	{
+		IndexType blockIndex = index / blockLength;
+		if (blockIndex < blockCount)
+		{
+			EntryType *block = this->getWritableBlock(blockIndex);
+			if (block)
+				return block + (index % blockLength);
+		}
+		return 0;
+	}
+
 	/**
 	 * Gets or creates block containing values at index and returns address of index.
 	 * Uses default initialisation of values in new blocks.
@@ -197,15 +344,9 @@ public:
 	EntryType *getOrCreateAddress(IndexType index)
 	{
 		IndexType blockIndex = index / blockLength;
-		EntryType *block = 0;
-		if (blockIndex < blockCount)
-			block = blocks[blockIndex];
+		EntryType *block = getOrCreateBlock(blockIndex);
 		if (!block)
-		{
-			block = getOrCreateBlock(blockIndex);
-			if (!block)
-				return 0;
-		}
+			return 0;
 		return block + (index % blockLength);
 	}
 
@@ -224,14 +365,12 @@ public:
 		if (initIndexSpacing < 1)
 			return 0;
 		IndexType blockIndex = index / blockLength;
-		EntryType *block = 0;
-		if (blockIndex < blockCount)
-			block = blocks[blockIndex];
+		const bool newBlock = (blockIndex >= blockCount) || (!blocks[blockIndex]);
+		EntryType *block = getOrCreateBlock(blockIndex);
 		if (!block)
+			return 0;
+		if (newBlock)
 		{
-			block = getOrCreateBlock(blockIndex);
-			if (!block)
-				return 0;
 			if (initIndexSpacing > 0)
 			{
 				for (IndexType i = 0; i < blockLength; i += initIndexSpacing)
@@ -330,6 +469,64 @@ public:
 		}
 		return true;
 	}
+
+	/**
+	 * Allocate block pointers for indexes 0..indexCount-1 so setting values
+	 * up to that size does not repeatedly grow them. Blocks themselves are
+	 * still allocated when first set.
+	 * @return  Boolean true on success, false on failure.
+	 */
+	bool reserve(IndexType indexCount)
+	{
+		return this->growBlocks((indexCount + this->blockLength - 1) / this->blockLength);
+	}
+
+	/**
+	 * Move entries to new indexes, e.g. when labels are reordered. Entries
+	 * are moved, not copied, so pointers keep their ownership. Entries at
+	 * old indexes with no new index are cleared, deleting them in derived
+	 * classes owning entries. Blocks are only allocated for new indexes
+	 * receiving an entry, so unused indexes are compacted away.
+	 * @param oldIndexCount  Size of newIndexes array. Entries at or beyond
+	 * this index are cleared.
+	 * @param newIndexes  New index for entry at each old index, or negative
+	 * to clear it. Must not map two old indexes to the same new index.
+	 * @return  Boolean true on success, false on failure in which case
+	 * entries moved so far are lost.
+	 */
+	bool permute(IndexType oldIndexCount, const IndexType *newIndexes)
+	{
+		block_array<IndexType, EntryType> permuted(this->blockLength, this->allocInitValue);
+		bool success = true;
+		for (IndexType blockIndex = 0; (blockIndex < this->blockCount) && success; ++blockIndex)
+		{
+			if (!this->blocks[blockIndex])
+				continue;
+			EntryType *block = this->getWritableBlock(blockIndex);
+			if (!block)
+			{
+				success = false;
+				break;
+			}
+			IndexType index = blockIndex*this->blockLength;
+			for (IndexType i = 0; (i < this->blockLength) && (index < oldIndexCount); ++i, ++index)
+			{
+				if ((newIndexes[index] >= 0) && (block[i] != this->allocInitValue))
+				{
+					if (!permuted.setValue(newIndexes[index], block[i]))
+					{
+						success = false;
+						break;
+					}
+					block[i] = this->allocInitValue;
+				}
+			}
+		}
+		// clear remaining entries, then take permuted blocks
+		this->clear();
+		this->swap(permuted);
+		return success;
+	}
 	
 };
 
@@ -384,6 +581,7 @@ public:
 		block_array<IndexType, unsigned int>::swap(other);
 	}
 
+	using block_array<IndexType, unsigned int>::getAllocatedBytes;
 	using block_array<IndexType, unsigned int>::getBlockCount;
 	using block_array<IndexType, unsigned int>::getBlockLength;
 	using block_array<IndexType, unsigned int>::getValue;
@@ -495,6 +693,38 @@ public:
 		return false;
 	}
 
+	/**
+	 * Set all entries from minIndex..maxIndex to true, in lots of 32 bits
+	 * where possible.
+	 * @param newTrueCount  On success, set to number of entries which were
+	 * previously false.
+	 * @return  true if completely successful, false otherwise
+	 */
+	bool setRangeTrue(IndexType minIndex, IndexType maxIndex, IndexType& newTrueCount)
+	{
+		newTrueCount = 0;
+		IndexType index = minIndex;
+		while (index <= maxIndex)
+		{
+			const IndexType intIndex = index >> 5;
+			const IndexType lastBit = ((maxIndex >> 5) == intIndex) ? (maxIndex & 0x1F) : 31;
+			const IndexType firstBit = index & 0x1F;
+			const unsigned int mask = (0xFFFFFFFF >> (31 - lastBit)) & (0xFFFFFFFF << firstBit);
+			unsigned int intValue = 0;
+			getValue(intIndex, intValue);
+			unsigned int newBits = mask & ~intValue;
+			if (newBits)
+			{
+				if (!setValue(intIndex, intValue | mask))
+					return false;
+				for (; newBits; newBits &= newBits - 1)
+					++newTrueCount;
+			}
+			index = (intIndex + 1) << 5;
+		}
+		return true;
+	}
+
 	/** Sets all entries from index 0..indexCount-1 to true.
 	 * @return  true if completely successful, false otherwise */
 	bool setAllTrue(IndexType indexCount)
@@ -1344,6 +1344,18 @@ public:
 			}
 		}
 	}
+
+	/** @return  Bytes allocated for btree nodes and their child arrays.
+	  * Excludes allocator overheads. */
+	size_t getAllocatedBytes() const
+	{
+		int stem_count, leaf_count, min_leaf_depth, max_leaf_depth;
+		double mean_leaf_depth, mean_stem_occupancy, mean_leaf_occupancy;
+		this->get_statistics(stem_count, leaf_count, min_leaf_depth, max_leaf_depth,
+			mean_leaf_depth, mean_stem_occupancy, mean_leaf_occupancy);
+		return static_cast<size_t>(stem_count + leaf_count)*sizeof(BTreeNode)
+			+ static_cast<size_t>(stem_count)*(2*btreeOrder + 1)*sizeof(BTreeNode *);
+	}
 };
 
 #endif /* !defined (CMZN_BTREE_HPP) */
@@ -22,6 +22,7 @@ Declaration of functions for displaying messages.
 #define NOMINMAX
 #include <windows.h>
 #endif /* defined (WIN32_USER_INTERFACE) */
+#include <mutex>
 
 #include "general/debug.h"
 #include "general/message.h"
@@ -39,6 +40,10 @@ static char message_string[MESSAGE_STRING_SIZE];
 
 static bool display_message_on_console = false;
 
+/* serialises messages from concurrent evaluation threads. Recursive so message
+	 functions may display further messages */
+static std::recursive_mutex message_mutex;
+
 /*
 Global functions
 ----------------
@@ -71,6 +76,7 @@ int display_message_string(enum Message_type message_type,
 	if (!the_string)
 		return 0;
 
+	std::lock_guard<std::recursive_mutex> lock(message_mutex);
 	if (display_any_message_function)
 	{
 		return_code=(*display_any_message_function)(the_string,	message_type,
@@ -185,6 +191,7 @@ form of arguments is used.
 	int return_code;
 	va_list ap;
 
+	std::lock_guard<std::recursive_mutex> lock(message_mutex);
 	va_start(ap,format);
 	message_string[MESSAGE_STRING_SIZE-1] = '\0';
 	return_code=vsnprintf(message_string,MESSAGE_STRING_SIZE-1,format,ap);
@@ -224,6 +231,7 @@ A function for writing out commands to com file.
 	va_list ap;
 	FILE *com_file;
 	ENTER(write_message_to_file);
+	std::lock_guard<std::recursive_mutex> lock(message_mutex);
 	va_start(ap,format);
 /*	return_code=vsnprintf(message_string,MESSAGE_STRING_SIZE,format,ap);*/
 	return_code=vsprintf(message_string,format,ap);
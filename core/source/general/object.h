@@ -245,8 +245,8 @@ PROTOTYPE_DEACCESS_OBJECT_FUNCTION(object_type) \
 	ENTER(DEACCESS(object_type)); \
 	if (object_address && (object = *object_address)) \
 	{ \
-		(object->access_count)--; \
-		if (object->access_count <= 0) \
+		/* single decrement and test is safe for atomic access counts */ \
+		if (--(object->access_count) <= 0) \
 		{ \
 			return_code = DESTROY(object_type)(object_address); \
 		} \
@@ -304,8 +304,7 @@ PROTOTYPE_REACCESS_OBJECT_FUNCTION(object_type) \
 		if (NULL != (current_object = *object_address)) \
 		{ \
 			/* deaccess the current object */ \
-			(current_object->access_count)--; \
-			if (current_object->access_count <= 0) \
+			if (--(current_object->access_count) <= 0) \
 			{ \
 				DESTROY(object_type)(object_address); \
 			} \
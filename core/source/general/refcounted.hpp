@@ -12,6 +12,8 @@
 #if !defined (CMZN_GENERAL_REFCOUNTED_HPP)
 #define CMZN_GENERAL_REFCOUNTED_HPP
 
+#include <atomic>
+
 namespace cmzn
 {
 
@@ -31,7 +33,8 @@ class RefCounted
 	template<class REFCOUNTED> friend void Reaccess(REFCOUNTED* &object, REFCOUNTED* newObject);
 
 protected:
-	mutable int access_count;
+	// atomic so objects can be accessed from concurrent evaluation threads
+	mutable std::atomic<int> access_count;
 
 	RefCounted() :
 		access_count(1)
@@ -49,8 +52,7 @@ protected:
 
 	void deaccess() const
 	{
-		--this->access_count;
-		if (this->access_count <= 0)
+		if (--this->access_count <= 0)
 			delete this;
 	}
 };
@@ -754,6 +754,35 @@ unsigned int Graphics_vertex_array::get_number_of_vertices(
 	return vertex_count;
 }
 
+/** Adds bytes allocated for buffer to size_t at bytes_void */
+static int Graphics_vertex_buffer_add_allocated_bytes(
+	struct Graphics_vertex_buffer *buffer, void *bytes_void)
+{
+	size_t *bytes = static_cast<size_t *>(bytes_void);
+	if (buffer->memory)
+	{
+		// all numeric buffers hold 4-byte GLfloat, int or unsigned int values
+		*bytes += static_cast<size_t>(buffer->max_vertex_count)*buffer->values_per_vertex*sizeof(GLfloat);
+	}
+	return 1;
+}
+
+size_t Graphics_vertex_array::getAllocatedBytes() const
+{
+	size_t bytes = 0;
+	FOR_EACH_OBJECT_IN_LIST(Graphics_vertex_buffer)(
+		Graphics_vertex_buffer_add_allocated_bytes, static_cast<void *>(&bytes), internal->buffer_list);
+	for (String_buffer_map::const_iterator pos = internal->string_buffer_list.begin();
+		pos != internal->string_buffer_list.end(); ++pos)
+	{
+		const std::vector<std::string>& strings = pos->second->strings_vectors;
+		bytes += strings.capacity()*sizeof(std::string);
+		for (std::vector<std::string>::const_iterator iter = strings.begin(); iter != strings.end(); ++iter)
+			bytes += iter->capacity();
+	}
+	return bytes;
+}
+
 int Graphics_vertex_array::find_first_location_of_integer_value(
 	enum Graphics_vertex_array_attribute_type vertex_type, int value)
 {
@@ -289,6 +289,12 @@ public:
 	unsigned int get_number_of_vertices(
 		Graphics_vertex_array_attribute_type vertex_type);
 
+	/**
+	 * @return  Bytes allocated for vertex buffers, including unused capacity,
+	 * and strings. Excludes allocator overheads and fast search ids.
+	 */
+	size_t getAllocatedBytes() const;
+
 	/**
 	 * Free any unused memory at the end of a buffer
 	 */
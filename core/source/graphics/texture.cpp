@@ -6015,6 +6015,17 @@ original image read into the texture.
 	return (return_code);
 } /* Texture_get_size */
 
+size_t Texture_get_allocated_bytes(struct Texture *texture)
+{
+	if (!((texture) && (texture->image)))
+		return 0;
+	const int bytes_per_pixel = Texture_storage_type_get_number_of_components(texture->storage)*
+		texture->number_of_bytes_per_component;
+	// texture images are row aligned to 4-byte boundary
+	const size_t padded_width_bytes = 4*((texture->width_texels*bytes_per_pixel + 3)/4);
+	return padded_width_bytes*texture->height_texels*texture->depth_texels;
+}
+
 int Texture_get_dimension(struct Texture *texture, int *dimension)
 /*******************************************************************************
 LAST MODIFIED : 24 May 2007
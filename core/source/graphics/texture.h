@@ -698,6 +698,12 @@ and depth returned are at least as large as those of the original image read
 into the texture.
 ==============================================================================*/
 
+/**
+ * @return  Bytes allocated for the texel image of the texture, including row
+ * padding to 4-byte boundaries, or 0 if none.
+ */
+size_t Texture_get_allocated_bytes(struct Texture *texture);
+
 int Texture_get_dimension(struct Texture *texture, int *dimension);
 
 enum Texture_wrap_mode Texture_get_wrap_mode(struct Texture *texture);
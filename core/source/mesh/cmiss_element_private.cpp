@@ -1000,6 +1000,59 @@ cmzn_element *cmzn_elementtemplate::createElement(int identifier)
 	return element;
 }
 
+int cmzn_elementtemplate::defineElements(int elementsCount, const int *identifiers,
+	cmzn_elementfieldtemplate *eft, int nodeIdentifiersCount, const int *nodeIdentifiers,
+	DsLabelIndex& firstElementIndex, int& createdCount)
+{
+	firstElementIndex = DS_LABEL_INDEX_INVALID;
+	createdCount = 0;
+	if ((elementsCount <= 0) || (nodeIdentifiersCount < 0))
+	{
+		display_message(ERROR_MESSAGE, "Mesh defineElements.  Invalid elements or node identifiers count");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if (!this->validate())
+	{
+		display_message(ERROR_MESSAGE, "Mesh defineElements.  Element template is not valid");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if (!this->fe_element_template->getElementShape())
+	{
+		display_message(ERROR_MESSAGE, "Mesh defineElements.  Element template does not have a shape set");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	FE_element_field_template *fe_eft = 0;
+	if (eft)
+	{
+		// after validating template so EFT may be substituted by equivalent merged in mesh
+		fe_eft = eft->get_FE_element_field_template();
+		if ((eft->getMesh() != this->getMesh()) ||
+			// compare in size_t as product can exceed int range for large inputs
+			(static_cast<size_t>(nodeIdentifiersCount) !=
+				static_cast<size_t>(elementsCount)*static_cast<size_t>(eft->getNumberOfLocalNodes())))
+		{
+			display_message(ERROR_MESSAGE, "Mesh defineElements.  "
+				"Element field template is from another mesh or number of node identifiers is incorrect");
+			return CMZN_ERROR_ARGUMENT;
+		}
+	}
+	FE_mesh *fe_mesh = this->getMesh();
+	this->beginChange();
+	int return_code = fe_mesh->create_FE_elements(elementsCount, identifiers,
+		this->fe_element_template, fe_eft, nodeIdentifiers, firstElementIndex, createdCount);
+	if ((this->legacyNodes) && (this->legacyFieldDataList.size() > 0))
+	{
+		for (int i = 0; (i < createdCount) && (CMZN_OK == return_code); ++i)
+		{
+			return_code = this->setLegacyNodesInElement(fe_mesh->getElement(firstElementIndex + i));
+			if (CMZN_OK != return_code)
+				display_message(ERROR_MESSAGE, "Mesh defineElements.  Failed to set legacy nodes (deprecated feature)");
+		}
+	}
+	this->endChange();
+	return return_code;
+}
+
 int cmzn_elementtemplate::mergeIntoElement(cmzn_element *element)
 {
 	if (this->validate())
@@ -1099,6 +1152,35 @@ public:
 		return element;
 	}
 
+	int defineElements(cmzn_elementtemplate_id elementtemplate, int elementsCount,
+		const int *identifiers, cmzn_elementfieldtemplate_id eft,
+		int nodeIdentifiersCount, const int *nodeIdentifiers)
+	{
+		if (!elementtemplate)
+			return CMZN_ERROR_ARGUMENT;
+		if (elementtemplate->getMesh() != this->fe_mesh)
+		{
+			display_message(ERROR_MESSAGE, "Mesh defineElements.  Element template is not from this mesh");
+			return CMZN_ERROR_ARGUMENT;
+		}
+		if (this->group)
+		{
+			FE_region_begin_change(this->fe_mesh->get_FE_region());
+		}
+		DsLabelIndex firstElementIndex;
+		int createdCount;
+		const int return_code = elementtemplate->defineElements(elementsCount, identifiers,
+			eft, nodeIdentifiersCount, nodeIdentifiers, firstElementIndex, createdCount);
+		if (this->group)
+		{
+			Computed_field_element_group *element_group = Computed_field_element_group_core_cast(group);
+			for (int i = 0; i < createdCount; ++i)
+				element_group->addObject(this->fe_mesh->getElement(firstElementIndex + i));
+			FE_region_end_change(this->fe_mesh->get_FE_region());
+		}
+		return return_code;
+	}
+
 	cmzn_elementtemplate_id createElementtemplate()
 	{
 		return cmzn_elementtemplate::create(this->fe_mesh);
@@ -1391,6 +1473,21 @@ int cmzn_mesh_define_element(cmzn_mesh_id mesh, int identifier,
 	return CMZN_ERROR_ARGUMENT;
 }
 
+int cmzn_mesh_define_elements(cmzn_mesh_id mesh,
+	cmzn_elementtemplate_id element_template, int elements_count,
+	const int *identifiers, cmzn_elementfieldtemplate_id eft,
+	int node_identifiers_count, const int *node_identifiers)
+{
+	if (!((mesh) && (element_template) && (0 < elements_count) &&
+		((!eft) || (node_identifiers))))
+	{
+		display_message(ERROR_MESSAGE, "Mesh defineElements.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	return mesh->defineElements(element_template, elements_count, identifiers,
+		eft, node_identifiers_count, node_identifiers);
+}
+
 int cmzn_mesh_destroy_all_elements(cmzn_mesh_id mesh)
 {
 	if (mesh)
@@ -1424,8 +1521,12 @@ cmzn_element_id cmzn_mesh_find_element_by_identifier(cmzn_mesh_id mesh,
 cmzn_differentialoperator_id cmzn_mesh_get_chart_differentialoperator(
 	cmzn_mesh_id mesh, int order, int term)
 {
-	if (mesh && (1 == order) && (1 <= term) && (term <= mesh->getDimension()))
-		return new cmzn_differentialoperator(mesh->get_FE_mesh()->get_FE_region(), mesh->getDimension(), term);
+	if (mesh && (1 <= order) && (order <= 2) && (1 <= term))
+	{
+		const int dimension = mesh->getDimension();
+		if (term <= ((1 == order) ? dimension : dimension*dimension))
+			return new cmzn_differentialoperator(mesh->get_FE_mesh()->get_FE_region(), dimension, order, term);
+	}
 	return 0;
 }
 
@@ -1467,11 +1568,32 @@ int cmzn_mesh_get_size(cmzn_mesh_id mesh)
 	return 0;
 }
 
+bool cmzn_mesh_is_element_neighbour_table_enabled(cmzn_mesh_id mesh)
+{
+	if (mesh)
+		return mesh->get_FE_mesh()->isNeighbourTableEnabled();
+	return false;
+}
+
 bool cmzn_mesh_match(cmzn_mesh_id mesh1, cmzn_mesh_id mesh2)
 {
 	return (mesh1 && mesh2 && mesh1->match(*mesh2));
 }
 
+int cmzn_mesh_set_element_neighbour_table_enabled(cmzn_mesh_id mesh, bool enabled)
+{
+	if (mesh)
+		return mesh->get_FE_mesh()->setNeighbourTableEnabled(enabled);
+	return CMZN_ERROR_ARGUMENT;
+}
+
+int cmzn_mesh_reorder_elements(cmzn_mesh_id mesh, bool keep_identifiers)
+{
+	if (mesh)
+		return mesh->get_FE_mesh()->reorderElements(keep_identifiers);
+	return CMZN_ERROR_ARGUMENT;
+}
+
 cmzn_mesh_group_id cmzn_mesh_cast_group(cmzn_mesh_id mesh)
 {
 	if (mesh && mesh->isGroup())
@@ -2047,6 +2169,45 @@ int cmzn_element_set_scale_factors(cmzn_element_id element,
 	return eftData->setElementScaleFactors(element->getIndex(), valuesIn);
 }
 
+cmzn_element_id cmzn_element_get_neighbour(cmzn_element_id element,
+	enum cmzn_element_face_type face_type,
+	enum cmzn_element_face_type *neighbour_face_type_out)
+{
+	if (neighbour_face_type_out)
+		*neighbour_face_type_out = CMZN_ELEMENT_FACE_TYPE_INVALID;
+	if (element)
+	{
+		FE_mesh *mesh = element->getMesh();
+		if (!mesh)
+		{
+			display_message(ERROR_MESSAGE, "Element getNeighbour.  Invalid element");
+			return 0;
+		}
+		const DsLabelIndex elementIndex = element->getIndex();
+		FE_mesh::ElementShapeFaces *elementShapeFaces = mesh->getElementShapeFaces(elementIndex);
+		const int faceNumber = (elementShapeFaces) ? elementShapeFaces->faceTypeToNumber(face_type) : -1;
+		if ((face_type < CMZN_ELEMENT_FACE_TYPE_XI1_0) || (faceNumber < 0))
+		{
+			display_message(ERROR_MESSAGE, "Element getNeighbour.  Invalid face type");
+			return 0;
+		}
+		int neighbourFaceNumber = -1;
+		const DsLabelIndex neighbourIndex = mesh->getElementFirstNeighbour(elementIndex, faceNumber, neighbourFaceNumber);
+		if (neighbourIndex >= 0)
+		{
+			cmzn_element *neighbour = mesh->getElement(neighbourIndex);
+			if (neighbour)
+			{
+				if (neighbour_face_type_out)
+					*neighbour_face_type_out = static_cast<cmzn_element_face_type>(
+						CMZN_ELEMENT_FACE_TYPE_XI1_0 + neighbourFaceNumber);
+				return neighbour->access();
+			}
+		}
+	}
+	return 0;
+}
+
 enum cmzn_element_shape_type cmzn_element_get_shape_type(
 	cmzn_element_id element)
 {
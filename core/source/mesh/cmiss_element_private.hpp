@@ -222,6 +222,15 @@ public:
 
 	cmzn_element *createElement(int identifier);
 
+	/** Create many elements from this template, optionally setting nodes for eft.
+	  * @see FE_mesh::create_FE_elements
+	  * @param firstElementIndex  On success, index of first new element; new
+	  * elements have consecutive indexes.
+	  * @param createdCount  On return, number of elements created. */
+	int defineElements(int elementsCount, const int *identifiers,
+		cmzn_elementfieldtemplate *eft, int nodeIdentifiersCount, const int *nodeIdentifiers,
+		DsLabelIndex& firstElementIndex, int& createdCount);
+
 	/** Variant for EX reader which assumes template has already been validated,
 	  * does not set legacy nodes and does not cache changes as assumed on */
 	cmzn_element *createElementEX(int identifier)
@@ -607,6 +607,43 @@ public:
 		return node;
 	}
 
+	int defineNodes(cmzn_nodetemplate_id node_template, int nodesCount,
+		const int *identifiers, int fieldsCount, const cmzn_field_id *fields,
+		int valuesCount, const double *values)
+	{
+		if (!node_template->validate())
+		{
+			display_message(ERROR_MESSAGE, "Nodeset defineNodes.  Node template is not valid");
+			return CMZN_ERROR_ARGUMENT;
+		}
+		std::vector<FE_field *> fe_fields(fieldsCount, static_cast<FE_field *>(0));
+		for (int f = 0; f < fieldsCount; ++f)
+		{
+			if (fields[f])
+				Computed_field_get_type_finite_element(fields[f], &(fe_fields[f]));
+			if ((!fe_fields[f]) || (FE_field_get_FE_region(fe_fields[f]) != this->fe_nodeset->get_FE_region()))
+			{
+				display_message(ERROR_MESSAGE, "Nodeset defineNodes.  Field %d is not a finite element field from this region", f + 1);
+				return CMZN_ERROR_ARGUMENT;
+			}
+		}
+		if (group)
+			FE_region_begin_change(this->fe_nodeset->get_FE_region());
+		DsLabelIndex firstNodeIndex;
+		int createdCount;
+		const int return_code = this->fe_nodeset->create_FE_nodes(nodesCount, identifiers,
+			node_template->get_FE_node_template(), fieldsCount, fe_fields.data(),
+			valuesCount, values, firstNodeIndex, createdCount);
+		if (group)
+		{
+			Computed_field_node_group *node_group = Computed_field_node_group_core_cast(group);
+			for (int i = 0; i < createdCount; ++i)
+				node_group->addObject(this->fe_nodeset->getNode(firstNodeIndex + i));
+			FE_region_end_change(this->fe_nodeset->get_FE_region());
+		}
+		return return_code;
+	}
+
 	cmzn_nodetemplate_id createNodetemplate()
 	{
 		return new cmzn_nodetemplate(this->fe_nodeset);
@@ -866,6 +903,21 @@ cmzn_node_id cmzn_nodeset_create_node(cmzn_nodeset_id nodeset,
 	return 0;
 }
 
+int cmzn_nodeset_define_nodes(cmzn_nodeset_id nodeset,
+	cmzn_nodetemplate_id node_template, int nodes_count, const int *identifiers,
+	int fields_count, const cmzn_field_id *fields, int values_count,
+	const double *values)
+{
+	if (!((nodeset) && (node_template) && (0 < nodes_count) && (0 <= fields_count)
+		&& ((0 == fields_count) || ((fields) && (values)))))
+	{
+		display_message(ERROR_MESSAGE, "Nodeset defineNodes.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	return nodeset->defineNodes(node_template, nodes_count, identifiers,
+		fields_count, fields, values_count, values);
+}
+
 cmzn_nodeiterator_id cmzn_nodeset_create_nodeiterator(
 	cmzn_nodeset_id nodeset)
 {
@@ -896,6 +948,13 @@ int cmzn_nodeset_get_size(cmzn_nodeset_id nodeset)
 	return 0;
 }
 
+int cmzn_nodeset_reorder_nodes(cmzn_nodeset_id nodeset, bool keep_identifiers)
+{
+	if (nodeset)
+		return nodeset->getFeNodeset()->reorderNodes(keep_identifiers);
+	return CMZN_ERROR_ARGUMENT;
+}
+
 int cmzn_nodeset_destroy_all_nodes(cmzn_nodeset_id nodeset)
 {
 	if (nodeset)
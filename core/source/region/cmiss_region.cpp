@@ -27,12 +27,17 @@
 #include "general/mystring.h"
 #include "graphics/scene.h"
 #include "region/cmiss_region.h"
+#include "region/cmiss_region_memory_usage.hpp"
 #include "region/cmiss_region_private.h"
+#include "finite_element/element_field_values_cache.hpp"
 #include "finite_element/finite_element_region.h"
 #include "finite_element/finite_element_region_private.h"
 #include "general/message.h"
 #include <algorithm>
+#include <atomic>
 #include <list>
+#include <mutex>
+#include <new>
 #include <vector>
 
 /*
@@ -69,6 +74,14 @@ struct cmzn_region
 	// all field caches currently in use for this region, for clearing
 	// when fields changed, and adding value caches for new fields.
 	std::list<cmzn_fieldcache_id> *field_caches;
+	// guards field_caches which are created and destroyed by concurrent
+	// evaluation threads. Recursive as destroying a value cache in the list
+	// can destroy its extra field cache.
+	std::recursive_mutex *field_caches_mutex;
+	// set while profiling field evaluation; guarded by field_caches_mutex.
+	// Field caches in use by other threads record into their own profiles,
+	// which guard their records and are kept until the cache is destroyed
+	FieldProfiler *field_profiler;
 
 	/* list of objects attached to region */
 	struct LIST(Any_object) *any_object_list;
@@ -86,8 +99,9 @@ struct cmzn_region
 	// list of notifiers which receive field module callbacks
 	cmzn_fieldmodulenotifier_list *notifier_list;
 
-	/* number of objects using this region */
-	int access_count;
+	/* number of objects using this region. Atomic as accessed by field caches
+	 * which may be created and destroyed by concurrent evaluation threads */
+	std::atomic<int> access_count;
 };
 
 /*
@@ -115,6 +129,18 @@ static void cmzn_region_Computed_field_change(
 	if (message && region)
 	{
 		int change_summary = MANAGER_MESSAGE_GET_CHANGE_SUMMARY(Computed_field)(message);
+		// extract finite element changes if needed by notifiers or to invalidate
+		// element field values shared by field caches
+		FE_region_changes *changes = 0;
+		FE_element_field_values_cache *elementFieldValuesCache =
+			FE_region_get_element_field_values_cache(region->fe_region);
+		if ((0 < region->notifier_list->size()) ||
+			(elementFieldValuesCache && (0 < elementFieldValuesCache->getSize())))
+		{
+			changes = FE_region_changes::create(region->fe_region);
+			if (elementFieldValuesCache)
+				elementFieldValuesCache->invalidate(changes);
+		}
 		// clear active field caches for changed fields
 		if ((change_summary & MANAGER_CHANGE_RESULT(Computed_field)) &&
 			(0 < region->field_caches->size()))
@@ -135,9 +161,7 @@ static void cmzn_region_Computed_field_change(
 			cmzn_fieldmoduleevent_id event = cmzn_fieldmoduleevent::create(region);
 			event->setChangeFlags(change_summary);
 			event->setManagerMessage(message);
-			FE_region_changes *changes = FE_region_changes::create(region->fe_region);
 			event->setFeRegionChanges(changes);
-			FE_region_changes::deaccess(changes);
 			for (cmzn_fieldmodulenotifier_list::iterator iter = region->notifier_list->begin();
 				iter != region->notifier_list->end(); ++iter)
 			{
@@ -145,6 +169,7 @@ static void cmzn_region_Computed_field_change(
 			}
 			cmzn_fieldmoduleevent::deaccess(event);
 		}
+		FE_region_changes::deaccess(changes);
 		if (change_summary & (MANAGER_CHANGE_RESULT(Computed_field) |
 			MANAGER_CHANGE_ADD(Computed_field)))
 		{
@@ -167,6 +192,7 @@ static int cmzn_region_fields_begin_change(struct cmzn_region *region)
 	if (region)
 	{
 		// reset field value caches so always re-evaluated. See cmzn_field::evaluate()
+		std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
 		for (std::list<cmzn_fieldcache_id>::iterator iter = region->field_caches->begin();
 			iter != region->field_caches->end(); ++iter)
 		{
@@ -342,7 +368,10 @@ cmzn_region *cmzn_region_create_internal(cmzn_region *base_region)
 		FE_region_set_cmzn_region_private(region->fe_region, region);
 		region->field_cache_size = 0;
 		region->field_caches = new std::list<cmzn_fieldcache_id>();
-		region->access_count = 1;
+		region->field_caches_mutex = new std::recursive_mutex();
+		region->field_profiler = 0;
+		// construct atomic in memory from ALLOCATE
+		new (&region->access_count) std::atomic<int>(1);
 		if (!(region->any_object_list && region->change_callback_list &&
 			region->field_manager && region->field_manager_callback_id &&
 			region->fe_region))
@@ -437,6 +466,8 @@ int DESTROY(cmzn_region)(struct cmzn_region **region_address)
 			}
 
 			delete region->field_caches;
+			delete region->field_caches_mutex;
+			delete region->field_profiler;
 			DESTROY(LIST(Any_object))(&(region->any_object_list));
 
 			cmzn_region_detach_fields(region);
@@ -504,14 +535,19 @@ int cmzn_region_add_field_private(cmzn_region_id region, cmzn_field_id field)
 		}
 		if (Computed_field_add_to_manager_private(field, region->field_manager))
 		{
+			std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
 			int i = 1;
 			for (std::list<cmzn_fieldcache_id>::iterator iter = region->field_caches->begin();
 				iter != region->field_caches->end(); ++iter)
 			{
 				cmzn_fieldcache_id field_cache = *iter;
 				field_cache->setValueCache(cache_index, 0);
+				if (field_cache->getProfile())
+					field_cache->getProfile()->clearRecord(cache_index);
 				++i;
 			}
+			if (region->field_profiler)
+				region->field_profiler->getAccumulatedProfile().clearRecord(cache_index);
 			cmzn_field_set_cache_index_private(field, cache_index);
 			return 1;
 		}
@@ -522,6 +558,7 @@ int cmzn_region_add_field_private(cmzn_region_id region, cmzn_field_id field)
 void cmzn_region_clear_field_value_caches(cmzn_region_id region, cmzn_field_id field)
 {
 	int cacheIndex = cmzn_field_get_cache_index_private(field);
+	std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
 	for (std::list<cmzn_fieldcache_id>::iterator iter = region->field_caches->begin();
 		iter != region->field_caches->end(); ++iter)
 	{
@@ -637,14 +674,24 @@ int cmzn_region_get_field_cache_size(cmzn_region_id region)
 void cmzn_region_add_field_cache(cmzn_region_id region, cmzn_fieldcache_id cache)
 {
 	if (region && cache)
+	{
+		std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
 		region->field_caches->push_back(cache);
+		if (region->field_profiler)
+			cache->setProfiling(true);
+	}
 }
 
 void cmzn_region_remove_field_cache(cmzn_region_id region,
 	cmzn_fieldcache_id cache)
 {
 	if (region && cache)
+	{
+		std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
 		region->field_caches->remove(cache);
+		if (region->field_profiler && cache->getProfile())
+			region->field_profiler->getAccumulatedProfile().add(*cache->getProfile());
+	}
 }
 
 int cmzn_fieldmodule_begin_change(cmzn_fieldmodule_id field_module)
@@ -663,6 +710,191 @@ int cmzn_fieldmodule_define_all_faces(cmzn_fieldmodule_id field_module)
 		cmzn_fieldmodule_get_region_internal(field_module)));
 }
 
+namespace {
+
+FE_element_field_values_cache *cmzn_fieldmodule_get_element_field_values_cache(
+	cmzn_fieldmodule_id field_module)
+{
+	return FE_region_get_element_field_values_cache(cmzn_region_get_FE_region(
+		cmzn_fieldmodule_get_region_internal(field_module)));
+}
+
+}
+
+int cmzn_fieldmodule_get_element_field_values_cache_capacity(
+	cmzn_fieldmodule_id field_module)
+{
+	FE_element_field_values_cache *cache =
+		cmzn_fieldmodule_get_element_field_values_cache(field_module);
+	if (cache)
+		return cache->getCapacity();
+	return 0;
+}
+
+int cmzn_fieldmodule_set_element_field_values_cache_capacity(
+	cmzn_fieldmodule_id field_module, int capacity)
+{
+	FE_element_field_values_cache *cache =
+		cmzn_fieldmodule_get_element_field_values_cache(field_module);
+	if (cache)
+		return cache->setCapacity(capacity);
+	return CMZN_ERROR_ARGUMENT;
+}
+
+int cmzn_fieldmodule_clear_element_field_values_cache(
+	cmzn_fieldmodule_id field_module)
+{
+	FE_element_field_values_cache *cache =
+		cmzn_fieldmodule_get_element_field_values_cache(field_module);
+	if (cache)
+	{
+		cache->clear();
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
+int cmzn_fieldmodule_get_element_field_values_cache_statistics(
+	cmzn_fieldmodule_id field_module, int *size_out, int *hits_out, int *misses_out)
+{
+	FE_element_field_values_cache *cache =
+		cmzn_fieldmodule_get_element_field_values_cache(field_module);
+	if (cache && size_out && hits_out && misses_out)
+	{
+		cache->getStatistics(*size_out, *hits_out, *misses_out);
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
+namespace {
+
+/** Reset element field values cache statistics start for profiler.
+ * Caller must hold field_caches_mutex */
+void cmzn_region_reset_field_profiler_element_field_values_start(cmzn_region *region)
+{
+	int size = 0, hits = 0, misses = 0;
+	FE_element_field_values_cache *cache =
+		FE_region_get_element_field_values_cache(region->fe_region);
+	if (cache)
+		cache->getStatistics(size, hits, misses);
+	region->field_profiler->setElementFieldValuesStart(hits, misses);
+}
+
+}
+
+int cmzn_fieldmodule_set_profiling_enabled(cmzn_fieldmodule_id field_module,
+	bool enabled)
+{
+	cmzn_region *region = cmzn_fieldmodule_get_region_internal(field_module);
+	if (!region)
+		return CMZN_ERROR_ARGUMENT;
+	std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
+	if (enabled == (0 != region->field_profiler))
+		return CMZN_OK;
+	if (enabled)
+	{
+		region->field_profiler = new FieldProfiler();
+		cmzn_region_reset_field_profiler_element_field_values_start(region);
+	}
+	else
+	{
+		delete region->field_profiler;
+		region->field_profiler = 0;
+	}
+	for (std::list<cmzn_fieldcache_id>::iterator iter = region->field_caches->begin();
+		iter != region->field_caches->end(); ++iter)
+	{
+		(*iter)->setProfiling(enabled);
+	}
+	return CMZN_OK;
+}
+
+bool cmzn_fieldmodule_is_profiling_enabled(cmzn_fieldmodule_id field_module)
+{
+	cmzn_region *region = cmzn_fieldmodule_get_region_internal(field_module);
+	if (region)
+	{
+		std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
+		return (0 != region->field_profiler);
+	}
+	return false;
+}
+
+int cmzn_fieldmodule_reset_profile(cmzn_fieldmodule_id field_module)
+{
+	cmzn_region *region = cmzn_fieldmodule_get_region_internal(field_module);
+	if (!region)
+		return CMZN_ERROR_ARGUMENT;
+	std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
+	if (!region->field_profiler)
+		return CMZN_ERROR_NOT_FOUND;
+	region->field_profiler->getAccumulatedProfile().clear();
+	cmzn_region_reset_field_profiler_element_field_values_start(region);
+	for (std::list<cmzn_fieldcache_id>::iterator iter = region->field_caches->begin();
+		iter != region->field_caches->end(); ++iter)
+	{
+		FieldProfile *profile = (*iter)->getProfile();
+		if (profile)
+			profile->clear();
+	}
+	return CMZN_OK;
+}
+
+char *cmzn_fieldmodule_write_profile_report(cmzn_fieldmodule_id field_module)
+{
+	cmzn_region *region = cmzn_fieldmodule_get_region_internal(field_module);
+	if (!region)
+		return 0;
+	std::lock_guard<std::recursive_mutex> lock(*region->field_caches_mutex);
+	if (!region->field_profiler)
+		return 0;
+	FieldProfile totalProfile;
+	totalProfile.add(region->field_profiler->getAccumulatedProfile());
+	for (std::list<cmzn_fieldcache_id>::iterator iter = region->field_caches->begin();
+		iter != region->field_caches->end(); ++iter)
+	{
+		const FieldProfile *profile = (*iter)->getProfile();
+		if (profile)
+			totalProfile.add(*profile);
+	}
+	int size = 0, hits = 0, misses = 0;
+	FE_element_field_values_cache *cache =
+		FE_region_get_element_field_values_cache(region->fe_region);
+	if (cache)
+		cache->getStatistics(size, hits, misses);
+	return duplicate_string(region->field_profiler->writeReport(
+		region, totalProfile, hits, misses).c_str());
+}
+
+int cmzn_fieldmodule_log_profile_report(cmzn_fieldmodule_id field_module)
+{
+	char *report = cmzn_fieldmodule_write_profile_report(field_module);
+	if (!report)
+		return (cmzn_fieldmodule_get_region_internal(field_module)) ?
+			CMZN_ERROR_NOT_FOUND : CMZN_ERROR_ARGUMENT;
+	display_message_string(INFORMATION_MESSAGE, report);
+	DEALLOCATE(report);
+	return CMZN_OK;
+}
+
+char *cmzn_region_write_memory_usage_report(cmzn_region_id region)
+{
+	if (!region)
+		return 0;
+	return duplicate_string(cmzn_region_write_memory_usage_json(region).c_str());
+}
+
+int cmzn_region_log_memory_usage_report(cmzn_region_id region)
+{
+	char *report = cmzn_region_write_memory_usage_report(region);
+	if (!report)
+		return CMZN_ERROR_ARGUMENT;
+	display_message_string(INFORMATION_MESSAGE, report);
+	DEALLOCATE(report);
+	return CMZN_OK;
+}
+
 int cmzn_region_begin_change(struct cmzn_region *region)
 {
 	if (region)
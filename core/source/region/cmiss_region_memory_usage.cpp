@@ -0,0 +1,248 @@
+/**
+ * FILE : cmiss_region_memory_usage.cpp
+ *
+ * Report of memory allocated for model and graphics storage in a region tree.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <map>
+#include "opencmiss/zinc/fieldimage.h"
+#include "opencmiss/zinc/fieldsubobjectgroup.h"
+#include "opencmiss/zinc/graphics.h"
+#include "opencmiss/zinc/region.h"
+#include "opencmiss/zinc/scene.h"
+#include "computed_field/computed_field_finite_element.h"
+#include "computed_field/computed_field_image.h"
+#include "computed_field/computed_field_private.hpp"
+#include "computed_field/computed_field_subobject_group.hpp"
+#include "finite_element/finite_element_mesh.hpp"
+#include "finite_element/finite_element_nodeset.hpp"
+#include "finite_element/finite_element_region.h"
+#include "general/debug.h"
+#include "graphics/graphics.h"
+#include "graphics/graphics_object.h"
+#include "graphics/graphics_vertex_array.hpp"
+#include "graphics/scene.h"
+#include "graphics/texture.h"
+#include "region/cmiss_region.h"
+#include "region/cmiss_region_memory_usage.hpp"
+#include "jsoncpp/json.h"
+
+namespace {
+
+/** Bytes held for a field, accumulated over nodesets and meshes */
+struct FieldMemoryUsage
+{
+	Json::Value nodesetValuesJson;
+	Json::Value meshValuesJson;
+	size_t totalBytes;
+
+	FieldMemoryUsage() :
+		nodesetValuesJson(Json::objectValue),
+		meshValuesJson(Json::objectValue),
+		totalBytes(0)
+	{
+	}
+};
+
+inline Json::Value bytesJson(size_t bytes)
+{
+	return Json::Value(static_cast<Json::UInt64>(bytes));
+}
+
+/** Add field bytes to regionJson "Fields" array, and their total excluding
+  * node values, which are already counted with nodesets, to regionBytes.
+  * @param feFieldUsage  Node values bytes of finite element fields. Per-element
+  * values bytes are added to it. */
+void writeFieldsMemoryUsage(cmzn_region_id region, FE_region *fe_region,
+	std::map<FE_field *, FieldMemoryUsage>& feFieldUsage, Json::Value& regionJson, size_t& regionBytes)
+{
+	Json::Value fieldsJson(Json::arrayValue);
+	const cmzn_set_cmzn_field& fields =
+		Computed_field_manager_get_fields(cmzn_region_get_Computed_field_manager(region));
+	for (cmzn_set_cmzn_field::const_iterator fieldIter = fields.begin(); fieldIter != fields.end(); ++fieldIter)
+	{
+		cmzn_field *field = *fieldIter;
+		Json::Value fieldJson;
+		size_t fieldBytes = 0;
+		size_t fieldExtraBytes = 0; // bytes not counted elsewhere in region
+		FE_field *fe_field = 0;
+		if (Computed_field_get_type_finite_element(field, &fe_field) && (fe_field))
+		{
+			FieldMemoryUsage& usage = feFieldUsage[fe_field];
+			fieldBytes += usage.totalBytes;
+			for (int dimension = 1; dimension <= MAXIMUM_ELEMENT_XI_DIMENSIONS; ++dimension)
+			{
+				FE_mesh *fe_mesh = FE_region_find_FE_mesh_by_dimension(fe_region, dimension);
+				const FE_mesh_field_data *meshFieldData = (fe_mesh) ? FE_field_getMeshFieldData(fe_field, fe_mesh) : 0;
+				if (meshFieldData)
+				{
+					const size_t bytes = meshFieldData->getAllocatedBytes();
+					usage.meshValuesJson[fe_mesh->getName()] = bytesJson(bytes);
+					fieldExtraBytes += bytes;
+				}
+			}
+			if (!usage.nodesetValuesJson.empty())
+				fieldJson["NodesetValuesBytes"] = usage.nodesetValuesJson;
+			if (!usage.meshValuesJson.empty())
+				fieldJson["MeshValuesBytes"] = usage.meshValuesJson;
+		}
+		cmzn_field_node_group_id nodeGroup = cmzn_field_cast_node_group(field);
+		if (nodeGroup)
+		{
+			const size_t bytes = Computed_field_node_group_core_cast(nodeGroup)->getLabelsGroup().getAllocatedBytes();
+			fieldJson["GroupBytes"] = bytesJson(bytes);
+			fieldExtraBytes += bytes;
+			cmzn_field_node_group_destroy(&nodeGroup);
+		}
+		cmzn_field_element_group_id elementGroup = cmzn_field_cast_element_group(field);
+		if (elementGroup)
+		{
+			const size_t bytes = Computed_field_element_group_core_cast(elementGroup)->getLabelsGroup().getAllocatedBytes();
+			fieldJson["GroupBytes"] = bytesJson(bytes);
+			fieldExtraBytes += bytes;
+			cmzn_field_element_group_destroy(&elementGroup);
+		}
+		cmzn_field_image_id image = cmzn_field_cast_image(field);
+		if (image)
+		{
+			const size_t bytes = Texture_get_allocated_bytes(cmzn_field_image_get_texture(image));
+			fieldJson["TextureBytes"] = bytesJson(bytes);
+			fieldExtraBytes += bytes;
+			cmzn_field_image_destroy(&image);
+		}
+		fieldBytes += fieldExtraBytes;
+		if (0 < fieldBytes)
+		{
+			fieldJson["Name"] = field->name;
+			fieldJson["TotalBytes"] = bytesJson(fieldBytes);
+			fieldsJson.append(fieldJson);
+			regionBytes += fieldExtraBytes;
+		}
+	}
+	regionJson["Fields"] = fieldsJson;
+}
+
+/** Add graphics vertex array bytes to regionJson "Graphics" array, and
+  * their total to regionBytes. */
+void writeGraphicsMemoryUsage(cmzn_region_id region, Json::Value& regionJson, size_t& regionBytes)
+{
+	Json::Value graphicsListJson(Json::arrayValue);
+	cmzn_scene *scene = cmzn_region_get_scene_private(region);
+	if (scene)
+	{
+		cmzn_graphics_id graphics = cmzn_scene_get_first_graphics(scene);
+		while (graphics)
+		{
+			Json::Value graphicsJson;
+			char *name = cmzn_graphics_get_name_internal(graphics);
+			graphicsJson["Name"] = name;
+			DEALLOCATE(name);
+			char *typeName = cmzn_graphics_type_enum_to_string(cmzn_graphics_get_type(graphics));
+			if (typeName)
+			{
+				graphicsJson["Type"] = typeName;
+				DEALLOCATE(typeName);
+			}
+			GT_object *graphicsObject = cmzn_graphics_get_graphics_object(graphics);
+			Graphics_vertex_array *vertexArray = (graphicsObject) ? GT_object_get_vertex_set(graphicsObject) : 0;
+			const size_t bytes = (vertexArray) ? vertexArray->getAllocatedBytes() : 0;
+			graphicsJson["VertexArrayBytes"] = bytesJson(bytes);
+			regionBytes += bytes;
+			graphicsListJson.append(graphicsJson);
+			cmzn_graphics_id nextGraphics = cmzn_scene_get_next_graphics(scene, graphics);
+			cmzn_graphics_destroy(&graphics);
+			graphics = nextGraphics;
+		}
+	}
+	regionJson["Graphics"] = graphicsListJson;
+}
+
+/** @param totalBytes  Bytes for region and its descendants are added to this.
+  * @return  JSON object reporting memory usage of region and descendants. */
+Json::Value getRegionMemoryUsageJson(cmzn_region_id region, size_t& totalBytes)
+{
+	Json::Value regionJson;
+	char *path = cmzn_region_get_path(region);
+	regionJson["Path"] = path;
+	DEALLOCATE(path);
+	size_t regionBytes = 0;
+	FE_region *fe_region = cmzn_region_get_FE_region(region);
+	std::map<FE_field *, FieldMemoryUsage> feFieldUsage;
+	Json::Value nodesetsJson(Json::arrayValue);
+	const cmzn_field_domain_type nodesetDomainTypes[2] = { CMZN_FIELD_DOMAIN_TYPE_NODES, CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS };
+	for (int n = 0; n < 2; ++n)
+	{
+		FE_nodeset *fe_nodeset = FE_region_find_FE_nodeset_by_field_domain_type(fe_region, nodesetDomainTypes[n]);
+		if (!fe_nodeset)
+			continue;
+		size_t labelsBytes, nodesBytes, valuesBytes;
+		std::map<FE_field *, size_t> fieldValuesBytes;
+		fe_nodeset->getAllocatedBytes(labelsBytes, nodesBytes, valuesBytes, fieldValuesBytes);
+		for (std::map<FE_field *, size_t>::iterator iter = fieldValuesBytes.begin(); iter != fieldValuesBytes.end(); ++iter)
+		{
+			FieldMemoryUsage& usage = feFieldUsage[iter->first];
+			usage.nodesetValuesJson[fe_nodeset->getName()] = bytesJson(iter->second);
+			usage.totalBytes += iter->second;
+		}
+		const size_t nodesetBytes = labelsBytes + nodesBytes + valuesBytes;
+		Json::Value nodesetJson;
+		nodesetJson["Name"] = fe_nodeset->getName();
+		nodesetJson["Size"] = fe_nodeset->getSize();
+		nodesetJson["LabelsBytes"] = bytesJson(labelsBytes);
+		nodesetJson["NodesBytes"] = bytesJson(nodesBytes);
+		nodesetJson["ValuesBytes"] = bytesJson(valuesBytes);
+		nodesetJson["TotalBytes"] = bytesJson(nodesetBytes);
+		nodesetsJson.append(nodesetJson);
+		regionBytes += nodesetBytes;
+	}
+	regionJson["Nodesets"] = nodesetsJson;
+	Json::Value meshesJson(Json::arrayValue);
+	for (int dimension = 1; dimension <= MAXIMUM_ELEMENT_XI_DIMENSIONS; ++dimension)
+	{
+		FE_mesh *fe_mesh = FE_region_find_FE_mesh_by_dimension(fe_region, dimension);
+		if (!fe_mesh)
+			continue;
+		size_t labelsBytes, elementsBytes, elementFieldTemplatesBytes, scaleFactorsBytes;
+		fe_mesh->getAllocatedBytes(labelsBytes, elementsBytes, elementFieldTemplatesBytes, scaleFactorsBytes);
+		const size_t meshBytes = labelsBytes + elementsBytes + elementFieldTemplatesBytes + scaleFactorsBytes;
+		Json::Value meshJson;
+		meshJson["Name"] = fe_mesh->getName();
+		meshJson["Size"] = fe_mesh->getSize();
+		meshJson["LabelsBytes"] = bytesJson(labelsBytes);
+		meshJson["ElementsBytes"] = bytesJson(elementsBytes);
+		meshJson["ElementFieldTemplatesBytes"] = bytesJson(elementFieldTemplatesBytes);
+		meshJson["ScaleFactorsBytes"] = bytesJson(scaleFactorsBytes);
+		meshJson["TotalBytes"] = bytesJson(meshBytes);
+		meshesJson.append(meshJson);
+		regionBytes += meshBytes;
+	}
+	regionJson["Meshes"] = meshesJson;
+	writeFieldsMemoryUsage(region, fe_region, feFieldUsage, regionJson, regionBytes);
+	writeGraphicsMemoryUsage(region, regionJson, regionBytes);
+	regionJson["RegionBytes"] = bytesJson(regionBytes);
+	size_t treeBytes = regionBytes;
+	Json::Value childrenJson(Json::arrayValue);
+	cmzn_region_id child = cmzn_region_get_first_child(region);
+	while (child)
+	{
+		childrenJson.append(getRegionMemoryUsageJson(child, treeBytes));
+		cmzn_region_reaccess_next_sibling(&child);
+	}
+	regionJson["Regions"] = childrenJson;
+	regionJson["TotalBytes"] = bytesJson(treeBytes);
+	totalBytes += treeBytes;
+	return regionJson;
+}
+
+}
+
+std::string cmzn_region_write_memory_usage_json(cmzn_region_id region)
+{
+	size_t totalBytes = 0;
+	return Json::StyledWriter().write(getRegionMemoryUsageJson(region, totalBytes));
+}
@@ -0,0 +1,28 @@
+/**
+ * FILE : cmiss_region_memory_usage.hpp
+ *
+ * Report of memory allocated for model and graphics storage in a region tree.
+ */
+/* OpenCMISS-Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (CMZN_REGION_MEMORY_USAGE_HPP)
+#define CMZN_REGION_MEMORY_USAGE_HPP
+
+#include "opencmiss/zinc/types/regionid.h"
+#include <string>
+
+/**
+ * Write a JSON report of bytes allocated for labels, maps, node values,
+ * element field templates, per-element field values, groups, textures and
+ * graphics vertex arrays in region and all its descendants.
+ * @see cmzn_region_write_memory_usage_report
+ * @param region  The root region of the tree to report on. Must be valid.
+ * @return  JSON report string.
+ */
+std::string cmzn_region_write_memory_usage_json(cmzn_region_id region);
+
+#endif /* !defined (CMZN_REGION_MEMORY_USAGE_HPP) */
@@ -500,6 +500,58 @@ int cmzn_region_write_file(cmzn_region_id region, const char *file_name)
 	return return_code;
 }
 
+cmzn_region_id cmzn_region_create_fork(cmzn_region_id region, double time)
+{
+	if (!region)
+	{
+		display_message(ERROR_MESSAGE, "cmzn_region_create_fork.  Invalid argument(s)");
+		return 0;
+	}
+	cmzn_region_id fork = cmzn_region_create_region(region);
+	if (!fork)
+		return 0;
+	cmzn_streaminformation_id writeInformation =
+		cmzn_region_create_streaminformation_region(region);
+	cmzn_streamresource_id writeResource =
+		cmzn_streaminformation_create_streamresource_memory(writeInformation);
+	cmzn_streaminformation_region_id writeInformationRegion =
+		cmzn_streaminformation_cast_region(writeInformation);
+	cmzn_streaminformation_region_set_attribute_real(writeInformationRegion,
+		CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME, time);
+	int return_code = cmzn_region_write(region, writeInformationRegion);
+	if (CMZN_OK == return_code)
+	{
+		cmzn_streamresource_memory_id memoryResource = cmzn_streamresource_cast_memory(writeResource);
+		void *buffer = 0;
+		unsigned int bufferSize = 0;
+		return_code = cmzn_streamresource_memory_get_buffer(memoryResource, &buffer, &bufferSize);
+		// nothing to read if region is empty
+		if ((CMZN_OK == return_code) && (buffer) && (bufferSize > 0))
+		{
+			cmzn_streaminformation_id readInformation =
+				cmzn_region_create_streaminformation_region(fork);
+			cmzn_streamresource_id readResource = cmzn_streaminformation_create_streamresource_memory_buffer(
+				readInformation, buffer, bufferSize);
+			cmzn_streaminformation_region_id readInformationRegion =
+				cmzn_streaminformation_cast_region(readInformation);
+			return_code = cmzn_region_read(fork, readInformationRegion);
+			cmzn_streaminformation_region_destroy(&readInformationRegion);
+			cmzn_streamresource_destroy(&readResource);
+			cmzn_streaminformation_destroy(&readInformation);
+		}
+		cmzn_streamresource_memory_destroy(&memoryResource);
+	}
+	cmzn_streaminformation_region_destroy(&writeInformationRegion);
+	cmzn_streamresource_destroy(&writeResource);
+	cmzn_streaminformation_destroy(&writeInformation);
+	if (CMZN_OK != return_code)
+	{
+		display_message(ERROR_MESSAGE, "cmzn_region_create_fork.  Failed to copy region");
+		cmzn_region_destroy(&fork);
+	}
+	return fork;
+}
+
 cmzn_streaminformation_id cmzn_region_create_streaminformation_region(struct cmzn_region *region)
 {
 	if (region)
@@ -0,0 +1,80 @@
+/*
+ * OpenCMISS-Zinc Library Benchmarks
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+// Times field cache creation and destruction, and first evaluation of many
+// fields, for a region with thousands of fields. Run by hand; not a test.
+
+#include <opencmiss/zinc/context.hpp>
+#include <opencmiss/zinc/element.hpp>
+#include <opencmiss/zinc/field.hpp>
+#include <opencmiss/zinc/fieldarithmeticoperators.hpp>
+#include <opencmiss/zinc/fieldcache.hpp>
+#include <opencmiss/zinc/fieldconstant.hpp>
+#include <opencmiss/zinc/fieldmodule.hpp>
+#include <opencmiss/zinc/mesh.hpp>
+#include <opencmiss/zinc/region.hpp>
+#include <opencmiss/zinc/result.hpp>
+#include "test_resources.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace OpenCMISS::Zinc;
+
+int main()
+{
+	Context context("benchmark");
+	Region region = context.getDefaultRegion();
+	Fieldmodule fm = region.getFieldmodule();
+	if (RESULT_OK != region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)))
+	{
+		printf("Failed to read model\n");
+		return 1;
+	}
+	Field coordinates = fm.findFieldByName("coordinates");
+	Element element = fm.findMeshByDimension(3).findElementByIdentifier(2);
+	if (!((coordinates.isValid()) && (element.isValid())))
+	{
+		printf("Model is missing coordinates or element 2\n");
+		return 1;
+	}
+
+	const int fieldCount = 2000;
+	std::vector<Field> fields(fieldCount);
+	fm.beginChange();
+	for (int i = 0; i < fieldCount; ++i)
+	{
+		const double offsets[3] = { static_cast<double>(i), 0.0, 0.0 };
+		Field offset = fm.createFieldConstant(3, offsets);
+		fields[i] = coordinates + offset;
+	}
+	fm.endChange();
+
+	const int cacheCount = 1000;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < cacheCount; ++i)
+		Fieldcache fieldcache = fm.createFieldcache();
+	const double createDestroyTime = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+
+	const double xi[3] = { 0.5, 0.5, 0.5 };
+	double x[3];
+	start = std::chrono::steady_clock::now();
+	Fieldcache fieldcache = fm.createFieldcache();
+	fieldcache.setMeshLocation(element, 3, xi);
+	for (int i = 0; i < fieldCount; ++i)
+		fields[i].evaluateReal(fieldcache, 3, x);
+	const double firstEvaluateTime = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+
+	printf("Fieldcache benchmark with %d added fields: create/destroy %g s per cache, "
+		"first evaluation of all fields %g s\n", 2*fieldCount,
+		createDestroyTime/cacheCount, firstEvaluateTime);
+	return 0;
+}
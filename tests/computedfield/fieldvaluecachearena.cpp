@@ -0,0 +1,121 @@
+/*
+ * OpenCMISS-Zinc Library Unit Tests
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include "computed_field/field_value_cache_arena.hpp"
+
+#include <vector>
+
+TEST(FieldValueCacheArena, allocateFromBlocks)
+{
+	// first block sized for 100 fields of 3 values and derivatives
+	FieldValueCacheArena arena(100);
+	EXPECT_EQ(0, arena.getCapacity());
+	EXPECT_EQ(0, arena.getBlockCount());
+	const int firstBlockSize = 100*3*(1 + MAXIMUM_ELEMENT_XI_DIMENSIONS);
+
+	FE_value *array1 = arena.allocate(3);
+	FE_value *array2 = arena.allocate(9);
+	EXPECT_EQ(2, arena.getLiveArrayCount());
+	EXPECT_EQ(1, arena.getBlockCount());
+	EXPECT_EQ(firstBlockSize, arena.getCapacity());
+	// arrays are consecutive in block
+	EXPECT_EQ(array1 + 3, array2);
+	for (int i = 0; i < 3; ++i)
+		array1[i] = static_cast<FE_value>(i);
+	for (int i = 0; i < 9; ++i)
+		array2[i] = static_cast<FE_value>(10 + i);
+
+	// fill first block; next block is twice the size
+	const int remainder = firstBlockSize - 12;
+	FE_value *array3 = arena.allocate(remainder);
+	EXPECT_EQ(array2 + 9, array3);
+	EXPECT_EQ(1, arena.getBlockCount());
+	FE_value *array4 = arena.allocate(1);
+	EXPECT_EQ(2, arena.getBlockCount());
+	EXPECT_EQ(3*firstBlockSize, arena.getCapacity());
+	EXPECT_EQ(4, arena.getLiveArrayCount());
+	array4[0] = -1.0;
+	for (int i = 0; i < 3; ++i)
+		EXPECT_EQ(static_cast<FE_value>(i), array1[i]);
+	for (int i = 0; i < 9; ++i)
+		EXPECT_EQ(static_cast<FE_value>(10 + i), array2[i]);
+
+	// minimum block size and zero size requests
+	FieldValueCacheArena smallArena(0);
+	EXPECT_NE(static_cast<FE_value *>(0), smallArena.allocate(0));
+	EXPECT_EQ(256, smallArena.getCapacity());
+	// oversize request gets a block of its own size
+	smallArena.allocate(1000);
+	EXPECT_EQ(256 + 1000, smallArena.getCapacity());
+}
+
+TEST(FieldValueCacheArena, reuseReleasedArrays)
+{
+	FieldValueCacheArena arena(10);
+	FE_value *array1 = arena.allocate(3);
+	FE_value *array2 = arena.allocate(12);
+	FE_value *array3 = arena.allocate(3);
+	const int capacity = arena.getCapacity();
+
+	// released arrays are reused for the same size only
+	EXPECT_TRUE(arena.release(array1, 3));
+	EXPECT_EQ(2, arena.getLiveArrayCount());
+	FE_value *array4 = arena.allocate(12);
+	EXPECT_NE(array1, array4);
+	EXPECT_NE(array2, array4);
+	FE_value *array5 = arena.allocate(3);
+	EXPECT_EQ(array1, array5);
+	EXPECT_TRUE(arena.release(array2, 12));
+	EXPECT_EQ(array2, arena.allocate(12));
+	EXPECT_EQ(capacity, arena.getCapacity());
+	EXPECT_EQ(4, arena.getLiveArrayCount());
+	// releasing no array is harmless
+	EXPECT_TRUE(arena.release(0, 3));
+	EXPECT_EQ(4, arena.getLiveArrayCount());
+
+	// arena rewinds to start of single block when no arrays in use
+	EXPECT_TRUE(arena.release(array2, 12));
+	EXPECT_TRUE(arena.release(array3, 3));
+	EXPECT_TRUE(arena.release(array4, 12));
+	EXPECT_TRUE(arena.release(array5, 3));
+	EXPECT_EQ(0, arena.getLiveArrayCount());
+	EXPECT_EQ(array1, arena.allocate(3));
+	EXPECT_EQ(capacity, arena.getCapacity());
+	EXPECT_EQ(1, arena.getBlockCount());
+}
+
+TEST(FieldValueCacheArena, rewindToSingleBlock)
+{
+	FieldValueCacheArena arena(0);
+	std::vector<FE_value *> arrays;
+	for (int i = 0; i < 100; ++i)
+		arrays.push_back(arena.allocate(12));
+	EXPECT_EQ(3, arena.getBlockCount());
+	const int capacity = arena.getCapacity();
+	EXPECT_EQ(256 + 512 + 1024, capacity);
+
+	// once no arrays are in use, blocks are replaced by one of total size
+	for (size_t i = 0; i < arrays.size(); ++i)
+		EXPECT_TRUE(arena.release(arrays[i], 12));
+	EXPECT_EQ(0, arena.getCapacity());
+	EXPECT_EQ(0, arena.getBlockCount());
+	arrays.clear();
+	for (int i = 0; i < 100; ++i)
+		arrays.push_back(arena.allocate(12));
+	EXPECT_EQ(1, arena.getBlockCount());
+	EXPECT_EQ(capacity, arena.getCapacity());
+	for (int i = 1; i < 100; ++i)
+		EXPECT_EQ(arrays[i - 1] + 12, arrays[i]);
+
+	// releasing more arrays than allocated fails
+	for (size_t i = 0; i < arrays.size(); ++i)
+		EXPECT_TRUE(arena.release(arrays[i], 12));
+	EXPECT_FALSE(arena.release(arrays[0], 12));
+}
@@ -0,0 +1,127 @@
+/*
+ * OpenCMISS-Zinc Library Unit Tests
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include "general/block_array.hpp"
+
+#include <thread>
+#include <vector>
+
+typedef block_array<int, int> int_block_array;
+
+namespace {
+
+void setValues(int_block_array& array, int indexCount, int offset)
+{
+	for (int i = 0; i < indexCount; ++i)
+		EXPECT_TRUE(array.setValue(i, i + offset));
+}
+
+void checkValues(const int_block_array& array, int indexCount, int offset)
+{
+	for (int i = 0; i < indexCount; ++i)
+		EXPECT_EQ(i + offset, array.getValue(i));
+}
+
+}
+
+TEST(block_array, copyOnWrite)
+{
+	const int blockLength = 8;
+	const int indexCount = 3*blockLength;
+	int_block_array source(blockLength);
+	setValues(source, indexCount, 100);
+	const size_t unsharedBytes = source.getAllocatedBytes();
+
+	int_block_array copy(source);
+	EXPECT_EQ(3, copy.getAllocatedBlockCount());
+	checkValues(copy, indexCount, 100);
+	// reading through const address does not copy blocks
+	const int_block_array& constSource = source;
+	const int_block_array& constCopy = copy;
+	EXPECT_EQ(constSource.getAddress(blockLength), constCopy.getAddress(blockLength));
+	EXPECT_GT(unsharedBytes, source.getAllocatedBytes());
+
+	// writing to source leaves copy unchanged
+	EXPECT_TRUE(source.setValue(blockLength + 1, -1));
+	EXPECT_EQ(-1, source.getValue(blockLength + 1));
+	checkValues(copy, indexCount, 100);
+	EXPECT_NE(constSource.getAddress(blockLength), constCopy.getAddress(blockLength));
+	// other blocks are still shared
+	EXPECT_EQ(constSource.getAddress(0), constCopy.getAddress(0));
+	EXPECT_EQ(constSource.getAddress(2*blockLength), constCopy.getAddress(2*blockLength));
+
+	// writing to copy leaves source unchanged
+	int *address = copy.getAddress(2);
+	ASSERT_NE(nullptr, address);
+	*address = -2;
+	EXPECT_EQ(-2, copy.getValue(2));
+	EXPECT_EQ(102, source.getValue(2));
+	EXPECT_EQ(-1, source.getValue(blockLength + 1));
+	EXPECT_EQ(blockLength + 101, copy.getValue(blockLength + 1));
+
+	// destroying or clearing one leaves the other intact
+	source.destroyBlock(2);
+	EXPECT_EQ(2, source.getAllocatedBlockCount());
+	EXPECT_EQ(3, copy.getAllocatedBlockCount());
+	EXPECT_EQ(2*blockLength + 100, copy.getValue(2*blockLength));
+	source.clear();
+	EXPECT_EQ(0, source.getAllocatedBlockCount());
+	EXPECT_EQ(-2, copy.getValue(2));
+	EXPECT_EQ(blockLength + 101, copy.getValue(blockLength + 1));
+	EXPECT_EQ(2*blockLength + 100, copy.getValue(2*blockLength));
+	// no longer sharing blocks, but keeps array of share count pointers
+	EXPECT_EQ(unsharedBytes + copy.getBlockCount()*sizeof(std::atomic<int> *), copy.getAllocatedBytes());
+}
+
+TEST(block_array, copyOfCopy)
+{
+	const int blockLength = 4;
+	const int indexCount = 2*blockLength;
+	int_block_array *source = new int_block_array(blockLength);
+	setValues(*source, indexCount, 0);
+	int_block_array copy1(*source);
+	int_block_array copy2(copy1);
+	delete source;
+	checkValues(copy1, indexCount, 0);
+	checkValues(copy2, indexCount, 0);
+	EXPECT_TRUE(copy2.setValue(0, 7));
+	EXPECT_EQ(0, copy1.getValue(0));
+	EXPECT_EQ(7, copy2.getValue(0));
+	EXPECT_TRUE(copy1.setValue(indexCount + 1, 9));
+	EXPECT_FALSE(copy2.hasValue(indexCount + 1, 9));
+}
+
+// copies sharing blocks may be written and destroyed in different threads
+TEST(block_array, threadedCopies)
+{
+	const int blockLength = 16;
+	const int indexCount = 64*blockLength;
+	const int threadCount = 4;
+	int_block_array source(blockLength);
+	setValues(source, indexCount, 0);
+	std::vector<int_block_array *> copies;
+	for (int t = 0; t < threadCount; ++t)
+		copies.push_back(new int_block_array(source));
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads.push_back(std::thread([&copies, t, indexCount]()
+		{
+			int_block_array *copy = copies[t];
+			for (int i = 0; i < indexCount; ++i)
+				copy->setValue(i, copy->getValue(i) + 1000*(t + 1));
+			delete copy;
+		}));
+	}
+	for (int t = 0; t < threadCount; ++t)
+		threads[t].join();
+	checkValues(source, indexCount, 0);
+	EXPECT_EQ(64, source.getAllocatedBlockCount());
+}
@@ -0,0 +1,197 @@
+/*
+ * OpenCMISS-Zinc Library Unit Tests
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include "datastore/maparray.hpp"
+
+#include <string>
+
+namespace {
+
+const size_t blockPointerBytes = sizeof(DsLabelIndex *);
+
+// Labels are only needed for getIndexLimit(), which is not tested here, so
+// maps are made without labels to avoid linking internal library symbols.
+class TestMapArray : public DsMapArrayLabelIndex
+{
+public:
+	TestMapArray(DsLabelIndex arraySizeIn) :
+		DsMapArrayLabelIndex(/*labels*/0, arraySizeIn, DS_LABEL_INDEX_UNALLOCATED, DS_LABEL_INDEX_INVALID)
+	{
+	}
+};
+
+void setArray(TestMapArray& map, DsLabelIndex index)
+{
+	DsLabelIndex *array = map.getOrCreateArray(index);
+	ASSERT_NE(static_cast<DsLabelIndex *>(0), array);
+	for (DsLabelIndex i = 0; i < map.getArraySize(); ++i)
+		array[i] = index*1000 + i;
+}
+
+void checkArray(const TestMapArray& map, DsLabelIndex index)
+{
+	const DsLabelIndex *array = map.getArray(index);
+	ASSERT_NE(static_cast<const DsLabelIndex *>(0), array);
+	for (DsLabelIndex i = 0; i < map.getArraySize(); ++i)
+		EXPECT_EQ(index*1000 + i, array[i]);
+}
+
+std::string storageDetails(int arrayCount, int arraySize, size_t bytes)
+{
+	char details[100];
+	snprintf(details, sizeof(details), "%d arrays of %d, %lu bytes",
+		arrayCount, arraySize, static_cast<unsigned long>(bytes));
+	return std::string(details);
+}
+
+}
+
+TEST(DsMapArray, packing)
+{
+	// 4 values of 4 bytes: 64 arrays are packed into each 1024 byte block
+	TestMapArray map(4);
+	EXPECT_EQ(4, map.getArraySize());
+	EXPECT_EQ(0, map.getAllocatedArrayCount());
+	EXPECT_EQ(0U, map.getAllocatedBytes());
+	EXPECT_EQ(storageDetails(0, 4, 0), map.getStorageDetails());
+	EXPECT_EQ(static_cast<DsLabelIndex *>(0), map.getArray(0));
+
+	DsLabelIndex *array0 = map.getOrCreateArray(0);
+	ASSERT_NE(static_cast<DsLabelIndex *>(0), array0);
+	for (DsLabelIndex i = 0; i < 4; ++i)
+		EXPECT_EQ(DS_LABEL_INDEX_INVALID, array0[i]);
+	EXPECT_EQ(array0, map.getOrCreateArray(0));
+	const size_t oneBlockBytes = 1024 + blockPointerBytes;
+	EXPECT_EQ(oneBlockBytes, map.getAllocatedBytes());
+
+	for (DsLabelIndex index = 0; index < 64; ++index)
+		setArray(map, index);
+	// arrays are contiguous in the one block
+	EXPECT_EQ(array0 + 4, map.getArray(1));
+	EXPECT_EQ(array0 + 63*4, map.getArray(63));
+	EXPECT_EQ(64, map.getAllocatedArrayCount());
+	EXPECT_EQ(oneBlockBytes, map.getAllocatedBytes());
+	EXPECT_EQ(storageDetails(64, 4, oneBlockBytes), map.getStorageDetails());
+
+	// next index starts a new block; block pointer array grows to 2
+	setArray(map, 64);
+	const size_t twoBlockBytes = 2*1024 + 2*blockPointerBytes;
+	EXPECT_EQ(65, map.getAllocatedArrayCount());
+	EXPECT_EQ(twoBlockBytes, map.getAllocatedBytes());
+	EXPECT_EQ(storageDetails(65, 4, twoBlockBytes), map.getStorageDetails());
+	for (DsLabelIndex index = 0; index <= 64; ++index)
+		checkArray(map, index);
+
+	// sparse index allocates only the block it is in
+	setArray(map, 1000);
+	EXPECT_EQ(static_cast<DsLabelIndex *>(0), map.getArray(999));
+	EXPECT_EQ(static_cast<DsLabelIndex *>(0), map.getArray(1001));
+	EXPECT_EQ(66, map.getAllocatedArrayCount());
+	EXPECT_EQ(3*1024 + 16*blockPointerBytes, map.getAllocatedBytes());
+	checkArray(map, 1000);
+}
+
+TEST(DsMapArray, packedToStandalone)
+{
+	// arrays are packed while smaller than the 1024 byte default block,
+	// otherwise each array has a block of exactly its own size
+	const struct
+	{
+		DsLabelIndex arraySize;
+		DsLabelIndex arraysPerBlock;
+	} cases[] =
+	{
+		{ 1, 256 },
+		{ 100, 2 },
+		{ 128, 2 },
+		{ 129, 1 },
+		{ 255, 1 },
+		{ 256, 1 },
+		{ 300, 1 }
+	};
+	for (size_t c = 0; c < sizeof(cases)/sizeof(cases[0]); ++c)
+	{
+		const DsLabelIndex arraySize = cases[c].arraySize;
+		const DsLabelIndex arraysPerBlock = cases[c].arraysPerBlock;
+		const size_t blockBytes = arraysPerBlock*arraySize*sizeof(DsLabelIndex);
+		TestMapArray map(arraySize);
+		setArray(map, 0);
+		EXPECT_EQ(blockBytes + blockPointerBytes, map.getAllocatedBytes());
+		if (arraysPerBlock > 1)
+		{
+			EXPECT_EQ(map.getArray(0) + arraySize, map.getOrCreateArray(1));
+		}
+		// fill two blocks
+		for (DsLabelIndex index = 0; index < 2*arraysPerBlock; ++index)
+			setArray(map, index);
+		EXPECT_EQ(2*arraysPerBlock, map.getAllocatedArrayCount());
+		const size_t twoBlockBytes = 2*blockBytes + 2*blockPointerBytes;
+		EXPECT_EQ(twoBlockBytes, map.getAllocatedBytes());
+		EXPECT_EQ(storageDetails(2*arraysPerBlock, arraySize, twoBlockBytes), map.getStorageDetails());
+		for (DsLabelIndex index = 0; index < 2*arraysPerBlock; ++index)
+			checkArray(map, index);
+	}
+}
+
+TEST(DsMapArray, freeing)
+{
+	TestMapArray map(4);
+	for (DsLabelIndex index = 0; index <= 64; ++index)
+		setArray(map, index);
+	EXPECT_EQ(2*1024 + 2*blockPointerBytes, map.getAllocatedBytes());
+
+	// clearing keeps memory but marks array unallocated
+	map.clearArray(1);
+	EXPECT_EQ(static_cast<DsLabelIndex *>(0), map.getArray(1));
+	EXPECT_EQ(64, map.getAllocatedArrayCount());
+	EXPECT_EQ(2*1024 + 2*blockPointerBytes, map.getAllocatedBytes());
+	DsLabelIndex *array1 = map.getOrCreateArray(1);
+	ASSERT_NE(static_cast<DsLabelIndex *>(0), array1);
+	for (DsLabelIndex i = 0; i < 4; ++i)
+		EXPECT_EQ(DS_LABEL_INDEX_INVALID, array1[i]);
+	setArray(map, 1);
+
+	// destroying only array in block frees block
+	map.destroyArray(64);
+	EXPECT_EQ(static_cast<DsLabelIndex *>(0), map.getArray(64));
+	EXPECT_EQ(64, map.getAllocatedArrayCount());
+	EXPECT_EQ(1024 + 2*blockPointerBytes, map.getAllocatedBytes());
+
+	// block is kept until its last array is destroyed
+	for (DsLabelIndex index = 0; index < 63; ++index)
+		map.destroyArray(index);
+	EXPECT_EQ(1, map.getAllocatedArrayCount());
+	EXPECT_EQ(1024 + 2*blockPointerBytes, map.getAllocatedBytes());
+	checkArray(map, 63);
+	map.destroyArray(63);
+	EXPECT_EQ(0, map.getAllocatedArrayCount());
+	EXPECT_EQ(2*blockPointerBytes, map.getAllocatedBytes());
+	EXPECT_EQ(storageDetails(0, 4, 2*blockPointerBytes), map.getStorageDetails());
+
+	// destroying unallocated array is harmless
+	map.destroyArray(5);
+	map.destroyArray(500);
+	EXPECT_EQ(2*blockPointerBytes, map.getAllocatedBytes());
+
+	// new array reallocates freed block with initial values
+	DsLabelIndex *array = map.getOrCreateArray(10);
+	ASSERT_NE(static_cast<DsLabelIndex *>(0), array);
+	for (DsLabelIndex i = 0; i < 4; ++i)
+		EXPECT_EQ(DS_LABEL_INDEX_INVALID, array[i]);
+	EXPECT_EQ(static_cast<DsLabelIndex *>(0), map.getArray(11));
+	EXPECT_EQ(1, map.getAllocatedArrayCount());
+	EXPECT_EQ(1024 + 2*blockPointerBytes, map.getAllocatedBytes());
+
+	// clear frees everything
+	map.clear();
+	EXPECT_EQ(0, map.getAllocatedArrayCount());
+	EXPECT_EQ(0U, map.getAllocatedBytes());
+	EXPECT_EQ(static_cast<DsLabelIndex *>(0), map.getArray(10));
+}
@@ -84,6 +84,31 @@ TEST(zincFieldCrossProduct, create_evaluate_2d)
 	EXPECT_FALSE(zinc.fm.createFieldCrossProduct(1, &f4).isValid());
 }
 
+TEST(zincFieldCrossProduct, evaluateAfterSourceChange)
+{
+	ZincTestSetupCpp zinc;
+
+	const double values1[] = { 1.0, 2.0 };
+	FieldConstant f1 = zinc.fm.createFieldConstant(2, values1);
+	EXPECT_TRUE(f1.isValid());
+	FieldCrossProduct f2 = zinc.fm.createFieldCrossProduct(1, &f1);
+	EXPECT_TRUE(f2.isValid());
+	// a 1-component cross product cannot be created
+	EXPECT_FALSE(zinc.fm.createFieldCrossProduct(0, &f1).isValid());
+
+	// value cache storage is reused for later evaluations in the same cache
+	Fieldcache cache = zinc.fm.createFieldcache();
+	double values[2];
+	EXPECT_EQ(CMZN_OK, f2.evaluateReal(cache, 2, values));
+	EXPECT_DOUBLE_EQ(-2.0, values[0]);
+	EXPECT_DOUBLE_EQ(1.0, values[1]);
+	const double values1b[] = { 3.0, -4.0 };
+	EXPECT_EQ(CMZN_OK, f1.assignReal(cache, 2, values1b));
+	EXPECT_EQ(CMZN_OK, f2.evaluateReal(cache, 2, values));
+	EXPECT_DOUBLE_EQ(4.0, values[0]);
+	EXPECT_DOUBLE_EQ(3.0, values[1]);
+}
+
 TEST(cmzn_field_cross_product, create_evaluate_3d)
 {
 	ZincTestSetup zinc;
@@ -17,12 +17,14 @@
 #include <opencmiss/zinc/fieldderivatives.hpp>
 #include <opencmiss/zinc/fieldlogicaloperators.hpp>
 #include <opencmiss/zinc/fieldmatrixoperators.hpp>
+#include <opencmiss/zinc/fieldtrigonometry.hpp>
 #include <opencmiss/zinc/fieldvectoroperators.hpp>
 
 #include "zinctestsetupcpp.hpp"
 
 #include "test_resources.h"
 
+#include <cmath>
 #include <limits>
 #include <sstream>
 
@@ -654,3 +656,94 @@ TEST(ZincFieldGradient, evaluateAtNodeFiniteDifference)
 		}
 	}
 }
+
+// Test exact second derivatives by forward mode automatic differentiation
+// against finite differences of first derivatives
+TEST(ZincField, secondDerivativesXi)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_CUBE_TRICUBIC_DEFORMED_RESOURCE)));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Field deformed = zinc.fm.findFieldByName("deformed");
+	EXPECT_TRUE(deformed.isValid());
+	Field temperature = zinc.fm.findFieldByName("temperature");
+	EXPECT_TRUE(temperature.isValid());
+
+	Field magnitude = zinc.fm.createFieldMagnitude(deformed);
+	Field deformed1 = zinc.fm.createFieldComponent(deformed, 1);
+	Field deformed2 = zinc.fm.createFieldComponent(deformed, 2);
+	Field coordinates1 = zinc.fm.createFieldComponent(coordinates, 1);
+	const double one = 1.0;
+	Field exponent = coordinates1 + zinc.fm.createFieldConstant(1, &one);
+	const int fieldsCount = 8;
+	Field fields[fieldsCount] =
+	{
+		deformed,
+		magnitude,
+		zinc.fm.createFieldDivide(coordinates, deformed),
+		zinc.fm.createFieldSqrt(temperature),
+		zinc.fm.createFieldAtan2(deformed1, deformed2),
+		zinc.fm.createFieldSin(zinc.fm.createFieldDotProduct(coordinates, deformed)),
+		zinc.fm.createFieldPower(magnitude, exponent),
+		zinc.fm.findFieldByName("xi")*deformed
+	};
+	for (int f = 0; f < fieldsCount; ++f)
+		EXPECT_TRUE(fields[f].isValid());
+
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element.isValid());
+	Differentialoperator d1[3], d2[9];
+	for (int i = 0; i < 3; ++i)
+	{
+		d1[i] = mesh3d.getChartDifferentialoperator(/*order*/1, i + 1);
+		EXPECT_TRUE(d1[i].isValid());
+	}
+	for (int t = 0; t < 9; ++t)
+	{
+		d2[t] = mesh3d.getChartDifferentialoperator(/*order*/2, t + 1);
+		EXPECT_TRUE(d2[t].isValid());
+	}
+	EXPECT_FALSE(mesh3d.getChartDifferentialoperator(2, 10).isValid());
+	EXPECT_FALSE(mesh3d.getChartDifferentialoperator(3, 1).isValid());
+
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	const double xi[3] = { 0.2, 0.7, 0.4 };
+	const double h = 1.0E-6;
+	double d2Values[3], plusValues[3], minusValues[3], xiPerturbed[3];
+	for (int f = 0; f < fieldsCount; ++f)
+	{
+		const int componentsCount = fields[f].getNumberOfComponents();
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j)
+			{
+				EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xi));
+				EXPECT_EQ(RESULT_OK, fields[f].evaluateDerivative(d2[i*3 + j], fieldcache, componentsCount, d2Values));
+				for (int k = 0; k < 3; ++k)
+					xiPerturbed[k] = xi[k];
+				xiPerturbed[j] = xi[j] + h;
+				EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xiPerturbed));
+				EXPECT_EQ(RESULT_OK, fields[f].evaluateDerivative(d1[i], fieldcache, componentsCount, plusValues));
+				xiPerturbed[j] = xi[j] - h;
+				EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xiPerturbed));
+				EXPECT_EQ(RESULT_OK, fields[f].evaluateDerivative(d1[i], fieldcache, componentsCount, minusValues));
+				for (int c = 0; c < componentsCount; ++c)
+				{
+					const double finiteDifference = (plusValues[c] - minusValues[c])/(2.0*h);
+					EXPECT_NEAR(finiteDifference, d2Values[c], 1.0E-4*(1.0 + fabs(finiteDifference)));
+				}
+			}
+	}
+
+	// fields not supporting automatic differentiation fail
+	Field sourceFields[2] = { coordinates, deformed };
+	Field crossProduct = zinc.fm.createFieldCrossProduct(2, sourceFields);
+	EXPECT_TRUE(crossProduct.isValid());
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xi));
+	EXPECT_EQ(RESULT_OK, crossProduct.evaluateDerivative(d1[0], fieldcache, 3, d2Values));
+	EXPECT_EQ(RESULT_ERROR_GENERAL, crossProduct.evaluateDerivative(d2[0], fieldcache, 3, d2Values));
+}
@@ -548,3 +548,104 @@ TEST(ZincFieldassignment, assignNodeValueVersions)
 	EXPECT_EQ(RESULT_OK, fieldassignment.assign());
 	checkAssignNodeValueVersions(zinc.fm, offsetZero, scaleOne);
 }
+
+TEST(ZincFieldassignment, evaluateAssignRealNodeset)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(TestResources::getLocation(TestResources::FIELDMODULE_CUBE_RESOURCE)));
+
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	EXPECT_TRUE(nodes.isValid());
+	EXPECT_EQ(8, nodes.getSize());
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	const double offsetValues[3] = { 0.1, 0.2, -0.1 };
+	Field offset = zinc.fm.createFieldConstant(3, offsetValues);
+	EXPECT_TRUE(offset.isValid());
+	Field offsetCoordinates = coordinates + offset;
+	EXPECT_TRUE(offsetCoordinates.isValid());
+
+	Fieldcache cache = zinc.fm.createFieldcache();
+	EXPECT_TRUE(cache.isValid());
+	Node node3 = nodes.findNodeByIdentifier(3);
+	EXPECT_EQ(RESULT_OK, cache.setNode(node3));
+
+	// finite element field read directly from nodes, and derived field evaluated per node
+	double x[24], offsetx[24], pointx[3];
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealNodeset(cache, nodes, 24, x));
+	EXPECT_EQ(RESULT_OK, offsetCoordinates.evaluateRealNodeset(cache, nodes, 24, offsetx));
+	Fieldcache pointcache = zinc.fm.createFieldcache();
+	for (int n = 0; n < 8; ++n)
+	{
+		EXPECT_EQ(RESULT_OK, pointcache.setNode(nodes.findNodeByIdentifier(n + 1)));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(pointcache, 3, pointx));
+		for (int c = 0; c < 3; ++c)
+		{
+			EXPECT_EQ(pointx[c], x[n*3 + c]);
+			EXPECT_DOUBLE_EQ(pointx[c] + offsetValues[c], offsetx[n*3 + c]);
+		}
+	}
+	// check location in cache is unchanged
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 3, pointx));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(x[2*3 + c], pointx[c]);
+
+	// assign and read back
+	EXPECT_EQ(RESULT_OK, coordinates.assignRealNodeset(cache, nodes, 24, offsetx));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealNodeset(cache, nodes, 24, x));
+	for (int i = 0; i < 24; ++i)
+		EXPECT_EQ(offsetx[i], x[i]);
+	for (int n = 0; n < 8; ++n)
+	{
+		EXPECT_EQ(RESULT_OK, pointcache.setNode(nodes.findNodeByIdentifier(n + 1)));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(pointcache, 3, pointx));
+		for (int c = 0; c < 3; ++c)
+			EXPECT_EQ(offsetx[n*3 + c], pointx[c]);
+	}
+
+	// nodeset group visited in identifier order
+	FieldNodeGroup nodeGroup = zinc.fm.createFieldNodeGroup(nodes);
+	EXPECT_TRUE(nodeGroup.isValid());
+	NodesetGroup nodesetGroup = nodeGroup.getNodesetGroup();
+	EXPECT_TRUE(nodesetGroup.isValid());
+	const int groupIdentifiers[3] = { 7, 2, 5 };
+	for (int i = 0; i < 3; ++i)
+		EXPECT_EQ(RESULT_OK, nodesetGroup.addNode(nodes.findNodeByIdentifier(groupIdentifiers[i])));
+	double groupx[9];
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealNodeset(cache, nodesetGroup, 9, groupx));
+	const int sortedIdentifiers[3] = { 2, 5, 7 };
+	for (int i = 0; i < 3; ++i)
+		for (int c = 0; c < 3; ++c)
+			EXPECT_EQ(x[(sortedIdentifiers[i] - 1)*3 + c], groupx[i*3 + c]);
+	const double zeroValues[9] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+	EXPECT_EQ(RESULT_OK, coordinates.assignRealNodeset(cache, nodesetGroup, 9, zeroValues));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealNodeset(cache, nodes, 24, offsetx));
+	for (int n = 0; n < 8; ++n)
+	{
+		const bool inGroup = (n == 1) || (n == 4) || (n == 6);
+		for (int c = 0; c < 3; ++c)
+			EXPECT_EQ(inGroup ? 0.0 : x[n*3 + c], offsetx[n*3 + c]);
+	}
+
+	// add node without field to get partial results
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	Node node9 = nodes.createNode(9, nodetemplate);
+	EXPECT_TRUE(node9.isValid());
+	double x9[27];
+	x9[24] = x9[25] = x9[26] = -1.0;
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealNodeset(cache, nodes, 24, x9));
+	EXPECT_EQ(RESULT_WARNING_PART_DONE, coordinates.evaluateRealNodeset(cache, nodes, 27, x9));
+	EXPECT_EQ(-1.0, x9[24]);
+	EXPECT_EQ(RESULT_WARNING_PART_DONE, offsetCoordinates.evaluateRealNodeset(cache, nodes, 27, x9));
+	EXPECT_EQ(RESULT_WARNING_PART_DONE, coordinates.assignRealNodeset(cache, nodes, 27, x9));
+	EXPECT_EQ(RESULT_OK, nodesetGroup.removeAllNodes());
+	EXPECT_EQ(RESULT_OK, nodesetGroup.addNode(node9));
+	EXPECT_EQ(RESULT_ERROR_NOT_FOUND, coordinates.evaluateRealNodeset(cache, nodesetGroup, 3, x9));
+
+	// invalid arguments
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealNodeset(cache, nodes, 27, 0));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealNodeset(cache, Nodeset(), 27, x9));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.assignRealNodeset(cache, nodes, 26, x9));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.assignRealNodeset(Fieldcache(), nodes, 27, x9));
+}
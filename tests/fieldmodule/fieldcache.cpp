@@ -0,0 +1,974 @@
+/*
+ * OpenCMISS-Zinc Library Unit Tests
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include <opencmiss/zinc/core.h>
+#include <opencmiss/zinc/differentialoperator.hpp>
+#include <opencmiss/zinc/element.hpp>
+#include <opencmiss/zinc/field.hpp>
+#include <opencmiss/zinc/fieldarithmeticoperators.hpp>
+#include <opencmiss/zinc/fieldcache.hpp>
+#include <opencmiss/zinc/fieldcomposite.hpp>
+#include <opencmiss/zinc/fieldconstant.hpp>
+#include <opencmiss/zinc/fieldfiniteelement.hpp>
+#include <opencmiss/zinc/fieldnodesetoperators.hpp>
+#include <opencmiss/zinc/fieldtrigonometry.hpp>
+#include <opencmiss/zinc/fieldvectoroperators.hpp>
+#include <opencmiss/zinc/logger.hpp>
+#include <opencmiss/zinc/mesh.hpp>
+#include <opencmiss/zinc/node.hpp>
+#include <opencmiss/zinc/nodeset.hpp>
+
+#include "zinctestsetupcpp.hpp"
+
+#include "test_resources.h"
+
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ZincFieldcache, evaluateRealBatch)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_CUBE_TRICUBIC_DEFORMED_RESOURCE)));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Field deformed = zinc.fm.findFieldByName("deformed");
+	EXPECT_TRUE(deformed.isValid());
+	Field temperature = zinc.fm.findFieldByName("temperature");
+	EXPECT_TRUE(temperature.isValid());
+	const double offsetValues[3] = { 1.5, 2.5, 3.5 };
+	Field offset = zinc.fm.createFieldConstant(3, offsetValues);
+	EXPECT_TRUE(offset.isValid());
+	const double scaleValue = 0.01;
+	Field scale = zinc.fm.createFieldConstant(1, &scaleValue);
+	EXPECT_TRUE(scale.isValid());
+	Field scaledTemperature = temperature*scale;
+	EXPECT_TRUE(scaledTemperature.isValid());
+	Field deformed_temperature_array[2] = { deformed, temperature };
+
+	// mix of field types with batch implementations and those using the generic fallback
+	const int fieldsCount = 15;
+	Field fields[fieldsCount] =
+	{
+		coordinates,
+		deformed + coordinates,
+		deformed - coordinates,
+		deformed*coordinates,
+		(deformed + offset)/(coordinates + offset),
+		zinc.fm.createFieldSqrt(temperature),
+		zinc.fm.createFieldExp(scaledTemperature),
+		zinc.fm.createFieldSin(scaledTemperature),
+		zinc.fm.createFieldAtan2(deformed, coordinates + offset),
+		zinc.fm.createFieldConcatenate(2, deformed_temperature_array),
+		zinc.fm.createFieldSumComponents(deformed),
+		zinc.fm.createFieldDotProduct(coordinates, deformed),
+		zinc.fm.createFieldMagnitude(deformed + offset),
+		zinc.fm.createFieldCrossProduct(coordinates + offset, deformed),
+		zinc.fm.createFieldNormalise(deformed + offset)
+	};
+	for (int f = 0; f < fieldsCount; ++f)
+		EXPECT_TRUE(fields[f].isValid());
+
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	EXPECT_TRUE(mesh3d.isValid());
+	const int elementsCount = mesh3d.getSize();
+	EXPECT_LT(0, elementsCount);
+	Differentialoperator d_dxi[3];
+	for (int d = 0; d < 3; ++d)
+	{
+		d_dxi[d] = mesh3d.getChartDifferentialoperator(/*order*/1, /*term*/d + 1);
+		EXPECT_TRUE(d_dxi[d].isValid());
+	}
+
+	// several locations per element, revisiting first element at end
+	const double xiPoints[5][3] =
+	{
+		{ 0.0, 0.0, 0.0 },
+		{ 0.25, 0.5, 0.75 },
+		{ 0.9, 0.1, 0.6 },
+		{ 1.0, 1.0, 1.0 },
+		{ 0.5, 0.5, 0.5 }
+	};
+	std::vector<Element> elements;
+	std::vector<double> xi;
+	Elementiterator iter = mesh3d.createElementiterator();
+	Element element;
+	while ((element = iter.next()).isValid())
+	{
+		for (int i = 0; i < 5; ++i)
+		{
+			elements.push_back(element);
+			xi.insert(xi.end(), xiPoints[i], xiPoints[i] + 3);
+		}
+	}
+	elements.push_back(elements[0]);
+	xi.insert(xi.end(), xiPoints[1], xiPoints[1] + 3);
+	const int locationsCount = static_cast<int>(elements.size());
+
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(elements[0], 3, xiPoints[2]));
+	double initialValues[3];
+	EXPECT_EQ(RESULT_OK, deformed.evaluateReal(fieldcache, 3, initialValues));
+
+	const double tolerance = 1.0E-12;
+	for (int f = 0; f < fieldsCount; ++f)
+	{
+		const int componentsCount = fields[f].getNumberOfComponents();
+		const int valuesCount = locationsCount*componentsCount;
+		std::vector<double> values(valuesCount);
+		std::vector<double> derivatives(valuesCount*3);
+		std::vector<double> valuesOnly(valuesCount);
+		EXPECT_EQ(RESULT_OK, fields[f].evaluateRealBatch(fieldcache, locationsCount, elements.data(),
+			3, xi.data(), valuesCount, values.data(), valuesCount*3, derivatives.data()));
+		EXPECT_EQ(RESULT_OK, fields[f].evaluateRealBatch(fieldcache, locationsCount, elements.data(),
+			3, xi.data(), valuesCount, valuesOnly.data()));
+		Fieldcache pointcache = zinc.fm.createFieldcache();
+		double pointValues[4], pointDerivatives[4];
+		for (int p = 0; p < locationsCount; ++p)
+		{
+			EXPECT_EQ(RESULT_OK, pointcache.setMeshLocation(elements[p], 3, xi.data() + p*3));
+			EXPECT_EQ(RESULT_OK, fields[f].evaluateReal(pointcache, componentsCount, pointValues));
+			for (int c = 0; c < componentsCount; ++c)
+			{
+				EXPECT_NEAR(pointValues[c], values[p*componentsCount + c], tolerance);
+				EXPECT_NEAR(pointValues[c], valuesOnly[p*componentsCount + c], tolerance);
+			}
+			for (int d = 0; d < 3; ++d)
+			{
+				EXPECT_EQ(RESULT_OK, fields[f].evaluateDerivative(d_dxi[d], pointcache, componentsCount, pointDerivatives));
+				for (int c = 0; c < componentsCount; ++c)
+					EXPECT_NEAR(pointDerivatives[c], derivatives[(p*componentsCount + c)*3 + d], tolerance);
+			}
+		}
+	}
+
+	// check location in cache and cached values not disturbed by batch evaluation
+	double finalValues[3];
+	EXPECT_EQ(RESULT_OK, deformed.evaluateReal(fieldcache, 3, finalValues));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_DOUBLE_EQ(initialValues[c], finalValues[c]);
+
+	// test invalid arguments
+	double values[12], derivatives[36];
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, deformed.evaluateRealBatch(fieldcache, 0, elements.data(), 3, xi.data(), 12, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, deformed.evaluateRealBatch(fieldcache, 4, 0, 3, xi.data(), 12, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, deformed.evaluateRealBatch(fieldcache, 4, elements.data(), 2, xi.data(), 12, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, deformed.evaluateRealBatch(fieldcache, 4, elements.data(), 3, 0, 12, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, deformed.evaluateRealBatch(fieldcache, 4, elements.data(), 3, xi.data(), 11, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, deformed.evaluateRealBatch(fieldcache, 4, elements.data(), 3, xi.data(), 12, 0));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, deformed.evaluateRealBatch(fieldcache, 4, elements.data(), 3, xi.data(), 12, values, 35, derivatives));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, deformed.evaluateRealBatch(fieldcache, 4, elements.data(), 3, xi.data(), 12, values, 36, 0));
+	EXPECT_EQ(RESULT_OK, deformed.evaluateRealBatch(fieldcache, 4, elements.data(), 3, xi.data(), 12, values, 36, derivatives));
+}
+
+// batches of locations forming tensor product grids in each element are
+// evaluated by sum factorisation; check against evaluating each location
+TEST(ZincFieldcache, evaluateRealBatchGrid)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_CUBE_TRICUBIC_DEFORMED_RESOURCE)));
+
+	const int fieldsCount = 3;
+	Field fields[fieldsCount] =
+	{
+		zinc.fm.findFieldByName("coordinates"),
+		zinc.fm.findFieldByName("deformed"),
+		zinc.fm.findFieldByName("temperature")
+	};
+	for (int f = 0; f < fieldsCount; ++f)
+		EXPECT_TRUE(fields[f].isValid());
+
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	EXPECT_TRUE(mesh3d.isValid());
+	Differentialoperator d_dxi[3];
+	for (int d = 0; d < 3; ++d)
+	{
+		d_dxi[d] = mesh3d.getChartDifferentialoperator(/*order*/1, /*term*/d + 1);
+		EXPECT_TRUE(d_dxi[d].isValid());
+	}
+
+	// grid of 3 x 4 x 5 points in each element, xi1 varying fastest
+	const int numbersOfPoints[3] = { 3, 4, 5 };
+	std::vector<Element> elements;
+	std::vector<double> xi;
+	Elementiterator iter = mesh3d.createElementiterator();
+	Element element;
+	while ((element = iter.next()).isValid())
+	{
+		for (int k = 0; k < numbersOfPoints[2]; ++k)
+			for (int j = 0; j < numbersOfPoints[1]; ++j)
+				for (int i = 0; i < numbersOfPoints[0]; ++i)
+				{
+					elements.push_back(element);
+					xi.push_back(i/static_cast<double>(numbersOfPoints[0] - 1));
+					xi.push_back(0.1 + 0.25*j);
+					xi.push_back(0.05 + 0.2*k);
+				}
+	}
+	const int locationsCount = static_cast<int>(elements.size());
+
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	Fieldcache pointcache = zinc.fm.createFieldcache();
+	// summation order differs from per-location evaluation
+	const double tolerance = 1.0E-10;
+	for (int f = 0; f < fieldsCount; ++f)
+	{
+		const int componentsCount = fields[f].getNumberOfComponents();
+		const int valuesCount = locationsCount*componentsCount;
+		std::vector<double> values(valuesCount);
+		std::vector<double> derivatives(valuesCount*3);
+		EXPECT_EQ(RESULT_OK, fields[f].evaluateRealBatch(fieldcache, locationsCount, elements.data(),
+			3, xi.data(), valuesCount, values.data(), valuesCount*3, derivatives.data()));
+		double pointValues[3], pointDerivatives[3];
+		for (int p = 0; p < locationsCount; ++p)
+		{
+			EXPECT_EQ(RESULT_OK, pointcache.setMeshLocation(elements[p], 3, xi.data() + p*3));
+			EXPECT_EQ(RESULT_OK, fields[f].evaluateReal(pointcache, componentsCount, pointValues));
+			for (int c = 0; c < componentsCount; ++c)
+				EXPECT_NEAR(pointValues[c], values[p*componentsCount + c], tolerance);
+			for (int d = 0; d < 3; ++d)
+			{
+				EXPECT_EQ(RESULT_OK, fields[f].evaluateDerivative(d_dxi[d], pointcache, componentsCount, pointDerivatives));
+				for (int c = 0; c < componentsCount; ++c)
+					EXPECT_NEAR(pointDerivatives[c], derivatives[(p*componentsCount + c)*3 + d], tolerance);
+			}
+		}
+	}
+}
+
+TEST(ZincFieldcache, compiledEvaluation)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_CUBE_TRICUBIC_DEFORMED_RESOURCE)));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Field deformed = zinc.fm.findFieldByName("deformed");
+	EXPECT_TRUE(deformed.isValid());
+	const double offsetValues[3] = { 1.5, 2.5, 3.5 };
+	Field offset = zinc.fm.createFieldConstant(3, offsetValues);
+	EXPECT_TRUE(offset.isValid());
+	const double scaleValue = 0.25;
+	Field scale = zinc.fm.createFieldConstant(1, &scaleValue);
+	EXPECT_TRUE(scale.isValid());
+
+	// expression with common sub-expressions and leaf fields used several times
+	Field displacement = deformed - coordinates;
+	Field shifted = coordinates + offset;
+	Field shiftedx = zinc.fm.createFieldComponent(shifted, 1);
+	Field magnitude = zinc.fm.createFieldMagnitude(shifted);
+	Field parts[3] =
+	{
+		zinc.fm.createFieldSqrt(zinc.fm.createFieldDotProduct(displacement, displacement) + scale),
+		zinc.fm.createFieldSin(magnitude*scale) + zinc.fm.createFieldAtan2(shiftedx, magnitude),
+		zinc.fm.createFieldSumComponents(zinc.fm.createFieldExp(displacement*displacement)/shifted)
+	};
+	Field expression = zinc.fm.createFieldConcatenate(3, parts);
+	EXPECT_TRUE(expression.isValid());
+	EXPECT_FALSE(expression.isCompiledEvaluation());
+
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element.isValid());
+	Differentialoperator d_dxi1 = mesh3d.getChartDifferentialoperator(/*order*/1, /*term*/1);
+	const double xiPoints[3][3] =
+	{
+		{ 0.0, 0.0, 0.0 },
+		{ 0.25, 0.5, 0.75 },
+		{ 0.9, 0.1, 0.6 }
+	};
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	double expectedValues[3][3], expectedDerivatives[3][3];
+	for (int p = 0; p < 3; ++p)
+	{
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xiPoints[p]));
+		EXPECT_EQ(RESULT_OK, expression.evaluateReal(fieldcache, 3, expectedValues[p]));
+		EXPECT_EQ(RESULT_OK, expression.evaluateDerivative(d_dxi1, fieldcache, 3, expectedDerivatives[p]));
+	}
+
+	EXPECT_EQ(RESULT_OK, expression.setCompiledEvaluation(true));
+	EXPECT_TRUE(expression.isCompiledEvaluation());
+	const double tolerance = 1.0E-12;
+	double values[3], derivatives[3];
+	for (int p = 0; p < 3; ++p)
+	{
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xiPoints[p]));
+		EXPECT_EQ(RESULT_OK, expression.evaluateReal(fieldcache, 3, values));
+		// derivatives are evaluated normally
+		EXPECT_EQ(RESULT_OK, expression.evaluateDerivative(d_dxi1, fieldcache, 3, derivatives));
+		for (int c = 0; c < 3; ++c)
+		{
+			EXPECT_NEAR(expectedValues[p][c], values[c], tolerance);
+			EXPECT_NEAR(expectedDerivatives[p][c], derivatives[c], tolerance);
+		}
+	}
+
+	// compiled field used as a source of another field
+	Field doubled = expression*expression;
+	double doubledValues[3];
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xiPoints[1]));
+	EXPECT_EQ(RESULT_OK, doubled.evaluateReal(fieldcache, 3, doubledValues));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_NEAR(expectedValues[1][c]*expectedValues[1][c], doubledValues[c], tolerance);
+
+	// program must be recompiled when constant in expression changes
+	const double newScaleValue = 0.5;
+	EXPECT_EQ(RESULT_OK, scale.assignReal(fieldcache, 1, &newScaleValue));
+	EXPECT_EQ(RESULT_OK, expression.evaluateReal(fieldcache, 3, values));
+	EXPECT_EQ(RESULT_OK, expression.setCompiledEvaluation(false));
+	EXPECT_FALSE(expression.isCompiledEvaluation());
+	double uncompiledValues[3];
+	EXPECT_EQ(RESULT_OK, expression.evaluateReal(fieldcache, 3, uncompiledValues));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_NEAR(uncompiledValues[c], values[c], tolerance);
+	EXPECT_GT(fabs(expectedValues[1][0] - values[0]), 1.0E-6);
+
+	// values must follow changes to node parameters of leaf fields
+	EXPECT_EQ(RESULT_OK, expression.setCompiledEvaluation(true));
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Node node = nodes.findNodeByIdentifier(1);
+	EXPECT_TRUE(node.isValid());
+	EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+	EXPECT_EQ(RESULT_OK, expression.evaluateReal(fieldcache, 3, values));
+	const double newDeformed[3] = { -0.1, 0.2, 0.15 };
+	EXPECT_EQ(RESULT_OK, deformed.assignReal(fieldcache, 3, newDeformed));
+	double newValues[3];
+	EXPECT_EQ(RESULT_OK, expression.evaluateReal(fieldcache, 3, newValues));
+	EXPECT_EQ(RESULT_OK, expression.setCompiledEvaluation(false));
+	EXPECT_EQ(RESULT_OK, expression.evaluateReal(fieldcache, 3, uncompiledValues));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_NEAR(uncompiledValues[c], newValues[c], tolerance);
+	EXPECT_GT(fabs(values[0] - newValues[0]), 1.0E-6);
+
+	// only real fields support compiled evaluation
+	Field stringField = zinc.fm.createFieldStringConstant("compiled");
+	EXPECT_TRUE(stringField.isValid());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, stringField.setCompiledEvaluation(true));
+	EXPECT_FALSE(stringField.isCompiledEvaluation());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, Field().setCompiledEvaluation(true));
+}
+
+namespace {
+
+const int THREAD_POINTS_COUNT = 50;
+
+/** Evaluates fields at mesh locations and nodes with its own field cache, and
+ * counts results differing from expected values evaluated serially */
+void evaluateConcurrently(Fieldmodule fm, Field expression, Field coordinates,
+	Field nodesetSum, Element element, Differentialoperator d_dxi1,
+	const double *xi, const double *expectedValues, const double *expectedDerivatives,
+	const double *expectedNodeValues, double expectedSum, int iterationsCount,
+	int *mismatchesCountOut)
+{
+	const double tolerance = 1.0E-12;
+	int mismatchesCount = 0;
+	Nodeset nodes = fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	for (int i = 0; i < iterationsCount; ++i)
+	{
+		// create and destroy caches while other threads are evaluating
+		Fieldcache fieldcache = fm.createFieldcache();
+		double values[3], derivatives[3];
+		for (int p = 0; p < THREAD_POINTS_COUNT; ++p)
+		{
+			if ((RESULT_OK != fieldcache.setMeshLocation(element, 3, xi + 3*p)) ||
+				(RESULT_OK != expression.evaluateReal(fieldcache, 3, values)) ||
+				(RESULT_OK != expression.evaluateDerivative(d_dxi1, fieldcache, 3, derivatives)))
+			{
+				++mismatchesCount;
+				continue;
+			}
+			for (int c = 0; c < 3; ++c)
+				if ((fabs(values[c] - expectedValues[3*p + c]) > tolerance) ||
+					(fabs(derivatives[c] - expectedDerivatives[3*p + c]) > tolerance))
+					++mismatchesCount;
+		}
+		Nodeiterator iter = nodes.createNodeiterator();
+		Node node;
+		int n = 0;
+		while ((node = iter.next()).isValid())
+		{
+			if ((RESULT_OK != fieldcache.setNode(node)) ||
+				(RESULT_OK != coordinates.evaluateReal(fieldcache, 3, values)))
+				++mismatchesCount;
+			else
+			{
+				for (int c = 0; c < 3; ++c)
+					if (values[c] != expectedNodeValues[3*n + c])
+						++mismatchesCount;
+			}
+			++n;
+		}
+		double sum;
+		fieldcache.clearLocation();
+		if ((RESULT_OK != nodesetSum.evaluateReal(fieldcache, 1, &sum)) ||
+			(fabs(sum - expectedSum) > tolerance))
+			++mismatchesCount;
+	}
+	*mismatchesCountOut = mismatchesCount;
+}
+
+}
+
+// evaluate the same model from many threads each with its own field cache
+TEST(ZincFieldcache, concurrentEvaluation)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_CUBE_TRICUBIC_DEFORMED_RESOURCE)));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Field deformed = zinc.fm.findFieldByName("deformed");
+	EXPECT_TRUE(deformed.isValid());
+	const double scaleValue = 0.5;
+	Field scale = zinc.fm.createFieldConstant(1, &scaleValue);
+	Field displacement = deformed - coordinates;
+	Field expression = zinc.fm.createFieldCrossProduct(deformed,
+		zinc.fm.createFieldSin(displacement*scale) + coordinates);
+	EXPECT_TRUE(expression.isValid());
+	Field compiledExpression = zinc.fm.createFieldExp(zinc.fm.createFieldMagnitude(displacement))*deformed;
+	EXPECT_EQ(RESULT_OK, compiledExpression.setCompiledEvaluation(true));
+	Field sum = expression + compiledExpression;
+	EXPECT_TRUE(sum.isValid());
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	FieldNodesetSum nodesetSum = zinc.fm.createFieldNodesetSum(
+		zinc.fm.createFieldDotProduct(deformed, coordinates), nodes);
+	EXPECT_TRUE(nodesetSum.isValid());
+
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element.isValid());
+	Differentialoperator d_dxi1 = mesh3d.getChartDifferentialoperator(/*order*/1, /*term*/1);
+
+	// expected values evaluated serially
+	std::vector<double> xi(3*THREAD_POINTS_COUNT);
+	for (int p = 0; p < THREAD_POINTS_COUNT; ++p)
+	{
+		xi[3*p] = (p % 5)*0.25;
+		xi[3*p + 1] = ((p / 5) % 5)*0.25;
+		xi[3*p + 2] = (p / 25)*0.5 + 0.1;
+	}
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	std::vector<double> expectedValues(3*THREAD_POINTS_COUNT), expectedDerivatives(3*THREAD_POINTS_COUNT);
+	for (int p = 0; p < THREAD_POINTS_COUNT; ++p)
+	{
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xi.data() + 3*p));
+		EXPECT_EQ(RESULT_OK, sum.evaluateReal(fieldcache, 3, expectedValues.data() + 3*p));
+		EXPECT_EQ(RESULT_OK, sum.evaluateDerivative(d_dxi1, fieldcache, 3, expectedDerivatives.data() + 3*p));
+	}
+	const int nodesCount = nodes.getSize();
+	EXPECT_EQ(64, nodesCount);
+	std::vector<double> expectedNodeValues(3*nodesCount);
+	Nodeiterator iter = nodes.createNodeiterator();
+	Node node;
+	int n = 0;
+	while ((node = iter.next()).isValid())
+	{
+		EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, expectedNodeValues.data() + 3*n));
+		++n;
+	}
+	double expectedSum;
+	fieldcache.clearLocation();
+	EXPECT_EQ(RESULT_OK, nodesetSum.evaluateReal(fieldcache, 1, &expectedSum));
+
+	const int threadsCount = 8;
+	const int iterationsCount = 20;
+	std::vector<int> mismatchesCounts(threadsCount, -1);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadsCount; ++t)
+		threads.push_back(std::thread(evaluateConcurrently, zinc.fm, sum, coordinates,
+			nodesetSum, element, d_dxi1, xi.data(), expectedValues.data(), expectedDerivatives.data(),
+			expectedNodeValues.data(), expectedSum, iterationsCount, mismatchesCounts.data() + t));
+	for (int t = 0; t < threadsCount; ++t)
+		threads[t].join();
+	for (int t = 0; t < threadsCount; ++t)
+		EXPECT_EQ(0, mismatchesCounts[t]);
+
+	// model is still consistent after concurrent evaluation
+	double values[3];
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xi.data() + 3));
+	EXPECT_EQ(RESULT_OK, sum.evaluateReal(fieldcache, 3, values));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(expectedValues[3 + c], values[c]);
+}
+
+TEST(ZincFieldcache, sharedElementFieldValuesCache)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element1 = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element1.isValid());
+	Element element2 = mesh3d.findElementByIdentifier(2);
+	EXPECT_TRUE(element2.isValid());
+
+	const int defaultCapacity = zinc.fm.getElementFieldValuesCacheCapacity();
+	EXPECT_LT(1000, defaultCapacity);
+	EXPECT_EQ(RESULT_OK, zinc.fm.clearElementFieldValuesCache());
+	int size, hits, misses;
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(0, size);
+	EXPECT_EQ(0, hits);
+	EXPECT_EQ(0, misses);
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, zinc.fm.getElementFieldValuesCacheStatistics(0, &hits, &misses));
+
+	const double xi[3] = { 0.5, 0.5, 0.5 };
+	double x1[3], x2[3], x[3];
+	Fieldcache fieldcache1 = zinc.fm.createFieldcache();
+	EXPECT_EQ(RESULT_OK, fieldcache1.setMeshLocation(element1, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache1, 3, x1));
+	EXPECT_EQ(RESULT_OK, fieldcache1.setMeshLocation(element2, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache1, 3, x2));
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(2, size);
+	EXPECT_EQ(0, hits);
+	EXPECT_EQ(2, misses);
+
+	// another field cache shares element field values already calculated
+	Fieldcache fieldcache2 = zinc.fm.createFieldcache();
+	EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(element1, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache2, 3, x));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(x1[c], x[c]);
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(2, size);
+	EXPECT_EQ(1, hits);
+	EXPECT_EQ(2, misses);
+
+	// changing node 3, used by element 2 only, keeps values for element 1
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Node node3 = nodes.findNodeByIdentifier(3);
+	EXPECT_TRUE(node3.isValid());
+	EXPECT_EQ(RESULT_OK, fieldcache1.setNode(node3));
+	const double newNodeCoordinates[3] = { 25.0, 0.0, 0.0 };
+	EXPECT_EQ(RESULT_OK, coordinates.assignReal(fieldcache1, 3, newNodeCoordinates));
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(1, size);
+	EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(element2, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache2, 3, x));
+	EXPECT_GT(x[0], x2[0]);
+	EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(element1, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache2, 3, x));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(x1[c], x[c]);
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(2, size);
+	EXPECT_EQ(2, hits);
+	EXPECT_EQ(3, misses);
+
+	// capacity bounds number of entries, discarding least recently used
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, zinc.fm.setElementFieldValuesCacheCapacity(0));
+	EXPECT_EQ(RESULT_OK, zinc.fm.setElementFieldValuesCacheCapacity(1));
+	EXPECT_EQ(1, zinc.fm.getElementFieldValuesCacheCapacity());
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(1, size);
+	EXPECT_EQ(RESULT_OK, fieldcache1.setMeshLocation(element2, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache1, 3, x));
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(1, size);
+	EXPECT_EQ(2, hits);
+	EXPECT_EQ(4, misses);
+	EXPECT_EQ(RESULT_OK, zinc.fm.setElementFieldValuesCacheCapacity(defaultCapacity));
+}
+
+TEST(ZincFieldcache, locationMemo)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element1 = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element1.isValid());
+	Element element2 = mesh3d.findElementByIdentifier(2);
+	EXPECT_TRUE(element2.isValid());
+
+	EXPECT_EQ(0, coordinates.getLocationMemoCapacity());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.setLocationMemoCapacity(-1));
+	EXPECT_EQ(RESULT_OK, coordinates.setLocationMemoCapacity(2));
+	EXPECT_EQ(2, coordinates.getLocationMemoCapacity());
+
+	// expensive field types memoise by default
+	FieldFindMeshLocation findMeshLocation = zinc.fm.createFieldFindMeshLocation(coordinates, coordinates, mesh3d);
+	EXPECT_TRUE(findMeshLocation.isValid());
+	EXPECT_LT(0, findMeshLocation.getLocationMemoCapacity());
+
+	EXPECT_EQ(RESULT_OK, zinc.fm.clearElementFieldValuesCache());
+	int size, hits, misses;
+	const double xi[3] = { 0.5, 0.25, 0.75 };
+	double x1[3], x2[3], x[3];
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element1, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, x1));
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element2, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, x2));
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(0, hits);
+	EXPECT_EQ(2, misses);
+
+	// alternating locations restores memoised values without interpolating
+	for (int i = 0; i < 3; ++i)
+	{
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element1, 3, xi));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, x));
+		for (int c = 0; c < 3; ++c)
+			EXPECT_EQ(x1[c], x[c]);
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element2, 3, xi));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, x));
+		for (int c = 0; c < 3; ++c)
+			EXPECT_EQ(x2[c], x[c]);
+	}
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(0, hits);
+	EXPECT_EQ(2, misses);
+
+	// values with derivatives are evaluated as not memoised
+	Differentialoperator d1 = mesh3d.getChartDifferentialoperator(1, 1);
+	double dx[3];
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateDerivative(d1, fieldcache, 3, dx));
+	EXPECT_EQ(RESULT_OK, zinc.fm.getElementFieldValuesCacheStatistics(&size, &hits, &misses));
+	EXPECT_EQ(0, hits);
+	EXPECT_EQ(3, misses);
+
+	// changing node 3, used by element 2 only, clears memoised values
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Node node3 = nodes.findNodeByIdentifier(3);
+	EXPECT_TRUE(node3.isValid());
+	EXPECT_EQ(RESULT_OK, fieldcache.setNode(node3));
+	const double newNodeCoordinates[3] = { 25.0, 0.0, 0.0 };
+	EXPECT_EQ(RESULT_OK, coordinates.assignReal(fieldcache, 3, newNodeCoordinates));
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element2, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, x));
+	EXPECT_GT(x[0], x2[0]);
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element1, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, x));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(x1[c], x[c]);
+
+	// find mesh location gives same result when returning to memoised location
+	Fieldcache fieldcache2 = zinc.fm.createFieldcache();
+	double xiOut[3];
+	for (int i = 0; i < 2; ++i)
+	{
+		EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(element1, 3, xi));
+		Element elementOut = findMeshLocation.evaluateMeshLocation(fieldcache2, 3, xiOut);
+		EXPECT_EQ(element1, elementOut);
+		for (int c = 0; c < 3; ++c)
+			EXPECT_NEAR(xi[c], xiOut[c], 1.0E-6);
+		EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(element2, 3, xi));
+		elementOut = findMeshLocation.evaluateMeshLocation(fieldcache2, 3, xiOut);
+		EXPECT_EQ(element2, elementOut);
+		for (int c = 0; c < 3; ++c)
+			EXPECT_NEAR(xi[c], xiOut[c], 1.0E-6);
+	}
+
+	EXPECT_EQ(RESULT_OK, coordinates.setLocationMemoCapacity(0));
+	EXPECT_EQ(0, coordinates.getLocationMemoCapacity());
+}
+
+// Value caches of all fields of a field cache share arena storage. Check
+// values are correct for many fields, in many field caches, and after fields
+// are added so value caches are discarded and their storage reused.
+TEST(ZincFieldcache, manyFieldsValueCacheStorage)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)));
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element2 = mesh3d.findElementByIdentifier(2);
+	EXPECT_TRUE(element2.isValid());
+
+	const int fieldCount = 500;
+	std::vector<Field> fields(fieldCount);
+	EXPECT_EQ(RESULT_OK, zinc.fm.beginChange());
+	for (int i = 0; i < fieldCount; ++i)
+	{
+		const double offsets[3] = { static_cast<double>(i), 0.0, 0.0 };
+		Field offset = zinc.fm.createFieldConstant(3, offsets);
+		fields[i] = coordinates + offset;
+		EXPECT_TRUE(fields[i].isValid());
+	}
+	EXPECT_EQ(RESULT_OK, zinc.fm.endChange());
+
+	const double xi[3] = { 0.5, 0.25, 0.75 };
+	double x0[3], x[3], dx0[3], dx[3];
+	Differentialoperator d1 = mesh3d.getChartDifferentialoperator(1, 1);
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element2, 3, xi));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, x0));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateDerivative(d1, fieldcache, 3, dx0));
+	for (int i = 0; i < fieldCount; ++i)
+	{
+		EXPECT_EQ(RESULT_OK, fields[i].evaluateReal(fieldcache, 3, x));
+		EXPECT_DOUBLE_EQ(x0[0] + static_cast<double>(i), x[0]);
+		EXPECT_DOUBLE_EQ(x0[1], x[1]);
+		EXPECT_DOUBLE_EQ(x0[2], x[2]);
+		EXPECT_EQ(RESULT_OK, fields[i].evaluateDerivative(d1, fieldcache, 3, dx));
+		for (int c = 0; c < 3; ++c)
+			EXPECT_DOUBLE_EQ(dx0[c], dx[c]);
+	}
+	// earlier values are not overwritten by arrays given to later fields
+	EXPECT_EQ(RESULT_OK, fields[0].evaluateReal(fieldcache, 3, x));
+	EXPECT_DOUBLE_EQ(x0[0], x[0]);
+
+	// many short-lived field caches
+	for (int j = 0; j < 20; ++j)
+	{
+		Fieldcache tmpFieldcache = zinc.fm.createFieldcache();
+		EXPECT_EQ(RESULT_OK, tmpFieldcache.setMeshLocation(element2, 3, xi));
+		EXPECT_EQ(RESULT_OK, fields[j*20].evaluateReal(tmpFieldcache, 3, x));
+		EXPECT_DOUBLE_EQ(x0[0] + static_cast<double>(j*20), x[0]);
+	}
+
+	// adding fields discards value caches, whose storage is reused
+	const int addCount = 10;
+	for (int i = 0; i < addCount; ++i)
+	{
+		const double offsets[3] = { 0.0, static_cast<double>(i + 1), 0.0 };
+		Field offset = zinc.fm.createFieldConstant(3, offsets);
+		Field field = coordinates + offset;
+		EXPECT_TRUE(field.isValid());
+		EXPECT_EQ(RESULT_OK, field.evaluateReal(fieldcache, 3, x));
+		EXPECT_DOUBLE_EQ(x0[0], x[0]);
+		EXPECT_DOUBLE_EQ(x0[1] + static_cast<double>(i + 1), x[1]);
+		EXPECT_EQ(RESULT_OK, fields[fieldCount - 1 - i].evaluateReal(fieldcache, 3, x));
+		EXPECT_DOUBLE_EQ(x0[0] + static_cast<double>(fieldCount - 1 - i), x[0]);
+		EXPECT_DOUBLE_EQ(x0[1], x[1]);
+	}
+}
+
+TEST(ZincFieldcache, profiling)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Field magnitude = zinc.fm.createFieldMagnitude(coordinates);
+	EXPECT_TRUE(magnitude.isValid());
+	EXPECT_EQ(RESULT_OK, magnitude.setName("magnitude"));
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element1 = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element1.isValid());
+
+	// field cache created before profiling is enabled also records
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+
+	EXPECT_FALSE(zinc.fm.isProfilingEnabled());
+	EXPECT_EQ(static_cast<char *>(0), zinc.fm.writeProfileReport());
+	EXPECT_EQ(RESULT_ERROR_NOT_FOUND, zinc.fm.resetProfile());
+	EXPECT_EQ(RESULT_ERROR_NOT_FOUND, zinc.fm.logProfileReport());
+	EXPECT_EQ(RESULT_OK, zinc.fm.setProfilingEnabled(true));
+	EXPECT_TRUE(zinc.fm.isProfilingEnabled());
+
+	const double xi[3] = { 0.5, 0.25, 0.75 };
+	double value;
+	EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element1, 3, xi));
+	EXPECT_EQ(RESULT_OK, magnitude.evaluateReal(fieldcache, 1, &value));
+	EXPECT_EQ(RESULT_OK, magnitude.evaluateReal(fieldcache, 1, &value));
+
+	char *report = zinc.fm.writeProfileReport();
+	EXPECT_NE(static_cast<char *>(0), report);
+	std::string reportString(report);
+	cmzn_deallocate(report);
+	EXPECT_NE(std::string::npos, reportString.find("\"magnitude\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"coordinates\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"CacheHits\" : 1"));
+	EXPECT_NE(std::string::npos, reportString.find("\"ElementFieldValuesCache\""));
+
+	// profiles of destroyed field caches are kept
+	Fieldcache fieldcache2 = zinc.fm.createFieldcache();
+	EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(element1, 3, xi));
+	EXPECT_EQ(RESULT_OK, magnitude.evaluateReal(fieldcache2, 1, &value));
+	fieldcache2 = Fieldcache();
+	report = zinc.fm.writeProfileReport();
+	reportString = report;
+	cmzn_deallocate(report);
+	EXPECT_NE(std::string::npos, reportString.find("\"Evaluations\" : 3"));
+
+	Logger logger = zinc.context.getLogger();
+	const int messageCount = logger.getNumberOfMessages();
+	EXPECT_EQ(RESULT_OK, zinc.fm.logProfileReport());
+	EXPECT_EQ(messageCount + 1, logger.getNumberOfMessages());
+
+	// reset discards profile data so no fields are reported
+	EXPECT_EQ(RESULT_OK, zinc.fm.resetProfile());
+	report = zinc.fm.writeProfileReport();
+	reportString = report;
+	cmzn_deallocate(report);
+	EXPECT_EQ(std::string::npos, reportString.find("\"magnitude\""));
+
+	EXPECT_EQ(RESULT_OK, zinc.fm.setProfilingEnabled(false));
+	EXPECT_FALSE(zinc.fm.isProfilingEnabled());
+	EXPECT_EQ(static_cast<char *>(0), zinc.fm.writeProfileReport());
+	EXPECT_EQ(RESULT_OK, magnitude.evaluateReal(fieldcache, 1, &value));
+}
+
+namespace {
+
+void evaluateMagnitudeRepeatedly(Fieldmodule fieldmodule, Field magnitude,
+	Element element, int evaluationCount, int *failureCount)
+{
+	Fieldcache fieldcache = fieldmodule.createFieldcache();
+	for (int i = 0; i < evaluationCount; ++i)
+	{
+		const double xi[3] = { 0.5, 0.25, static_cast<double>(i % 11)/10.0 };
+		double value;
+		if ((RESULT_OK != fieldcache.setMeshLocation(element, 3, xi)) ||
+			(RESULT_OK != magnitude.evaluateReal(fieldcache, 1, &value)) ||
+			(RESULT_OK != magnitude.evaluateReal(fieldcache, 1, &value)))
+			++(*failureCount);
+	}
+}
+
+}
+
+// Enable, reset, report and disable profiling while other threads evaluate
+TEST(ZincFieldcache, profilingConcurrentEvaluation)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Field magnitude = zinc.fm.createFieldMagnitude(coordinates);
+	EXPECT_TRUE(magnitude.isValid());
+	EXPECT_EQ(RESULT_OK, magnitude.setName("magnitude"));
+	Element element1 = zinc.fm.findMeshByDimension(3).findElementByIdentifier(1);
+	EXPECT_TRUE(element1.isValid());
+
+	const int threadCount = 4;
+	const int evaluationCount = 5000;
+	int failureCounts[threadCount];
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+	{
+		failureCounts[t] = 0;
+		threads.push_back(std::thread(evaluateMagnitudeRepeatedly, zinc.fm, magnitude,
+			element1, evaluationCount, &(failureCounts[t])));
+	}
+	for (int i = 0; i < 50; ++i)
+	{
+		EXPECT_EQ(RESULT_OK, zinc.fm.setProfilingEnabled(true));
+		EXPECT_EQ(RESULT_OK, zinc.fm.resetProfile());
+		char *report = zinc.fm.writeProfileReport();
+		EXPECT_NE(static_cast<char *>(0), report);
+		cmzn_deallocate(report);
+		EXPECT_EQ(RESULT_OK, zinc.fm.setProfilingEnabled(false));
+	}
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads[t].join();
+		EXPECT_EQ(0, failureCounts[t]);
+	}
+}
+
+// Test component and composite fields evaluating only the components they
+// need from their sources give the same results as full evaluation
+TEST(ZincFieldcache, componentEvaluation)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_CUBE_TRICUBIC_DEFORMED_RESOURCE)));
+
+	Field deformed = zinc.fm.findFieldByName("deformed");
+	EXPECT_TRUE(deformed.isValid());
+	Field temperature = zinc.fm.findFieldByName("temperature");
+	EXPECT_TRUE(temperature.isValid());
+	Field deformed2 = zinc.fm.createFieldComponent(deformed, 2);
+	EXPECT_TRUE(deformed2.isValid());
+	const int sourceComponentIndexes[2] = { 3, 1 };
+	Field deformed31 = zinc.fm.createFieldComponent(deformed, 2, sourceComponentIndexes);
+	EXPECT_TRUE(deformed31.isValid());
+	Field concatenateFields[2] = { deformed2, temperature };
+	Field concatenate = zinc.fm.createFieldConcatenate(2, concatenateFields);
+	EXPECT_TRUE(concatenate.isValid());
+	// compiled evaluation loads only component 3 of deformed
+	Field squared = deformed31*deformed31;
+	EXPECT_TRUE(squared.isValid());
+
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element.isValid());
+	Differentialoperator d_dxi[3];
+	for (int d = 0; d < 3; ++d)
+		d_dxi[d] = mesh3d.getChartDifferentialoperator(/*order*/1, /*term*/d + 1);
+
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	const double xiList[2][3] = { { 0.2, 0.6, 0.3 }, { 0.9, 0.1, 0.5 } };
+	double x[3], dx[3][3], t, value, values[2], derivative, derivatives[2];
+	for (int p = 0; p < 2; ++p)
+	{
+		// evaluate component fields before source so only some components of it are evaluated
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xiList[p]));
+		EXPECT_EQ(RESULT_OK, deformed2.evaluateReal(fieldcache, 1, &value));
+		EXPECT_EQ(RESULT_OK, deformed31.evaluateReal(fieldcache, 2, values));
+		EXPECT_EQ(RESULT_OK, deformed.evaluateReal(fieldcache, 3, x));
+		EXPECT_EQ(x[1], value);
+		EXPECT_EQ(x[2], values[0]);
+		EXPECT_EQ(x[0], values[1]);
+		EXPECT_EQ(RESULT_OK, concatenate.evaluateReal(fieldcache, 2, values));
+		EXPECT_EQ(RESULT_OK, temperature.evaluateReal(fieldcache, 1, &t));
+		EXPECT_EQ(x[1], values[0]);
+		EXPECT_EQ(t, values[1]);
+		EXPECT_EQ(RESULT_OK, squared.evaluateReal(fieldcache, 2, values));
+		EXPECT_DOUBLE_EQ(x[2]*x[2], values[0]);
+		EXPECT_DOUBLE_EQ(x[0]*x[0], values[1]);
+
+		// derivatives
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xiList[1 - p]));
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element, 3, xiList[p]));
+		for (int d = 0; d < 3; ++d)
+		{
+			EXPECT_EQ(RESULT_OK, deformed2.evaluateDerivative(d_dxi[d], fieldcache, 1, &derivative));
+			EXPECT_EQ(RESULT_OK, deformed31.evaluateDerivative(d_dxi[d], fieldcache, 2, derivatives));
+			EXPECT_EQ(RESULT_OK, deformed.evaluateDerivative(d_dxi[d], fieldcache, 3, dx[d]));
+			EXPECT_EQ(dx[d][1], derivative);
+			EXPECT_EQ(dx[d][2], derivatives[0]);
+			EXPECT_EQ(dx[d][0], derivatives[1]);
+		}
+	}
+
+	// node location
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Node node = nodes.findNodeByIdentifier(5);
+	EXPECT_TRUE(node.isValid());
+	EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+	EXPECT_EQ(RESULT_OK, deformed31.evaluateReal(fieldcache, 2, values));
+	EXPECT_EQ(RESULT_OK, deformed.evaluateReal(fieldcache, 3, x));
+	EXPECT_EQ(x[2], values[0]);
+	EXPECT_EQ(x[0], values[1]);
+}
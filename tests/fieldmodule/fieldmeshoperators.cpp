@@ -314,6 +314,57 @@ TEST(ZincFieldMeshIntegral, midpoint_quadrature_large_numbers)
 	}
 }
 
+// Gauss point integrals interpolate finite element fields with basis functions
+// tabulated at the points; check against sums of values evaluated at each point
+TEST(ZincFieldMeshIntegral, gauss_points_tricubic_hermite)
+{
+	ZincTestSetupCpp zinc;
+	int result;
+
+	EXPECT_EQ(OK, result = zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_CUBE_TRICUBIC_DEFORMED_RESOURCE)));
+	EXPECT_EQ(OK, result = zinc.fm.defineAllFaces());
+	Field coordinateField = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinateField.isValid());
+	// integrate over xi so each point has its Gauss weight only
+	Field xiField = zinc.fm.findFieldByName("xi");
+	EXPECT_TRUE(xiField.isValid());
+
+	const double gaussXi[2] = { 0.5 - 0.5/sqrt(3.0), 0.5 + 0.5/sqrt(3.0) };
+	const int numberOfPoints = 2;
+	Fieldcache cache = zinc.fm.createFieldcache();
+	for (int dimension = 2; dimension <= 3; ++dimension)
+	{
+		Mesh mesh = zinc.fm.findMeshByDimension(dimension);
+		EXPECT_TRUE(mesh.isValid());
+		FieldMeshIntegral integralField = zinc.fm.createFieldMeshIntegral(coordinateField, xiField, mesh);
+		EXPECT_TRUE(integralField.isValid());
+		EXPECT_EQ(OK, result = integralField.setNumbersOfPoints(1, &numberOfPoints));
+
+		double expectedIntegral[3] = { 0.0, 0.0, 0.0 };
+		const int pointsCount = (dimension == 3) ? 8 : 4;
+		const double weight = (dimension == 3) ? 0.125 : 0.25;
+		Elementiterator iter = mesh.createElementiterator();
+		Element element;
+		while ((element = iter.next()).isValid())
+		{
+			for (int p = 0; p < pointsCount; ++p)
+			{
+				const double xi[3] = { gaussXi[p % 2], gaussXi[(p/2) % 2], gaussXi[p/4] };
+				EXPECT_EQ(OK, result = cache.setMeshLocation(element, dimension, xi));
+				double x[3];
+				EXPECT_EQ(OK, result = coordinateField.evaluateReal(cache, 3, x));
+				for (int c = 0; c < 3; ++c)
+					expectedIntegral[c] += weight*x[c];
+			}
+		}
+		double integral[3];
+		EXPECT_EQ(OK, result = integralField.evaluateReal(cache, 3, integral));
+		for (int c = 0; c < 3; ++c)
+			EXPECT_NEAR(expectedIntegral[c], integral[c], 1.0E-12);
+	}
+}
+
 TEST(ZincFieldMeshIntegralSquares, quadrature)
 {
 	ZincTestSetupCpp zinc;
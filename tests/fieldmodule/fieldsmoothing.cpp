@@ -9,11 +9,17 @@
 #include <gtest/gtest.h>
 
 #include <opencmiss/zinc/element.hpp>
+#include <opencmiss/zinc/elementbasis.hpp>
+#include <opencmiss/zinc/elementfieldtemplate.hpp>
+#include <opencmiss/zinc/elementtemplate.hpp>
 #include <opencmiss/zinc/field.hpp>
 #include <opencmiss/zinc/fieldcache.hpp>
 #include <opencmiss/zinc/fieldfiniteelement.hpp>
 #include <opencmiss/zinc/fieldsmoothing.hpp>
+#include <opencmiss/zinc/mesh.hpp>
 #include <opencmiss/zinc/node.hpp>
+#include <opencmiss/zinc/nodeset.hpp>
+#include <opencmiss/zinc/nodetemplate.hpp>
 #include <opencmiss/zinc/status.hpp>
 
 #include "zinctestsetupcpp.hpp"
@@ -152,3 +158,75 @@ TEST(ZincFieldsmoothing, smoothHermiteCubes)
 			EXPECT_NEAR(expectedValues3[v][c], values3[v][c], tol);
 	}
 }
+
+// Smoothing averages the delta coordinates of the elements sharing each node
+// derivative. Compare with the derivatives and interpolated values obtained
+// from those averages, and check that smoothing again gives the same result.
+TEST(ZincFieldsmoothing, smoothHermiteLineDerivatives)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement field = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/2);
+	EXPECT_TRUE(field.isValid());
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(field));
+	EXPECT_EQ(RESULT_OK, nodetemplate.setValueNumberOfVersions(field, -1, Node::VALUE_LABEL_D_DS1, 1));
+	const int nodesCount = 4;
+	const int nodeIdentifiers[nodesCount] = { 1, 2, 3, 4 };
+	const Field fields[1] = { field };
+	// per node: x, dx/ds1, y, dy/ds1 with derivatives initially zero
+	const double values[nodesCount*4] =
+	{
+		0.0, 0.0, 0.0, 0.0,
+		1.0, 0.0, 2.0, 0.0,
+		3.0, 0.0, 2.0, 0.0,
+		6.0, 0.0, -1.0, 0.0
+	};
+	EXPECT_EQ(RESULT_OK, nodes.defineNodes(nodetemplate, nodesCount, nodeIdentifiers, 1, fields, nodesCount*4, values));
+
+	Mesh mesh = zinc.fm.findMeshByDimension(1);
+	Elementbasis basis = zinc.fm.createElementbasis(1, Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE);
+	Elementfieldtemplate eft = mesh.createElementfieldtemplate(basis);
+	EXPECT_TRUE(eft.isValid());
+	Elementtemplate elementtemplate = mesh.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_LINE));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(field, -1, eft));
+	const int elementIdentifiers[3] = { 1, 2, 3 };
+	const int elementNodeIdentifiers[6] = { 1, 2, 2, 3, 3, 4 };
+	EXPECT_EQ(RESULT_OK, mesh.defineElements(elementtemplate, 3, elementIdentifiers, eft, 6, elementNodeIdentifiers));
+
+	Fieldsmoothing smoothing = zinc.fm.createFieldsmoothing();
+	EXPECT_TRUE(smoothing.isValid());
+	const double expectedDerivatives[nodesCount][2] =
+	{
+		{ 1.0, 2.0 },
+		{ 1.5, 1.0 },
+		{ 2.5, -1.5 },
+		{ 3.0, -3.0 }
+	};
+	// at xi = 0.5 in element 2
+	const double expectedValues[2] = { 1.875, 2.3125 };
+	Fieldcache cache = zinc.fm.createFieldcache();
+	double derivatives[2], x[2];
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		EXPECT_EQ(RESULT_OK, field.smooth(smoothing));
+		for (int n = 0; n < nodesCount; ++n)
+		{
+			Node node = nodes.findNodeByIdentifier(nodeIdentifiers[n]);
+			EXPECT_EQ(RESULT_OK, cache.setNode(node));
+			EXPECT_EQ(RESULT_OK, field.getNodeParameters(cache, -1, Node::VALUE_LABEL_D_DS1, 1, 2, derivatives));
+			EXPECT_DOUBLE_EQ(expectedDerivatives[n][0], derivatives[0]);
+			EXPECT_DOUBLE_EQ(expectedDerivatives[n][1], derivatives[1]);
+			EXPECT_EQ(RESULT_OK, field.evaluateReal(cache, 2, x));
+			EXPECT_DOUBLE_EQ(values[n*4], x[0]);
+			EXPECT_DOUBLE_EQ(values[n*4 + 2], x[1]);
+		}
+		const double xi = 0.5;
+		EXPECT_EQ(RESULT_OK, cache.setMeshLocation(mesh.findElementByIdentifier(2), 1, &xi));
+		EXPECT_EQ(RESULT_OK, field.evaluateReal(cache, 2, x));
+		EXPECT_DOUBLE_EQ(expectedValues[0], x[0]);
+		EXPECT_DOUBLE_EQ(expectedValues[1], x[1]);
+	}
+}
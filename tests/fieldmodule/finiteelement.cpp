@@ -26,7 +26,9 @@
 #include <opencmiss/zinc/fieldcache.hpp>
 #include <opencmiss/zinc/fieldconstant.hpp>
 #include <opencmiss/zinc/fieldmodule.hpp>
+#include <opencmiss/zinc/fieldsubobjectgroup.hpp>
 #include <opencmiss/zinc/fieldfiniteelement.hpp>
+#include <opencmiss/zinc/fieldmeshoperators.hpp>
 #include <opencmiss/zinc/fieldvectoroperators.hpp>
 #include <opencmiss/zinc/node.hpp>
 #include <opencmiss/zinc/region.hpp>
@@ -35,6 +37,8 @@
 
 #include "test_resources.h"
 
+#include <vector>
+
 TEST(cmzn_field_finite_element, create)
 {
 	ZincTestSetup zinc;
@@ -1967,6 +1971,160 @@ TEST(ZincMesh, destroyElement)
 
 namespace {
 
+/** Check element field location, neighbour along xi1 and group membership for
+  * each element in a strip of square elements 1 unit wide.
+  * Elements in even positions of elements array must be in the group.
+  * @param elementPosition  Position along the strip of each element in elements.
+  * @param identifierPosition  Position along the strip of element with each
+  * identifier from 1. */
+void checkElementStrip(int elementsCount, Element *elements, const int *elementPosition,
+	const int *identifierPosition, Fieldcache& cache, FieldFiniteElement& coordinates, MeshGroup& meshGroup)
+{
+	const double xi[2] = { 0.25, 0.75 };
+	double value[2];
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		const int position = elementPosition[e];
+		EXPECT_EQ(RESULT_OK, cache.setMeshLocation(elements[e], 2, xi));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 2, value));
+		EXPECT_DOUBLE_EQ(position + 0.25, value[0]);
+		EXPECT_DOUBLE_EQ(0.75, value[1]);
+		Element neighbour = elements[e].getNeighbour(Element::FACE_TYPE_XI1_1);
+		if (position < (elementsCount - 1))
+		{
+			EXPECT_TRUE(neighbour.isValid());
+			EXPECT_EQ(position + 1, identifierPosition[neighbour.getIdentifier() - 1]);
+		}
+		else
+			EXPECT_FALSE(neighbour.isValid());
+		EXPECT_EQ(0 == e % 2, meshGroup.containsElement(elements[e]));
+	}
+}
+
+}
+
+// tests reordering elements moves faces, parents, groups and field data,
+// and always notifies changes even if identifiers are kept
+TEST(ZincMesh, reorderElements)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/2);
+	EXPECT_TRUE(coordinates.isValid());
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(coordinates));
+	// two rows of nodes along a strip of square elements
+	const int elementsCount = 10;
+	const int rowNodesCount = elementsCount + 1;
+	double x[rowNodesCount*2*2];
+	for (int n = 0; n < rowNodesCount*2; ++n)
+	{
+		x[n*2] = static_cast<double>(n % rowNodesCount);
+		x[n*2 + 1] = static_cast<double>(n / rowNodesCount);
+	}
+	EXPECT_EQ(RESULT_OK, nodes.defineNodes(nodetemplate, rowNodesCount*2, 0, 1, &coordinates, rowNodesCount*2*2, x));
+
+	// elements have identifiers in scattered order along the strip
+	Mesh mesh2d = zinc.fm.findMeshByDimension(2);
+	Elementbasis basis = zinc.fm.createElementbasis(2, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+	Elementfieldtemplate eft = mesh2d.createElementfieldtemplate(basis);
+	Elementtemplate elementtemplate = mesh2d.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_SQUARE));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(coordinates, -1, eft));
+	int positionIdentifiers[elementsCount];
+	int nodeIdentifiers[elementsCount*4];
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		const int position = ((e + 1)*3) % elementsCount;
+		positionIdentifiers[position] = e + 1;
+		nodeIdentifiers[e*4] = position + 1;
+		nodeIdentifiers[e*4 + 1] = position + 2;
+		nodeIdentifiers[e*4 + 2] = position + rowNodesCount + 1;
+		nodeIdentifiers[e*4 + 3] = position + rowNodesCount + 2;
+	}
+	EXPECT_EQ(RESULT_OK, mesh2d.defineElements(elementtemplate, elementsCount, 0, eft, elementsCount*4, nodeIdentifiers));
+	EXPECT_EQ(RESULT_OK, zinc.fm.defineAllFaces());
+	Mesh mesh1d = zinc.fm.findMeshByDimension(1);
+	const int linesCount = elementsCount*3 + 1;
+	EXPECT_EQ(linesCount, mesh1d.getSize());
+	Element elements[elementsCount];
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		elements[e] = mesh2d.findElementByIdentifier(e + 1);
+		EXPECT_TRUE(elements[e].isValid());
+	}
+	FieldElementGroup elementGroup = zinc.fm.createFieldElementGroup(mesh2d);
+	MeshGroup meshGroup = elementGroup.getMeshGroup();
+	for (int e = 0; e < elementsCount; e += 2)
+		EXPECT_EQ(RESULT_OK, meshGroup.addElement(elements[e]));
+
+	Fieldmodulenotifier notifier = zinc.fm.createFieldmodulenotifier();
+	EXPECT_TRUE(notifier.isValid());
+	FieldmodulecallbackRecordChange recordChange;
+	EXPECT_EQ(RESULT_OK, notifier.setCallback(recordChange));
+	Fieldcache cache = zinc.fm.createFieldcache();
+
+	// check each element has the same location, neighbours and group membership
+	// elementPosition is its position along the strip for each original element
+	int elementPosition[elementsCount];
+	for (int p = 0; p < elementsCount; ++p)
+		elementPosition[positionIdentifiers[p] - 1] = p;
+	checkElementStrip(elementsCount, elements, elementPosition, elementPosition, cache, coordinates, meshGroup);
+
+	// keep identifiers: elements and fields are still notified as changed
+	EXPECT_EQ(RESULT_OK, mesh2d.reorderElements(true));
+	EXPECT_EQ(elementsCount, mesh2d.getSize());
+	EXPECT_EQ(elementsCount/2, meshGroup.getSize());
+	for (int e = 0; e < elementsCount; ++e)
+		EXPECT_EQ(e + 1, elements[e].getIdentifier());
+	checkElementStrip(elementsCount, elements, elementPosition, elementPosition, cache, coordinates, meshGroup);
+	EXPECT_TRUE(recordChange.lastEvent.isValid());
+	EXPECT_EQ(Field::CHANGE_FLAG_PARTIAL_RESULT, recordChange.lastEvent.getFieldChangeFlags(coordinates));
+	Meshchanges meshchanges2d = recordChange.lastEvent.getMeshchanges(mesh2d);
+	EXPECT_EQ(Element::CHANGE_FLAG_FIELD, meshchanges2d.getSummaryElementChangeFlags());
+
+	// renumber: identifiers follow the strip
+	recordChange.lastEvent = Fieldmoduleevent();
+	EXPECT_EQ(RESULT_OK, mesh2d.reorderElements(false));
+	EXPECT_TRUE(recordChange.lastEvent.isValid());
+	meshchanges2d = recordChange.lastEvent.getMeshchanges(mesh2d);
+	EXPECT_EQ(Element::CHANGE_FLAG_IDENTIFIER | Element::CHANGE_FLAG_FIELD, meshchanges2d.getSummaryElementChangeFlags());
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		EXPECT_EQ(elementPosition[e] + 1, elements[e].getIdentifier());
+		EXPECT_EQ(elements[e], mesh2d.findElementByIdentifier(elementPosition[e] + 1));
+	}
+	int identifierPosition[elementsCount];
+	for (int p = 0; p < elementsCount; ++p)
+		identifierPosition[p] = p;
+	checkElementStrip(elementsCount, elements, elementPosition, identifierPosition, cache, coordinates, meshGroup);
+	Elementiterator iter = mesh2d.createElementiterator();
+	Element element;
+	int id = 0;
+	while ((element = iter.next()).isValid())
+		EXPECT_EQ(++id, element.getIdentifier());
+	EXPECT_EQ(elementsCount, id);
+
+	// reorder face mesh: faces have no nodes so keep their order, but are renumbered
+	recordChange.lastEvent = Fieldmoduleevent();
+	EXPECT_EQ(RESULT_OK, mesh1d.reorderElements(false));
+	EXPECT_TRUE(recordChange.lastEvent.isValid());
+	EXPECT_EQ(linesCount, mesh1d.getSize());
+	checkElementStrip(elementsCount, elements, elementPosition, identifierPosition, cache, coordinates, meshGroup);
+
+	// reordering nodes keeping identifiers also notifies
+	recordChange.lastEvent = Fieldmoduleevent();
+	EXPECT_EQ(RESULT_OK, nodes.reorderNodes(true));
+	EXPECT_TRUE(recordChange.lastEvent.isValid());
+	EXPECT_EQ(Field::CHANGE_FLAG_PARTIAL_RESULT, recordChange.lastEvent.getFieldChangeFlags(coordinates));
+	Nodesetchanges nodesetchanges = recordChange.lastEvent.getNodesetchanges(nodes);
+	EXPECT_EQ(Node::CHANGE_FLAG_FIELD, nodesetchanges.getSummaryNodeChangeFlags());
+	checkElementStrip(elementsCount, elements, elementPosition, identifierPosition, cache, coordinates, meshGroup);
+}
+
+namespace {
+
 Elementfieldtemplate makeScaledTrilinearEft(Fieldmodule& fm)
 {
 	Mesh mesh3d = fm.findMeshByDimension(3);
@@ -2062,3 +2220,409 @@ TEST(ZincElementfieldtemplate, mergeExternalElementfieldtemplate)
 		EXPECT_DOUBLE_EQ(scaleFactors[s], scaleFactorsOut[s]);
 	}
 }
+
+// Test element parameters are gathered correctly after node parameters change
+// and when nodes of an element have different fields defined
+TEST(ZincFieldFiniteElement, gatherElementParametersNodeFieldChanges)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement u = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/1);
+	EXPECT_TRUE(u.isValid());
+	FieldFiniteElement v = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/1);
+	EXPECT_TRUE(v.isValid());
+
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(u));
+
+	Fieldcache cache = zinc.fm.createFieldcache();
+	EXPECT_TRUE(cache.isValid());
+	for (int n = 1; n <= 3; ++n)
+	{
+		Node node = nodes.createNode(n, nodetemplate);
+		EXPECT_TRUE(node.isValid());
+		EXPECT_EQ(RESULT_OK, cache.setNode(node));
+		const double value = static_cast<double>(n*n);
+		EXPECT_EQ(RESULT_OK, u.setNodeParameters(cache, -1, Node::VALUE_LABEL_VALUE, 1, 1, &value));
+	}
+
+	Mesh mesh1d = zinc.fm.findMeshByDimension(1);
+	Elementbasis linearBasis = zinc.fm.createElementbasis(1, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+	Elementfieldtemplate eft = mesh1d.createElementfieldtemplate(linearBasis);
+	EXPECT_TRUE(eft.isValid());
+	Elementtemplate elementtemplate = mesh1d.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_LINE));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(u, -1, eft));
+	Element elements[2];
+	for (int e = 0; e < 2; ++e)
+	{
+		const int nodeIdentifiers[2] = { e + 1, e + 2 };
+		elements[e] = mesh1d.createElement(e + 1, elementtemplate);
+		EXPECT_TRUE(elements[e].isValid());
+		EXPECT_EQ(RESULT_OK, elements[e].setNodesByIdentifier(eft, 2, nodeIdentifiers));
+	}
+
+	const double xi = 0.25;
+	double value;
+	EXPECT_EQ(RESULT_OK, cache.setMeshLocation(elements[0], 1, &xi));
+	EXPECT_EQ(RESULT_OK, u.evaluateReal(cache, 1, &value));
+	EXPECT_DOUBLE_EQ(1.75, value);
+	EXPECT_EQ(RESULT_OK, cache.setMeshLocation(elements[1], 1, &xi));
+	EXPECT_EQ(RESULT_OK, u.evaluateReal(cache, 1, &value));
+	EXPECT_DOUBLE_EQ(5.25, value);
+
+	// change node parameters
+	Node node2 = nodes.findNodeByIdentifier(2);
+	EXPECT_EQ(RESULT_OK, cache.setNode(node2));
+	const double newValue = 8.0;
+	EXPECT_EQ(RESULT_OK, u.setNodeParameters(cache, -1, Node::VALUE_LABEL_VALUE, 1, 1, &newValue));
+	EXPECT_EQ(RESULT_OK, cache.setMeshLocation(elements[0], 1, &xi));
+	EXPECT_EQ(RESULT_OK, u.evaluateReal(cache, 1, &value));
+	EXPECT_DOUBLE_EQ(2.75, value);
+
+	// define another field on node 2 only so nodes of each element differ in fields defined
+	Nodetemplate nodetemplate2 = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate2.defineField(v));
+	EXPECT_EQ(RESULT_OK, node2.merge(nodetemplate2));
+	EXPECT_EQ(RESULT_OK, cache.setNode(node2));
+	const double vValue = 100.0;
+	EXPECT_EQ(RESULT_OK, v.setNodeParameters(cache, -1, Node::VALUE_LABEL_VALUE, 1, 1, &vValue));
+	EXPECT_EQ(RESULT_OK, cache.setMeshLocation(elements[0], 1, &xi));
+	EXPECT_EQ(RESULT_OK, u.evaluateReal(cache, 1, &value));
+	EXPECT_DOUBLE_EQ(2.75, value);
+	EXPECT_EQ(RESULT_OK, cache.setMeshLocation(elements[1], 1, &xi));
+	EXPECT_EQ(RESULT_OK, u.evaluateReal(cache, 1, &value));
+	EXPECT_DOUBLE_EQ(8.25, value);
+
+	// define on remaining nodes so all nodes again have the same fields
+	for (int n = 1; n <= 3; n += 2)
+	{
+		Node node = nodes.findNodeByIdentifier(n);
+		EXPECT_EQ(RESULT_OK, node.merge(nodetemplate2));
+	}
+	EXPECT_EQ(RESULT_OK, cache.setMeshLocation(elements[1], 1, &xi));
+	EXPECT_EQ(RESULT_OK, u.evaluateReal(cache, 1, &value));
+	EXPECT_DOUBLE_EQ(8.25, value);
+
+	// cached gather plans must not keep field alive once undefined and released
+	EXPECT_EQ(RESULT_OK, u.setName("u"));
+	Elementtemplate undefineElementtemplate = mesh1d.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, undefineElementtemplate.undefineField(u));
+	for (int e = 0; e < 2; ++e)
+		EXPECT_EQ(RESULT_OK, elements[e].merge(undefineElementtemplate));
+	Nodetemplate undefineNodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, undefineNodetemplate.undefineField(u));
+	for (int n = 1; n <= 3; ++n)
+		EXPECT_EQ(RESULT_OK, nodes.findNodeByIdentifier(n).merge(undefineNodetemplate));
+	elementtemplate = Elementtemplate();
+	nodetemplate = Nodetemplate();
+	cache.clearLocation();
+	u = FieldFiniteElement();
+	EXPECT_FALSE(zinc.fm.findFieldByName("u").isValid());
+}
+
+// test faces are shared and numbered consecutively on a mesh large enough for
+// face node keys to be calculated in concurrent threads
+TEST(ZincMesh, defineAllFacesLargeMesh)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/3);
+	EXPECT_TRUE(coordinates.isValid());
+	EXPECT_EQ(RESULT_OK, coordinates.setTypeCoordinate(true));
+	EXPECT_EQ(RESULT_OK, coordinates.setManaged(true));
+
+	const int n = 14; // elements in each direction
+	const int nodesCount1 = n + 1;
+	EXPECT_EQ(RESULT_OK, zinc.fm.beginChange());
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(coordinates));
+	Fieldcache cache = zinc.fm.createFieldcache();
+	int nodeIdentifier = 1;
+	for (int k = 0; k < nodesCount1; ++k)
+		for (int j = 0; j < nodesCount1; ++j)
+			for (int i = 0; i < nodesCount1; ++i)
+			{
+				Node node = nodes.createNode(nodeIdentifier++, nodetemplate);
+				EXPECT_EQ(RESULT_OK, cache.setNode(node));
+				const double x[3] = { static_cast<double>(i), static_cast<double>(j), static_cast<double>(k) };
+				EXPECT_EQ(RESULT_OK, coordinates.assignReal(cache, 3, x));
+			}
+
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Elementbasis basis = zinc.fm.createElementbasis(3, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+	Elementfieldtemplate eft = mesh3d.createElementfieldtemplate(basis);
+	EXPECT_TRUE(eft.isValid());
+	Elementtemplate elementtemplate = mesh3d.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_CUBE));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(coordinates, -1, eft));
+	int elementIdentifier = 1;
+	for (int k = 0; k < n; ++k)
+		for (int j = 0; j < n; ++j)
+			for (int i = 0; i < n; ++i)
+			{
+				const int base = 1 + i + j*nodesCount1 + k*nodesCount1*nodesCount1;
+				const int plane = nodesCount1*nodesCount1;
+				const int nodeIdentifiers[8] = { base, base + 1, base + nodesCount1, base + nodesCount1 + 1,
+					base + plane, base + plane + 1, base + plane + nodesCount1, base + plane + nodesCount1 + 1 };
+				Element element = mesh3d.createElement(elementIdentifier++, elementtemplate);
+				EXPECT_TRUE(element.isValid());
+				EXPECT_EQ(RESULT_OK, element.setNodesByIdentifier(eft, 8, nodeIdentifiers));
+			}
+	EXPECT_EQ(RESULT_OK, zinc.fm.endChange());
+	EXPECT_EQ(n*n*n, mesh3d.getSize());
+
+	EXPECT_EQ(RESULT_OK, zinc.fm.defineAllFaces());
+	Mesh mesh2d = zinc.fm.findMeshByDimension(2);
+	const int faceCount = 3*n*n*nodesCount1;
+	EXPECT_EQ(faceCount, mesh2d.getSize());
+	Mesh mesh1d = zinc.fm.findMeshByDimension(1);
+	const int lineCount = 3*n*nodesCount1*nodesCount1;
+	EXPECT_EQ(lineCount, mesh1d.getSize());
+	EXPECT_TRUE(mesh2d.findElementByIdentifier(faceCount).isValid());
+	EXPECT_FALSE(mesh2d.findElementByIdentifier(faceCount + 1).isValid());
+	EXPECT_TRUE(mesh1d.findElementByIdentifier(lineCount).isValid());
+	EXPECT_FALSE(mesh1d.findElementByIdentifier(lineCount + 1).isValid());
+
+	// shared faces are interior
+	FieldIsExterior isExterior = zinc.fm.createFieldIsExterior();
+	EXPECT_TRUE(isExterior.isValid());
+	int exteriorCount = 0;
+	Elementiterator iter = mesh2d.createElementiterator();
+	Element face;
+	while ((face = iter.next()).isValid())
+	{
+		EXPECT_EQ(RESULT_OK, cache.setElement(face));
+		double value;
+		EXPECT_EQ(RESULT_OK, isExterior.evaluateReal(cache, 1, &value));
+		if (value != 0.0)
+			++exteriorCount;
+	}
+	EXPECT_EQ(6*n*n, exteriorCount);
+
+	// defining again adds no faces
+	EXPECT_EQ(RESULT_OK, zinc.fm.defineAllFaces());
+	EXPECT_EQ(faceCount, mesh2d.getSize());
+	EXPECT_EQ(lineCount, mesh1d.getSize());
+}
+
+namespace {
+
+// product of a polynomial in each xi direction, each of degree no higher
+// than its basis so it is interpolated exactly
+class XiPolynomial
+{
+	int dimension;
+	double coefficients[3][4];
+
+public:
+
+	XiPolynomial(int dimensionIn, const double coefficientsIn[3][4]) :
+		dimension(dimensionIn)
+	{
+		for (int d = 0; d < 3; ++d)
+			for (int j = 0; j < 4; ++j)
+				this->coefficients[d][j] = coefficientsIn[d][j];
+	}
+
+	/** @param derivativeBits  Bit d set to differentiate once in direction d. */
+	double evaluate(const double *xi, int derivativeBits) const
+	{
+		double value = 1.0;
+		for (int d = 0; d < this->dimension; ++d)
+		{
+			const double *c = this->coefficients[d];
+			const double x = xi[d];
+			value *= (derivativeBits & (1 << d)) ? (c[1] + x*(2.0*c[2] + x*3.0*c[3])) :
+				(c[0] + x*(c[1] + x*(c[2] + x*c[3])));
+		}
+		return value;
+	}
+
+	double integrate() const
+	{
+		double value = 1.0;
+		for (int d = 0; d < this->dimension; ++d)
+		{
+			const double *c = this->coefficients[d];
+			value *= c[0] + c[1]/2.0 + c[2]/3.0 + c[3]/4.0;
+		}
+		return value;
+	}
+};
+
+// Interpolate polynomials the basis reproduces exactly over a unit element and
+// compare with their values at many xi and their integral by Gauss quadrature,
+// which tabulates the basis at the quadrature points
+void checkBasisInterpolation(int dimension, const Elementbasis::FunctionType *functionTypes)
+{
+	ZincTestSetupCpp zinc;
+
+	const double polynomialCoefficients[3][3][4] =
+	{
+		{ { 1.0, 0.5, 0.0, 0.0 }, { 0.5, -1.0, 2.0, 0.0 }, { 2.0, 0.25, -1.5, 0.75 } },
+		{ { 0.75, -0.5, 0.0, 0.0 }, { 1.5, 0.5, -0.25, 0.0 }, { -0.5, 1.0, 0.5, -1.25 } },
+		{ { -1.0, 2.0, 0.0, 0.0 }, { 0.25, 1.5, 1.0, 0.0 }, { 1.0, -2.0, 0.5, 1.5 } }
+	};
+	int nodesCounts[3] = { 1, 1, 1 };
+	double coefficients[3][4];
+	double coordinatesCoefficients[3][3][4];
+	for (int d = 0; d < dimension; ++d)
+	{
+		int order = 3;
+		switch (functionTypes[d])
+		{
+		case Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE:
+			nodesCounts[d] = 2;
+			order = 1;
+			break;
+		case Elementbasis::FUNCTION_TYPE_QUADRATIC_LAGRANGE:
+			nodesCounts[d] = 3;
+			order = 2;
+			break;
+		case Elementbasis::FUNCTION_TYPE_CUBIC_LAGRANGE:
+			nodesCounts[d] = 4;
+			break;
+		default: // cubic Hermite
+			nodesCounts[d] = 2;
+			break;
+		}
+		for (int j = 0; j < 4; ++j)
+			coefficients[d][j] = polynomialCoefficients[d][order - 1][j];
+		// coordinates are xi
+		for (int c = 0; c < dimension; ++c)
+			for (int j = 0; j < 4; ++j)
+				coordinatesCoefficients[c][d][j] = (c == d) ? ((j == 1) ? 1.0 : 0.0) : ((j == 0) ? 1.0 : 0.0);
+	}
+	const XiPolynomial polynomial(dimension, coefficients);
+
+	EXPECT_EQ(RESULT_OK, zinc.fm.beginChange());
+	FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(dimension);
+	EXPECT_TRUE(coordinates.isValid());
+	EXPECT_EQ(RESULT_OK, coordinates.setTypeCoordinate(true));
+	FieldFiniteElement field = zinc.fm.createFieldFiniteElement(1);
+	EXPECT_TRUE(field.isValid());
+
+	Mesh mesh = zinc.fm.findMeshByDimension(dimension);
+	Elementbasis basis = zinc.fm.createElementbasis(dimension, functionTypes[0]);
+	EXPECT_TRUE(basis.isValid());
+	for (int d = 1; d < dimension; ++d)
+		EXPECT_EQ(RESULT_OK, basis.setFunctionType(d + 1, functionTypes[d]));
+	Elementfieldtemplate eft = mesh.createElementfieldtemplate(basis);
+	EXPECT_TRUE(eft.isValid());
+	const int nodesCount = nodesCounts[0]*nodesCounts[1]*nodesCounts[2];
+	EXPECT_EQ(nodesCount, eft.getNumberOfLocalNodes());
+	const int functionsCount = eft.getNumberOfFunctions();
+
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(coordinates));
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(field));
+	for (int fn = 1; fn <= functionsCount; ++fn)
+	{
+		const Node::ValueLabel valueLabel = eft.getTermNodeValueLabel(fn, 1);
+		EXPECT_EQ(RESULT_OK, nodetemplate.setValueNumberOfVersions(coordinates, -1, valueLabel, 1));
+		EXPECT_EQ(RESULT_OK, nodetemplate.setValueNumberOfVersions(field, -1, valueLabel, 1));
+	}
+	Fieldcache cache = zinc.fm.createFieldcache();
+	std::vector<int> nodeIdentifiers(nodesCount);
+	for (int n = 0; n < nodesCount; ++n)
+	{
+		nodeIdentifiers[n] = n + 1;
+		Node node = nodes.createNode(nodeIdentifiers[n], nodetemplate);
+		EXPECT_TRUE(node.isValid());
+	}
+	// local nodes vary fastest with xi1
+	for (int fn = 1; fn <= functionsCount; ++fn)
+	{
+		const int localNodeIndex = eft.getTermLocalNodeIndex(fn, 1);
+		const Node::ValueLabel valueLabel = eft.getTermNodeValueLabel(fn, 1);
+		const int derivativeBits = static_cast<int>(valueLabel) - static_cast<int>(Node::VALUE_LABEL_VALUE);
+		double nodeXi[3];
+		int nodeOffset = localNodeIndex - 1;
+		for (int d = 0; d < 3; ++d)
+		{
+			nodeXi[d] = (nodesCounts[d] > 1) ? static_cast<double>(nodeOffset % nodesCounts[d])/(nodesCounts[d] - 1) : 0.0;
+			nodeOffset /= nodesCounts[d];
+		}
+		EXPECT_EQ(RESULT_OK, cache.setNode(nodes.findNodeByIdentifier(nodeIdentifiers[localNodeIndex - 1])));
+		double coordinatesValues[3];
+		for (int c = 0; c < dimension; ++c)
+			coordinatesValues[c] = XiPolynomial(dimension, coordinatesCoefficients[c]).evaluate(nodeXi, derivativeBits);
+		EXPECT_EQ(RESULT_OK, coordinates.setNodeParameters(cache, -1, valueLabel, 1, dimension, coordinatesValues));
+		const double value = polynomial.evaluate(nodeXi, derivativeBits);
+		EXPECT_EQ(RESULT_OK, field.setNodeParameters(cache, -1, valueLabel, 1, 1, &value));
+	}
+
+	Elementtemplate elementtemplate = mesh.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType((dimension == 1) ? Element::SHAPE_TYPE_LINE :
+		((dimension == 2) ? Element::SHAPE_TYPE_SQUARE : Element::SHAPE_TYPE_CUBE)));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(coordinates, -1, eft));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(field, -1, eft));
+	Element element = mesh.createElement(1, elementtemplate);
+	EXPECT_TRUE(element.isValid());
+	EXPECT_EQ(RESULT_OK, element.setNodesByIdentifier(eft, nodesCount, nodeIdentifiers.data()));
+	EXPECT_EQ(RESULT_OK, zinc.fm.endChange());
+
+	const double xiValues[5] = { 0.0, 0.2, 0.45, 0.8, 1.0 };
+	const int pointsCount = (dimension == 1) ? 5 : ((dimension == 2) ? 25 : 125);
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		double xi[3];
+		for (int d = 0, offset = p; d < 3; ++d, offset /= 5)
+			xi[d] = xiValues[offset % 5];
+		EXPECT_EQ(RESULT_OK, cache.setMeshLocation(element, dimension, xi));
+		double value;
+		EXPECT_EQ(RESULT_OK, field.evaluateReal(cache, 1, &value));
+		EXPECT_NEAR(polynomial.evaluate(xi, 0), value, 1.0E-12);
+		double coordinatesValues[3];
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, dimension, coordinatesValues));
+		for (int c = 0; c < dimension; ++c)
+			EXPECT_NEAR(xi[c], coordinatesValues[c], 1.0E-12);
+	}
+
+	FieldMeshIntegral integral = zinc.fm.createFieldMeshIntegral(field, coordinates, mesh);
+	EXPECT_TRUE(integral.isValid());
+	const int numberOfPoints = 4;
+	EXPECT_EQ(RESULT_OK, integral.setNumbersOfPoints(1, &numberOfPoints));
+	double integralValue;
+	EXPECT_EQ(RESULT_OK, cache.clearLocation());
+	EXPECT_EQ(RESULT_OK, integral.evaluateReal(cache, 1, &integralValue));
+	EXPECT_NEAR(polynomial.integrate(), integralValue, 1.0E-12);
+}
+
+}
+
+// Basis values are calculated by kernels specialised for each monomial order,
+// after blending; check Lagrange and Hermite interpolation in 1-3 dimensions
+TEST(ZincElementbasis, interpolatePolynomials)
+{
+	const Elementbasis::FunctionType types1d[][1] =
+	{
+		{ Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE },
+		{ Elementbasis::FUNCTION_TYPE_QUADRATIC_LAGRANGE },
+		{ Elementbasis::FUNCTION_TYPE_CUBIC_LAGRANGE },
+		{ Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE }
+	};
+	for (int i = 0; i < 4; ++i)
+		checkBasisInterpolation(1, types1d[i]);
+	const Elementbasis::FunctionType types2d[][2] =
+	{
+		{ Elementbasis::FUNCTION_TYPE_QUADRATIC_LAGRANGE, Elementbasis::FUNCTION_TYPE_QUADRATIC_LAGRANGE },
+		{ Elementbasis::FUNCTION_TYPE_CUBIC_LAGRANGE, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE },
+		{ Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE, Elementbasis::FUNCTION_TYPE_QUADRATIC_LAGRANGE },
+		{ Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE, Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE }
+	};
+	for (int i = 0; i < 4; ++i)
+		checkBasisInterpolation(2, types2d[i]);
+	const Elementbasis::FunctionType types3d[][3] =
+	{
+		{ Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE, Elementbasis::FUNCTION_TYPE_QUADRATIC_LAGRANGE, Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE },
+		{ Elementbasis::FUNCTION_TYPE_CUBIC_LAGRANGE, Elementbasis::FUNCTION_TYPE_CUBIC_LAGRANGE, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE },
+		{ Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE, Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE, Elementbasis::FUNCTION_TYPE_CUBIC_HERMITE }
+	};
+	for (int i = 0; i < 3; ++i)
+		checkBasisInterpolation(3, types3d[i]);
+}
@@ -23,9 +23,12 @@
 #include <opencmiss/zinc/context.hpp>
 #include <opencmiss/zinc/element.hpp>
 #include <opencmiss/zinc/field.hpp>
+#include <opencmiss/zinc/fieldcache.hpp>
 #include <opencmiss/zinc/fieldconstant.hpp>
+#include <opencmiss/zinc/fieldfiniteelement.hpp>
 #include <opencmiss/zinc/fieldlogicaloperators.hpp>
 #include <opencmiss/zinc/fieldmodule.hpp>
+#include <opencmiss/zinc/fieldsubobjectgroup.hpp>
 #include <opencmiss/zinc/node.hpp>
 #include <opencmiss/zinc/status.hpp>
 #include <opencmiss/zinc/stream.hpp>
@@ -419,6 +422,303 @@ TEST(ZincMesh, destroyElements)
 	EXPECT_EQ(0, mesh.getSize());
 }
 
+TEST(ZincMesh, elementNeighbourTable)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(OK, zinc.root_region.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)));
+	Mesh mesh = zinc.fm.findMeshByDimension(3);
+	EXPECT_FALSE(mesh.isElementNeighbourTableEnabled());
+	Element element1 = mesh.findElementByIdentifier(1);
+	EXPECT_TRUE(element1.isValid());
+	Element element2 = mesh.findElementByIdentifier(2);
+	EXPECT_TRUE(element2.isValid());
+
+	for (int i = 0; i < 2; ++i)
+	{
+		const bool enabled = (i == 1);
+		EXPECT_EQ(OK, mesh.setElementNeighbourTableEnabled(enabled));
+		EXPECT_EQ(enabled, mesh.isElementNeighbourTableEnabled());
+		Element::FaceType neighbourFaceType = Element::FACE_TYPE_INVALID;
+		EXPECT_EQ(element2, element1.getNeighbour(Element::FACE_TYPE_XI1_1, &neighbourFaceType));
+		EXPECT_EQ(Element::FACE_TYPE_XI1_0, neighbourFaceType);
+		EXPECT_EQ(element1, element2.getNeighbour(Element::FACE_TYPE_XI1_0, &neighbourFaceType));
+		EXPECT_EQ(Element::FACE_TYPE_XI1_1, neighbourFaceType);
+		EXPECT_FALSE(element1.getNeighbour(Element::FACE_TYPE_XI1_0, &neighbourFaceType).isValid());
+		EXPECT_EQ(Element::FACE_TYPE_INVALID, neighbourFaceType);
+		EXPECT_FALSE(element2.getNeighbour(Element::FACE_TYPE_XI3_1).isValid());
+		EXPECT_FALSE(element1.getNeighbour(Element::FACE_TYPE_ALL).isValid());
+	}
+
+	// table is updated for neighbours of removed element
+	EXPECT_EQ(OK, mesh.destroyElement(element1));
+	Element::FaceType neighbourFaceType = Element::FACE_TYPE_XI1_1;
+	EXPECT_FALSE(element2.getNeighbour(Element::FACE_TYPE_XI1_0, &neighbourFaceType).isValid());
+	EXPECT_EQ(Element::FACE_TYPE_INVALID, neighbourFaceType);
+	EXPECT_FALSE(element1.getNeighbour(Element::FACE_TYPE_XI1_1).isValid());
+
+	EXPECT_EQ(OK, mesh.setElementNeighbourTableEnabled(false));
+	EXPECT_FALSE(mesh.isElementNeighbourTableEnabled());
+}
+
+TEST(ZincMesh, defineElements)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/1);
+	EXPECT_TRUE(coordinates.isValid());
+	EXPECT_EQ(RESULT_OK, coordinates.setTypeCoordinate(true));
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(coordinates));
+	Fieldcache cache = zinc.fm.createFieldcache();
+	for (int n = 1; n <= 4; ++n)
+	{
+		Node node = nodes.createNode(n, nodetemplate);
+		EXPECT_EQ(RESULT_OK, cache.setNode(node));
+		const double x = static_cast<double>(n*n);
+		EXPECT_EQ(RESULT_OK, coordinates.assignReal(cache, 1, &x));
+	}
+
+	Mesh mesh = zinc.fm.findMeshByDimension(1);
+	Elementbasis basis = zinc.fm.createElementbasis(1, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+	Elementfieldtemplate eft = mesh.createElementfieldtemplate(basis);
+	EXPECT_TRUE(eft.isValid());
+	Elementtemplate elementtemplate = mesh.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_LINE));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(coordinates, -1, eft));
+
+	const int identifiers[3] = { 10, 20, 30 };
+	const int nodeIdentifiers[6] = { 1, 2, 2, 3, 3, 4 };
+	// invalid arguments create no elements
+	Elementtemplate noElementtemplate;
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(noElementtemplate, 3, identifiers, eft, 6, nodeIdentifiers));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(elementtemplate, 0, identifiers, eft, 6, nodeIdentifiers));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(elementtemplate, 3, identifiers, eft, 5, nodeIdentifiers));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(elementtemplate, 3, identifiers, eft, -6, nodeIdentifiers));
+	// element count times local nodes exceeds int range
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(elementtemplate, 0x40000003, identifiers, eft, 6, nodeIdentifiers));
+	const int repeatIdentifiers[3] = { 10, 20, 10 };
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(elementtemplate, 3, repeatIdentifiers, eft, 6, nodeIdentifiers));
+	const int badNodeIdentifiers[6] = { 1, 2, 2, 3, 3, 5 };
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(elementtemplate, 3, identifiers, eft, 6, badNodeIdentifiers));
+	EXPECT_EQ(0, mesh.getSize());
+
+	EXPECT_EQ(RESULT_OK, mesh.defineElements(elementtemplate, 3, identifiers, eft, 6, nodeIdentifiers));
+	EXPECT_EQ(3, mesh.getSize());
+	// identifiers now in use
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(elementtemplate, 1, identifiers + 2, eft, 2, nodeIdentifiers));
+	EXPECT_EQ(3, mesh.getSize());
+
+	const double xi = 0.25;
+	double x;
+	for (int e = 0; e < 3; ++e)
+	{
+		Element element = mesh.findElementByIdentifier(identifiers[e]);
+		EXPECT_TRUE(element.isValid());
+		Node node = element.getNode(eft, 2);
+		EXPECT_EQ(nodeIdentifiers[e*2 + 1], node.getIdentifier());
+		EXPECT_EQ(RESULT_OK, cache.setMeshLocation(element, 1, &xi));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 1, &x));
+		EXPECT_DOUBLE_EQ(0.75*(e + 1)*(e + 1) + 0.25*(e + 2)*(e + 2), x);
+	}
+
+	// automatic identifiers, no nodes
+	Elementfieldtemplate noEft;
+	EXPECT_EQ(RESULT_OK, mesh.defineElements(elementtemplate, 2, 0, noEft, 0, 0));
+	EXPECT_EQ(5, mesh.getSize());
+	Element element1 = mesh.findElementByIdentifier(1);
+	EXPECT_TRUE(element1.isValid());
+	EXPECT_TRUE(mesh.findElementByIdentifier(2).isValid());
+	EXPECT_FALSE(element1.getNode(eft, 1).isValid());
+
+	// element template must be from the same mesh, including for mesh groups
+	Mesh mesh2d = zinc.fm.findMeshByDimension(2);
+	Elementtemplate elementtemplate2d = mesh2d.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, elementtemplate2d.setElementShapeType(Element::SHAPE_TYPE_SQUARE));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, mesh.defineElements(elementtemplate2d, 1, 0, noEft, 0, 0));
+	EXPECT_EQ(5, mesh.getSize());
+	FieldElementGroup elementGroup = zinc.fm.createFieldElementGroup(mesh);
+	MeshGroup meshGroup = elementGroup.getMeshGroup();
+	EXPECT_TRUE(meshGroup.isValid());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, meshGroup.defineElements(elementtemplate2d, 1, 0, noEft, 0, 0));
+	EXPECT_EQ(0, meshGroup.getSize());
+	EXPECT_EQ(0, mesh2d.getSize());
+	EXPECT_EQ(5, mesh.getSize());
+	EXPECT_EQ(RESULT_OK, meshGroup.defineElements(elementtemplate, 1, 0, noEft, 0, 0));
+	EXPECT_EQ(1, meshGroup.getSize());
+	EXPECT_EQ(6, mesh.getSize());
+}
+
+TEST(ZincNodeset, defineNodes)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/3);
+	EXPECT_TRUE(coordinates.isValid());
+	FieldFiniteElement temperature = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/1);
+	EXPECT_TRUE(temperature.isValid());
+	FieldFiniteElement pressure = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/1);
+	EXPECT_TRUE(pressure.isValid());
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_DATAPOINTS);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(coordinates));
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(temperature));
+	EXPECT_EQ(RESULT_OK, nodetemplate.setValueNumberOfVersions(temperature, -1, Node::VALUE_LABEL_D_DS1, 1));
+
+	const int nodesCount = 4;
+	const int identifiers[nodesCount] = { 7, 3, 12, 5 };
+	const Field fields[2] = { coordinates, temperature };
+	// per node: x, y, z, T, dT/ds1
+	double values[nodesCount*5];
+	for (int n = 0; n < nodesCount; ++n)
+		for (int v = 0; v < 5; ++v)
+			values[n*5 + v] = n*10.0 + v;
+
+	// invalid arguments create no nodes
+	Nodetemplate noNodetemplate;
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, nodes.defineNodes(noNodetemplate, nodesCount, identifiers, 2, fields, nodesCount*5, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, nodes.defineNodes(nodetemplate, 0, identifiers, 2, fields, nodesCount*5, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, nodes.defineNodes(nodetemplate, nodesCount, identifiers, 2, fields, nodesCount*5 - 1, values));
+	const Field undefinedFields[1] = { pressure };
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, nodes.defineNodes(nodetemplate, nodesCount, identifiers, 1, undefinedFields, nodesCount, values));
+	const int repeatIdentifiers[nodesCount] = { 7, 3, 7, 5 };
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, nodes.defineNodes(nodetemplate, nodesCount, repeatIdentifiers, 2, fields, nodesCount*5, values));
+	EXPECT_EQ(0, nodes.getSize());
+
+	EXPECT_EQ(RESULT_OK, nodes.defineNodes(nodetemplate, nodesCount, identifiers, 2, fields, nodesCount*5, values));
+	EXPECT_EQ(nodesCount, nodes.getSize());
+	// identifiers now in use
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, nodes.defineNodes(nodetemplate, 1, identifiers + 1, 0, 0, 0, 0));
+	EXPECT_EQ(nodesCount, nodes.getSize());
+
+	Fieldcache cache = zinc.fm.createFieldcache();
+	double x[3], t;
+	for (int n = 0; n < nodesCount; ++n)
+	{
+		Node node = nodes.findNodeByIdentifier(identifiers[n]);
+		EXPECT_TRUE(node.isValid());
+		EXPECT_EQ(RESULT_OK, cache.setNode(node));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 3, x));
+		for (int c = 0; c < 3; ++c)
+			EXPECT_DOUBLE_EQ(values[n*5 + c], x[c]);
+		EXPECT_EQ(RESULT_OK, temperature.getNodeParameters(cache, -1, Node::VALUE_LABEL_VALUE, 1, 1, &t));
+		EXPECT_DOUBLE_EQ(values[n*5 + 3], t);
+		EXPECT_EQ(RESULT_OK, temperature.getNodeParameters(cache, -1, Node::VALUE_LABEL_D_DS1, 1, 1, &t));
+		EXPECT_DOUBLE_EQ(values[n*5 + 4], t);
+	}
+
+	// automatic identifiers, values from template
+	EXPECT_EQ(RESULT_OK, nodes.defineNodes(nodetemplate, 2, 0, 0, 0, 0, 0));
+	EXPECT_EQ(nodesCount + 2, nodes.getSize());
+	EXPECT_TRUE(nodes.findNodeByIdentifier(1).isValid());
+	Node node2 = nodes.findNodeByIdentifier(2);
+	EXPECT_TRUE(node2.isValid());
+	EXPECT_EQ(RESULT_OK, cache.setNode(node2));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 3, x));
+	EXPECT_DOUBLE_EQ(0.0, x[0]);
+}
+
+TEST(ZincNodeset, reorderNodes)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/1);
+	EXPECT_TRUE(coordinates.isValid());
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(coordinates));
+	// chain of elements visiting nodes in scattered order, plus one unused node
+	const int chainNodesCount = 20;
+	int chainNodeIdentifiers[chainNodesCount];
+	double x[chainNodesCount + 1];
+	for (int n = 0; n < chainNodesCount; ++n)
+		chainNodeIdentifiers[n] = (n*7) % chainNodesCount + 1;
+	for (int n = 0; n <= chainNodesCount; ++n)
+		x[n] = 0.5*n*n;
+	EXPECT_EQ(RESULT_OK, nodes.defineNodes(nodetemplate, chainNodesCount + 1, 0, 1, &coordinates, chainNodesCount + 1, x));
+	// destroy a node to leave an unused index
+	EXPECT_EQ(RESULT_OK, nodes.destroyNode(nodes.findNodeByIdentifier(chainNodesCount + 1)));
+	EXPECT_EQ(RESULT_OK, nodes.defineNodes(nodetemplate, 1, 0, 1, &coordinates, 1, x + chainNodesCount));
+
+	Mesh mesh = zinc.fm.findMeshByDimension(1);
+	Elementbasis basis = zinc.fm.createElementbasis(1, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+	Elementfieldtemplate eft = mesh.createElementfieldtemplate(basis);
+	Elementtemplate elementtemplate = mesh.createElementtemplate();
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_LINE));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(coordinates, -1, eft));
+	const int elementsCount = chainNodesCount - 1;
+	int nodeIdentifiers[elementsCount*2];
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		nodeIdentifiers[e*2] = chainNodeIdentifiers[e];
+		nodeIdentifiers[e*2 + 1] = chainNodeIdentifiers[e + 1];
+	}
+	EXPECT_EQ(RESULT_OK, mesh.defineElements(elementtemplate, elementsCount, 0, eft, elementsCount*2, nodeIdentifiers));
+
+	FieldNodeGroup nodeGroup = zinc.fm.createFieldNodeGroup(nodes);
+	NodesetGroup nodesetGroup = nodeGroup.getNodesetGroup();
+	for (int id = 2; id <= chainNodesCount; id += 3)
+		EXPECT_EQ(RESULT_OK, nodesetGroup.addNode(nodes.findNodeByIdentifier(id)));
+	const int groupSize = nodesetGroup.getSize();
+	Node unusedNode = nodes.findNodeByIdentifier(chainNodesCount + 1);
+	EXPECT_TRUE(unusedNode.isValid());
+
+	Fieldcache cache = zinc.fm.createFieldcache();
+	double xi, value;
+
+	// keep identifiers: node handles, groups, element nodes and values are unchanged
+	EXPECT_EQ(RESULT_OK, nodes.reorderNodes(true));
+	EXPECT_EQ(chainNodesCount + 1, nodes.getSize());
+	EXPECT_EQ(groupSize, nodesetGroup.getSize());
+	for (int id = 1; id <= chainNodesCount + 1; ++id)
+	{
+		Node node = nodes.findNodeByIdentifier(id);
+		EXPECT_EQ(id, node.getIdentifier());
+		EXPECT_EQ((id <= chainNodesCount) && (2 == id % 3), nodesetGroup.containsNode(node));
+		EXPECT_EQ(RESULT_OK, cache.setNode(node));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 1, &value));
+		EXPECT_DOUBLE_EQ(x[id - 1], value);
+	}
+	EXPECT_EQ(chainNodesCount + 1, unusedNode.getIdentifier());
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		Element element = mesh.findElementByIdentifier(e + 1);
+		EXPECT_EQ(nodeIdentifiers[e*2], element.getNode(eft, 1).getIdentifier());
+		EXPECT_EQ(nodeIdentifiers[e*2 + 1], element.getNode(eft, 2).getIdentifier());
+	}
+
+	// renumber: nodes along chain get consecutive identifiers, unused node is last
+	EXPECT_EQ(RESULT_OK, nodes.reorderNodes(false));
+	EXPECT_EQ(chainNodesCount + 1, nodes.getSize());
+	EXPECT_EQ(groupSize, nodesetGroup.getSize());
+	EXPECT_EQ(chainNodesCount + 1, unusedNode.getIdentifier());
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		Element element = mesh.findElementByIdentifier(e + 1);
+		Node node1 = element.getNode(eft, 1);
+		Node node2 = element.getNode(eft, 2);
+		EXPECT_EQ(1, abs(node2.getIdentifier() - node1.getIdentifier()));
+		xi = 0.0;
+		EXPECT_EQ(RESULT_OK, cache.setMeshLocation(element, 1, &xi));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 1, &value));
+		EXPECT_DOUBLE_EQ(x[nodeIdentifiers[e*2] - 1], value);
+		xi = 1.0;
+		EXPECT_EQ(RESULT_OK, cache.setMeshLocation(element, 1, &xi));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 1, &value));
+		EXPECT_DOUBLE_EQ(x[nodeIdentifiers[e*2 + 1] - 1], value);
+		// node group membership follows the nodes
+		EXPECT_EQ(2 == nodeIdentifiers[e*2] % 3, nodesetGroup.containsNode(node1));
+	}
+	Nodeiterator iter = nodes.createNodeiterator();
+	Node node;
+	int id = 0;
+	while ((node = iter.next()).isValid())
+		EXPECT_EQ(++id, node.getIdentifier());
+	EXPECT_EQ(chainNodesCount + 1, id);
+}
+
 TEST(ZincNodeset, destroyNodes)
 {
 	ZincTestSetupCpp zinc;
@@ -8,6 +8,14 @@
 
 #include <gtest/gtest.h>
 
+#include <opencmiss/zinc/fieldassignment.hpp>
+#include <opencmiss/zinc/fieldcache.hpp>
+#include <opencmiss/zinc/fieldfiniteelement.hpp>
+#include <opencmiss/zinc/fieldmodule.hpp>
+#include <opencmiss/zinc/node.hpp>
+#include <opencmiss/zinc/nodeset.hpp>
+#include <opencmiss/zinc/nodetemplate.hpp>
+#include <opencmiss/zinc/status.hpp>
 #include <opencmiss/zinc/timesequence.hpp>
 #include "zinctestsetupcpp.hpp"
 
@@ -39,3 +47,85 @@ TEST(ZincTimesequence, api)
 	ASSERT_DOUBLE_EQ(5.5, outValue = seq3.getTime(4));
 	ASSERT_EQ(4, seq3.getNumberOfTimes());
 }
+
+// test interpolation of fields with different time sequences, alternating
+// between times so cached time lookups are reused and replaced
+TEST(ZincTimesequence, interpolateNodeParameters)
+{
+	ZincTestSetupCpp zinc;
+
+	const double timesA[3] = { 0.0, 1.0, 2.0 };
+	Timesequence sequenceA = zinc.fm.getMatchingTimesequence(3, timesA);
+	EXPECT_TRUE(sequenceA.isValid());
+	const double timesB[3] = { 0.0, 2.0, 6.0 };
+	Timesequence sequenceB = zinc.fm.getMatchingTimesequence(3, timesB);
+	EXPECT_TRUE(sequenceB.isValid());
+
+	FieldFiniteElement fieldA = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/1);
+	EXPECT_TRUE(fieldA.isValid());
+	FieldFiniteElement fieldB = zinc.fm.createFieldFiniteElement(/*numberOfComponents*/1);
+	EXPECT_TRUE(fieldB.isValid());
+
+	Nodeset nodeset = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodeset.createNodetemplate();
+	EXPECT_EQ(OK, nodetemplate.defineField(fieldA));
+	EXPECT_EQ(OK, nodetemplate.setTimesequence(fieldA, sequenceA));
+	EXPECT_EQ(OK, nodetemplate.defineField(fieldB));
+	EXPECT_EQ(OK, nodetemplate.setTimesequence(fieldB, sequenceB));
+	Fieldcache cache = zinc.fm.createFieldcache();
+	for (int n = 1; n <= 2; ++n)
+	{
+		Node node = nodeset.createNode(n, nodetemplate);
+		EXPECT_TRUE(node.isValid());
+		EXPECT_EQ(OK, cache.setNode(node));
+		for (int t = 0; t < 3; ++t)
+		{
+			EXPECT_EQ(OK, cache.setTime(timesA[t]));
+			const double valueA = n*10.0*(t + 1);
+			EXPECT_EQ(OK, fieldA.assignReal(cache, 1, &valueA));
+			EXPECT_EQ(OK, cache.setTime(timesB[t]));
+			const double valueB = n*100.0*(t + 1);
+			EXPECT_EQ(OK, fieldB.assignReal(cache, 1, &valueB));
+		}
+	}
+
+	const double times[7] = { 0.5, 3.0, 1.5, 0.5, 2.0, 7.0, 3.0 };
+	const double expectedA[7] = { 15.0, 30.0, 25.0, 15.0, 30.0, 30.0, 30.0 };
+	const double expectedB[7] = { 125.0, 225.0, 175.0, 125.0, 200.0, 300.0, 225.0 };
+	double value;
+	double nodesetValues[2];
+	for (int i = 0; i < 7; ++i)
+	{
+		EXPECT_EQ(OK, cache.setTime(times[i]));
+		for (int n = 1; n <= 2; ++n)
+		{
+			EXPECT_EQ(OK, cache.setNode(nodeset.findNodeByIdentifier(n)));
+			EXPECT_EQ(OK, fieldA.evaluateReal(cache, 1, &value));
+			EXPECT_DOUBLE_EQ(n*expectedA[i], value);
+			EXPECT_EQ(OK, fieldB.evaluateReal(cache, 1, &value));
+			EXPECT_DOUBLE_EQ(n*expectedB[i], value);
+		}
+		EXPECT_EQ(OK, fieldB.evaluateRealNodeset(cache, nodeset, 2, nodesetValues));
+		EXPECT_DOUBLE_EQ(expectedB[i], nodesetValues[0]);
+		EXPECT_DOUBLE_EQ(2.0*expectedB[i], nodesetValues[1]);
+	}
+
+	// each field cache keeps its own time lookups
+	Fieldcache cache2 = zinc.fm.createFieldcache();
+	EXPECT_EQ(OK, cache.setTime(times[0]));
+	EXPECT_EQ(OK, cache2.setTime(times[1]));
+	for (int n = 1; n <= 2; ++n)
+	{
+		Node node = nodeset.findNodeByIdentifier(n);
+		EXPECT_EQ(OK, cache.setNode(node));
+		EXPECT_EQ(OK, cache2.setNode(node));
+		EXPECT_EQ(OK, fieldB.evaluateReal(cache, 1, &value));
+		EXPECT_DOUBLE_EQ(n*expectedB[0], value);
+		EXPECT_EQ(OK, fieldB.evaluateReal(cache2, 1, &value));
+		EXPECT_DOUBLE_EQ(n*expectedB[1], value);
+		EXPECT_EQ(OK, fieldA.evaluateReal(cache, 1, &value));
+		EXPECT_DOUBLE_EQ(n*expectedA[0], value);
+		EXPECT_EQ(OK, fieldA.evaluateReal(cache2, 1, &value));
+		EXPECT_DOUBLE_EQ(n*expectedA[1], value);
+	}
+}
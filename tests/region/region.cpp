@@ -8,9 +8,25 @@
 
 #include <gtest/gtest.h>
 
+#include <opencmiss/zinc/core.h>
+#include <opencmiss/zinc/element.hpp>
+#include <opencmiss/zinc/fieldcache.hpp>
+#include <opencmiss/zinc/fieldfiniteelement.hpp>
+#include <opencmiss/zinc/fieldsubobjectgroup.hpp>
+#include <opencmiss/zinc/logger.hpp>
+#include <opencmiss/zinc/mesh.hpp>
+#include <opencmiss/zinc/node.hpp>
+#include <opencmiss/zinc/nodeset.hpp>
+#include <opencmiss/zinc/streamregion.hpp>
+
 #include "zinctestsetup.hpp"
 #include "zinctestsetupcpp.hpp"
 
+#include "test_resources.h"
+
+#include <string>
+#include <vector>
+
 TEST(cmzn_region, build_tree)
 {
 	ZincTestSetup zinc;
@@ -170,3 +186,278 @@ TEST(ZincRegion, append_insert_region)
 	EXPECT_EQ(ERROR_ARGUMENT_CONTEXT, zinc.root_region.appendChild(or1));
 	EXPECT_EQ(ERROR_ARGUMENT_CONTEXT, zinc.root_region.insertChildBefore(or1, r2));
 }
+
+TEST(ZincRegion, memoryUsageReport)
+{
+	ZincTestSetupCpp zinc;
+
+	Region cubes = zinc.root_region.createChild("cubes");
+	EXPECT_TRUE(cubes.isValid());
+	EXPECT_EQ(OK, cubes.readFile(
+		TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)));
+	Fieldmodule fm = cubes.getFieldmodule();
+	Nodeset nodes = fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	FieldNodeGroup nodeGroup = fm.createFieldNodeGroup(nodes);
+	EXPECT_TRUE(nodeGroup.isValid());
+	EXPECT_EQ(OK, nodeGroup.setName("bob"));
+	EXPECT_EQ(OK, nodeGroup.getNodesetGroup().addNode(nodes.findNodeByIdentifier(1)));
+
+	char *report = zinc.root_region.writeMemoryUsageReport();
+	EXPECT_NE(static_cast<char *>(0), report);
+	std::string reportString(report);
+	cmzn_deallocate(report);
+	EXPECT_NE(std::string::npos, reportString.find("\"Path\" : \"/cubes/\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"Name\" : \"nodes\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"Name\" : \"mesh3d\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"Name\" : \"coordinates\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"NodesetValuesBytes\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"Name\" : \"bob\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"GroupBytes\""));
+	EXPECT_NE(std::string::npos, reportString.find("\"TotalBytes\""));
+
+	Logger logger = zinc.context.getLogger();
+	const int messageCount = logger.getNumberOfMessages();
+	EXPECT_EQ(OK, cubes.logMemoryUsageReport());
+	EXPECT_EQ(messageCount + 1, logger.getNumberOfMessages());
+
+	EXPECT_EQ(static_cast<char *>(0), cmzn_region_write_memory_usage_report(0));
+	EXPECT_EQ(ERROR_ARGUMENT, cmzn_region_log_memory_usage_report(0));
+}
+
+namespace {
+
+/** Define many line elements with a multi-component element-constant field
+  * so merge maps indexes and merges component values in several threads
+  * where available. Each value is set directly, not merged. */
+void defineElementConstantLines(Region& region, int elementsCount, int componentsCount)
+{
+	Fieldmodule fm = region.getFieldmodule();
+	EXPECT_EQ(OK, fm.beginChange());
+	FieldFiniteElement field = fm.createFieldFiniteElement(componentsCount);
+	EXPECT_EQ(OK, field.setName("values"));
+	EXPECT_EQ(OK, field.setManaged(true));
+	Mesh mesh = fm.findMeshByDimension(1);
+	Elementbasis constantBasis = fm.createElementbasis(1, Elementbasis::FUNCTION_TYPE_CONSTANT);
+	Elementfieldtemplate eft = mesh.createElementfieldtemplate(constantBasis);
+	EXPECT_EQ(OK, eft.setParameterMappingMode(Elementfieldtemplate::PARAMETER_MAPPING_MODE_ELEMENT));
+	Elementtemplate elementtemplate = mesh.createElementtemplate();
+	EXPECT_EQ(OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_LINE));
+	EXPECT_EQ(OK, elementtemplate.defineField(field, -1, eft));
+	Fieldcache cache = fm.createFieldcache();
+	std::vector<double> values(componentsCount);
+	const double xi = 0.5;
+	for (int e = 0; e < elementsCount; ++e)
+	{
+		Element element = mesh.createElement(e + 1, elementtemplate);
+		EXPECT_EQ(OK, cache.setMeshLocation(element, 1, &xi));
+		for (int c = 0; c < componentsCount; ++c)
+			values[c] = 0.5*e + 0.25*c;
+		EXPECT_EQ(OK, field.assignReal(cache, componentsCount, values.data()));
+	}
+	EXPECT_EQ(OK, fm.endChange());
+}
+
+std::string writeRegionToBuffer(Region& region)
+{
+	StreaminformationRegion sir = region.createStreaminformationRegion();
+	StreamresourceMemory resource = sir.createStreamresourceMemory();
+	EXPECT_EQ(OK, region.write(sir));
+	void *buffer = 0;
+	unsigned int bufferSize = 0;
+	EXPECT_EQ(OK, resource.getBuffer(&buffer, &bufferSize));
+	return std::string(static_cast<const char *>(buffer), bufferSize);
+}
+
+void readBuffer(Region& region, const std::string& buffer)
+{
+	StreaminformationRegion sir = region.createStreaminformationRegion();
+	sir.createStreamresourceMemoryBuffer(buffer.data(), static_cast<unsigned int>(buffer.size()));
+	EXPECT_EQ(OK, region.read(sir));
+}
+
+/** Add identifierOffset to identifiers of all elements in 1-D mesh */
+void offsetLineIdentifiers(Region& region, int identifierOffset)
+{
+	Fieldmodule fm = region.getFieldmodule();
+	Mesh mesh = fm.findMeshByDimension(1);
+	std::vector<Element> elements;
+	Elementiterator iter = mesh.createElementiterator();
+	Element element;
+	while ((element = iter.next()).isValid())
+		elements.push_back(element);
+	EXPECT_EQ(OK, fm.beginChange());
+	for (size_t i = 0; i < elements.size(); ++i)
+		EXPECT_EQ(OK, elements[i].setIdentifier(elements[i].getIdentifier() + identifierOffset));
+	EXPECT_EQ(OK, fm.endChange());
+}
+
+/** Check field values in each element of reference region equal those in
+  * the element with identifier offset by identifierOffset in region */
+void checkElementFieldValues(Region& referenceRegion, Region& region, int identifierOffset)
+{
+	Fieldmodule referenceFm = referenceRegion.getFieldmodule();
+	Fieldmodule fm = region.getFieldmodule();
+	Field referenceField = referenceFm.findFieldByName("values");
+	Field field = fm.findFieldByName("values");
+	EXPECT_TRUE(field.isValid());
+	const int componentsCount = referenceField.getNumberOfComponents();
+	EXPECT_EQ(componentsCount, field.getNumberOfComponents());
+	Fieldcache referenceCache = referenceFm.createFieldcache();
+	Fieldcache cache = fm.createFieldcache();
+	Mesh mesh = fm.findMeshByDimension(1);
+	std::vector<double> referenceValues(componentsCount), values(componentsCount);
+	const double xi = 0.5;
+	Elementiterator iter = referenceFm.findMeshByDimension(1).createElementiterator();
+	Element referenceElement;
+	int mismatchCount = 0;
+	while ((referenceElement = iter.next()).isValid())
+	{
+		Element element = mesh.findElementByIdentifier(referenceElement.getIdentifier() + identifierOffset);
+		EXPECT_TRUE(element.isValid());
+		EXPECT_EQ(OK, referenceCache.setMeshLocation(referenceElement, 1, &xi));
+		EXPECT_EQ(OK, referenceField.evaluateReal(referenceCache, componentsCount, referenceValues.data()));
+		EXPECT_EQ(OK, cache.setMeshLocation(element, 1, &xi));
+		EXPECT_EQ(OK, field.evaluateReal(cache, componentsCount, values.data()));
+		if (values != referenceValues)
+			++mismatchCount;
+	}
+	EXPECT_EQ(0, mismatchCount);
+}
+
+}
+
+// Tests merging element field values gives the same values as setting them
+// directly, for new elements with original and offset identifiers and when
+// merging the same data again over existing elements. Sized so index mapping
+// and component merging use several threads on multi-core machines.
+TEST(ZincRegion, mergeElementFieldValues)
+{
+	ZincTestSetupCpp zinc;
+
+	const int elementsCount = 9000;
+	const int componentsCount = 16;
+	Region reference = zinc.root_region.createChild("reference");
+	defineElementConstantLines(reference, elementsCount, componentsCount);
+	const std::string buffer = writeRegionToBuffer(reference);
+	const int identifierOffset = 100000;
+	Region offset = zinc.context.createRegion();
+	readBuffer(offset, buffer);
+	offsetLineIdentifiers(offset, identifierOffset);
+	const std::string offsetBuffer = writeRegionToBuffer(offset);
+
+	Region merged = zinc.root_region.createChild("merged");
+	readBuffer(merged, buffer);
+	readBuffer(merged, offsetBuffer);
+	Mesh mesh1d = merged.getFieldmodule().findMeshByDimension(1);
+	EXPECT_EQ(2*elementsCount, mesh1d.getSize());
+	checkElementFieldValues(reference, merged, 0);
+	checkElementFieldValues(reference, merged, identifierOffset);
+
+	readBuffer(merged, offsetBuffer);
+	readBuffer(merged, buffer);
+	EXPECT_EQ(2*elementsCount, mesh1d.getSize());
+	checkElementFieldValues(reference, merged, 0);
+	checkElementFieldValues(reference, merged, identifierOffset);
+}
+
+namespace {
+
+void evaluateNodeCoordinates(Region& region, int nodeIdentifier, double *values)
+{
+	Fieldmodule fm = region.getFieldmodule();
+	Field coordinates = fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Node node = fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES).findNodeByIdentifier(nodeIdentifier);
+	EXPECT_TRUE(node.isValid());
+	Fieldcache cache = fm.createFieldcache();
+	EXPECT_EQ(OK, cache.setNode(node));
+	EXPECT_EQ(OK, coordinates.evaluateReal(cache, 3, values));
+}
+
+void assignNodeCoordinates(Region& region, int nodeIdentifier, const double *values)
+{
+	Fieldmodule fm = region.getFieldmodule();
+	Field coordinates = fm.findFieldByName("coordinates");
+	Node node = fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES).findNodeByIdentifier(nodeIdentifier);
+	Fieldcache cache = fm.createFieldcache();
+	EXPECT_EQ(OK, cache.setNode(node));
+	EXPECT_EQ(OK, coordinates.assignReal(cache, 3, values));
+}
+
+}
+
+// Tests a fork is an independent copy of a region and its subregions:
+// perturbing a field in either leaves the other unchanged
+TEST(ZincRegion, createFork)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(static_cast<cmzn_region_id>(0), cmzn_region_create_fork(0, 0.0));
+
+	Region region = zinc.root_region.createChild("model");
+	EXPECT_EQ(OK, region.readFile(TestResources::getLocation(TestResources::FIELDMODULE_TWO_CUBES_RESOURCE)));
+	Region child = region.createChild("child");
+	EXPECT_EQ(OK, child.readFile(TestResources::getLocation(TestResources::FIELDMODULE_CUBE_RESOURCE)));
+
+	Region fork = region.createFork(0.0);
+	EXPECT_TRUE(fork.isValid());
+	EXPECT_FALSE(fork.getParent().isValid());
+	Fieldmodule fm = region.getFieldmodule();
+	Fieldmodule forkFm = fork.getFieldmodule();
+	EXPECT_EQ(12, forkFm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES).getSize());
+	EXPECT_EQ(2, forkFm.findMeshByDimension(3).getSize());
+	Region forkChild = fork.findChildByName("child");
+	EXPECT_TRUE(forkChild.isValid());
+	EXPECT_EQ(8, forkChild.getFieldmodule().findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES).getSize());
+
+	const double originalCoordinates[3] = { 0.0, 0.0, 0.0 };
+	double coordinates[3];
+	evaluateNodeCoordinates(fork, 1, coordinates);
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(originalCoordinates[c], coordinates[c]);
+
+	// perturb fork: original is unchanged at node and in element
+	const double perturbedCoordinates[3] = { -0.5, 0.25, 1.5 };
+	assignNodeCoordinates(fork, 1, perturbedCoordinates);
+	evaluateNodeCoordinates(fork, 1, coordinates);
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(perturbedCoordinates[c], coordinates[c]);
+	evaluateNodeCoordinates(region, 1, coordinates);
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(originalCoordinates[c], coordinates[c]);
+	const double xi[3] = { 0.0, 0.0, 0.0 };
+	Field coordinatesField = fm.findFieldByName("coordinates");
+	Fieldcache cache = fm.createFieldcache();
+	EXPECT_EQ(OK, cache.setMeshLocation(fm.findMeshByDimension(3).findElementByIdentifier(1), 3, xi));
+	EXPECT_EQ(OK, coordinatesField.evaluateReal(cache, 3, coordinates));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(originalCoordinates[c], coordinates[c]);
+	Field forkCoordinatesField = forkFm.findFieldByName("coordinates");
+	Fieldcache forkCache = forkFm.createFieldcache();
+	EXPECT_EQ(OK, forkCache.setMeshLocation(forkFm.findMeshByDimension(3).findElementByIdentifier(1), 3, xi));
+	EXPECT_EQ(OK, forkCoordinatesField.evaluateReal(forkCache, 3, coordinates));
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(perturbedCoordinates[c], coordinates[c]);
+
+	// perturb original: fork is unchanged
+	const double perturbedCoordinates2[3] = { 10.0, 0.0, 2.0 };
+	assignNodeCoordinates(region, 2, perturbedCoordinates2);
+	evaluateNodeCoordinates(fork, 2, coordinates);
+	EXPECT_EQ(10.0, coordinates[0]);
+	EXPECT_EQ(0.0, coordinates[1]);
+	EXPECT_EQ(0.0, coordinates[2]);
+
+	// destroying elements in fork leaves original intact
+	Mesh forkMesh = forkFm.findMeshByDimension(3);
+	EXPECT_EQ(OK, forkMesh.destroyAllElements());
+	EXPECT_EQ(0, forkMesh.getSize());
+	EXPECT_EQ(2, fm.findMeshByDimension(3).getSize());
+	evaluateNodeCoordinates(region, 1, coordinates);
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(originalCoordinates[c], coordinates[c]);
+
+	// empty region forks to empty region
+	Region emptyFork = zinc.context.createRegion().createFork(0.0);
+	EXPECT_TRUE(emptyFork.isValid());
+	EXPECT_EQ(0, emptyFork.getFieldmodule().findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES).getSize());
+}